@@ -33,15 +33,6 @@ void __stdcall AddDebuggerMenuItem(char const*, bool (__stdcall *)(), void (__st
 {
     // TODO: maybe use dconsole for this
 }
-
-void __stdcall AddStatistic( const char* Name, const char* TypeName, gosType Type, void* Value, DWORD Flags )
-{
-    printf("STATISTICS: [%s : %s]\n", Name, TypeName);
-}
-void __stdcall StatisticFormat(char const* s)
-{
-    printf("STATISTICS: [%s]\n", s);
-}
 ////////////////////////////////////////////////////////////////////////////////
 
 void* DecodeJPG( const char* FileName, BYTE* Data, DWORD DataSize, DWORD* TextureWidth, DWORD* TextureHeight, bool TextureLoad, void *pDestSurf )
@@ -120,7 +111,7 @@ double __stdcall gos_GetHiResTime()
 #ifdef PLATFORM_LINUX
     struct timespec ts;
     clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
-    double time_sec = ts.tv_sec + ((double)ts.tv_nsec)/10.0e+9;
+    double time_sec = ts.tv_sec + ((double)ts.tv_nsec)/1.0e+9;
     return time_sec;
 #else
 	return ((double)timeGetTime()) * 0.001;
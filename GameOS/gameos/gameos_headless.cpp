@@ -0,0 +1,486 @@
+#include <vector>
+#include <string.h>
+
+#include "gameos.hpp"
+
+#ifdef LINUX_BUILD
+#include <cstdarg>
+#endif
+
+#include "utils/Image.h"
+
+// Stands in for gameos_graphics.cpp, gameos_sound.cpp and gos_render.cpp in
+// headless builds (see gameos_headless library and GAMEOS_HEADLESS main).
+// Nothing is drawn or played: textures only remember their size so they can be
+// locked, fonts are fixed pitch and audio channels are always stopped.
+
+struct SDL_Window;
+SDL_Window* g_sdl_window = NULL;
+
+static const DWORD INVALID_TEXTURE_ID = 0;
+
+static const int HEADLESS_CHAR_WIDTH = 8;
+static const int HEADLESS_CHAR_HEIGHT = 16;
+
+struct gosHeadlessTexture {
+    bool in_use_;
+    int width_;
+    int height_;
+    gos_TextureFormat format_;
+    DWORD* pdata_;
+};
+
+// slot 0 is never handed out, it is INVALID_TEXTURE_ID
+static std::vector<gosHeadlessTexture> g_textures(1);
+
+static float g_viewport_top = 0.0f;
+static float g_viewport_left = 0.0f;
+static float g_viewport_bottom = 1.0f;
+static float g_viewport_right = 1.0f;
+static float g_render_viewport[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+static HGOSFONT3D g_text_font = NULL;
+
+////////////////////////////////////////////////////////////////////////////////
+class gosFont {
+public:
+    int ref_count_;
+};
+
+class gosBuffer {
+public:
+    int element_size_;
+    uint32_t count_;
+};
+
+class gosVertexDeclaration {
+};
+
+class gosRenderMaterial {
+};
+
+static gosRenderMaterial g_render_material;
+
+////////////////////////////////////////////////////////////////////////////////
+static DWORD addTexture(gos_TextureFormat Format, int w, int h) {
+
+    gosHeadlessTexture tex;
+    tex.in_use_ = true;
+    tex.width_ = w;
+    tex.height_ = h;
+    tex.format_ = Format;
+    tex.pdata_ = NULL;
+
+    g_textures.push_back(tex);
+    return (DWORD)(g_textures.size() - 1);
+}
+
+static gosHeadlessTexture* getTexture(DWORD Handle) {
+    gosASSERT(Handle != INVALID_TEXTURE_ID && Handle < g_textures.size());
+    gosASSERT(g_textures[Handle].in_use_);
+    return &g_textures[Handle];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// graphics
+//
+void _stdcall gos_DrawLines(gos_VERTEX* Vertices, int NumVertices)
+{
+}
+void _stdcall gos_DrawPoints(gos_VERTEX* Vertices, int NumVertices)
+{
+}
+void _stdcall gos_DrawQuads(gos_VERTEX* Vertices, int NumVertices)
+{
+}
+void _stdcall gos_DrawTriangles(gos_VERTEX* Vertices, int NumVertices)
+{
+}
+
+void __stdcall gos_GetViewport( float* pViewportMulX, float* pViewportMulY, float* pViewportAddX, float* pViewportAddY )
+{
+    gosASSERT(pViewportMulX && pViewportMulY && pViewportAddX && pViewportAddY);
+    *pViewportMulX = (g_viewport_right - g_viewport_left) * Environment.screenWidth;
+    *pViewportMulY = (g_viewport_bottom - g_viewport_top) * Environment.screenHeight;
+    *pViewportAddX = g_viewport_left * Environment.screenWidth;
+    *pViewportAddY = g_viewport_top * Environment.screenHeight;
+}
+
+HGOSFONT3D __stdcall gos_LoadFont( const char* FontFile, DWORD StartLine/* = 0*/, int CharCount/* = 256*/, DWORD TextureHandle/*=0*/)
+{
+    gosFont* font = new gosFont();
+    font->ref_count_ = 1;
+    return font;
+}
+
+void __stdcall gos_DeleteFont( HGOSFONT3D FontHandle )
+{
+    gosASSERT(FontHandle);
+    if(g_text_font == FontHandle)
+        g_text_font = NULL;
+    if(0 == --FontHandle->ref_count_)
+        delete FontHandle;
+}
+
+DWORD __stdcall gos_NewEmptyTexture( gos_TextureFormat Format, const char* Name, DWORD HeightWidth, DWORD Hints/*=0*/, gos_RebuildFunction pFunc/*=0*/, void *pInstance/*=0*/)
+{
+    int w = HeightWidth;
+    int h = HeightWidth;
+    if(HeightWidth&0xffff0000)
+    {
+        h = HeightWidth >> 16;
+        w = HeightWidth & 0xffff;
+    }
+    return addTexture(Format, w, h);
+}
+
+DWORD __stdcall gos_NewTextureFromMemory( gos_TextureFormat Format, const char* FileName, BYTE* pBitmap, DWORD Size, DWORD Hints/*=0*/, gos_RebuildFunction pFunc/*=0*/, void *pInstance/*=0*/)
+{
+    gosASSERT(pFunc == 0);
+
+    // decoded only for its size, the pixels are never needed
+    Image img;
+    if(!img.loadTGA(pBitmap, Size)) {
+        SPEW(("DBG", "failed to load texture from data, filename: %s\n", FileName ? FileName : "NO FILENAME"));
+        STOP(("Failed to create texture\n"));
+        return INVALID_TEXTURE_ID;
+    }
+    return addTexture(Format, img.getWidth(), img.getHeight());
+}
+
+DWORD __stdcall gos_NewTextureFromFile( gos_TextureFormat Format, const char* FileName, DWORD Hints/*=0*/, gos_RebuildFunction pFunc/*=0*/, void *pInstance/*=0*/)
+{
+    Image img;
+    if(!img.loadFromFile(FileName)) {
+        SPEW(("DBG", "failed to load texture from file: %s\n", FileName));
+        STOP(("Failed to create texture\n"));
+        return INVALID_TEXTURE_ID;
+    }
+    return addTexture(Format, img.getWidth(), img.getHeight());
+}
+
+void __stdcall gos_DestroyTexture( DWORD Handle )
+{
+    gosHeadlessTexture* ptex = getTexture(Handle);
+    delete[] ptex->pdata_;
+    ptex->pdata_ = NULL;
+    ptex->in_use_ = false;
+}
+
+void __stdcall gos_LockTexture( DWORD Handle, DWORD MipMapSize, bool ReadOnly, TEXTUREPTR* TextureInfo )
+{
+    gosASSERT(MipMapSize == 0);
+
+    // the buffer is only made the first time a texture is locked and then
+    // kept, so what was written through it reads back on the next lock
+    gosHeadlessTexture* ptex = getTexture(Handle);
+    if(!ptex->pdata_) {
+        const int num_pixels = ptex->width_ * ptex->height_;
+        ptex->pdata_ = new DWORD[num_pixels];
+        memset(ptex->pdata_, 0, num_pixels * sizeof(DWORD));
+    }
+
+    TextureInfo->pTexture = ptex->pdata_;
+    TextureInfo->Width = ptex->width_;
+    TextureInfo->Height = ptex->height_;
+    TextureInfo->Pitch = ptex->width_;
+    TextureInfo->Type = ptex->format_;
+}
+
+void __stdcall gos_UnLockTexture( DWORD Handle )
+{
+    getTexture(Handle);
+}
+
+void __stdcall gos_PushRenderStates()
+{
+}
+
+void __stdcall gos_PopRenderStates()
+{
+}
+
+void __stdcall gos_RenderIndexedArray( gos_VERTEX* pVertexArray, DWORD NumberVertices, WORD* lpwIndices, DWORD NumberIndices )
+{
+}
+
+void __stdcall gos_RenderIndexedArray( gos_VERTEX_2UV* pVertexArray, DWORD NumberVertices, WORD* lpwIndices, DWORD NumberIndices )
+{
+}
+
+void __stdcall gos_RenderIndexedArray(HGOSBUFFER ib, HGOSBUFFER vb, HGOSVERTEXDECLARATION vdecl, const float* mvp)
+{
+}
+
+void __stdcall gos_RenderIndexedArray(HGOSBUFFER ib, HGOSBUFFER vb, HGOSVERTEXDECLARATION vdecl)
+{
+}
+
+void __stdcall gos_SetRenderState( gos_RenderState RenderState, int Value )
+{
+}
+
+void __stdcall gos_SetScreenMode( DWORD Width, DWORD Height, DWORD bitDepth/*=16*/, DWORD Device/*=0*/, bool disableZBuffer/*=0*/, bool AntiAlias/*=0*/, bool RenderToVram/*=0*/, bool GotoFullScreen/*=0*/, int DirtyRectangle/*=0*/, bool GotoWindowMode/*=0*/, bool EnableStencil/*=0*/, DWORD Renderer/*=0*/)
+{
+    Environment.screenWidth = Width;
+    Environment.screenHeight = Height;
+    Environment.drawableWidth = Width;
+    Environment.drawableHeight = Height;
+}
+
+void __stdcall gos_SetupViewport( bool FillZ, float ZBuffer, bool FillBG, DWORD BGColor, float top, float left, float bottom, float right, bool ClearStencil/*=0*/, DWORD StencilValue/*=0*/)
+{
+    g_viewport_top = top;
+    g_viewport_left = left;
+    g_viewport_bottom = bottom;
+    g_viewport_right = right;
+}
+
+void __stdcall gos_SetRenderViewport(float x, float y, float w, float h)
+{
+    g_render_viewport[0] = x;
+    g_render_viewport[1] = y;
+    g_render_viewport[2] = w;
+    g_render_viewport[3] = h;
+}
+
+void __stdcall gos_GetRenderViewport(float* x, float* y, float* w, float* h)
+{
+    gosASSERT(x && y && w && h);
+    *x = g_render_viewport[0];
+    *y = g_render_viewport[1];
+    *w = g_render_viewport[2];
+    *h = g_render_viewport[3];
+}
+
+void __stdcall gos_TextDraw( const char *Message, ... )
+{
+}
+
+void __stdcall gos_TextDrawBackground( int Left, int Top, int Right, int Bottom, DWORD Color )
+{
+}
+
+void __stdcall gos_TextSetAttributes( HGOSFONT3D FontHandle, DWORD Foreground, float Size, bool WordWrap, bool Proportional, bool Bold, bool Italic, DWORD WrapType/*=0*/, bool DisableEmbeddedCodes/*=0*/)
+{
+    g_text_font = FontHandle;
+}
+
+void __stdcall gos_TextSetPosition( int XPosition, int YPosition )
+{
+}
+
+void __stdcall gos_TextSetRegion( int Left, int Top, int Right, int Bottom )
+{
+}
+
+void __stdcall gos_TextStringLength( DWORD* Width, DWORD* Height, const char *fmt, ... )
+{
+    gosASSERT(Width && Height);
+
+    if(!fmt) {
+        *Width = 1;
+        *Height = 1;
+        return;
+    }
+
+    const int   MAX_TEXT_LEN = 4096;
+	char        text[MAX_TEXT_LEN] = {0};
+	va_list	    ap;
+
+    va_start(ap, fmt);
+	vsnprintf(text, MAX_TEXT_LEN - 1, fmt, ap);
+    va_end(ap);
+
+    int num_newlines = 0;
+    int max_width = 0;
+    int cur_width = 0;
+    for(const char* txtptr = text; *txtptr; ++txtptr) {
+        if(*txtptr == '\n') {
+            num_newlines++;
+            max_width = max_width > cur_width ? max_width : cur_width;
+            cur_width = 0;
+        } else {
+            cur_width += HEADLESS_CHAR_WIDTH;
+        }
+    }
+    max_width = max_width > cur_width ? max_width : cur_width;
+
+    *Width = max_width;
+    *Height = (num_newlines + 1) * HEADLESS_CHAR_HEIGHT;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+size_t __stdcall gos_GetMachineInformation( MachineInfo mi, int Param1/*=0*/, int Param2/*=0*/, int Param3/*=0*/, int Param4/*=0*/)
+{
+    if(mi == gos_Info_GetDeviceLocalMemory)
+        return 1024*1024*1024;
+    if(mi == gos_Info_GetDeviceAGPMemory)
+        return 512*1024*1024;
+    if (mi == gos_Info_CanMultitextureDetail)
+        return true;
+    if(mi == gos_Info_NumberDevices)
+        return 1;
+    if(mi == gos_Info_GetDeviceName)
+        return (size_t)"headless";
+    if(mi == gos_Info_ValidMode)
+        return 1;
+    if(mi == gos_Info_GetIMECaretStatus)
+        return 1;
+
+    return 0;
+}
+
+int gos_GetWindowDisplayIndex()
+{
+    return 0;
+}
+
+int gos_GetNumDisplayModes(int DisplayIndex)
+{
+    return 1;
+}
+
+bool gos_GetDisplayModeByIndex(int DisplayIndex, int ModeIndex, int* XRes, int* YRes, int* BitDepth)
+{
+    gosASSERT(XRes && YRes && BitDepth);
+    if(ModeIndex != 0)
+        return false;
+
+    *XRes = Environment.screenWidth;
+    *YRes = Environment.screenHeight;
+    *BitDepth = 32;
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// GPU Buffers management code
+////////////////////////////////////////////////////////////////////////////////
+
+gosBuffer* __stdcall gos_CreateBuffer(gosBUFFER_TYPE type, gosBUFFER_USAGE usage, int element_size, uint32_t count, void* buffer_data)
+{
+	gosBuffer* pbuffer = new gosBuffer();
+	pbuffer->element_size_ = element_size;
+	pbuffer->count_ = count;
+	return pbuffer;
+}
+
+uint32_t gos_GetBufferSizeBytes(HGOSBUFFER buffer)
+{
+	gosASSERT(buffer);
+    return buffer->element_size_ * buffer->count_;
+}
+
+void __stdcall gos_DestroyBuffer(gosBuffer* buffer)
+{
+	gosASSERT(buffer);
+	delete buffer;
+}
+
+void __stdcall gos_BindBufferBase(gosBuffer* buffer, uint32_t slot)
+{
+	gosASSERT(buffer);
+}
+
+void __stdcall gos_UpdateBuffer(HGOSBUFFER buffer, void* data, size_t offset, size_t num_bytes)
+{
+	gosASSERT(buffer);
+    gosASSERT(buffer->element_size_ * buffer->count_ >= num_bytes);
+}
+
+HGOSVERTEXDECLARATION __stdcall gos_CreateVertexDeclaration(gosVERTEX_FORMAT_RECORD* records, int count)
+{
+	gosASSERT(records && count > 0);
+	return new gosVertexDeclaration();
+}
+
+void __stdcall gos_DestroyVertexDeclaration(HGOSVERTEXDECLARATION vdecl)
+{
+	gosASSERT(vdecl);
+	delete vdecl;
+}
+
+HGOSRENDERMATERIAL __stdcall gos_getRenderMaterial(const char* material)
+{
+	gosASSERT(material);
+	return &g_render_material;
+}
+
+void __stdcall gos_ApplyRenderMaterial(HGOSRENDERMATERIAL material)
+{
+	gosASSERT(material);
+}
+
+void __stdcall gos_SetRenderMaterialParameterFloat4(HGOSRENDERMATERIAL material, const char* name, const float* v)
+{
+	gosASSERT(material);
+}
+
+void __stdcall gos_SetRenderMaterialParameterMat4(HGOSRENDERMATERIAL material, const char* name, const float* m)
+{
+	gosASSERT(material);
+}
+
+void __stdcall gos_SetRenderMaterialUniformBlockBindingPoint(HGOSRENDERMATERIAL material, const char* name, uint32_t slot)
+{
+	gosASSERT(material && name);
+}
+
+void __stdcall gos_SetCommonMaterialParameters(HGOSRENDERMATERIAL material)
+{
+	gosASSERT(material);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// audio
+//
+class gosAudio {
+};
+
+//////////////////////////////////////////////////////////////////////////////////
+// Resources are handed out so the game can keep track of them, nothing is
+// loaded.
+//
+void __stdcall gosAudio_CreateResource( HGOSAUDIO* hgosaudio, enum gosAudio_ResourceType res_type, const char* file_name, gosAudio_Format* ga_wf, void* data, int size, bool only2D)
+{
+    gosASSERT(hgosaudio);
+    *hgosaudio = new gosAudio();
+}
+
+void __stdcall gosAudio_DestroyResource( HGOSAUDIO* hgosaudio )
+{
+    gosASSERT(hgosaudio && *hgosaudio);
+    delete *hgosaudio;
+    *hgosaudio = NULL;
+}
+
+void __stdcall gosAudio_AllocateChannelSliders( int Channel, DWORD properties)
+{
+}
+
+void __stdcall gosAudio_AssignResourceToChannel( int Channel, HGOSAUDIO hgosaudio)
+{
+}
+
+void __stdcall gosAudio_SetChannelSlider( int Channel, enum gosAudio_Properties prop, float value1, float value2, float value3)
+{
+}
+
+void __stdcall gosAudio_GetChannelSlider( int Channel, enum gosAudio_Properties prop, float* value1, float* value2, float* value3)
+{
+    if(value1) *value1 = 0.0f;
+    if(value2) *value2 = 0.0f;
+    if(value3) *value3 = 0.0f;
+}
+
+void __stdcall gosAudio_SetChannelPlayMode( int Channel, enum gosAudio_PlayMode ga_pm )
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+// Nothing ever plays, so a sound the game waits on is done at once
+//
+gosAudio_PlayMode __stdcall gosAudio_GetChannelPlayMode( int Channel )
+{
+    return gosAudio_Stop;
+}
@@ -0,0 +1,375 @@
+#include "gameos.hpp"
+#include "toolos.hpp"
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+//
+// Statistics registered with AddStatistic() are read once a frame by
+// gos_UpdateStatistics(), which the main loop calls when the frame is done.
+// Every statistic keeps its last STAT_HISTORY values; the overlay shows the
+// current value and the minimum, average and maximum over the last
+// STAT_WINDOW frames. With -statscsv <file> every frame is also written out
+// as one CSV row.
+//
+// gos_timedata values must be counted in GetCycles() ticks, whatever those
+// are on the platform (the TSC on Windows, nanoseconds elsewhere). They are
+// shown in milliseconds, scaled by how many ticks the frame's real time took.
+//
+
+static const int STAT_HISTORY = 512;
+static const int STAT_WINDOW = 60;
+static const int STAT_NAME_LEN = 64;
+
+struct gosStatistic {
+    char    name[STAT_NAME_LEN];
+    char    type_name[16];
+    gosType type;
+    void*   value;
+    DWORD   flags;                  // StatFlags, or Stat_Format for a line of text
+    float   percent;                // gos_timedata: share of the last frame
+    float   history[STAT_HISTORY];
+};
+
+static std::vector<gosStatistic*> g_statistics;
+static size_t g_stat_insert_pos = 0;
+static std::vector<gosStatistic*> g_stat_pending_format;
+static bool g_stat_last_was_new = true;
+
+static int g_stat_head = 0;
+static int g_stat_frames = 0;
+static __int64 g_stat_last_cycles = 0;
+static double g_stat_last_time = 0.0;
+static float g_stat_frame_ms = 0.0f;
+
+static bool g_stat_show = false;
+static int g_stat_page = 0;
+
+static FILE* g_stat_csv = NULL;
+static size_t g_stat_csv_columns = 0;
+
+////////////////////////////////////////////////////////////////////////////////
+static gosStatistic* find_statistic(const char* name, size_t* pos)
+{
+    for(size_t i=0; i<g_statistics.size(); ++i) {
+        gosStatistic* s = g_statistics[i];
+        if(!(s->flags & Stat_Format) && 0 == strcmp(s->name, name)) {
+            if(pos)
+                *pos = i;
+            return s;
+        }
+    }
+    return NULL;
+}
+
+static gosStatistic* new_statistic(const char* name, DWORD flags)
+{
+    gosStatistic* s = new gosStatistic;
+    memset(s, 0, sizeof(gosStatistic));
+    strncpy(s->name, name, STAT_NAME_LEN - 1);
+    s->flags = flags;
+    return s;
+}
+
+static void insert_statistic(gosStatistic* s)
+{
+    if(g_stat_insert_pos > g_statistics.size())
+        g_stat_insert_pos = g_statistics.size();
+    g_statistics.insert(g_statistics.begin() + g_stat_insert_pos, s);
+    g_stat_insert_pos++;
+}
+
+// Format lines are held back until it's known whether they belong to new statistics or to ones registered before
+static void flush_pending_format()
+{
+    for(size_t i=0; i<g_stat_pending_format.size(); ++i) {
+        if(g_stat_last_was_new)
+            insert_statistic(g_stat_pending_format[i]);
+        else
+            delete g_stat_pending_format[i];
+    }
+    g_stat_pending_format.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A mission registers its statistics again each time it loads. Those keep their
+// place and history and only pick up the new pointer, and anything new is
+// added after the last one registered, so the display doesn't grow duplicates.
+//
+void __stdcall AddStatistic( const char* Name, const char* TypeName, gosType Type, void* Value, DWORD Flags )
+{
+    gosASSERT(Name && Value);
+
+    size_t pos;
+    gosStatistic* s = find_statistic(Name, &pos);
+    g_stat_last_was_new = (s == NULL);
+    flush_pending_format();
+    if(s) {
+        g_stat_insert_pos = pos + 1;
+    } else {
+        s = new_statistic(Name, Flags);
+        insert_statistic(s);
+    }
+
+    strncpy(s->type_name, TypeName ? TypeName : "", sizeof(s->type_name) - 1);
+    s->type = Type;
+    s->value = Value;
+    s->flags = Flags & ~Stat_Format;
+}
+
+void __stdcall StatisticFormat( const char* String )
+{
+    g_stat_pending_format.push_back(new_statistic(String, Stat_Format));
+}
+
+float __stdcall gos_ReturnStatistic( const char* Name, int Frame )
+{
+    gosStatistic* s = find_statistic(Name, NULL);
+    if(!s || Frame > 0 || -Frame >= STAT_HISTORY || -Frame >= g_stat_frames)
+        return 0.0f;
+    return s->history[(g_stat_head + Frame + STAT_HISTORY) % STAT_HISTORY];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static size_t get_type_size(gosType type)
+{
+    switch(type) {
+        case gos_DWORD:     return sizeof(DWORD);
+        case gos_WORD:      return sizeof(WORD);
+        case gos_BYTE:      return sizeof(BYTE);
+        case gos_int:       return sizeof(int);
+        case gos_short:     return sizeof(short);
+        case gos_char:      return sizeof(char);
+        case gos_float:     return sizeof(float);
+        case gos_double:    return sizeof(double);
+        case gos_int64:
+        case gos_timedata:  return sizeof(__int64);
+        default:            return 0;
+    }
+}
+
+static float read_statistic(gosStatistic* s, double ms_per_cycle)
+{
+    float v = 0.0f;
+    switch(s->type) {
+        case gos_DWORD:     v = (float)*(DWORD*)s->value; break;
+        case gos_WORD:      v = (float)*(WORD*)s->value; break;
+        case gos_BYTE:      v = (float)*(BYTE*)s->value; break;
+        case gos_int:       v = (float)*(int*)s->value; break;
+        case gos_short:     v = (float)*(short*)s->value; break;
+        case gos_char:      v = (float)*(char*)s->value; break;
+        case gos_float:     v = *(float*)s->value; break;
+        case gos_double:    v = (float)*(double*)s->value; break;
+        case gos_int64:     v = (float)*(__int64*)s->value; break;
+        case gos_timedata:  v = (float)(*(__int64*)s->value * ms_per_cycle); break;  // GetCycles() ticks
+        default:            break;  // gos_cycledata has no gos_CycleData here
+    }
+
+    if(s->flags & Stat_AutoReset)
+        memset(s->value, 0, get_type_size(s->type));
+
+    return v;
+}
+
+static void write_csv_row()
+{
+    size_t num_columns = 0;
+    for(size_t i=0; i<g_statistics.size(); ++i)
+        if(!(g_statistics[i]->flags & Stat_Format))
+            num_columns++;
+
+    // statistics can be added at any time, so the header is repeated when they are
+    if(num_columns != g_stat_csv_columns) {
+        fprintf(g_stat_csv, "frame,frame ms");
+        for(size_t i=0; i<g_statistics.size(); ++i) {
+            gosStatistic* s = g_statistics[i];
+            if(!(s->flags & Stat_Format))
+                fprintf(g_stat_csv, ",\"%s (%s)\"", s->name, s->type == gos_timedata ? "ms" : s->type_name);
+        }
+        fprintf(g_stat_csv, "\n");
+        g_stat_csv_columns = num_columns;
+    }
+
+    fprintf(g_stat_csv, "%d,%.3f", g_stat_frames, g_stat_frame_ms);
+    for(size_t i=0; i<g_statistics.size(); ++i) {
+        gosStatistic* s = g_statistics[i];
+        if(!(s->flags & Stat_Format))
+            fprintf(g_stat_csv, ",%g", s->history[g_stat_head]);
+    }
+    fprintf(g_stat_csv, "\n");
+}
+
+void gos_UpdateStatistics()
+{
+    __int64 cycles = GetCycles();
+    double time = gos_GetHiResTime();
+
+    double ms_per_cycle = 0.0;
+    g_stat_frame_ms = 0.0f;
+    if(g_stat_last_cycles && cycles > g_stat_last_cycles) {
+        g_stat_frame_ms = (float)((time - g_stat_last_time) * 1000.0);
+        ms_per_cycle = g_stat_frame_ms / (double)(cycles - g_stat_last_cycles);
+    }
+    g_stat_last_cycles = cycles;
+    g_stat_last_time = time;
+
+    flush_pending_format();
+
+    g_stat_head = (g_stat_head + 1) % STAT_HISTORY;
+    g_stat_frames++;
+
+    for(size_t i=0; i<g_statistics.size(); ++i) {
+        gosStatistic* s = g_statistics[i];
+        if(s->flags & Stat_Format)
+            continue;
+        float v = read_statistic(s, ms_per_cycle);
+        s->history[g_stat_head] = v;
+        if(s->type == gos_timedata)
+            s->percent = g_stat_frame_ms > 0.0f ? 100.0f * v / g_stat_frame_ms : 0.0f;
+    }
+
+    if(g_stat_csv)
+        write_csv_row();
+}
+
+bool gos_OpenStatisticsLog(const char* FileName)
+{
+    gosASSERT(!g_stat_csv);
+    g_stat_csv = fopen(FileName, "w");
+    if(!g_stat_csv) {
+        SPEW(("STATISTICS", "Cannot write %s\n", FileName));
+        return false;
+    }
+    g_stat_csv_columns = 0;
+    return true;
+}
+
+void gos_DestroyStatistics()
+{
+    if(g_stat_csv) {
+        fclose(g_stat_csv);
+        g_stat_csv = NULL;
+    }
+
+    g_stat_last_was_new = false;
+    flush_pending_format();
+    for(size_t i=0; i<g_statistics.size(); ++i)
+        delete g_statistics[i];
+    g_statistics.clear();
+    g_stat_insert_pos = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void gos_ToggleStatistics()
+{
+    g_stat_show = !g_stat_show;
+}
+
+void gos_PageStatistics(int Delta)
+{
+    g_stat_page += Delta;   // clamped when drawn, once the page size is known
+}
+
+static void format_value(char* buf, size_t len, const gosStatistic* s, float v)
+{
+    int dp = 0;
+    if(s->flags & Stat_1DP)
+        dp = 1;
+    else if(s->flags & Stat_2DP)
+        dp = 2;
+    else if(s->flags & Stat_3DP)
+        dp = 3;
+    else if(s->type == gos_timedata)
+        dp = 2;
+    else if(s->type == gos_float || s->type == gos_double)
+        dp = 2;
+    snprintf(buf, len, "%.*f", dp, v);
+}
+
+static void draw_column(int x, int y, const char* text)
+{
+    if(text[0]) {
+        gos_TextSetPosition(x, y);
+        gos_TextDraw(text);
+    }
+}
+
+void __stdcall gos_DrawStatistics( HGOSFONT3D FontHandle )
+{
+    if(!g_stat_show || !FontHandle)
+        return;
+
+    gos_TextSetAttributes(FontHandle, 0xffffffff, 1.0f, false, true, false, false);
+    gos_TextSetRegion(0, 0, Environment.screenWidth, Environment.screenHeight);
+
+    DWORD name_w = 0, num_w, line_h;
+    for(size_t i=0; i<g_statistics.size(); ++i) {
+        DWORD w, h;
+        gos_TextStringLength(&w, &h, "%s", g_statistics[i]->name);
+        if(w > name_w)
+            name_w = w;
+    }
+    gos_TextStringLength(&num_w, &line_h, "-0000000.00");
+    name_w += num_w / 2;
+    num_w += num_w / 4;
+
+    const int left = 10;
+    const int top = 10;
+    const int lines_per_page = line_h ? (int)((Environment.screenHeight - 2 * top) / line_h) - 2 : 0;
+    if(lines_per_page <= 0)
+        return;
+
+    const int num_pages = ((int)g_statistics.size() + lines_per_page - 1) / lines_per_page;
+    if(g_stat_page >= num_pages)
+        g_stat_page = num_pages ? num_pages - 1 : 0;
+    if(g_stat_page < 0)
+        g_stat_page = 0;
+
+    const int window = g_stat_frames < STAT_WINDOW ? g_stat_frames : STAT_WINDOW;
+
+    int y = top;
+    char text[64];
+    snprintf(text, sizeof(text), "%.2f ms/frame  (page %d/%d)", g_stat_frame_ms, g_stat_page + 1, num_pages ? num_pages : 1);
+    draw_column(left, y, "Statistics");
+    draw_column(left + name_w, y, text);
+    y += line_h;
+    draw_column(left + name_w, y, "now");
+    draw_column(left + name_w + num_w, y, "min");
+    draw_column(left + name_w + num_w * 2, y, "avg");
+    draw_column(left + name_w + num_w * 3, y, "max");
+    y += line_h;
+
+    const size_t first = g_stat_page * lines_per_page;
+    for(size_t i=first; i<g_statistics.size() && i<first + lines_per_page; ++i, y+=line_h) {
+        const gosStatistic* s = g_statistics[i];
+        draw_column(left, y, s->name);
+        if(s->flags & Stat_Format)
+            continue;
+
+        float v = s->history[g_stat_head];
+        format_value(text, sizeof(text), s, v);
+        draw_column(left + name_w, y, text);
+
+        if(!(s->flags & Stat_Total) && window) {
+            float mn = v, mx = v, total = 0.0f;
+            for(int j=0; j<window; ++j) {
+                float h = s->history[(g_stat_head - j + STAT_HISTORY) % STAT_HISTORY];
+                mn = h < mn ? h : mn;
+                mx = h > mx ? h : mx;
+                total += h;
+            }
+            format_value(text, sizeof(text), s, mn);
+            draw_column(left + name_w + num_w, y, text);
+            format_value(text, sizeof(text), s, total / window);
+            draw_column(left + name_w + num_w * 2, y, text);
+            format_value(text, sizeof(text), s, mx);
+            draw_column(left + name_w + num_w * 3, y, text);
+        }
+
+        if(s->type == gos_timedata)
+            snprintf(text, sizeof(text), "ms  %.1f%%", s->percent);
+        else
+            snprintf(text, sizeof(text), "%s", s->type_name);
+        draw_column(left + name_w + num_w * 4, y, text);
+    }
+}
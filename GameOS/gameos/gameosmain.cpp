@@ -3,16 +3,29 @@
 #include <stdio.h>
 #include <time.h>
 
+#ifndef GAMEOS_HEADLESS
 #include <SDL2/SDL.h>
 #include "gos_input.h"
 
 #include "utils/camera.h"
 #include "utils/shader_builder.h"
 #include "utils/gl_utils.h"
+#endif // GAMEOS_HEADLESS
 #include "utils/timing.h"
 
 #include <signal.h>
 
+extern bool gosExitGameOS();
+
+extern float frameRate;
+
+extern void gos_UpdateStatistics();
+extern bool gos_OpenStatisticsLog(const char* FileName);
+extern void gos_DestroyStatistics();
+
+static bool g_exit = false;
+
+#ifndef GAMEOS_HEADLESS
 extern void gos_CreateRenderer(graphics::RenderContextHandle ctx_h, graphics::RenderWindowHandle win_h, int w, int h);
 extern void gos_DestroyRenderer();
 extern void gos_RendererBeginFrame();
@@ -21,13 +34,12 @@ extern void gos_RendererHandleEvents();
 extern void gos_RenderUpdateDebugInput();
 extern void gos_RenderEnableDebugDrawCalls();
 extern bool gos_RenderGetEnableDebugDrawCalls();
-
-extern bool gosExitGameOS();
+extern void gos_ToggleStatistics();
+extern void gos_PageStatistics(int Delta);
 
 extern bool gos_CreateAudio();
 extern void gos_DestroyAudio();
 
-static bool g_exit = false;
 static bool g_focus_lost = false;
 #if 0
 static camera g_camera;
@@ -43,6 +55,15 @@ static void handle_key_down( SDL_Keysym* keysym ) {
             if(keysym->mod & KMOD_RALT)
                 gos_RenderEnableDebugDrawCalls();
             break;
+        case 's':
+            if(keysym->mod & KMOD_RALT)
+                gos_ToggleStatistics();
+            break;
+        case SDLK_PAGEUP:
+        case SDLK_PAGEDOWN:
+            if(keysym->mod & KMOD_RALT)
+                gos_PageStatistics(keysym->sym == SDLK_PAGEUP ? -1 : 1);
+            break;
     }
 }
 
@@ -158,8 +179,6 @@ static void draw_screen( void )
     //CHECK_GL_ERROR;
 }
 
-extern float frameRate;
-
 
 const char* getStringForType(GLenum type)
 {
@@ -221,13 +240,11 @@ void GLAPIENTRY OpenGLDebugLog(GLenum source, GLenum type, GLuint id, GLenum sev
 		printf("Message : %s\n", message);
 	}
 }
+#endif // GAMEOS_HEADLESS
 
 #ifndef DISABLE_GAMEOS_MAIN
-int main(int argc, char** argv)
-{
-    //signal(SIGTRAP, SIG_IGN);
+static char* build_command_line(int argc, char** argv) {
 
-    // gather command line
 	size_t cmdline_len = 0;
     for(int i=0;i<argc;++i) {
         cmdline_len += strlen(argv[i]);
@@ -242,6 +259,25 @@ int main(int argc, char** argv)
         offset += arglen + 1;
     }
     cmdline[cmdline_len] = '\0';
+    return cmdline;
+}
+
+// -statscsv <file> writes every frame's statistics (see AddStatistic) to a CSV file
+static void open_statistics_log(int argc, char** argv) {
+
+    for(int i=1;i<argc-1;++i) {
+        if(0 == strcmp(argv[i], "-statscsv"))
+            gos_OpenStatisticsLog(argv[i+1]);
+    }
+}
+
+#ifndef GAMEOS_HEADLESS
+int main(int argc, char** argv)
+{
+    //signal(SIGTRAP, SIG_IGN);
+
+    // gather command line
+    char* cmdline = build_command_line(argc, argv);
 
     // fills in Environment structure
     GetGameOSEnvironment(cmdline);
@@ -249,6 +285,8 @@ int main(int argc, char** argv)
     delete[] cmdline;
     cmdline = NULL;
 
+    open_statistics_log(argc, argv);
+
     int w = Environment.screenWidth;
     int h = Environment.screenHeight;
 
@@ -339,6 +377,8 @@ int main(int argc, char** argv)
         draw_screen();
         graphics::swap_window(win);
 
+        gos_UpdateStatistics();
+
         g_exit |= gosExitGameOS();
 
 		uint64_t end_tick = timing::gettickcount();
@@ -348,6 +388,8 @@ int main(int argc, char** argv)
     
     Environment.TerminateGameEngine();
 
+    gos_DestroyStatistics();
+
     gos_DestroyRenderer();
 
     graphics::destroy_render_context(ctx);
@@ -357,4 +399,76 @@ int main(int argc, char** argv)
 
     return 0;
 }
+#else // GAMEOS_HEADLESS
+//
+// No window, GL context or audio device: the gos_* draw, texture and audio
+// entry points are the no-ops from gameos_headless.cpp. Game logic is called
+// back to back, each call one fixed step of 1/-tickrate seconds (30 by
+// default), until the game quits or -maxticks calls have been made.
+//
+int main(int argc, char** argv)
+{
+    float tick_rate = 30.0f;
+    uint64_t max_ticks = 0;
+    for(int i=1;i<argc-1;++i) {
+        if(0 == strcmp(argv[i], "-tickrate"))
+            tick_rate = (float)atof(argv[i+1]);
+        else if(0 == strcmp(argv[i], "-maxticks"))
+            max_ticks = strtoull(argv[i+1], NULL, 10);
+    }
+
+    if(tick_rate <= 0.0f) {
+        fprintf(stderr, "-tickrate must be greater than 0\n");
+        return 1;
+    }
+
+    // gather command line
+    char* cmdline = build_command_line(argc, argv);
+
+    // fills in Environment structure
+    GetGameOSEnvironment(cmdline);
+
+    delete[] cmdline;
+    cmdline = NULL;
+
+    Environment.headless = true;
+    Environment.drawableWidth = Environment.screenWidth;
+    Environment.drawableHeight = Environment.screenHeight;
+
+    open_statistics_log(argc, argv);
+
+    Environment.InitializeGameEngine();
+
+	timing::init();
+
+    uint64_t num_ticks = 0;
+    uint64_t start_tick = timing::gettickcount();
+
+    while( !g_exit ) {
+
+        // the game turns this into its frame length
+        frameRate = tick_rate;
+        Environment.DoGameLogic();
+        ++num_ticks;
+
+        gos_UpdateStatistics();
+
+        g_exit |= gosExitGameOS();
+        if(max_ticks && num_ticks >= max_ticks)
+            g_exit = true;
+    }
+
+    uint64_t dt = timing::ticks2ms(timing::gettickcount() - start_tick);
+    const float seconds = dt > 0 ? (float)dt / 1000.0f : 0.001f;
+    printf("HEADLESS: %llu ticks in %.2f s: %.1f ticks/s, %.1fx real time\n",
+           (unsigned long long)num_ticks, seconds, num_ticks / seconds,
+           (num_ticks / tick_rate) / seconds);
+
+    Environment.TerminateGameEngine();
+
+    gos_DestroyStatistics();
+
+    return 0;
+}
+#endif // GAMEOS_HEADLESS
 #endif // DISABLE_GAMEOS_MAIN
@@ -9,9 +9,6 @@
 
 #define BUFFER_OFFSET(bytes) ((GLubyte*) NULL + (bytes))
 
-uint32_t vec4_to_uint32(const vec4& v);
-vec4 uint32_to_vec4(uint32_t v);
-
 struct Texture {
 	Texture():id(0), w(0), h(0), depth(1), fmt_(TF_NONE) {}
     bool isValid() { return id > 0; }
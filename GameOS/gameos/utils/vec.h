@@ -10,6 +10,7 @@ Standard 3D math definitions and routines
 */
 
 #include <math.h>
+#include <stdint.h>
 #ifndef PI
 #define PI 3.1415926535f
 #endif
@@ -541,6 +542,11 @@ mat3 scale3(const float x, const float y, const float z);
 mat4 scale4(const float x, const float y, const float z);
 //@}
 
+/** Packed 8 bit per channel color (0xAABBGGRR) to and from [0,1] vectors. @{ */
+uint32_t vec4_to_uint32(const vec4& v);
+vec4 uint32_to_vec4(uint32_t v);
+//@}
+
 /** HLSL (High-Level Shading Language) notation of basic types. @{ */
 // needed to cemment this because of conflicts with mayas float2,3,4
 //typedef vec2 float2;
@@ -215,6 +215,7 @@ typedef struct
 	bool	dontClearRegistry;		// When true, the registry is not cleared when the .exe is changed
     // sebi:
     bool    checkCDForFiles;        // Whether to check for files on CD when File::open is called 
+    bool    headless;               // Set by GameOS when running with no window, GL context or audio device (game logic only)
 //
 // Current screen mode (application can check, but may change from frame to frame)
 //
@@ -2955,6 +2956,12 @@ void __stdcall StatisticFormat( const char* String );
 //
 float __stdcall gos_ReturnStatistic( const char* Name, int Frame=0 );
 
+//
+// Draws the statistics over the screen with the given font, when switched on (Right Alt+S, Right Alt+Page Up/Down
+// to page through them). Call this from UpdateRenderers, after everything else has been drawn.
+//
+void __stdcall gos_DrawStatistics( HGOSFONT3D FontHandle );
+
 
 
 //
@@ -108,6 +108,10 @@
 #include"logistics.h"
 #endif
 
+#ifndef REPLAY_H
+#include"replay.h"
+#endif
+
 MoverGroupPtr			CurGroup = NULL;
 GameObjectPtr			CurObject = NULL;
 long					CurObjectClass = 0;
@@ -6578,7 +6582,7 @@ void ablDebugPrintCallback (const char* s) {
 
 void ablSeedRandom (unsigned long seed) {
 
-	gos_srand(seed);
+	gos_srand(REPLAY_seedRandom(seed));
 }
 
 //*****************************************************************************
@@ -193,8 +193,10 @@ long CollisionGrid::init (Stuff::Vector3D &newOrigin)
 	// Reset all of the grid data.	
 	memset(grid,0,gridSize);
 	memset(nodes,0,nodeSize);
+	for (unsigned long i=0;i<maxObjects;i++)
+		nodes[i].cell = COLLISION_NOT_IN_GRID;
 		
-	nextAvailableNode = 0;
+	numNodes = 0;
 	gridOrigin = newOrigin;
 	
 	giantObjects = NULL;
@@ -222,38 +224,102 @@ void CollisionGrid::destroy (void)
 }	
 		
 //------------------------------------------------------------------------------
-long CollisionGrid::add (unsigned long gridIndex, GameObjectPtr object)
+void CollisionGrid::link (long cell, CollisionGridNodePtr node)
 {
-	gosASSERT(nextAvailableNode < maxObjects);
-	gosASSERT((gridIndex >= 0) && (gridIndex < (xGridWidth * yGridWidth)));
-	
-	CollisionGridNodePtr prev = grid[gridIndex];
-	CollisionGridNodePtr node = &nodes[nextAvailableNode++];
-	grid[gridIndex] = node;
-	node->object = object;
-	node->next = prev;
-	
-	return(NO_ERR);
+	//----------------------------------------------------------------
+	// Lists are kept in reverse collidable list order.  That is the
+	// order the grid used to be rebuilt in every frame, so objects
+	// still get checked (and hit) in the same order.
+	CollisionGridNodePtr *prev = &giantObjects;
+	if (cell != COLLISION_GIANT_LIST)
+	{
+		gosASSERT((cell >= 0) && (cell < long(xGridWidth * yGridWidth)));
+		prev = &grid[cell];
+	}
+
+	while (*prev && (*prev > node))
+		prev = &((*prev)->next);
+
+	node->next = *prev;
+	*prev = node;
+	node->cell = cell;
 }
 
 //------------------------------------------------------------------------------
-long CollisionGrid::add (GameObjectPtr object)
+void CollisionGrid::remove (unsigned long nodeIndex)
+{
+	if (nodeIndex >= maxObjects)
+		return;
+
+	CollisionGridNodePtr node = &nodes[nodeIndex];
+	if (node->cell == COLLISION_NOT_IN_GRID)
+		return;
+
+	CollisionGridNodePtr *prev = (node->cell == COLLISION_GIANT_LIST) ? &giantObjects : &grid[node->cell];
+	while (*prev && (*prev != node))
+		prev = &((*prev)->next);
+
+	if (*prev)
+		*prev = node->next;
+
+	node->next = NULL;
+	node->cell = COLLISION_NOT_IN_GRID;
+}
+
+//------------------------------------------------------------------------------
+void CollisionGrid::setNumObjects (unsigned long numObjects)
+{
+	//------------------------------------------------
+	// The collidable list got shorter.  Drop the rest.
+	for (unsigned long i=numObjects;i<numNodes;i++)
+	{
+		remove(i);
+		nodes[i].object = NULL;
+	}
+
+	numNodes = numObjects;
+}
+
+//------------------------------------------------------------------------------
+long CollisionGrid::add (unsigned long nodeIndex, GameObjectPtr object)
 {
 	if (object->getTangible())		//Can anything even hit me?
 	{
-		gosASSERT(nextAvailableNode < maxObjects);
+		gosASSERT(nodeIndex < maxObjects);
+		CollisionGridNodePtr node = &nodes[nodeIndex];
+
+		//------------------------------------------------------
+		// The collidable list was rebuilt and this is someone
+		// else's node now.
+		if (node->object != object)
+		{
+			remove(nodeIndex);
+			node->object = object;
+		}
+
 		float objectRadius = object->getExtentRadius();
 		
 		//---------------------------------------------
 		// Check if we are a giant Object
 		if (objectRadius > maxGridRadius)
 		{
-			CollisionGridNodePtr node = &nodes[nextAvailableNode++];
-			node->object = object;
-			node->next = giantObjects;
-			giantObjects = node;
+			if (node->cell != COLLISION_GIANT_LIST)
+			{
+				remove(nodeIndex);
+				link(COLLISION_GIANT_LIST,node);
+			}
 			return NO_ERR;
 		}
+
+		//---------------------------------------------
+		// Haven't moved (buildings, turrets, gates...)
+		// so we're already in the right square.
+		Stuff::Vector3D position = object->getPosition();
+		if ((node->cell >= 0) && (position.x == node->lastX) && (position.y == node->lastY))
+			return NO_ERR;
+
+		node->lastX = position.x;
+		node->lastY = position.y;
 		
 		float gx,gy;
 		
@@ -278,17 +344,117 @@ long CollisionGrid::add (GameObjectPtr object)
 		gy /= maxGridRadius;	
 
 		unsigned long gridIndex = float2long(gx-0.5f) + float2long(gy-0.5f) * xGridWidth;
-		
-		long result = add(gridIndex,object);
-		return result;
+
+		//--------------------------------------------------
+		// Only relink when we've moved to another square.
+		if (node->cell != long(gridIndex))
+		{
+			remove(nodeIndex);
+			link(gridIndex,node);
+		}
+		return NO_ERR;
 	}
 
+	remove(nodeIndex);
 	return NO_ERR;
 }	
 
+//------------------------------------------------------------------------------
+bool CollisionGrid::updateNode (CollisionGridNodePtr node)
+{
+	GameObjectPtr obj = node->object;
+	Stuff::Vector3D position = obj->getPosition();
+
+	int cellRow = 0, cellCol = 0;
+	int block = 0, vertex = 0;
+	obj->getCellPosition(cellRow,cellCol);
+	long objectClass = obj->getObjectClass();
+	if (objectClass < EXPLOSION)
+		obj->getBlockAndVertexNumber(block,vertex);
+
+	bool moved = (position.x != node->x) || (position.y != node->y) ||
+				 (cellRow != node->cellRow) || (cellCol != node->cellCol) ||
+				 (block != node->block) || (vertex != node->vertex);
+
+	node->x = position.x;
+	node->y = position.y;
+	node->cellRow = cellRow;
+	node->cellCol = cellCol;
+	node->block = block;
+	node->vertex = vertex;
+	node->objectClass = objectClass;
+
+	return(moved);
+}
+
+//------------------------------------------------------------------------------
+void CollisionGrid::testPairs (unsigned long first)
+{
+	//------------------------------------------------------------------
+	// Same tests as CollisionSystem::detectCollision, done from the
+	// snapshots for the whole batch at once.  Movers hit when they are
+	// in the same cell, everything else when the extent radii overlap.
+	for (unsigned long i=first;i<numPairs;i++)
+	{
+		CollisionGridNodePtr node1 = &nodes[pairObj1[i]];
+		CollisionGridNodePtr node2 = &nodes[pairObj2[i]];
+
+		float dx = node2->x - node1->x;
+		float dy = node2->y - node1->y;
+		float distMag = dx * dx + dy * dy;
+		float maxDist = node2->radius + node1->radius;
+		maxDist *= maxDist;
+
+		bool movers = (node1->objectClass < EXPLOSION) & (node2->objectClass < EXPLOSION);
+		bool sameCell = (node1->block == node2->block) & (node1->vertex == node2->vertex) &
+						(node1->cellRow == node2->cellRow) & (node1->cellCol == node2->cellCol);
+
+		pairHit[i] = movers ? sameCell : (distMag < maxDist);
+	}
+}
+
+//------------------------------------------------------------------------------
+void CollisionGrid::flushPairs (void)
+{
+	testPairs(0);
+
+	for (unsigned long i=0;i<numPairs;i++)
+	{
+		if (!pairHit[i])
+			continue;
+
+		CollisionGridNodePtr node1 = &nodes[pairObj1[i]];
+		CollisionGridNodePtr node2 = &nodes[pairObj2[i]];
+		CollisionSystem::checkExtents(node1->object,node2->object,0.0);
+
+		//-----------------------------------------------------------
+		// Collisions can bounce movers into the next cell.  If that
+		// happened, the rest of the batch has to see where they are now.
+		bool moved1 = updateNode(node1);
+		bool moved2 = updateNode(node2);
+		if (moved1 || moved2)
+			testPairs(i+1);
+	}
+
+	numPairs = 0;
+}
+
 //------------------------------------------------------------------------------
 void CollisionGrid::createGrid (void)
 {
+	//------------------------------------------------------
+	// Take everyone's snapshot once, instead of once a pair.
+	for (unsigned long i=0;i<numNodes;i++)
+	{
+		if (nodes[i].cell != COLLISION_NOT_IN_GRID)
+		{
+			updateNode(&nodes[i]);
+			nodes[i].radius = nodes[i].object->getExtentRadius();
+		}
+	}
+
+	numPairs = 0;
+
 	//------------------------------------------------
 	// This block of code is only necessary if
 	// we collide a giantObject against a giantObject.
@@ -298,7 +464,7 @@ void CollisionGrid::createGrid (void)
 	{
 		if (g->next)
 		{
-			checkGrid(g->object,g->next);
+			checkGrid(g,g->next);
 			totalGiantObjects++;
 		}
 		g = g->next;
@@ -313,7 +479,7 @@ void CollisionGrid::createGrid (void)
 			
 			while (g)
 			{
-				GameObjectPtr obj = g->object;
+				CollisionGridNodePtr obj = g;
 				
 				//--------------------------------------
 				// Check against the big things.
@@ -358,38 +524,45 @@ void CollisionGrid::createGrid (void)
 			}
 		}
 	}
+
+	flushPairs();
 }	
 
 //------------------------------------------------------------------------------
-void CollisionGrid::checkGrid (GameObjectPtr obj1, CollisionGridNodePtr area)
+void CollisionGrid::checkGrid (CollisionGridNodePtr node, CollisionGridNodePtr area)
 {
+	long class1 = node->objectClass;
 	while (area)
 	{
-		GameObjectPtr obj2 = area->object;
+		CollisionGridNodePtr node2 = area;
 		area = area->next;
 
-		if (obj1 && obj2)
+		long class2 = node2->objectClass;
+
+		//-------------------------------------------------------------
+		// CULL collisions between things which can never collide here
+		//------------------------------------------------------------
+		if (((class1 == TURRET) && (class2 == TURRET)) ||
+			((class1 == GATE) && (class2 == GATE)) ||
+			((class1 == GATE) && (class2 == TURRET)) ||
+			((class1 == TURRET) && (class2 == GATE)) ||
+			((class1 == TURRET) && (class2 == TREE)) ||
+			((class1 == TREE) && (class2 == TURRET)) ||
+			((class1 == EXPLOSION) && (class2 == EXPLOSION)))
 		{
-			//-------------------------------------------------------------
-			// CULL collisions between things which can never collide here
-			//------------------------------------------------------------
-			if (((obj1->getObjectClass() == TURRET) && (obj2->getObjectClass() == TURRET)) ||
-				((obj1->getObjectClass() == GATE) && (obj2->getObjectClass() == GATE)) ||
-				((obj1->getObjectClass() == GATE) && (obj2->getObjectClass() == TURRET)) ||
-				((obj1->getObjectClass() == TURRET) && (obj2->getObjectClass() == GATE)) ||
-				((obj1->getObjectClass() == TURRET) && (obj2->getObjectClass() == TREE)) ||
-				((obj1->getObjectClass() == TREE) && (obj2->getObjectClass() == TURRET)) ||
-				((obj1->getObjectClass() == EXPLOSION) && (obj2->getObjectClass() == EXPLOSION)))
-			{
-				
-			}
-			else
-			{
-				//--------------------------------------------------------
-				// At this point, we have two objects in the same area
-				// and they can collide.  We now run the bigBoy detection
-				CollisionSystem::detectCollision(obj1,obj2);
-			}
+			
+		}
+		else
+		{
+			//--------------------------------------------------------
+			// At this point, we have two objects in the same area
+			// and they can collide.  Queue them up for the bigBoy
+			// detection, which runs on a whole batch at a time.
+			pairObj1[numPairs] = node - nodes;
+			pairObj2[numPairs] = node2 - nodes;
+			numPairs++;
+			if (numPairs == COLLISION_PAIR_BATCH)
+				flushPairs();
 		}
 	}
 }	
@@ -431,6 +604,12 @@ long CollisionSystem::init (FitIniFile *scenarioFile)
 	collisionGrid = new CollisionGrid;
 	gosASSERT(collisionGrid != NULL);
 
+	//---------------------------------------------------------
+	// The grid is kept from frame to frame.  checkObjects only
+	// moves the objects that changed squares.
+	Stuff::Vector3D gridCenter(0L,0L,0L);
+	collisionGrid->init(gridCenter);
+
 	globalCollisionAlert = new GlobalCollisionAlert;
 	gosASSERT(globalCollisionAlert);
 	
@@ -444,10 +623,6 @@ long CollisionSystem::init (FitIniFile *scenarioFile)
 //------------------------------------------------------------------------------
 void CollisionSystem::checkObjects (void)
 {
-	Stuff::Vector3D gridCenter(0L,0L,0L);
-	
-	collisionGrid->init(gridCenter);
-
 	//-----------------------------------------------------------
 	// Reset the Collision Alerts
 	globalCollisionAlert->purgeRecords();
@@ -463,11 +638,14 @@ void CollisionSystem::checkObjects (void)
 #ifdef _DEBUG
 		long result = 
 #endif
-			collisionGrid->add(objList[i]);
+			collisionGrid->add(i,objList[i]);
 			gosASSERT(result == NO_ERR);
 			objList[i]->handleStaticCollision();
 		}
+		else
+			collisionGrid->remove(i);
 	}
+	collisionGrid->setNumObjects(numCollidables);
 
 #else	
 	//---------------------------------------------------------
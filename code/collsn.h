@@ -29,12 +29,36 @@
 #define NO_ERR	0
 #endif
 
+//------------------------------------------------------------------------------
+// Node cell when not in a grid square
+#define COLLISION_NOT_IN_GRID	-1
+#define COLLISION_GIANT_LIST	-2
+
+//------------------------------------------------------------------------------
+// Candidate pairs are tested this many at a time
+#define COLLISION_PAIR_BATCH	256
+
 //------------------------------------------------------------------------------
 // classes
 struct CollisionGridNode
 {
 	GameObjectPtr			object;
 	CollisionGridNodePtr	next;
+	long					cell;			//grid index, or one of the above
+	float					lastX;			//position the cell was figured from
+	float					lastY;
+
+	//-----------------------------------------------------------
+	// Snapshot of the object taken once per frame by createGrid,
+	// so pair tests don't go through the virtual accessors.
+	float					x;
+	float					y;
+	float					radius;
+	long					objectClass;
+	int						cellRow;
+	int						cellCol;
+	int						block;
+	int						vertex;
 };
 
 //------------------------------------------------------------------------------
@@ -98,9 +122,9 @@ class CollisionGrid
 		
 		CollisionGridNodePtr	giantObjects;		//Collection of objects larger than maxGridRadius
 		CollisionGridNodePtr	*grid;				//Pointer to array of gridNodes layed out in space
-		CollisionGridNodePtr	nodes;				//Actual grid nodes available to layout in space.
+		CollisionGridNodePtr	nodes;				//One node per collidable, by collidable list index.
 		
-		unsigned long			nextAvailableNode;	//next node in nodes which can be used.
+		unsigned long			numNodes;			//nodes in use (size of the collidable list)
 		Stuff::Vector3D			gridOrigin;			//Center point of the grid.
 		
 		bool					gridIsGo;			//Have we already allocated everything?
@@ -113,6 +137,11 @@ class CollisionGrid
 		
 		float 					gridXCheck;
 		float 					gridYCheck;
+
+		unsigned long			numPairs;			//candidate pairs waiting in the batch
+		unsigned long			pairObj1[COLLISION_PAIR_BATCH];
+		unsigned long			pairObj2[COLLISION_PAIR_BATCH];
+		bool					pairHit[COLLISION_PAIR_BATCH];
 		
 	//Member Functions
 	//-----------------
@@ -131,7 +160,8 @@ class CollisionGrid
 			
 			maxGridRadius = 0;
 			
-			nextAvailableNode = 0;
+			numNodes = 0;
+			numPairs = 0;
 			
 			gridOrigin.Zero();
 			
@@ -152,12 +182,20 @@ class CollisionGrid
 			destroy();
 		}
 		
-		long add (unsigned long gridIndex, GameObjectPtr object);
-		long add (GameObjectPtr object);
+		void link (long cell, CollisionGridNodePtr node);
+		long add (unsigned long nodeIndex, GameObjectPtr object);
+		void remove (unsigned long nodeIndex);
+		void setNumObjects (unsigned long numObjects);
 		
-		void createGrid (void);		//Put all objects in world into grids
+		void createGrid (void);		//Check every object against its neighbors
 		
-		void checkGrid (GameObjectPtr object, CollisionGridNodePtr area);	//Check each object against grid
+		void checkGrid (CollisionGridNodePtr node, CollisionGridNodePtr area);	//Check each object against grid
+
+		bool updateNode (CollisionGridNodePtr node);	//Refresh the snapshot.  TRUE if the object moved.
+
+		void testPairs (unsigned long first);		//Find the hits among the batched pairs
+
+		void flushPairs (void);						//Run the hits through checkExtents
 };
 
 //------------------------------------------------------------------------------
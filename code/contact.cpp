@@ -40,6 +40,10 @@
 #include"soundsys.h"
 #endif
 
+#ifndef ZONEPROF_H
+#include"zoneprof.h"
+#endif
+
 #include<gameos.hpp>
 
 //***************************************************************************
@@ -52,8 +56,15 @@ float						SensorSystem::scanFrequency = 0.5;
 
 bool						TeamSensorSystem::homeTeamInContact = false;
 bool						SensorSystemManager::enemyInLOS = true;
+bool						SensorSystemManager::enemyInLOSThisCycle = false;
+long						SensorSystemManager::largestContactThisCycle = -1;
+long						SensorSystemManager::updateFrames = 0;
+long						SensorSystemManager::scanBudget = 0;
+DWORD						SensorSystemManager::scansLastFrame = 0;
+DWORD						SensorSystemManager::deferredLastFrame = 0;
 
 extern float scenarioTime;
+extern float worldUnitsPerMeter;
 extern UserHeapPtr missionHeap;
 
 #define	VISUAL_CONTACT_FLAG	0x8000
@@ -116,6 +127,7 @@ void SensorSystem::init (void) {
 	nextScanUpdate = 0.5;
 	
 	lastScanUpdate = 0.0;
+	scanDeferred = false;
 	
 	numContacts = 0;
 	id = numSensors++;
@@ -345,6 +357,7 @@ long SensorSystem::calcContactStatus (MoverPtr mover) {
 		(newContactStatus != CONTACT_NONE))
 	{
 		SensorSystemManager::enemyInLOS = true;
+		SensorSystemManager::enemyInLOSThisCycle = true;
 	}
  
 	return(newContactStatus);
@@ -527,11 +540,12 @@ void SensorSystem::updateScan (bool forceUpdate) {
 		long currentScan = -1;
 		if ((currentScan = scanBattlefield()) > -1)		//No returns size of largest contact.
 		{
-			if (owner->isMover() && 
-				(owner->getTeam() == Team::home) && 
-				(currentScan > SoundSystem::largestSensorContact))
+			if (owner->isMover() && (owner->getTeam() == Team::home))
 			{
-				SoundSystem::largestSensorContact = currentScan;
+				if (currentScan > SoundSystem::largestSensorContact)
+					SoundSystem::largestSensorContact = currentScan;
+				if (currentScan > SensorSystemManager::largestContactThisCycle)
+					SensorSystemManager::largestContactThisCycle = currentScan;
 			}
 		}
 
@@ -571,6 +585,44 @@ __inline void getLargest (long &currentLargest, MoverPtr mover, long contactStat
 		currentLargest = thisMoverSize;
 }
 
+//---------------------------------------------------------------------------
+
+long SensorSystem::getScanCandidates (long* moverIndices) {
+
+	//---------------------------------------------------------------------
+	// Anyone calcContactStatus could find is within sensor or visual range
+	// of us. Our current contacts are added too, since any that have left
+	// that range still need to be dropped. The list comes back in mover
+	// list order, the order scanBattlefield always went in...
+	float scanRange = getEffectiveRange() * worldUnitsPerMeter;
+	float visualRange = owner->getVisualRange();
+	if (visualRange > scanRange)
+		scanRange = visualRange;
+	long numCandidates = SensorManager->getMoversInRange(owner->getPosition(), scanRange * SENSOR_GRID_RANGE_SLACK, moverIndices);
+
+	for (long i = 0; i < numContacts; i++) {
+		long moverIndex = SensorManager->getMoverIndex(contacts[i] & 0x7FFF);
+		if (moverIndex > -1)
+			moverIndices[numCandidates++] = moverIndex;
+	}
+
+	for (long i = 1; i < numCandidates; i++) {
+		long moverIndex = moverIndices[i];
+		long j = i - 1;
+		while ((j > -1) && (moverIndices[j] > moverIndex)) {
+			moverIndices[j + 1] = moverIndices[j];
+			j--;
+		}
+		moverIndices[j + 1] = moverIndex;
+	}
+
+	long numUnique = 0;
+	for (long i = 0; i < numCandidates; i++)
+		if ((numUnique == 0) || (moverIndices[numUnique - 1] != moverIndices[i]))
+			moverIndices[numUnique++] = moverIndices[i];
+	return(numUnique);
+}
+
 //---------------------------------------------------------------------------
 long SensorSystem::scanBattlefield (void) 
 {
@@ -588,10 +640,11 @@ long SensorSystem::scanBattlefield (void)
 
 	long numNewContacts = 0;
 
-	long numMovers = ObjectManager->getNumMovers();
-	for (long i = 0; i < numMovers; i++) 
+	long moverIndices[MAX_MOVERS + MAX_CONTACTS_PER_SENSOR];
+	long numCandidates = getScanCandidates(moverIndices);
+	for (long i = 0; i < numCandidates; i++) 
 	{
-		MoverPtr mover = (MoverPtr)ObjectManager->getMover(i);
+		MoverPtr mover = (MoverPtr)ObjectManager->getMover(moverIndices[i]);
 		if (mover->getExists() && (mover->getTeamId() != owner->getTeamId())) 
 		{
 			long contactStatus = calcContactStatus(mover);
@@ -758,14 +811,9 @@ void TeamSensorSystem::update (void) {
 		}
 #endif
 		
-		if (Team::teams[teamId] == Team::home)
-			SoundSystem::largestSensorContact = -1;
-
-		//---------------------------------
-		// First, update actual scanning...
-		for (long i = 0; i < numSensors; i++)
-			sensors[i]->updateScan();
-
+		//-----------------------------------------------------
+		// The scans themselves are spread over several frames by
+		// SensorSystemManager::updateSensors...
 		if (Team::teams[teamId]->rosterSize < NUM_CONTACT_UPDATES_PER_PASS)
 			numContactUpdatesPerPass = Team::teams[teamId]->rosterSize;
 		else
@@ -1195,6 +1243,11 @@ long SensorSystemManager::init (bool debug) {
 
 	SensorSystem::numSensors = 0;
 
+	updateFrame = 0;
+	numDeferredSensors = 0;
+	enemyInLOSThisCycle = false;
+	largestContactThisCycle = -1;
+
 	return(NO_ERR);
 }
 
@@ -1333,16 +1386,179 @@ void SensorSystemManager::updateSensors (void)
 		teamSensors[i]->update();
 	*/
 	
-	//Let's try one team per frame update!!
-	if (Team::teams[teamToUpdate] == Team::home)
-		enemyInLOS = false;		//Resets every scan for HOME team!!!!
-		
+	buildMoverGrid();
+
+	//-------------------------------------------------------------------
+	// Every sensor scans once every numFrames frames, in the frame its id
+	// picks, so the scans are spread out evenly instead of a whole team
+	// coming due at once.  By default there is one frame per team, so a
+	// sensor scans exactly as often as when the teams took turns.
+	long numFrames = (updateFrames > 0) ? updateFrames : Team::numTeams;
+	long bucket = updateFrame % numFrames;
+	updateFrame++;
+
+	if (bucket == 0)
+	{
+		//---------------------------------------------------------------
+		// New cycle.  The home team flags now show what the last cycle
+		// saw.  Scans still raise them right away.
+		enemyInLOS = enemyInLOSThisCycle;
+		enemyInLOSThisCycle = false;
+		SoundSystem::largestSensorContact = largestContactThisCycle;
+		largestContactThisCycle = -1;
+	}
+
+	PROFILE_BEGIN("Sensor Scans");
+
+	//-----------------------------------------------------------------
+	// Sensors that didn't fit in last frame's budget go first...
+	long numScans = 0;
+	long numStillDeferred = 0;
+	for (long i = 0; i < numDeferredSensors; i++)
+	{
+		if ((scanBudget > 0) && (numScans >= scanBudget))
+			deferredSensors[numStillDeferred++] = deferredSensors[i];
+		else
+		{
+			SensorSystemPtr sensor = sensorPool[deferredSensors[i]];
+			sensor->scanDeferred = false;
+			sensor->updateScan();
+			numScans++;
+		}
+	}
+	numDeferredSensors = numStillDeferred;
+
+	for (long i = 0; i < Team::numTeams; i++)
+	{
+		TeamSensorSystemPtr teamSensor = teamSensors[i];
+		for (long j = 0; j < teamSensor->numSensors; j++)
+		{
+			SensorSystemPtr sensor = teamSensor->sensors[j];
+			if (((sensor->id % numFrames) != bucket) || sensor->scanDeferred)
+				continue;
+
+			if ((scanBudget > 0) && (numScans >= scanBudget))
+			{
+				if (numDeferredSensors < MAX_SENSORS)
+				{
+					sensor->scanDeferred = true;
+					deferredSensors[numDeferredSensors++] = sensor->id;
+				}
+			}
+			else
+			{
+				sensor->updateScan();
+				numScans++;
+			}
+		}
+	}
+
+	scansLastFrame = numScans;
+	deferredLastFrame = numDeferredSensors;
+
+	PROFILE_END("Sensor Scans");
+
+	//Contact upkeep is still one team per frame.
  	teamSensors[teamToUpdate]->update();
 	teamToUpdate++;
 	if (teamToUpdate == Team::numTeams)
 		teamToUpdate = 0;
 }
 
+//---------------------------------------------------------------------------
+
+void SensorSystemManager::buildMoverGrid (void) {
+
+	if ((gridTurn == turn) && (gridNumMovers == ObjectManager->getNumMovers()))
+		return;
+
+	gridTurn = turn;
+	gridNumMovers = ObjectManager->getNumMovers();
+	gridOriginX = -Terrain::worldUnitsMapSide / 2.0f;
+	gridOriginY = -Terrain::worldUnitsMapSide / 2.0f;
+	gridBucketSize = Terrain::worldUnitsMapSide / SENSOR_GRID_DIM;
+	if (gridBucketSize < 1.0f)
+		gridBucketSize = 1.0f;
+
+	for (long i = 0; i <= MAX_MOVERS; i++)
+		gridMoverIndex[i] = -1;
+
+	//----------------------------------------------------------------
+	// Counting sort of the mover list into the buckets. gridStart[b]
+	// ends up as the first entry of bucket b in gridMovers...
+	short moverBucket[MAX_MOVERS];
+	for (long i = 0; i <= (SENSOR_GRID_DIM * SENSOR_GRID_DIM); i++)
+		gridStart[i] = 0;
+	for (long i = 0; i < gridNumMovers; i++) {
+		MoverPtr mover = ObjectManager->getMover(i);
+		Stuff::Vector3D position = mover->getPosition();
+		long bucketC = (long)((position.x - gridOriginX) / gridBucketSize);
+		long bucketR = (long)((position.y - gridOriginY) / gridBucketSize);
+		if (bucketC < 0)
+			bucketC = 0;
+		else if (bucketC >= SENSOR_GRID_DIM)
+			bucketC = SENSOR_GRID_DIM - 1;
+		if (bucketR < 0)
+			bucketR = 0;
+		else if (bucketR >= SENSOR_GRID_DIM)
+			bucketR = SENSOR_GRID_DIM - 1;
+		moverBucket[i] = (short)(bucketR * SENSOR_GRID_DIM + bucketC);
+		gridStart[moverBucket[i] + 1]++;
+		long handle = mover->getHandle();
+		if ((handle > 0) && (handle <= MAX_MOVERS))
+			gridMoverIndex[handle] = (short)i;
+	}
+	for (long i = 1; i <= (SENSOR_GRID_DIM * SENSOR_GRID_DIM); i++)
+		gridStart[i] += gridStart[i - 1];
+
+	short nextSlot[SENSOR_GRID_DIM * SENSOR_GRID_DIM];
+	memcpy(nextSlot, gridStart, sizeof(short) * SENSOR_GRID_DIM * SENSOR_GRID_DIM);
+	for (long i = 0; i < gridNumMovers; i++)
+		gridMovers[nextSlot[moverBucket[i]]++] = (short)i;
+}
+
+//---------------------------------------------------------------------------
+
+long SensorSystemManager::getMoversInRange (Stuff::Vector3D center, float range, long* moverIndices) {
+
+	//------------------------------------------------------------------
+	// Everyone in the buckets the range box touches, in no given order.
+	// Callers still do their own distance checks...
+	buildMoverGrid();
+
+	long minC = (long)((center.x - range - gridOriginX) / gridBucketSize);
+	long maxC = (long)((center.x + range - gridOriginX) / gridBucketSize);
+	long minR = (long)((center.y - range - gridOriginY) / gridBucketSize);
+	long maxR = (long)((center.y + range - gridOriginY) / gridBucketSize);
+	if (minC < 0)
+		minC = 0;
+	if (maxC >= SENSOR_GRID_DIM)
+		maxC = SENSOR_GRID_DIM - 1;
+	if (minR < 0)
+		minR = 0;
+	if (maxR >= SENSOR_GRID_DIM)
+		maxR = SENSOR_GRID_DIM - 1;
+
+	long numFound = 0;
+	for (long r = minR; r <= maxR; r++)
+		for (long c = minC; c <= maxC; c++) {
+			long bucket = r * SENSOR_GRID_DIM + c;
+			for (long i = gridStart[bucket]; i < gridStart[bucket + 1]; i++)
+				moverIndices[numFound++] = gridMovers[i];
+		}
+	return(numFound);
+}
+
+//---------------------------------------------------------------------------
+
+long SensorSystemManager::getMoverIndex (long handle) {
+
+	buildMoverGrid();
+	if ((handle < 1) || (handle > MAX_MOVERS))
+		return(-1);
+	return(gridMoverIndex[handle]);
+}
+
 //---------------------------------------------------------------------------
 #if 0
 void SensorSystemManager::updateTeamContactLists (void) {
@@ -148,6 +148,7 @@ class SensorSystem {
 
 		float					nextScanUpdate;
 		float					lastScanUpdate;
+		bool					scanDeferred;			//due, but waiting on the per frame scan budget
 
 		unsigned short			contacts[MAX_CONTACTS_PER_SENSOR];
 		long					numContacts;
@@ -237,6 +238,8 @@ class SensorSystem {
 
 		void clearContacts (void);
 
+		long getScanCandidates (long* moverIndices);
+
 		long scanBattlefield (void);
 
 		long scanMover (Mover* mover);
@@ -343,12 +346,32 @@ class TeamSensorSystem {
 
 //---------------------------------------------------------------------------
 
+//---------------------------------------------------------------------------
+// Movers are bucketed by world position once a turn, so a sensor scan only
+// looks at the movers close enough to be sensed or seen. The slack covers
+// the approximate distances used by lineOfSight...
+#define	SENSOR_GRID_DIM				32
+#define	SENSOR_GRID_RANGE_SLACK		1.125f
+
 class SensorSystemManager {
 
 	//-------------
 	// Data Members
 	
 	protected:
+
+		long					gridTurn;				//turn the mover grid was built
+		long					gridNumMovers;
+		float					gridOriginX;
+		float					gridOriginY;
+		float					gridBucketSize;			//world units per bucket side
+		short					gridStart[SENSOR_GRID_DIM * SENSOR_GRID_DIM + 1];
+		short					gridMovers[MAX_MOVERS];	//mover list indices, by bucket
+		short					gridMoverIndex[MAX_MOVERS + 1];	//mover list index, by handle
+
+		long					updateFrame;			//picks which sensors scan this frame
+		short					deferredSensors[MAX_SENSORS];	//over budget last frame, scan first
+		long					numDeferredSensors;
 		
 		long					freeSensors;			//How many sensors are currently free
 		SensorSystemPtr*		sensorPool;				//Pool of ALL sensors
@@ -361,6 +384,13 @@ class SensorSystemManager {
 		
 	public:
 		static bool				enemyInLOS;				//Flag is set every frame that I can see someone on sensors or visually.
+		static bool				enemyInLOSThisCycle;
+		static long				largestContactThisCycle;
+
+		static long				updateFrames;			//every sensor scans once in this many frames (0 = one frame per team)
+		static long				scanBudget;				//most sensor scans per frame (0 = no limit)
+		static DWORD			scansLastFrame;
+		static DWORD			deferredLastFrame;
 
 	//-----------------
 	// Member Functions
@@ -388,6 +418,10 @@ class SensorSystemManager {
 				teamSensors[i] = NULL;
 			numEcms = 0;
 			teamToUpdate = 0;
+			gridTurn = -1;
+			gridNumMovers = 0;
+			updateFrame = 0;
+			numDeferredSensors = 0;
 		}
 		
 		long init (bool debug);
@@ -422,6 +456,12 @@ class SensorSystemManager {
 
 		void updateSensors (void);
 
+		void buildMoverGrid (void);
+
+		long getMoversInRange (Stuff::Vector3D center, float range, long* moverIndices);
+
+		long getMoverIndex (long handle);
+
 		//void updateTeamContactLists (void);
 
 		void update (void);
@@ -37,6 +37,7 @@ controlGui.cpp			: Implementation of the controlGui component.
 #include"malloc.h"
 
 #include"chatwindow.h"
+#include"replay.h"
 
 
 
@@ -1683,7 +1684,7 @@ void ControlGui::doStop()
 			if (MPlayer && !MPlayer->isServer())
 				MPlayer->sendPlayerOrder(&tacOrder, false, 1, &pMover);
 			else
-				pMover->handleTacticalOrder(tacOrder);
+				REPLAY_playerOrder(pMover, &tacOrder);
 		}
 	}
 
@@ -2954,7 +2955,7 @@ void	ControlGui::toggleHoldPosition()
 					else
 						pMover->getPilot()->getCurTacOrder()->attackParams.pursue = true;
 					pMover->getPilot()->getCurTacOrder()->pack(NULL, NULL);
-					pMover->handleTacticalOrder(*pMover->getPilot()->getCurTacOrder());
+					REPLAY_playerOrder(pMover, pMover->getPilot()->getCurTacOrder());
 				}
 			}
 		}
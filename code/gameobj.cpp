@@ -72,6 +72,14 @@
 #include"comndr.h"
 #endif
 
+#ifndef ZONEPROF_H
+#include"zoneprof.h"
+#endif
+
+#ifndef OBJECTIVE_H
+#include"objective.h"
+#endif
+
 //---------------------------------------------------------------------------
 extern GameLog* CombatLog;
 
@@ -86,6 +94,8 @@ extern char* ExceptionGameMsg;
 char ChunkDebugMsg[5120];
 
 unsigned long GameObject::spanMask = 0;
+unsigned long GameObject::statusChanges = 0;
+unsigned long GameObject::positionChanges = 0;
 float GameObject::blockCaptureRange = 0.0;
 bool GameObject::initialize = false;
 
@@ -1738,6 +1748,12 @@ Stuff::Vector3D GameObject::relativePosition (float angle, float distance, unsig
 
 void GameObject::setPosition (const Stuff::Vector3D& newPosition, bool calcPositions) {
 
+	//---------------------------------------------------------------
+	// Objectives only see movers, and only which side of an area's
+	// edge they're on...
+	if (isMover() && CAreaObjectiveCondition::EdgeCrossed(position, newPosition))
+		positionChanges++;
+
 	position = newPosition;
 
 	if (calcPositions) {
@@ -1839,27 +1855,10 @@ bool GameObject::lineOfSight (Stuff::Vector3D point, bool checkVisibleBits) {
 
 //---------------------------------------------------------------------------
 
-#ifdef LAB_ONLY
-extern __int64 MCTimeLOSUpdate;
-#endif
+float GameObject::getVisualRange (void) {
 
-inline bool GameObject::lineOfSight (GameObjectPtr target, float startExtRad, bool checkVisibleBits) 
-{
-	__int64 timeStart = GetCycles(); 
-
-	//If we call this without a target, we have no LOS!!
-	// Keeps it from crashing, too.
-	// Not sure where all of the calls Glenn makes to this are, but I'm looking!
-	if (!target) {
-#ifdef LAB_ONLY
-		MCTimeLOSUpdate += (GetCycles() - timeStart);
-#endif
-		return false;
-	}
-
-	Stuff::Vector3D distance;
-	distance.Subtract(target->getPosition(),getPosition());
-	float dist = distance.GetApproximateLength();
+	//----------------------------------------------------------------
+	// How far, in world units, lineOfSight will look for a target...
 
 	//Figure out altitude above minimum terrain altitude and look up in table.
 	float baseElevation = MapData::waterDepth;
@@ -1890,11 +1889,28 @@ inline bool GameObject::lineOfSight (GameObjectPtr target, float startExtRad, bo
 		radius *= mover->getLOSFactor();
 	}
 
-	if (dist > (radius * 25.0f * worldUnitsPerMeter))
+	return(radius * 25.0f * worldUnitsPerMeter);
+}
+
+//---------------------------------------------------------------------------
+
+inline bool GameObject::lineOfSight (GameObjectPtr target, float startExtRad, bool checkVisibleBits) 
+{
+	PROFILE_ZONE_FINE("LOS Update");
+
+	//If we call this without a target, we have no LOS!!
+	// Keeps it from crashing, too.
+	// Not sure where all of the calls Glenn makes to this are, but I'm looking!
+	if (!target) {
+		return false;
+	}
+
+	Stuff::Vector3D distance;
+	distance.Subtract(target->getPosition(),getPosition());
+	float dist = distance.GetApproximateLength();
+
+	if (dist > getVisualRange())
 	{
-#ifdef LAB_ONLY
-		MCTimeLOSUpdate += (GetCycles() - timeStart);
-#endif
 		return false;
 	}
 		
@@ -1905,54 +1921,32 @@ inline bool GameObject::lineOfSight (GameObjectPtr target, float startExtRad, bo
 	{
 		if (isMover() && ObjectManager->useMoverLineOfSightTable) 
 		{
-			long index = (handle * ObjectManager->maxMovers) + target->handle;
-			char losStatus = ObjectManager->moverLineOfSightTable[index];
+			long losStatus = ObjectManager->getMoverLOS(handle, target->handle);
 			if (losStatus == -1) 
 			{
-				bool los = Team::lineOfSight(getLOSPosition(), target->getLOSPosition(), getTeamId(), target->getAppearRadius(), startExtRad, checkVisibleBits);
-				if (los) 
-				{
-					ObjectManager->moverLineOfSightTable[index] = 1;
-					//Inverse is NOT always true!!!!
-					// I can demonstrate a case!!
-					// -fs
-				   // ObjectManager->moverLineOfSightTable[(target->handle * ObjectManager->maxMovers) + handle] = 1;
-				}
-				else 
-				{
-					ObjectManager->moverLineOfSightTable[index] = 0;
-					// ObjectManager->moverLineOfSightTable[(target->handle * ObjectManager->maxMovers) + handle] = 0;
-				}
+				//Inverse is NOT always true!!!!
+				// I can demonstrate a case!!
+				// -fs
+				losStatus = Team::lineOfSight(getLOSPosition(), target->getLOSPosition(), getTeamId(), target->getAppearRadius(), startExtRad, checkVisibleBits);
+				ObjectManager->setMoverLOS(handle, target->handle, (losStatus != 0));
 			}
 			
-			if (ObjectManager->moverLineOfSightTable[index])
+			if (losStatus)
 			{
-#ifdef LAB_ONLY
-			MCTimeLOSUpdate += (GetCycles() - timeStart);
-#endif
 				return true;
 			}
 			else
 			{
-#ifdef LAB_ONLY
-			MCTimeLOSUpdate += (GetCycles() - timeStart);
-#endif
 				return false;
 			}
 		}
 		
 		if (Team::lineOfSight(getLOSPosition(), target->getLOSPosition(), getTeamId(), target->getAppearRadius(), startExtRad, checkVisibleBits))
 		{
-#ifdef LAB_ONLY
-		MCTimeLOSUpdate += (GetCycles() - timeStart);
-#endif
 			return(true);
 		}
 		else
 		{
-#ifdef LAB_ONLY
-		MCTimeLOSUpdate += (GetCycles() - timeStart);
-#endif
 			return(false);
 		}
 	}
@@ -1973,17 +1967,11 @@ inline bool GameObject::lineOfSight (GameObjectPtr target, float startExtRad, bo
 		
 			if (Team::lineOfSight(getLOSPosition(), target->getLOSPosition(), getTeamId(), target->getAppearRadius(), startExtRad, checkVisibleBits)) 
 			{
-#ifdef LAB_ONLY
-				MCTimeLOSUpdate += (GetCycles() - timeStart);
-#endif
 				return(true);
 			}
 //		}
 //	}
 
-#ifdef LAB_ONLY
-	MCTimeLOSUpdate += (GetCycles() - timeStart);
-#endif
 	return(false);
 }
 
@@ -346,6 +346,9 @@ class GameObject {
 
 	public:
 
+		static unsigned long		statusChanges;		//Bumped when status, team, commander or pilot of a mover changes
+		static unsigned long		positionChanges;	//Bumped when a mover crosses the edge of an objective area
+
 		void* operator new (size_t ourSize);
 
 		void operator delete (void *us);
@@ -589,11 +592,15 @@ class GameObject {
 		//NEVER call this with forceStatus UNLESS you are recovering a mech!!!
 		void setStatus (long newStatus, bool forceStatus = false) 
 		{
+			long oldStatus = status;
 			if (((status != OBJECT_STATUS_DESTROYED) && (status != OBJECT_STATUS_DISABLED)) || forceStatus)
 				status = newStatus;
 
 			if (newStatus == OBJECT_STATUS_DESTROYED)
 				status = newStatus;
+
+			if ((status != oldStatus) && isMover())
+				statusChanges++;
 		}
 
 		virtual bool isCrippled (void) {
@@ -667,6 +674,8 @@ class GameObject {
 		virtual bool lineOfSight (Stuff::Vector3D point, bool checkVisibleBits = true);
 
 		virtual bool lineOfSight (GameObjectPtr target, float startExtRad = 0.0f, bool checkVisibleBits = true);
+
+		float getVisualRange (void);
 	
 		virtual float relFacingTo (Stuff::Vector3D goal, long bodyLocation = -1);
 
@@ -72,6 +72,7 @@ float GroupMoveOffsets[10][2] = {
 */
 extern char OverlayIsBridge[NUM_OVERLAY_TYPES];
 extern PriorityQueuePtr	openList;
+extern GlobalMapPtr GlobalMoveMap[3];
 GoalMapNode* MoverGroup::goalMap = NULL;
 
 //***************************************************************************
@@ -522,6 +523,18 @@ long MoverGroup::calcMoveGoals (Stuff::Vector3D goal, long numMovers, Stuff::Vec
 		}
 	}		
 
+	//---------------------------------------------------------------
+	// Everyone's headed the same way, so have the global maps share a
+	// flow field to the goal areas for the next few seconds...
+	if (numGoalsFound > 1)
+		for (long level = 0; level < 3; level++)
+			if (GlobalMoveMap[level] && GlobalMoveMap[level]->areaMap)
+				for (long i = 0; i < numGoalsFound; i++) {
+					int cellRow, cellCol;
+					land->worldToCell(goalList[i], cellRow, cellCol);
+					GlobalMoveMap[level]->requestFlowField(GlobalMoveMap[level]->calcArea(cellRow, cellCol));
+				}
+
 	return(numGoalsFound);
 }
 
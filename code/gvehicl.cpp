@@ -111,6 +111,10 @@
 #include"comndr.h"
 #endif
 
+#ifndef ZONEPROF_H
+#include"zoneprof.h"
+#endif
+
 #include "../resource.h"
 
 extern unsigned long		NextIdNumber;
@@ -914,6 +918,7 @@ void GroundVehicle::init (bool create, ObjectTypePtr objType) {
 
 	canRefit = (vehicleT->refitPoints > 0);
 	canRecover = (vehicleT->recoverPoints > 0);
+	statusChanges++;
 	captureable = captureable || (vehicleT->resourcePoints > 0);
 	if (captureable)
 		setFlag(OBJECT_FLAG_CAPTURABLE,true);
@@ -1034,6 +1039,7 @@ long GroundVehicle::init (FitIniFile* vehicleFile)
 	if (result != NO_ERR)
 		return(result);
 	status = cStatus;
+	statusChanges++;
 
 	result = vehicleFile->readIdInt("BattleRating", battleRating);
 	if (result != NO_ERR)
@@ -2085,7 +2091,7 @@ void GroundVehicle::setNextMovePath (char& newThrottleSetting) {
 	if (haveWayPoint) {
 		pilot->setMoveGoal(MOVEGOAL_LOCATION, &nextWayPoint);
 		TacticalOrderPtr curTacOrder = pilot->getCurTacOrder();
-		pilot->requestMovePath(curTacOrder->selectionIndex, MOVEPARAM_FACE_TARGET + MOVEPARAM_FOLLOW_ROADS, 0);
+		pilot->requestMovePath(curTacOrder->selectionIndex, MOVEPARAM_FACE_TARGET + MOVEPARAM_FOLLOW_ROADS);
 		}
 	else {
 		pilot->clearMoveOrders();
@@ -3396,10 +3402,6 @@ long GroundVehicle::update (void)
 	}
 	else if (getAwake() && !isDisabled())
 	{
-		#ifdef MC_PROFILE
-		QueryPerformanceCounter(startCk);
-		#endif
-
 		//-----------------------------------------------------
 		// Not destroyed nor disabled yet, so update our LOS...
 		GroundVehicleTypePtr vehicleType = (GroundVehicleTypePtr)ObjectManager->getObjectType(typeHandle);ObjectManager->getObjectType(typeHandle);
@@ -3428,26 +3430,18 @@ long GroundVehicle::update (void)
 		}
 	}
 	
+	PROFILE_BEGIN_FINE("Mover Control");
 	((ObjectAppearance*)appearance)->pilotNameID = IDS_NOPILOT;
 	control.update(this);
+	PROFILE_END("Mover Control");
 	
-	#ifdef MC_PROFILE
-	QueryPerformanceCounter(endCk);
-	srCtrlUpd += (endCk.LowPart - startCk.LowPart);
-	#endif
-
-	#ifdef MC_PROFILE
-	QueryPerformanceCounter(startCk);
-	#endif
+	PROFILE_BEGIN_FINE("Mover Dynamics");
 
 	bool emergencyStop = false;
 	if (!isDisabled())
 		emergencyStop = crashAvoidanceSystem();
 
-	#ifdef MC_PROFILE
-	QueryPerformanceCounter(endCk);
-	srDyneUpd += (endCk.LowPart - startCk.LowPart);
-	#endif
+	PROFILE_END("Mover Dynamics");
 
 	//--------------------------------------------------------------------
 	// At this point, the other updates have completed, its time to
@@ -3461,9 +3455,7 @@ long GroundVehicle::update (void)
 	// the terrain.  So, whenever you want a position derived from
 	// a velocity, multiply velocity by worldUnitsPerMeter.
 
-	#ifdef MC_PROFILE
-	QueryPerformanceCounter(startCk);
-	#endif
+	PROFILE_BEGIN_FINE("Mover Appearance");
 
 	float velMag = 0.0;
 	if (!emergencyStop)
@@ -3486,11 +3478,9 @@ long GroundVehicle::update (void)
 		pilot->orderMoveToPoint (false, true, ORDER_ORIGIN_PLAYER, location, -1, TACORDER_PARAM_RUN);
 	}
 
-	#ifdef MC_PROFILE
-	QueryPerformanceCounter(endCk);
-	srApprUpd += (endCk.LowPart - startCk.LowPart);
-	QueryPerformanceCounter(startCk);
-	#endif
+	PROFILE_END("Mover Appearance");
+
+	PROFILE_BEGIN_FINE("Mover Position");
 
 	if (teleportPosition.x > -999990.0) {
 		setPosition(teleportPosition);
@@ -3830,11 +3820,7 @@ long GroundVehicle::update (void)
 	long blockNumber = float2long(xCoord) + (float2long(yCoord) * Terrain::blocksMapSide);
 	addMoverToList(blockNumber);
 
-		#ifdef MC_PROFILE
-		QueryPerformanceCounter(endCk);
-
-		srObjtUpd += (endCk.LowPart - startCk.LowPart);
-		#endif
+	PROFILE_END("Mover Position");
 
 	if (getDebugFlag(OBJECT_DFLAG_DISABLE))
 		disable(DEBUGGER_DEATH);
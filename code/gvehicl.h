@@ -539,6 +539,7 @@ class GroundVehicle : public Mover {
 		{
             printf("setOnGUI\n");
 			isOnGui = onGui;
+			statusChanges++;
 		}
 };
 
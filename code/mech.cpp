@@ -126,6 +126,10 @@
 #include"logisticsdata.h"
 #endif
 
+#ifndef ZONEPROF_H
+#include"zoneprof.h"
+#endif
+
 #include "../resource.h"
 
 //--------
@@ -2756,6 +2760,7 @@ long BattleMech::init (FitIniFile* mechFile) {
 	//	return(result);
 
 	status = cStatus;
+	statusChanges++;
 
 	result = mechFile->readIdBoolean("NotMineYet",notMineYet);
 	if (result != NO_ERR)
@@ -4589,7 +4594,7 @@ void BattleMech::setNextMovePath (char& newThrottleSetting, long& newGestureStat
 	if (haveWayPoint) {
 		pilot->setMoveGoal(MOVEGOAL_LOCATION, &nextWayPoint);
 		TacticalOrderPtr curTacOrder = pilot->getCurTacOrder();
-		pilot->requestMovePath(curTacOrder->selectionIndex, MOVEPARAM_FACE_TARGET/*+MOVEPARAM_INIT*/, 1);
+		pilot->requestMovePath(curTacOrder->selectionIndex, MOVEPARAM_FACE_TARGET/*+MOVEPARAM_INIT*/);
 		}
 	else {
 		//-----------------------------------------------------------
@@ -5811,9 +5816,7 @@ long BattleMech::update (void)
 
 	if (!isDestroyed() && !isDisabled())
 	{
-		#ifdef MC_PROFILE
-		QueryPerformanceCounter(startCk);
-		#endif
+		PROFILE_BEGIN_FINE("Mover Control");
 
 		//Be damned sure our legs are marked correctly!!
 		calcLegStatus();
@@ -5868,14 +5871,9 @@ long BattleMech::update (void)
 			shutDownThisFrame = false;
 		}
 		
-		#ifdef MC_PROFILE
-		QueryPerformanceCounter(endCk);
-		srCtrlUpd += (endCk.LowPart - startCk.LowPart);
-		#endif
+		PROFILE_END("Mover Control");
 
-		#ifdef MC_PROFILE
-		QueryPerformanceCounter(startCk);
-		#endif
+		PROFILE_BEGIN_FINE("Mover Dynamics");
 
 		//updateDynamics();
 
@@ -5893,11 +5891,7 @@ long BattleMech::update (void)
 				ramTarget->updatePathLock(true);
 		}
 
-		#ifdef MC_PROFILE
-		QueryPerformanceCounter(endCk);
-
-		srDyneUpd += (endCk.LowPart - startCk.LowPart);
-		#endif
+		PROFILE_END("Mover Dynamics");
 
 		//--------------------------------------------------------------------
 		// At this point, the other updates have completed, its time to
@@ -5911,9 +5905,7 @@ long BattleMech::update (void)
 		// the terrain.  So, whenever you want a position derived from
 		// a velocity, multiply velocity by worldUnitsPerMeter.
 
-		#ifdef MC_PROFILE
-		QueryPerformanceCounter(startCk);
-		#endif
+		PROFILE_BEGIN_FINE("Mover Position");
 
 		if (teleportPosition.x > -999990.0) {
 			setPosition(teleportPosition);
@@ -6009,15 +6001,9 @@ long BattleMech::update (void)
 
 		//float inverseAngle = 180.0;
 
-		#ifdef MC_PROFILE
-		QueryPerformanceCounter(endCk);
-
-		srObjtUpd += (endCk.LowPart - startCk.LowPart);
-		#endif
+		PROFILE_END("Mover Position");
 		
-		#ifdef MC_PROFILE
-		QueryPerformanceCounter(startCk);
-		#endif
+		PROFILE_BEGIN_FINE("Mover Appearance");
 
 		bool inView = appearance->recalcBounds();
 		if (inView)
@@ -6043,17 +6029,7 @@ long BattleMech::update (void)
 				setTangible(true);
 		}
 
-		#ifdef MC_PROFILE
-		QueryPerformanceCounter(endCk);
-
-		srApprUpd += (endCk.LowPart - startCk.LowPart);
-		#endif
-
-		#ifdef MC_PROFILE
-		QueryPerformanceCounter(endCk);
-
-		srObjtUpd += (endCk.LowPart - startCk.LowPart);
-		#endif
+		PROFILE_END("Mover Appearance");
 		
 		if (getDebugFlag(OBJECT_DFLAG_DISABLE))
 			disable(DEBUGGER_DEATH);
@@ -64,6 +64,14 @@
 #include"prefs.h"
 #endif
 
+#ifndef REPLAY_H
+#include"replay.h"
+#endif
+
+#ifndef ZONEPROF_H
+#include"zoneprof.h"
+#endif
+
 extern CPrefs prefs;
 
 #include "../resource.h"
@@ -161,6 +169,10 @@ enum ProcType { CPU_UNKNOWN, CPU_PENTIUM, CPU_MMX, CPU_KATMAI };
 ProcType Processor = CPU_PENTIUM;		//Needs to be set when GameOS supports ProcessorID -- MECHCMDR2
 extern float frameRate;
 void EnterWindowMode();
+void HeadlessReport (long result);
+#ifdef ZONEPROF
+void ZoneProfDump (bool summary);
+#endif
 
 extern long MaxMoveGoalChecks;
 extern bool useSound;
@@ -170,8 +182,18 @@ bool ShowMovers = false;
 bool EnemiesGoalPlan = false;
 bool inViewMode = false;
 extern bool CullPathAreas;
+extern bool JumpPointSearch;
+extern bool IncrementalReplan;
+extern float FixedStepRate;
+extern long MaxTicksPerFrame;
+extern bool InterpolateTicks;
 unsigned long viewObject = 0x0;
 char missionName[1024];
+char replayFileName[1024] = {0};
+char tickTimesFileName[1024] = {0};
+char profileFileName[1024] = {0};
+bool replayRecord = false;
+long checkLOSRays = 0;
 
 extern char FileMissingString[];
 extern char CDMissingString[];
@@ -247,11 +269,6 @@ Stuff::Vector3D pos[36] =
 #ifdef LAB_ONLY
 long currentLineElement = 0;
 LineElement *debugLines[10000];
-
-#define ProfileTime(x,y)	x=GetCycles();y;x=GetCycles()-x;
-extern __int64 MCTimeMultiplayerUpdate;
-#else
-#define ProfileTime(x,y)	y;
 #endif
 
 #define	MAX_KILL_AT_START	100
@@ -675,6 +692,8 @@ DWORD endTime;
 //---------------------------------------------------------------------------
 void __stdcall UpdateRenderers()
 {
+	PROFILE_ZONE("Render");
+
 	if (!SnifferMode)
 	{
 		hasGuardBand = true;
@@ -732,6 +751,7 @@ void __stdcall UpdateRenderers()
 		userInput->render();
 
 		DEBUGWINS_render();
+		gos_DrawStatistics(GameDebugWindow::font);
 
 		#ifdef LAB_ONLY
 		if (currentLineElement)
@@ -1165,6 +1185,14 @@ void __stdcall InitializeGameEngine()
 				useMusic = FALSE;
 			}
 
+			//-----------------------------------------------
+			// No audio device when headless, don't load any.
+			if (Environment.headless)
+			{
+				useSound = FALSE;
+				useMusic = FALSE;
+			}
+
 			result = systemFile->seekBlock("CameraSettings");
 			if (result == NO_ERR)
 			{
@@ -1409,6 +1437,26 @@ void __stdcall InitializeGameEngine()
 				if (result != NO_ERR)
 					useRealLOS = true;
 					
+				result = prefsFile->readIdBoolean("JumpPointSearch",JumpPointSearch);
+				if (result != NO_ERR)
+					JumpPointSearch = true;
+
+				result = prefsFile->readIdBoolean("IncrementalReplan",IncrementalReplan);
+				if (result != NO_ERR)
+					IncrementalReplan = true;
+
+				result = prefsFile->readIdFloat("FixedStepRate",FixedStepRate);
+				if (result != NO_ERR)
+					FixedStepRate = 0.0f;
+
+				result = prefsFile->readIdLong("MaxTicksPerFrame",MaxTicksPerFrame);
+				if (result != NO_ERR)
+					MaxTicksPerFrame = 4;
+
+				result = prefsFile->readIdBoolean("InterpolateTicks",InterpolateTicks);
+				if (result != NO_ERR)
+					InterpolateTicks = true;
+					
 				result = prefsFile->readIdLong("GameVisibleVertices",GameVisibleVertices);
 				if (result != NO_ERR)
 					GameVisibleVertices = 30;
@@ -1663,14 +1711,54 @@ void __stdcall InitializeGameEngine()
 		movieSoundUseDirectSound(0);
 #endif
 
+		if (replayFileName[0])
+		{
+			if (REPLAY_init(replayFileName, replayRecord, tickTimesFileName[0] ? tickTimesFileName : NULL) != NO_ERR)
+				STOP(("Cannot use replay log %s", replayFileName));
+
+			//---------------------------------------------------
+			// A replay knows which mission it came from.  A
+			// recording is only any good started from the
+			// command line, since that's how it will be played.
+			if (!replayRecord)
+			{
+				strcpy(missionName, REPLAY_getMissionName());
+				justStartMission = true;
+				inViewMode = false;
+			}
+			else if (!justStartMission)
+				STOP(("Recording needs a mission to play: -mission <name>"));
+		}
+
+		if (Environment.headless && !justStartMission)
+			STOP(("Headless runs need a mission to play: -mission <name>"));
+
+	#ifdef ZONEPROF
+		//-------------------------------------------------
+		// Headless runs are for timing, so always profile.
+		if (Environment.headless || profileFileName[0])
+			ZoneProf_enable(true);
+	#endif
+
 		if (justStartMission)
 		{
+			REPLAY_beginMission(missionName);
 			logistics->setLogisticsState(log_STARTMISSIONFROMCMDLINE);
 			char commandersToLoad[MAX_MC_PLAYERS][3] = {{0, 0, 0}, {1, 1, 1}, {2, 0, 2}, {3, 3, 3}, {4, 4, 4}, {5, 5, 5}, {6, 6, 6}, {7, 7, 7}};
 			mission->init(missionName, MISSION_LOAD_SP_QUICKSTART, 0, NULL, commandersToLoad, 2);
 			eye->activate();
 			eye->update();
 			mission->start();
+
+			if (checkLOSRays > 0)
+			{
+				//---------------------------------------------------
+				// Only here to check the LOS shortcuts on this map
+				// against the full march, not to play it.
+				long numMismatches = Team::checkLOSHeightBound(checkLOSRays);
+				printf("LOSCHECK: %s %ld of %ld rays differ\n", missionName, numMismatches, checkLOSRays);
+				quitGame = true;
+			}
 		}
 		else
 		{
@@ -1801,6 +1889,16 @@ void __stdcall TerminateGameEngine()
 	if (!gameStarted)
 		return;
 
+	//---------------------------------------------------------
+	// GameOS ran out of ticks before the mission was decided.
+	if (Environment.headless)
+		HeadlessReport(mis_PLAYING);
+
+#ifdef ZONEPROF
+	if (ZoneProf_isEnabled() && profileFileName[0])
+		ZoneProfDump(!Environment.headless);
+#endif
+
 	if (!SnifferMode)
 	{
 		//--------------------------------------------------
@@ -2012,6 +2110,75 @@ float frameNum = 0.0f;
 bool enoughTime = true;
 long enoughCount = 0;
 
+//---------------------------------------------------------------------------
+//
+// Headless runs (see Environment.headless) have nobody to show the results
+// screen to.  Instead the outcome, and the profiler's summary of the whole
+// run, are printed once the mission is decided or GameOS stops.
+//
+bool headlessReported = false;
+long headlessFrames = 0;
+
+#ifdef ZONEPROF
+//---------------------------------------------------------------------------
+//
+// The profiler is switched on with -profile <file> or Ctrl+Alt+Shift+K.
+// Switching it off again writes out what it caught.
+//
+bool zoneProfWasEnabled = false;
+
+void ZoneProfDump (bool summary)
+{
+	const char* fileName = profileFileName[0] ? profileFileName : "zoneprof.json";
+	if (ZoneProf_writeTrace(fileName))
+		printf("PROFILE: %ld frames written to %s\n", ZoneProf_getNumFrames(), fileName);
+	else
+		printf("PROFILE: Cannot write %s\n", fileName);
+
+	if (summary)
+		ZoneProf_printSummary(stdout);
+}
+
+//---------------------------------------------------------------------------
+void ZoneProfFrame (void)
+{
+	ZoneProf_frame();
+
+	bool enabled = ZoneProf_isEnabled();
+	if (zoneProfWasEnabled && !enabled)
+		ZoneProfDump(true);
+
+	zoneProfWasEnabled = enabled;
+}
+#endif
+
+//---------------------------------------------------------------------------
+void HeadlessReport (long result)
+{
+	if (headlessReported)
+		return;
+
+	headlessReported = true;
+
+	const char* outcome = "ended by script";
+	switch (result)
+	{
+		case mis_PLAYING:				outcome = "still playing";	break;
+		case mis_PLAYER_LOST_BIG:		outcome = "lost big";		break;
+		case mis_PLAYER_LOST_SMALL:		outcome = "lost small";		break;
+		case mis_PLAYER_DRAW:			outcome = "draw";			break;
+		case mis_PLAYER_WIN_SMALL:		outcome = "won small";		break;
+		case mis_PLAYER_WIN_BIG:		outcome = "won big";		break;
+	}
+
+	printf("HEADLESS: %s %s after %.1f s of game time in %ld frames\n", missionName, outcome, scenarioTime, headlessFrames);
+
+#ifdef ZONEPROF
+	if (ZoneProf_isEnabled())
+		ZoneProf_printSummary(stdout);
+#endif
+}
+
 //---------------------------------------------------------------------------
 //
 // No multi-thread now!
@@ -2019,6 +2186,12 @@ long enoughCount = 0;
 bool DoneSniffing = false;
 void __stdcall DoGameLogic()
 {
+#ifdef ZONEPROF
+	ZoneProfFrame();
+#endif
+
+	PROFILE_ZONE("Game Logic");
+
 	if (!SnifferMode)
 	{
 	#ifdef LAB_ONLY		//Used for debugging LOS
@@ -2026,7 +2199,7 @@ void __stdcall DoGameLogic()
 	#endif
 	
 		if (MPlayer) {
-			ProfileTime(MCTimeMultiplayerUpdate,MPlayer->update());
+			PROFILE_CALL("Multiplayer Update", MPlayer->update());
 			if (MPlayer->waitingToStartMission) 
 			{
 				if (MPlayer->startMission)
@@ -2119,7 +2292,20 @@ void __stdcall DoGameLogic()
 			if (mission && (!optionsScreenWrapper || optionsScreenWrapper->isDone() ) )
 			{
 				long result = mission->update();
-				if (result == 9999) {
+				if (Environment.headless)
+					headlessFrames++;
+
+				if (Environment.headless && ((result != mis_PLAYING) || REPLAY_finished()))
+				{
+					//---------------------------------------------
+					// Nobody is watching the results screen.  Say
+					// how it went and get out.  Replays stop where
+					// the recording did, decided or not.
+					HeadlessReport(result);
+					mission->destroy();
+					quitGame = true;
+				}
+				else if (result == 9999) {
 					mission->destroy();
 					//delete mission;
 					//mission = NULL;
@@ -2508,6 +2694,35 @@ void ParseCommandLine(const char *command_line)
 		{
 			SnifferMode = true;
 		}
+		else if (S_stricmp(argv[i], "-record") == 0) {
+			i++;
+			if (i < n_args) {
+				strncpy(replayFileName, argv[i], 1023);
+				replayRecord = true;
+			}
+		}
+		else if (S_stricmp(argv[i], "-replay") == 0) {
+			i++;
+			if (i < n_args) {
+				strncpy(replayFileName, argv[i], 1023);
+				replayRecord = false;
+			}
+		}
+		else if (S_stricmp(argv[i], "-ticktimes") == 0) {
+			i++;
+			if (i < n_args)
+				strncpy(tickTimesFileName, argv[i], 1023);
+		}
+		else if (S_stricmp(argv[i], "-profile") == 0) {
+			i++;
+			if (i < n_args)
+				strncpy(profileFileName, argv[i], 1023);
+		}
+		else if (S_stricmp(argv[i], "-checklos") == 0) {
+			i++;
+			if (i < n_args)
+				checkLOSRays = textToLong(argv[i]);
+		}
 		else if (S_stricmp(argv[i], "-braindead") == 0) {
 			i++;
 			if (i < n_args) {
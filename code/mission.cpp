@@ -114,6 +114,14 @@
 #include"prefs.h"
 #endif
 
+#ifndef REPLAY_H
+#include"replay.h"
+#endif
+
+#ifndef ZONEPROF_H
+#include"zoneprof.h"
+#endif
+
 #include "../resource.h"
 
 #include<gameos.hpp>
@@ -219,82 +227,8 @@ bool Mission::terminationCounterStarted = false;
 double Mission::missionTerminationTime = -1.0;
 unsigned long Mission::terminationResult = mis_PLAYING;
 
-extern float OneOverProcessorSpeed;
 extern PriorityQueuePtr	openList;
 
-//
-// Macro used for statistic timing of main functions
-//
-#ifdef LAB_ONLY
-#define ProfileTime(x,y)	x=GetCycles();y;x=GetCycles()-x;
-extern __int64 MCTimeTerrainUpdate 	;
-extern __int64 MCTimeCameraUpdate 		;
-extern __int64 MCTimeWeatherUpdate 	;
-extern __int64 MCTimePathManagerUpdate ; 
-extern __int64 MCTimeRunBrainUpdate ;
-extern __int64 MCTimePath1Update ;
-extern __int64 MCTimePath2Update ;
-extern __int64 MCTimePath3Update ;
-extern __int64 MCTimePath4Update ;
-extern __int64 MCTimePath5Update ;
-extern __int64 MCTimeCalcGoal1Update ;
-extern __int64 MCTimeCalcPath1Update;
-extern __int64 MCTimeCalcPath2Update;
-extern __int64 MCTimeCalcPath3Update;
-extern __int64 MCTimeCalcPath4Update;
-extern __int64 MCTimeCalcPath5Update;
-extern __int64 MCTimeCalcGoal2Update ;
-extern __int64 MCTimeCalcGoal3Update ;
-extern __int64 MCTimeCalcGoal4Update ;
-extern __int64 MCTimeCalcGoal5Update ;
-extern __int64 MCTimeCalcGoal6Update ;
-extern __int64 MCTimeTerrainGeometry 	; 
-extern __int64 MCTimeCraterUpdate 		; 
-extern __int64 MCTimeTXMManagerUpdate 	; 
-extern __int64 MCTimeSensorUpdate 		; 
-extern __int64 MCTimeLOSUpdate			; 
-extern __int64 MCTimeCollisionUpdate 	; 
-extern __int64 MCTimeMissionScript 	; 
-extern __int64 MCTimeInterfaceUpdate 	; 
-extern __int64 MCTimeMissionTotal; 
-
-extern __int64 MCTimeLOSCalc;
-extern __int64 MCTimeTerrainObjectsUpdate;
-extern __int64 MCTimeMechsUpdate;
-extern __int64 MCTimeVehiclesUpdate;
-extern __int64 MCTimeTurretsUpdate;
-
-extern __int64 MCTimeTerrainObjectsTL;
-extern __int64 MCTimeMechsTL;
-extern __int64 MCTimeVehiclesTL;
-extern __int64 MCTimeTurretsTL;
-
-extern __int64 MCTimeAllElseUpdate;
-
-extern __int64 MCTimeAnimationCalc;
-
-extern __int64 MCTimeABLLoad 			;
-extern __int64 MCTimeMiscToTeamLoad 	; 
-extern __int64 MCTimeTeamLoad 			; 
-extern __int64 MCTimeObjectLoad 		; 
-extern __int64 MCTimeTerrainLoad 		; 
-extern __int64 MCTimeMoveLoad 			; 
-extern __int64 MCTimeMissionABLLoad 	; 
-extern __int64 MCTimeWarriorLoad 		; 
-extern __int64 MCTimeMoverPartsLoad	; 
-extern __int64 MCTimeObjectiveLoad 	; 
-extern __int64 MCTimeCommanderLoad 	; 
-extern __int64 MCTimeMiscLoad 			; 
-extern __int64 MCTimeGUILoad 			; 
-
-extern __int64 x1;
-
-extern __int64 x;
-
-
-#else
-#define ProfileTime(x,y)	y;
-#endif
 
 long GameVisibleVertices		= 60;
 float BaseHeadShotElevation		= 1.0f;
@@ -310,6 +244,10 @@ bool saveInMissionSave = false;
 
 float forcedFrameRate = -1.0f;
 
+float FixedStepRate = 0.0f;			//Simulation ticks per second.  Zero runs one tick of frameLength per frame.
+long MaxTicksPerFrame = 4;			//Most ticks we'll run to catch up in one frame.
+bool InterpolateTicks = true;		//Draw movers between their last two ticks.
+
 extern bool 			invulnerableON;		//Used for tutorials so mechs can take damage, but look like they are taking damage!  Otherwise, I'd just use NOPAIN!!
 
 #define DEFAULT_SKY			1
@@ -319,14 +257,20 @@ long Mission::update (void)
 {
 	if (active)
 	{
-		turn++;
+		PROFILE_ZONE("Mission Update");
+
+		//--------------------------------------------------
+		// Update length of time scenario has been running and
+		// find out how many simulation ticks this frame gets.
+		long numTicks = updateClock();
+		bool fixedStep = (FixedStepRate > 0.0f) && !MPlayer;
 
-		memset(ObjectManager->moverLineOfSightTable, -1, ObjectManager->maxMovers*ObjectManager->maxMovers);
+		if (numTicks)
+		{
+			turn++;
 
-#ifdef LAB_ONLY
-		MCTimeLOSCalc = 0;
-		MCTimeAnimationCalc = 0;
-#endif
+			ObjectManager->updateMoverLOSCache();
+		}
 
 		if (forcedFrameRate != -1.0f)
 			frameLength /= forcedFrameRate;
@@ -389,6 +333,15 @@ long Mission::update (void)
 				neverEndingStory = true;
 				missionLineChanged = turn;
 			}
+
+			#ifdef ZONEPROF
+			//Starts a new profile capture, or ends one and writes it out.
+			if (userInput->getKeyDown(KEY_K) && userInput->ctrl() && userInput->alt() && userInput->shift())
+			{
+				ZoneProf_enable(!ZoneProf_isEnabled());
+				missionLineChanged = turn;
+			}
+			#endif
 			#endif
 		}
 	
@@ -409,34 +362,6 @@ long Mission::update (void)
 			saveInMissionSave = false;
 		}
 
-		//--------------------------------------------------
-		// Update length of time scenario has been running.
-		if (!missionInterface->isPaused() || MPlayer )
-		{
-			//First Frame we just set LastTimeGetTime.
-			// After that, it increments based on System Time.
-			// NOT the crazy GameOS frameRate.
-			DWORD currentTimeGetTime = timeGetTime();
-			if (LastTimeGetTime != 0xffffffff)
-			{
-				float milliseconds = currentTimeGetTime - LastTimeGetTime;
-				scenarioTime += (milliseconds / 1000.0f);
-			}
-			LastTimeGetTime = currentTimeGetTime;
-
-			soundSystem->clearIsPaused();
-		}
-		else
-		{
-			//Keep track of system time.  Just don't add it to scenarioTime!!
-			DWORD currentTimeGetTime = timeGetTime();
-			LastTimeGetTime = currentTimeGetTime;
-
-			soundSystem->setIsPaused();
-		}
-
-		//--------------------------------------------------
-		
 		//------------------------------------------------------------------------
 		// There is a TINYYYYYYYYYY chance this will never go if timeGetTime()
 		// happens to return 0 (one millisecond every approx. 49 days). I can live
@@ -464,26 +389,33 @@ long Mission::update (void)
 #endif
 
 		mcTextureManager->clearArrays();
+
+		//-----------------------------------------------------------
+		// Orders from a replay log go in where the player's would.
+		REPLAY_update();
 		
 		if (missionInterface)
-			ProfileTime(MCTimeInterfaceUpdate,missionInterface->update());
+			PROFILE_CALL("Interface Update", missionInterface->update());
 		
-		ProfileTime(MCTimeCameraUpdate,eye->update());
+		PROFILE_CALL("Camera Update", eye->update());
 		
 		missionInterface->updateVTol();
 		
-		ProfileTime(MCTimeTerrainUpdate,land->update());
+		PROFILE_CALL("Terrain Update", land->update());
 
 		//ALWAYS update weather AFTER the camera.  May change the lights!
 		if (useNonWeaponEffects)
-			ProfileTime(MCTimeWeatherUpdate,weather->update());		//Should the rain fall during a pause?
+			PROFILE_CALL("Weather Update", weather->update());		//Should the rain fall during a pause?
 		
 		missionInterface->updateWaypoints();
 
 #ifdef USE_PATH_COST_TABLE
 		GlobalMoveMap[0]->resetPathCostTable();
 #endif
-		ProfileTime(MCTimePathManagerUpdate,PathManager->update());
+		if (numTicks)
+		{
+			PROFILE_CALL("PathManager Update", PathManager->update());
+		}
 
 		if (KillAmbientLight) {
 	//		ambientRed<<16)+(ambientGreen<<8)+ambientBlue;
@@ -498,41 +430,70 @@ long Mission::update (void)
 		land->terrainTextures->update();
 
 
-		ProfileTime(MCTimeTerrainGeometry,land->geometry());
+		PROFILE_CALL("Terrain Geometry", land->geometry());
 
-		if ( missionInterface->isPaused() && !MPlayer )
-			ObjectManager->updateAppearancesOnly( true, true, true );
-		else
-			ObjectManager->update(true, true, true);
-
-		ProfileTime(MCTimeCraterUpdate,craterManager->update());
-		
-		//Do not UPDATE the textures during a pause.  
-		//This uncaches things which only objectManager->update can cache back in!!!!!
-		if ( !missionInterface->isPaused() || MPlayer )
-			ProfileTime(MCTimeTXMManagerUpdate,mcTextureManager->update());
+		//-----------------------------------------------------------
+		// Run the simulation.  Normally that's one tick of frameLength
+		// per frame.  With a fixed step it's however many whole steps
+		// the clock owes us, maybe none, each exactly one step long.
+		bool paused = missionInterface->isPaused() && !MPlayer;
+		float renderFrameLength = frameLength;
+		for (long tick = 0; tick < numTicks; tick++)
+		{
+			if (tick > 0)
+			{
+				turn++;
+				ObjectManager->updateMoverLOSCache();
+				REPLAY_update();
+				PROFILE_CALL("PathManager Update", PathManager->update());
+			}
 
-		//--------------------------------------
-		// update sensor and contact managers...
-		if (useSensors && ( !missionInterface->isPaused() || MPlayer ) )
-			ProfileTime(MCTimeSensorUpdate, SensorManager->update());
+			if (fixedStep)
+			{
+				frameLength = 1.0f / FixedStepRate;
+				scenarioTime += frameLength;
+				actualTime = scenarioTime;
+				if (forcedFrameRate != -1.0f)
+					frameLength /= forcedFrameRate;
+
+				if (InterpolateTicks)
+					ObjectManager->saveTickPositions();
+			}
 
-		if (useCollisions && ( !missionInterface->isPaused() || MPlayer ) )
-			ProfileTime(MCTimeCollisionUpdate,ObjectManager->updateCollisions());
+			REPLAY_startTick();
+			long tickResult = updateTick(paused);
+			REPLAY_endTick();
+			if (tickResult == 9999)
+			{
+				frameLength = renderFrameLength;
+				return(terminationResult = 9999);
+			}
+		}
+		frameLength = renderFrameLength;
 
-		if (missionBrain)
+		if (fixedStep)
 		{
-			if ( !missionInterface->isPaused() || MPlayer )
+			//-------------------------------------------------------
+			// No tick this frame.  Keep the appearances up with the
+			// camera like a pause does, without letting time pass.
+			if (!numTicks)
 			{
-				ProfileTime(MCTimeMissionScript,missionBrain->execute());
-				long missionResult = missionBrain->getInteger();
-				if (missionResult == 9999)
-					return(terminationResult = 9999);
-				if (!MPlayer)
-					terminationResult = missionResult;
+				frameLength = 0.0f;
+				ObjectManager->updateAppearancesOnly( true, true, true );
+				frameLength = renderFrameLength;
 			}
+
+			if (InterpolateTicks)
+				ObjectManager->interpolateMovers(tickInterpolation);
 		}
 
+		PROFILE_CALL("Crater Update", craterManager->update());
+		
+		//Do not UPDATE the textures during a pause.  
+		//This uncaches things which only objectManager->update can cache back in!!!!!
+		if (!paused)
+			PROFILE_CALL("TXM Mgr Update", mcTextureManager->update());
+
 		//----------------------------------------------------
 		// Check is all player forces dead/disabled.
 		if (!MPlayer && !terminationCounterStarted)
@@ -655,6 +616,11 @@ long Mission::update (void)
 			}
 		}
 
+		//----------------------------------------------------------------
+		// Start next frame's door path solves on the worker threads. They
+		// run while we draw, and PathManager->update() picks them up...
+		PathManager->dispatchJobs();
+
 		if (userInput->getKeyDown(KEY_F) && !userInput->ctrl() && userInput->alt() && !userInput->shift())
 		{
 			showFrameRate ^= true;
@@ -701,47 +667,115 @@ long Mission::update (void)
 		}
 #endif
 
-#ifdef LAB_ONLY
-		MCTimeMissionTotal 		= MCTimeTerrainUpdate +
-									MCTimeCameraUpdate +
-									MCTimeWeatherUpdate + 
-									MCTimePathManagerUpdate +
-									MCTimeRunBrainUpdate +
-									MCTimePath1Update + 
-									MCTimePath2Update + 
-									MCTimePath3Update + 
-									MCTimePath4Update + 
-									MCTimePath5Update + 
-									MCTimeCalcPath1Update +
-									MCTimeCalcPath2Update +
-									MCTimeCalcPath3Update +
-									MCTimeCalcPath4Update +
-									MCTimeCalcPath5Update +
-									MCTimeCalcGoal1Update + 
-									MCTimeCalcGoal2Update + 
-									MCTimeCalcGoal3Update + 
-									MCTimeCalcGoal4Update + 
-									MCTimeCalcGoal5Update + 
-									MCTimeCalcGoal6Update + 
-									MCTimeTerrainGeometry +
-									MCTimeInterfaceUpdate +
-									MCTimeCraterUpdate +
-									MCTimeTXMManagerUpdate +
-									MCTimeSensorUpdate +
-									MCTimeLOSUpdate +
-									MCTimeCollisionUpdate +
-									MCTimeMissionScript+ 
-									MCTimeTerrainObjectsUpdate +
-									MCTimeMechsUpdate +
-									MCTimeVehiclesUpdate +
-									MCTimeTurretsUpdate +
-									MCTimeAllElseUpdate;
-#endif
 	}
 
 	return scenarioResult;
 }
 
+//----------------------------------------------------------------------------------
+// Advances the clock and returns how many simulation ticks to run this frame.
+// Without a fixed step that's always one and scenarioTime follows the system
+// clock.  With one, system time piles up in tickAccumulator and each tick
+// takes one step out of it.  The ticks themselves advance scenarioTime, so the
+// simulation never sees anything but whole steps.
+long Mission::updateClock (void)
+{
+	bool fixedStep = (FixedStepRate > 0.0f) && !MPlayer;
+	float elapsed = 0.0f;
+
+	if (!missionInterface->isPaused() || MPlayer )
+	{
+		//First Frame we just set LastTimeGetTime.
+		// After that, it increments based on System Time.
+		// NOT the crazy GameOS frameRate.
+		DWORD currentTimeGetTime = timeGetTime();
+		if (LastTimeGetTime != 0xffffffff)
+		{
+			float milliseconds = currentTimeGetTime - LastTimeGetTime;
+			elapsed = (milliseconds / 1000.0f);
+		}
+		LastTimeGetTime = currentTimeGetTime;
+
+		//----------------------------------------------------
+		// Headless runs go as fast as they can.  Each frame is
+		// one frameLength of game time, whatever the clock says,
+		// or exactly one tick when running fixed steps.
+		if (Environment.headless)
+			elapsed = fixedStep ? (1.0f / FixedStepRate) : frameLength;
+
+		soundSystem->clearIsPaused();
+	}
+	else
+	{
+		//Keep track of system time.  Just don't add it to scenarioTime!!
+		DWORD currentTimeGetTime = timeGetTime();
+		LastTimeGetTime = currentTimeGetTime;
+
+		soundSystem->setIsPaused();
+
+		if (fixedStep)
+			return(0);
+	}
+
+	if (!fixedStep)
+	{
+		scenarioTime += elapsed;
+		return(1);
+	}
+
+	float stepLength = 1.0f / FixedStepRate;
+	long maxTicks = (MaxTicksPerFrame > 0) ? MaxTicksPerFrame : 1;
+	tickAccumulator += elapsed;
+
+	long numTicks = (long)(tickAccumulator / stepLength);
+	if (numTicks > maxTicks)
+	{
+		//----------------------------------------------------
+		// We can't keep up.  Drop what we can't simulate rather
+		// than fall further behind every frame.
+		numTicks = maxTicks;
+		tickAccumulator = 0.0f;
+	}
+	else
+		tickAccumulator -= numTicks * stepLength;
+
+	tickInterpolation = tickAccumulator / stepLength;
+	return(numTicks);
+}
+
+//----------------------------------------------------------------------------------
+// One simulation tick: objects, sensors, collisions and the mission script.
+// Returns 9999 if the script wants out.
+long Mission::updateTick (bool paused)
+{
+	PROFILE_ZONE("Update Tick");
+
+	if (paused)
+		ObjectManager->updateAppearancesOnly( true, true, true );
+	else
+		ObjectManager->update(true, true, true);
+
+	//--------------------------------------
+	// update sensor and contact managers...
+	if (useSensors && !paused)
+		PROFILE_CALL("Sensor Update", SensorManager->update());
+
+	if (useCollisions && !paused)
+		PROFILE_CALL("Collision Update", ObjectManager->updateCollisions());
+
+	if (missionBrain && !paused)
+	{
+		PROFILE_CALL("Mission Script", missionBrain->execute());
+		long missionResult = missionBrain->getInteger();
+		if (missionResult == 9999)
+			return(9999);
+		if (!MPlayer)
+			terminationResult = missionResult;
+	}
+
+	return(NO_ERR);
+}
+
 //----------------------------------------------------------------------------------
 
 long Mission::getStatus (void) {
@@ -983,6 +1017,7 @@ void Mission::createPartObject (long partIndex, MoverPtr mover) {
 		mover->init(true, objType);
 		mover->setAwake(parts[partIndex].active ? true : false);
 		mover->setHandle(ObjectManager->getHandle(mover));
+		ObjectManager->indexObject(mover);
 
 		//----------------------------------------------
 		// Load the profile data into the game object...
@@ -1227,6 +1262,7 @@ typedef struct _MoverInitData {
 			mover->init(true, objType);
 			mover->setAwake(moverSpec->active);
 			mover->setHandle(ObjectManager->getHandle(mover));
+			ObjectManager->indexObject(mover);
 
 			//----------------------------------------------
 			// Load the profile data into the game object...
@@ -1631,6 +1667,8 @@ bool IsGateOpen (int objectWID) {
 //----------------------------------------------------------------------------
 void Mission::init (const char *missionName, long loadType, long dropZoneID, Stuff::Vector3D* dropZoneList, char commandersToLoad[8][3], long numMoversPerCommander)
 {
+	PROFILE_ZONE("Mission Load");
+
 	neverEndingStory = false;
 	invulnerableON = false;
 
@@ -1684,18 +1722,14 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 	turn = 0;
 	terminationCounterStarted = 0;
 
-	#ifdef LAB_ONLY
-	x=GetCycles();
-	#endif
+	PROFILE_BEGIN("ABL Load");
 
 	//-----------------------
 	// Init the ABL system...
 	initABL();
 
-#ifdef LAB_ONLY
-	x1=GetCycles();
-	MCTimeABLLoad=x1-x;
-#endif
+	PROFILE_END("ABL Load");
+	PROFILE_BEGIN("Misc To Team Load");
 
 	initBareMinimum();
 	loadProgress = 4.0f;
@@ -1763,6 +1797,14 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 	if (result != NO_ERR)
 		MaxTreeLOSCellBlock = 5;
 
+	result = gameSystemFile->readIdLong("SensorUpdateFrames",SensorSystemManager::updateFrames);
+	if (result != NO_ERR)
+		SensorSystemManager::updateFrames = 0;
+
+	result = gameSystemFile->readIdLong("SensorScanBudget",SensorSystemManager::scanBudget);
+	if (result != NO_ERR)
+		SensorSystemManager::scanBudget = 0;
+
 	result = gameSystemFile->readIdFloatArray("WeaponRange", WeaponRange, NUM_FIRERANGES);
 	gosASSERT(result == NO_ERR);
 
@@ -1954,10 +1996,8 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 		}
 	}
 
-#ifdef LAB_ONLY
-	x=GetCycles();
-	MCTimeMiscToTeamLoad=x-x1;
-#endif
+	PROFILE_END("Misc To Team Load");
+	PROFILE_BEGIN("Team Load");
 
 	//-----------------------------------
 	// Find the SKY Number and save it.
@@ -1989,6 +2029,7 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 			Team::teams[i] = NULL;
 		}
 	Team::numTeams = 0;
+	Team::destroyLOSHeightBound();
 	for (int i = 0; i < Commander::numCommanders; i++)
 		if (Commander::commanders[i]) {
 			delete Commander::commanders[i];
@@ -2108,10 +2149,8 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 		dropZone.y = -1.f;
 	}
 
-#ifdef LAB_ONLY
-	x1=GetCycles();
-	MCTimeTeamLoad=x1-x;
-#endif
+	PROFILE_END("Team Load");
+	PROFILE_BEGIN("Object Load");
 
 	//-----------------------------------------------------------------
 	// Load the names of the scenario tunes.
@@ -2177,10 +2216,8 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 
 	loadProgress = 15.0f;
 
-#ifdef LAB_ONLY
-	x=GetCycles();
-	MCTimeObjectLoad=x-x1;
-#endif
+	PROFILE_END("Object Load");
+	PROFILE_BEGIN("Terrain Load");
 
 	long terrainInitResult = land->init(&pakFile, 0, GameVisibleVertices, loadProgress, 20.0 );
 
@@ -2191,10 +2228,8 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 
 	loadProgress = 35.0f;
 
-#ifdef LAB_ONLY
-	x1=GetCycles();
-	MCTimeTerrainLoad=x1-x;
-#endif
+	PROFILE_END("Terrain Load");
+	PROFILE_BEGIN("Move Load");
 
 	land->load( missionFile );
 
@@ -2235,10 +2270,8 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 
 	loadProgress = 40.0f;
 
-#ifdef LAB_ONLY
-	x=GetCycles();
-	MCTimeMoveLoad=x-x1;
-#endif
+	PROFILE_END("Move Load");
+	PROFILE_BEGIN("Mission ABL Load");
 
 	//----------------------
 	// Load ABL Libraries...
@@ -2291,10 +2324,8 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 
 	missionBrainCallback = missionBrain->findFunction("handlemessage", TRUE);
 
-#ifdef LAB_ONLY
-	x1=GetCycles();
-	MCTimeMissionABLLoad=x1-x;
-#endif
+	PROFILE_END("Mission ABL Load");
+	PROFILE_BEGIN("Warrior Load");
 
 	loadProgress = 41.0f;
 
@@ -2388,10 +2419,8 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 				
 	}	
 	
-#ifdef LAB_ONLY
-	x=GetCycles();
-	MCTimeWarriorLoad=x-x1;
-#endif
+	PROFILE_END("Warrior Load");
+	PROFILE_BEGIN("Mover Parts Load");
 
 	loadProgress = 43.0f;
 
@@ -2773,10 +2802,8 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 			}
 		}
 
-#ifdef LAB_ONLY
-	x1=GetCycles();
-	MCTimeMoverPartsLoad=x1-x;
-#endif
+	PROFILE_END("Mover Parts Load");
+	PROFILE_BEGIN("Objective Load");
 
 	loadProgress = 68.0f;
 
@@ -2840,10 +2867,8 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 	}
 	ReadNavMarkers(missionFile, Team::home->objectives);
 */
-#ifdef LAB_ONLY
-	x=GetCycles();
-	MCTimeObjectiveLoad=x-x1;
-#endif
+	PROFILE_END("Objective Load");
+	PROFILE_BEGIN("Commander Load");
 
 	//----------------------------
 	// Read in Commander Groups...
@@ -2892,15 +2917,15 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 	if (!MPlayer)
 		Commander::home->setLocalMoverId(0);
 
-#ifdef LAB_ONLY
-	x1=GetCycles();
-	MCTimeCommanderLoad=x1-x;
-#endif
+	PROFILE_END("Commander Load");
+	PROFILE_BEGIN("Misc Load");
 
 	//-----------------------------------------------------
 	// This tracks time since scenario started in seconds.
 	LastTimeGetTime = 0xffffffff;
 	scenarioTime = 0.0;
+	tickAccumulator = 0.0f;
+	tickInterpolation = 0.0f;
 	MissionStartTime = 0;
 	runningTime = 0.0;
 	actualTime = 0.0;
@@ -2927,10 +2952,8 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 
 	loadProgress = 99.0;
 
-#ifdef LAB_ONLY
-	x=GetCycles();
-	MCTimeMiscLoad=x-x1;
-#endif
+	PROFILE_END("Misc Load");
+	PROFILE_BEGIN("GUI Load");
 
 	//----------------------------------------------------------------------------
 	// Start the Mission GUI
@@ -2983,27 +3006,7 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 	if (CombatLog)
 		MechWarrior::logPilots(CombatLog);
 
-#ifdef LAB_ONLY
-	x1=GetCycles();
-	MCTimeGUILoad=x1-x;
-#endif
-
-#ifdef LAB_ONLY	
-	//Add Mission Load statistics to GameOS Debugger screen!
-	MCTimeABLLoad       *= OneOverProcessorSpeed;
-	MCTimeMiscToTeamLoad*= OneOverProcessorSpeed;
-	MCTimeTeamLoad      *= OneOverProcessorSpeed;
-	MCTimeObjectLoad    *= OneOverProcessorSpeed;
-	MCTimeTerrainLoad   *= OneOverProcessorSpeed;
-	MCTimeMoveLoad      *= OneOverProcessorSpeed;
-	MCTimeMissionABLLoad*= OneOverProcessorSpeed;
-	MCTimeWarriorLoad   *= OneOverProcessorSpeed;
-	MCTimeMoverPartsLoad*= OneOverProcessorSpeed;
-	MCTimeObjectiveLoad *= OneOverProcessorSpeed;
-	MCTimeCommanderLoad *= OneOverProcessorSpeed;
-	MCTimeMiscLoad      *= OneOverProcessorSpeed;
-	MCTimeGUILoad       *= OneOverProcessorSpeed;
-#endif
+	PROFILE_END("GUI Load");
 
 	missionFile->close();
 	delete missionFile;
@@ -3114,6 +3117,8 @@ void Mission::initTGLForMission()
 //----------------------------------------------------------------------------------
 void Mission::destroy (bool initLogistics)
 {
+	REPLAY_endMission();
+
 	//---------------------------------------------------------------
 	// Shutdown the Mission Interface
 	if (missionInterface)
@@ -3245,6 +3250,7 @@ void Mission::destroy (bool initLogistics)
 			Team::teams[i] = NULL;
 		}
 	Team::numTeams = 0;
+	Team::destroyLOSHeightBound();
 
 	long numC = Commander::numCommanders;
 	for (int i = 0; i < numC; i++)
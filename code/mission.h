@@ -189,6 +189,9 @@ class Mission
 										
 		float							actualTime;
 		float							runningTime;
+
+		float							tickAccumulator;	// wall clock time not yet simulated (fixed step only)
+		float							tickInterpolation;	// how far the drawn frame is between the last two ticks
 										
 		long 							numSmallStrikes;
 		long 							numLargeStrikes;
@@ -248,6 +251,9 @@ class Mission
 			missionFileName[0] = 0;
 
 			missionBrainParams = NULL;
+
+			tickAccumulator = 0.0f;
+			tickInterpolation = 0.0f;
 		}
 		
 		Mission (void)
@@ -270,6 +276,9 @@ class Mission
 		
 		long update (void);
 		long render (void);
+
+		long updateClock (void);
+		long updateTick (bool paused);
 		
 		void destroy (bool initLogistics = true);
 		
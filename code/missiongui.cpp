@@ -96,6 +96,10 @@
 #include"keyboardref.h"
 #endif
 
+#ifndef REPLAY_H
+#include"replay.h"
+#endif
+
 #include "../resource.h"
 
 #include"platform_windows.h"
@@ -187,6 +191,8 @@ long lightState = 0;
 extern bool ShowMovers;
 extern bool CullPathAreas;
 extern bool ZeroHPrime;
+extern bool JumpPointSearch;
+extern bool IncrementalReplan;
 extern bool CalcValidAreaTable;
 extern bool EnemiesGoalPlan;
 bool paintingMyVtol = false;
@@ -777,7 +783,7 @@ void MissionInterfaceManager::update (void)
 		GlobalMoveMap[1]->calcArea(row, col),
 		GlobalMoveMap[2]->calcArea(row, col),
 		wPos.x, wPos.y, wPos.z,
-		PathManager->numPaths, PathManager->peakPaths);
+		PathManager->numPaths, PathManager->getPeakLatency());
 	if (MPlayer) {
 		char mpStr[256];
 		if (MPlayer->isServer())
@@ -794,6 +800,10 @@ void MissionInterfaceManager::update (void)
 		strcat(DebugStatusBarString, " [CULL PATH AREAS]");
 	if (ZeroHPrime)
 		strcat(DebugStatusBarString, " [ZERO HPRIME]");
+	if (!JumpPointSearch)
+		strcat(DebugStatusBarString, " [NO JUMP POINTS]");
+	if (!IncrementalReplan)
+		strcat(DebugStatusBarString, " [NO REPLAN]");
 	if (CalcValidAreaTable)
 		strcat(DebugStatusBarString, " [CALC VALID AREA]");
 	if (GlobalMap::logEnabled)
@@ -1718,10 +1728,8 @@ int MissionInterfaceManager::update( bool leftClickedClick, bool rightClickedCli
 					tacOrder.pack(NULL, NULL);					
 					MPlayer->sendPlayerOrder(&tacOrder, false, 1, &pMover);
 					}
-				else {
-					pMover->getPilot()->setExecutingQueue(true);
-					pMover->getPilot()->executeTacOrderQueue();
-				}
+				else
+					REPLAY_playerOrder(pMover, NULL, REPLAY_ORDER_EXECUTE_QUEUE);
 			}
 		}
 		bRetVal = 1;
@@ -1890,7 +1898,7 @@ void MissionInterfaceManager::doAttack()
 			if (MPlayer && !MPlayer->isServer())
 				MPlayer->sendPlayerOrder(&tacOrder, false, 1, &pMover);
 			else
-				pMover->handleTacticalOrder(tacOrder);
+				REPLAY_playerOrder(pMover, &tacOrder);
 		}
 	}
 
@@ -2325,7 +2333,7 @@ int MissionInterfaceManager::bigAirStrike()
 {
 	Stuff::Vector3D v = makeAirStrikeTarget( wPos );
 
-	IfaceCallStrike (ARTILLERY_LARGE,&v,NULL);
+	REPLAY_playerStrike (ARTILLERY_LARGE,v);
 //	if ( !isPaused() )
 		soundSystem->playSupportSample(SUPPORT_AIRSTRIKE);
 	return 1;
@@ -2334,7 +2342,7 @@ int MissionInterfaceManager::smlAirStrike()
 {
 	Stuff::Vector3D v = makeAirStrikeTarget( wPos );
 
-	IfaceCallStrike (ARTILLERY_SMALL,&v,NULL);
+	REPLAY_playerStrike (ARTILLERY_SMALL,v);
 //	if ( !isPaused() )
 		soundSystem->playSupportSample(SUPPORT_AIRSTRIKE);
 	return 1;
@@ -2343,7 +2351,7 @@ int MissionInterfaceManager::snsAirStrike()
 {
 	Stuff::Vector3D v = makeAirStrikeTarget( wPos );
 
-	IfaceCallStrike (ARTILLERY_SENSOR,&v,NULL);
+	REPLAY_playerStrike (ARTILLERY_SENSOR,v);
 //	if ( !isPaused() )
 		soundSystem->playSupportSample(SUPPORT_PROBE);
 	return 1;
@@ -2507,17 +2515,11 @@ int MissionInterfaceManager::handleOrders( TacticalOrder& order)
 				order.attackParams.range = (FireRangeType)pMover->attackRange;
 				order.pack( NULL, NULL );
 				if ( userInput->getKeyDown( WAYPOINT_KEY ) ) // way point one
-				{
-					pMover->getPilot()->setExecutingQueue(FALSE);
-					pMover->getPilot()->addQueuedTacOrder(order);					
-				}
+					REPLAY_playerOrder(pMover, &order, REPLAY_ORDER_QUEUE);
 				else if ( controlGui.getMines() )
-				{
-					pMover->getPilot()->addQueuedTacOrder(order);
-					pMover->getPilot()->setExecutingQueue(TRUE);
-				}
+					REPLAY_playerOrder(pMover, &order, REPLAY_ORDER_QUEUE_EXECUTE);
 				else
-					pMover->handleTacticalOrder(order);
+					REPLAY_playerOrder(pMover, &order);
 			}
 
 		}
@@ -2830,7 +2832,7 @@ void HandlePlayerOrder (MoverPtr mover, TacticalOrderPtr tacOrder) {
 	if (MPlayer && !MPlayer->isServer())
 		MPlayer->sendPlayerOrder(tacOrder, false, 1, &mover);
 	else
-		mover->handleTacticalOrder(*tacOrder);
+		REPLAY_playerOrder(mover, tacOrder);
 }
 						
 //--------------------------------------------------------------------------------------
@@ -4766,7 +4768,7 @@ int MissionInterfaceManager::quickDebugInfo() {
 				GameMap->getShallowWater(row, col) ? 1 : (GameMap->getDeepWater(row, col) ? 2 : 0),
 				row, col,
 				wPos.x, wPos.y, wPos.z,
-				PathManager->numPaths, PathManager->peakPaths, target->getName());
+				PathManager->numPaths, PathManager->getPeakLatency(), target->getName());
 		else
 			sprintf(debugString, "INFO = %s(%c%c) %d(W%d) [%d, %d] (%.4f, %.4f, %.4f) #Pth=%d(%d)\n",
 				terrainStr[GameMap->getTerrain(row, col)],
@@ -4776,14 +4778,22 @@ int MissionInterfaceManager::quickDebugInfo() {
 				GameMap->getShallowWater(row, col) ? 1 : (GameMap->getDeepWater(row, col) ? 2 : 0),
 				row, col,
 				wPos.x, wPos.y, wPos.z,
-				PathManager->numPaths, PathManager->peakPaths);
+				PathManager->numPaths, PathManager->getPeakLatency());
 		DEBUGWINS_print(debugString);
-		sprintf(debugString, "REQ =");
 		char s[10];
-		for (long i = 0; i < 25; i++) {
-			sprintf(s, " %02d", PathManager->sourceTally[i]);
-			strcat(debugString, s);
+		for (long p = 0; p < NUM_PATH_PRIORITIES; p++) {
+			sprintf(debugString, "LAT%d =", p);
+			for (long i = 0; i < NUM_PATH_LATENCY_BUCKETS; i++) {
+				sprintf(s, " %02d", PathManager->latencyHistogram[p][i]);
+				strcat(debugString, s);
+			}
+			DEBUGWINS_print(debugString);
 		}
+		sprintf(debugString, "JOBS = %d sent, %d used, %d stale", PathManager->jobsDispatched, PathManager->jobHits, PathManager->jobMisses);
+		DEBUGWINS_print(debugString);
+		sprintf(debugString, "GPATH CACHE = %d hits, %d misses, FLOW = %d fields, %d paths", GlobalMap::pathCacheHits, GlobalMap::pathCacheMisses, GlobalMap::flowFieldBuilds, GlobalMap::flowFieldPaths);
+		DEBUGWINS_print(debugString);
+		sprintf(debugString, "REPLAN = %d repairs, %d rebuilds, %d fallbacks", MoveReplanner::numRepairs, MoveReplanner::numRebuilds, MoveReplanner::numFallbacks);
 		DEBUGWINS_print(debugString);
 		lastTime = gos_GetElapsedTime();
 	}
@@ -5394,7 +5404,7 @@ void MissionInterfaceManager::doEject( GameObject* who )
 	if (MPlayer && !MPlayer->isServer())
 		MPlayer->sendPlayerOrder(&tacOrder, false, 1, &pMover);
 	else
-		pMover->handleTacticalOrder(tacOrder);
+		REPLAY_playerOrder(pMover, &tacOrder);
 }
 
 bool MissionInterfaceManager::hotKeyIsPressed( int whichCommand )
@@ -20,12 +20,35 @@
 #include"warrior.h"
 #endif
 
+#ifndef MOVER_H
+#include"mover.h"
+#endif
+
+#ifndef THREADPOOL_H
+#include"threadpool.h"
+#endif
+
+#ifndef ZONEPROF_H
+#include"zoneprof.h"
+#endif
+
 #include"gameos.hpp"
+#include"toolos.hpp"
 
 
 long MovePathManager::numPaths = 0;
-long MovePathManager::peakPaths = 0;
-long MovePathManager::sourceTally[50];
+long MovePathManager::frameBudget = 2000;
+long MovePathManager::minPathsPerFrame = 1;
+long MovePathManager::fixedPathsPerFrame = 0;
+long MovePathManager::agingFrames = 8;
+float MovePathManager::avgPathTime = 0.0;
+long MovePathManager::pathsThisFrame = 0;
+long MovePathManager::latencyHistogram[NUM_PATH_PRIORITIES][NUM_PATH_LATENCY_BUCKETS];
+long MovePathManager::peakLatency[NUM_PATH_PRIORITIES];
+long MovePathManager::lastDecayTurn = 0;
+long MovePathManager::jobsDispatched = 0;
+long MovePathManager::jobHits = 0;
+long MovePathManager::jobMisses = 0;
 MovePathManagerPtr PathManager = NULL;
 
 //***************************************************************************
@@ -53,6 +76,8 @@ long MovePathManager::init (void) {
 		pool[i].pilot = NULL;
 		pool[i].selectionIndex = 0;
 		pool[i].moveParams = 0;
+		pool[i].priority = PATH_PRIORITY_IDLE;
+		pool[i].requestTurn = 0;
 		if (i > 0)
 			pool[i].prev = &pool[i - 1];
 		else
@@ -70,9 +95,37 @@ long MovePathManager::init (void) {
 	freeList = &pool[0];
 
 	numPaths = 0;
-	peakPaths = 0;
-	for (int i =0; i < 50; i++)
-		sourceTally[i] = 0;
+	avgPathTime = 0.0;
+	pathsThisFrame = 0;
+	for (long i = 0; i < NUM_PATH_PRIORITIES; i++) {
+		for (long j = 0; j < NUM_PATH_LATENCY_BUCKETS; j++)
+			latencyHistogram[i][j] = 0;
+		peakLatency[i] = 0;
+	}
+	lastDecayTurn = turn;
+
+	//--------------------------------------------------------------
+	// Path job maps are only worth having if we have workers to run
+	// them. They are sized just like PathFindMap[SECTOR_PATHMAP]...
+	numJobs = 0;
+	jobsRunning = false;
+	jobsDispatched = 0;
+	jobHits = 0;
+	jobMisses = 0;
+	if (WorkerThreads && (WorkerThreads->getNumThreads() > 0))
+		for (long i = 0; i < MAX_PATH_JOBS; i++) {
+			if (!jobs[i].map) {
+				jobs[i].map = new MoveMap;
+				gosASSERT(jobs[i].map != NULL);
+				jobs[i].map->init(SECTOR_DIM * 2, SECTOR_DIM * 2);
+				jobs[i].map->initOpenList();
+			}
+			if (!jobs[i].path) {
+				jobs[i].path = new MovePath;
+				gosASSERT(jobs[i].path != NULL);
+				jobs[i].path->init();
+			}
+		}
 
 	return(NO_ERR);
 }
@@ -81,6 +134,18 @@ long MovePathManager::init (void) {
 
 void MovePathManager::destroy (void) {
 
+	syncJobs();
+	numJobs = 0;
+	for (long i = 0; i < MAX_PATH_JOBS; i++) {
+		if (jobs[i].map) {
+			delete jobs[i].map;
+			jobs[i].map = NULL;
+		}
+		if (jobs[i].path) {
+			delete jobs[i].path;
+			jobs[i].path = NULL;
+		}
+	}
 }
 
 //---------------------------------------------------------------------------
@@ -104,7 +169,6 @@ void MovePathManager::remove (PathQueueRecPtr rec) {
 	rec->next = freeList;
 	freeList = rec;
 
-	sourceTally[rec->num]--;
 	numPaths--;
 }
 
@@ -125,7 +189,22 @@ PathQueueRecPtr MovePathManager::remove (MechWarriorPtr pilot) {
 
 #define	DEBUG_MOVEPATH_QUEUE	0
 
-void MovePathManager::request (MechWarriorPtr pilot, long selectionIndex, unsigned long moveParams, long source) {
+long MovePathManager::calcPriority (MechWarriorPtr pilot) {
+
+	//-------------------------------------------------------------
+	// Callers that know the order's origin pass it in. Otherwise,
+	// go by what the pilot is currently doing...
+	TacticalOrderPtr tacOrder = pilot->getCurTacOrder();
+	if ((tacOrder->code != TACTICAL_ORDER_NONE) && (tacOrder->origin == ORDER_ORIGIN_PLAYER))
+		return(PATH_PRIORITY_PLAYER);
+	if (tacOrder->isCombatOrder() || pilot->getCurrentTarget())
+		return(PATH_PRIORITY_COMBAT);
+	return(PATH_PRIORITY_IDLE);
+}
+
+//---------------------------------------------------------------------------
+
+void MovePathManager::request (MechWarriorPtr pilot, long selectionIndex, unsigned long moveParams, long priority) {
 
 	//-----------------------------------------------------
 	// If the pilot is already awaiting a calc, purge it...
@@ -146,10 +225,11 @@ void MovePathManager::request (MechWarriorPtr pilot, long selectionIndex, unsign
 
 	//---------------------------------------------------
 	// New record has no next. Already has no previous...
-	pathQRec->num = source;
 	pathQRec->pilot = pilot;
 	pathQRec->selectionIndex = selectionIndex;
 	pathQRec->moveParams = moveParams;
+	pathQRec->priority = (priority == PATH_PRIORITY_NONE) ? calcPriority(pilot) : priority;
+	pathQRec->requestTurn = turn;
 
 	if (queueEnd) {
 		queueEnd->next = pathQRec;
@@ -165,10 +245,54 @@ void MovePathManager::request (MechWarriorPtr pilot, long selectionIndex, unsign
 	pilot->setMovePathRequest(pathQRec);
 	
 	numPaths++;
-	sourceTally[source]++;
+}
+
+//---------------------------------------------------------------------------
 
-	if (numPaths > peakPaths)
-		peakPaths = numPaths;
+PathQueueRecPtr MovePathManager::getNextRequest (void) {
+
+	//-----------------------------------------------------------------
+	// Lowest effective class wins. Waiting promotes a request one class
+	// every agingFrames frames. Ties go to the earliest request, since
+	// the queue is kept in arrival order...
+	PathQueueRecPtr bestQRec = NULL;
+	long bestRank = 0;
+	for (PathQueueRecPtr curQRec = queueFront; curQRec; curQRec = curQRec->next) {
+		long waited = turn - curQRec->requestTurn;
+		if (waited < 0)
+			waited = 0;
+		long rank = curQRec->priority - (waited / agingFrames);
+		if (!bestQRec || (rank < bestRank)) {
+			bestQRec = curQRec;
+			bestRank = rank;
+		}
+	}
+	return(bestQRec);
+}
+
+//---------------------------------------------------------------------------
+
+void MovePathManager::recordLatency (PathQueueRecPtr rec) {
+
+	long waited = turn - rec->requestTurn;
+	if (waited < 0)
+		waited = 0;
+	if (waited > peakLatency[rec->priority])
+		peakLatency[rec->priority] = waited;
+	if (waited >= NUM_PATH_LATENCY_BUCKETS)
+		waited = NUM_PATH_LATENCY_BUCKETS - 1;
+	latencyHistogram[rec->priority][waited]++;
+}
+
+//---------------------------------------------------------------------------
+
+long MovePathManager::getPeakLatency (void) {
+
+	long peak = 0;
+	for (long i = 0; i < NUM_PATH_PRIORITIES; i++)
+		if (peakLatency[i] > peak)
+			peak = peakLatency[i];
+	return(peak);
 }
 
 //---------------------------------------------------------------------------
@@ -176,10 +300,11 @@ void MovePathManager::request (MechWarriorPtr pilot, long selectionIndex, unsign
 void MovePathManager::calcPath (void) {
 
 	if (queueFront) {
-		//------------------------------
-		// Grab the next in the queue...
-		PathQueueRecPtr curQRec = queueFront;
-		remove(queueFront);
+		//---------------------------------------
+		// Grab the most urgent in the queue...
+		PathQueueRecPtr curQRec = getNextRequest();
+		remove(curQRec);
+		recordLatency(curQRec);
 
 		//--------------------------------------------------
 		// If the mover is no longer around, don't bother...
@@ -195,57 +320,150 @@ void MovePathManager::calcPath (void) {
 
 //----------------------------------------------------------------------------------
 void DEBUGWINS_print (char* s, long window);
-#ifdef LAB_ONLY
-extern __int64 MCTimePath1Update;
-extern __int64 MCTimePath2Update;
-extern __int64 MCTimePath3Update;
-extern __int64 MCTimePath4Update;
-extern __int64 MCTimePath5Update;
-extern __int64 MCTimeCalcGoal1Update;
-extern __int64 MCTimeCalcGoal2Update;
-extern __int64 MCTimeCalcGoal3Update;
-extern __int64 MCTimeCalcGoal4Update;
-extern __int64 MCTimeCalcGoal5Update;
-extern __int64 MCTimeCalcGoal6Update;
-#endif
 void MovePathManager::update (void) {
 
-	#ifdef LAB_ONLY
-	MCTimePath1Update = 0;
-	MCTimePath2Update = 0;
-	MCTimePath3Update = 0;
-	MCTimePath4Update = 0;
-	MCTimePath5Update = 0;
-
-	MCTimeCalcGoal1Update = 0;
-	MCTimeCalcGoal2Update = 0;
-	MCTimeCalcGoal3Update = 0;
-	MCTimeCalcGoal4Update = 0;
-	MCTimeCalcGoal5Update = 0;
-	MCTimeCalcGoal6Update = 0;
-#endif
-
-	#ifdef MC_PROFILE
-	QueryPerformanceCounter(startCk);
-	#endif
+	//-----------------------------------------------------
+	// Any path jobs started last frame must be done first...
+	PROFILE_CALL("Path Job Sync", syncJobs());
+
+	//-----------------------------------------------------------------
+	// Keep the latency histograms live by decaying them periodically...
+	if ((turn - lastDecayTurn) >= PATH_LATENCY_WINDOW || (turn < lastDecayTurn)) {
+		for (long i = 0; i < NUM_PATH_PRIORITIES; i++) {
+			for (long j = 0; j < NUM_PATH_LATENCY_BUCKETS; j++)
+				latencyHistogram[i][j] >>= 1;
+			peakLatency[i] = 0;
+		}
+		lastDecayTurn = turn;
+	}
 
-	long numPathsToProcess = 6;
-	//if (numPaths > 15)
-	//	numPathsToProcess = 10;
-	for (long i = 0; i < numPathsToProcess; i++) {
-		if (!queueFront)
+	//-----------------------------------------------------------------
+	// Solve paths until the frame budget is spent. We stop early if the
+	// average solve would overrun it, but always do minPathsPerFrame.
+	// Recorded missions solve a fixed count instead, so the paths come
+	// out on the same ticks however fast the machine is...
+	double startTime = gos_GetHiResTime();
+	pathsThisFrame = 0;
+	while (queueFront) {
+		double elapsed = (gos_GetHiResTime() - startTime) * 1000000.0;
+		bool frameFull;
+		if (fixedPathsPerFrame > 0)
+			frameFull = (pathsThisFrame >= fixedPathsPerFrame);
+		else
+			frameFull = (pathsThisFrame >= minPathsPerFrame) && ((elapsed + avgPathTime) > frameBudget);
+		if (frameFull)
 			break;
-		calcPath();
+		double pathStart = gos_GetHiResTime();
+		PROFILE_CALL("Solve Path", calcPath());
+		pathsThisFrame++;
+		float pathTime = (float)((gos_GetHiResTime() - pathStart) * 1000000.0);
+		avgPathTime += (pathTime - avgPathTime) * 0.125f;
 	}
 
+	//--------------------------------------------------------------
+	// Jobs not picked up this frame are stale by next frame anyway...
+	numJobs = 0;
+
 //	char s[50];
 //	sprintf(s, "num paths = %d", numPaths);
 //	DEBUGWINS_print(s, 0);
+}
+
+//---------------------------------------------------------------------------
+
+void SolvePathJob (void* data) {
+
+	//-----------------------------------------------------------
+	// Runs on a worker thread. Touches only the job's own map and
+	// path, plus read-only map data...
+	PROFILE_ZONE("Path Job");
+
+	PathJobPtr job = (PathJobPtr)data;
+	job->result = job->map->calcPath(job->path, &job->goal, job->goalCell);
+}
+
+//---------------------------------------------------------------------------
+
+void MovePathManager::dispatchJobs (void) {
+
+	if (jobsRunning || !jobs[0].map)
+		return;
+
+	numJobs = 0;
+	for (PathQueueRecPtr curQRec = queueFront; curQRec && (numJobs < MAX_PATH_JOBS); curQRec = curQRec->next) {
+		MechWarriorPtr pilot = curQRec->pilot;
+		MoverPtr mover = pilot->getVehicle();
+		if (!mover)
+			continue;
+
+		PathJobPtr job = &jobs[numJobs];
+		if (!pilot->prepareMovePathJob(curQRec->moveParams, job->map))
+			continue;
+
+		job->moverWID = mover->getWatchID();
+		job->checksum = job->map->calcSetUpChecksum();
+		job->path->clear();
+		job->goal.x = -999999.0;
+		job->goal.y = -999999.0;
+		job->goal.z = -999999.0;
+		job->goalCell[0] = -1;
+		job->goalCell[1] = -1;
+		job->result = 0;
+		numJobs++;
+		WorkerThreads->submit(SolvePathJob, job);
+	}
+
+	jobsRunning = (numJobs > 0);
+	jobsDispatched += numJobs;
+}
 
-	#ifdef MC_PROFILE
-	QueryPerformanceCounter(endCk);
-	srMvPathUpd += (endCk.LowPart - startCk.LowPart);
-	#endif
+//---------------------------------------------------------------------------
+
+void MovePathManager::syncJobs (void) {
+
+	if (jobsRunning) {
+		WorkerThreads->wait();
+		jobsRunning = false;
+	}
+}
+
+//---------------------------------------------------------------------------
+
+bool MovePathManager::getJobPath (long moverWID, MoveMapPtr map, MovePathPtr path, Stuff::Vector3D* goal, int* goalCell, long& result) {
+
+	//-------------------------------------------------------------------------
+	// Only valid if the map was just set up exactly as the job's was. If so,
+	// hand back what calcPath() would have written to path, goal and goalCell.
+	// Each job is good for one try...
+	for (long i = 0; i < numJobs; i++) {
+		PathJobPtr job = &jobs[i];
+		if (job->moverWID != moverWID)
+			continue;
+		job->moverWID = 0;
+		syncJobs();
+
+		if (map->calcSetUpChecksum() != job->checksum) {
+			jobMisses++;
+			return(false);
+		}
+
+		//-------------------------------------------------------
+		// A failed solve leaves the path's target as it was...
+		Stuff::Vector3D oldTarget = path->target;
+		*path = *job->path;
+		if (job->result == 0)
+			path->target = oldTarget;
+		if (goal && (job->goal.x > -999000.0))
+			*goal = job->goal;
+		if (job->goalCell[0] != -1) {
+			goalCell[0] = job->goalCell[0];
+			goalCell[1] = job->goalCell[1];
+		}
+		result = job->result;
+		jobHits++;
+		return(true);
+	}
+	return(false);
 }
 
 //***************************************************************************
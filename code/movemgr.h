@@ -21,21 +21,49 @@
 #include"dwarrior.h"
 #endif
 
+#ifndef MOVE_H
+#include"move.h"
+#endif
+
 //***************************************************************************
 
+#define	NUM_PATH_LATENCY_BUCKETS	16	// frames waited, last bucket is "or more"
+#define	PATH_LATENCY_WINDOW			300	// frames between histogram decays
+
 typedef struct _PathQueueRec* PathQueueRecPtr;
 
 typedef struct _PathQueueRec {
-	long				num;
 	MechWarriorPtr		pilot;
 	long				selectionIndex;
 	unsigned long		moveParams;
 	bool				initPath;
 	bool				faceObject;
+	long				priority;
+	long				requestTurn;
 	PathQueueRecPtr		prev;
 	PathQueueRecPtr		next;
 } PathQueueRec;
 
+//------------------------------------------------------------------------
+// At the end of each frame, queued requests that will be door-to-door
+// steps of a complex path are set up on the main thread, copied into a
+// job's own MoveMap and solved on the worker threads. When the request is
+// served next frame, the job is used only if a fresh setUp still matches
+// its checksum, so results are identical to solving it then and there.
+#define	MAX_PATH_JOBS				16
+
+typedef struct _PathJob {
+	MoveMapPtr			map;				// snapshot of the set up sector map
+	MovePathPtr			path;
+	long				moverWID;
+	uint64_t			checksum;			// of the snapshot, taken before the solve
+	Stuff::Vector3D		goal;
+	int					goalCell[2];
+	long				result;
+} PathJob;
+
+typedef PathJob* PathJobPtr;
+
 //---------------------------------------------------------------------------
 
 class MovePathManager {
@@ -47,8 +75,22 @@ class MovePathManager {
 		PathQueueRecPtr		queueEnd;
 		PathQueueRecPtr		freeList;
 		static long			numPaths;
-		static long			peakPaths;
-		static long			sourceTally[50];
+		static long			frameBudget;			// microseconds of path solving per frame
+		static long			minPathsPerFrame;		// always solved, regardless of budget
+		static long			fixedPathsPerFrame;		// if set, solve exactly this many and ignore the budget
+		static long			agingFrames;			// frames waited per priority class gained
+		static float		avgPathTime;			// running average solve time (microseconds)
+		static long			pathsThisFrame;
+		static long			latencyHistogram[NUM_PATH_PRIORITIES][NUM_PATH_LATENCY_BUCKETS];
+		static long			peakLatency[NUM_PATH_PRIORITIES];
+		static long			lastDecayTurn;
+
+		PathJob				jobs[MAX_PATH_JOBS];
+		long				numJobs;
+		bool				jobsRunning;
+		static long			jobsDispatched;
+		static long			jobHits;
+		static long			jobMisses;
 
 	public:
 
@@ -57,6 +99,12 @@ class MovePathManager {
 		void operator delete (void* us);
 		
 		MovePathManager (void) {
+			for (long i = 0; i < MAX_PATH_JOBS; i++) {
+				jobs[i].map = NULL;
+				jobs[i].path = NULL;
+			}
+			numJobs = 0;
+			jobsRunning = false;
 			init();
 		}
 		
@@ -72,11 +120,25 @@ class MovePathManager {
 
 		PathQueueRecPtr remove (MechWarriorPtr pilot);
 
-		void request (MechWarriorPtr pilot, long selectionIndex, unsigned long moveParams, long source);
+		void request (MechWarriorPtr pilot, long selectionIndex, unsigned long moveParams, long priority = PATH_PRIORITY_NONE);
+
+		static long calcPriority (MechWarriorPtr pilot);
+
+		PathQueueRecPtr getNextRequest (void);
 
 		void calcPath (void);
 
+		void recordLatency (PathQueueRecPtr rec);
+
+		long getPeakLatency (void);
+
 		void update (void);
+
+		void dispatchJobs (void);
+
+		void syncJobs (void);
+
+		bool getJobPath (long moverWID, MoveMapPtr map, MovePathPtr path, Stuff::Vector3D* goal, int* goalCell, long& result);
 };
 
 typedef MovePathManager* MovePathManagerPtr;
@@ -118,6 +118,14 @@
 #include"logisticspilot.h"
 #endif
 
+#ifndef MOVEMGR_H
+#include"movemgr.h"
+#endif
+
+#ifndef ZONEPROF_H
+#include"zoneprof.h"
+#endif
+
 //--------
 // DEFINES
 #define	GOALMAP_CELL_DIM	61
@@ -2673,6 +2681,7 @@ long Mover::setTeamId (long _teamId, bool setup) {
 	}
 
 	teamId = _teamId;
+	statusChanges++;
 	Assert(teamId > -2, teamId, " Mover.setTeamId: bad teamId ");
 
 	if (setup) {
@@ -3353,6 +3362,7 @@ void Mover::setPilotHandle (long _pilotHandle) {
 		pilot = MechWarrior::warriorList[pilotHandle];
 		pilot->setVehicle((GameObjectPtr)this);
 	}
+	statusChanges++;
 }
 
 //---------------------------------------------------------------------------
@@ -3426,6 +3436,7 @@ void Mover::setCommanderId (long _commanderId) {
 	if (commanderId > -1)
 		prevCommanderId = commanderId;
 	commanderId = _commanderId;
+	statusChanges++;
 }
 
 //---------------------------------------------------------------------------
@@ -4370,15 +4381,6 @@ bool Mover::canMoveHere (Stuff::Vector3D worldPos) {
 
 //-----------------------------------------------------------------------------
 
-#ifdef LAB_ONLY
-extern __int64 MCTimeCalcGoal1Update;
-extern __int64 MCTimeCalcGoal2Update;
-extern __int64 MCTimeCalcGoal3Update;
-extern __int64 MCTimeCalcGoal4Update;
-extern __int64 MCTimeCalcGoal5Update;
-extern __int64 MCTimeCalcGoal6Update;
-#endif
-
 long Mover::calcMoveGoal (GameObjectPtr target,
 						  Stuff::Vector3D moveCenter,
 						  float moveRadius,
@@ -4389,8 +4391,6 @@ long Mover::calcMoveGoal (GameObjectPtr target,
 						  short* validAreas,
 						  unsigned long moveParams) {
 
-	__int64 startTime = 0;
-
 	if (goalMapRowStart[0] == -1) {
 		for (long i = 0; i < GOALMAP_CELL_DIM; i++)
 			goalMapRowStart[i] = i * GOALMAP_CELL_DIM;
@@ -4515,7 +4515,7 @@ long Mover::calcMoveGoal (GameObjectPtr target,
 		//---------------------------------------------------
 		// If we have a max move radius (i.e. guarding area),
 		// anything beyond our radius is bad...
-		startTime = GetCycles();
+		PROFILE_BEGIN("Goal Move Radius");
 		if (moveRadius > 0.0) {
 			long moveCellRange = moveRadius / metersPerCell;
 			if (moveCellRange < 1)
@@ -4531,9 +4531,7 @@ long Mover::calcMoveGoal (GameObjectPtr target,
 					goalMap[goalMapRowStart[r] + c] -= 5000;
 			}
 		}
-#ifdef LAB_ONLY
-		MCTimeCalcGoal2Update += (GetCycles() - startTime);
-#endif
+		PROFILE_END("Goal Move Radius");
 		//---------------------------------------------------------------------------
 		// If the pilot has a set fire range, let's use it in determining how far out
 		// we would consider attacking. If we're ramming, fireCellrange will stay at
@@ -4665,7 +4663,7 @@ long Mover::calcMoveGoal (GameObjectPtr target,
 	for (int i = 0; i < numValidAreas; i++)
 		validAreaTable[validAreas[i]] = 1;
 
-	startTime = GetCycles();
+	PROFILE_BEGIN("Goal Terrain Weights");
 	long deepWaterWeight = ((moveLevel == 1) ? 0 : 999999);
 
 	//-----------------------------------------
@@ -4731,11 +4729,9 @@ long Mover::calcMoveGoal (GameObjectPtr target,
 			else
 				goalMap[goalMapRowStart[r] + c] = -999999;
 		}
-#ifdef LAB_ONLY
-		MCTimeCalcGoal1Update += (GetCycles() - startTime);
-#endif
+	PROFILE_END("Goal Terrain Weights");
 
-	startTime = GetCycles();
+	PROFILE_BEGIN("Goal Sort");
 	long goalList[MAX_MOVE_GOALS][2];
 	//------------------
 	// Setup the list...
@@ -4774,9 +4770,7 @@ long Mover::calcMoveGoal (GameObjectPtr target,
 		}
 	}
 
-#ifdef LAB_ONLY
-	MCTimeCalcGoal3Update += (GetCycles() - startTime);
-#endif
+	PROFILE_END("Goal Sort");
 
 	//----------------------------------------------------------------------
 	// If we're attacking this target, let's use a selectionIndex based upon
@@ -4821,7 +4815,7 @@ long Mover::calcMoveGoal (GameObjectPtr target,
 		long curMoverRow = cellPositionRow;
 		long curMoverCol = cellPositionCol;
 
-		startTime = GetCycles();
+		PROFILE_BEGIN("Goal LOF Search");
 		long i = 0;
 		ObjectManager->useMoverLineOfSightTable = false;
 		while (noLOF && (i < MaxMoveGoalChecks)) {
@@ -4842,7 +4836,7 @@ long Mover::calcMoveGoal (GameObjectPtr target,
 				position = start;
 				cellPositionRow = curGoalCell[0];
 				cellPositionCol = curGoalCell[1];
-				__int64 lstartTime = GetCycles();
+				PROFILE_BEGIN_FINE("Goal LOS Check");
                 // sebi
 				//if (goalList[i][1] > -10000) {
 				if (weight > -10000) {
@@ -4853,14 +4847,10 @@ long Mover::calcMoveGoal (GameObjectPtr target,
 					else
 						noLOF = !lineOfSight(moveGoal, false);
 				}
-#ifdef LAB_ONLY
-				MCTimeCalcGoal4Update += (GetCycles() - lstartTime);
-#endif
+				PROFILE_END("Goal LOS Check");
 			}
 		}
-#ifdef LAB_ONLY
-		MCTimeCalcGoal5Update += (GetCycles() - startTime);
-#endif
+		PROFILE_END("Goal LOF Search");
 		ObjectManager->useMoverLineOfSightTable = true;
 		position = curMoverPosition;
 		cellPositionRow = curMoverRow;
@@ -4869,7 +4859,7 @@ long Mover::calcMoveGoal (GameObjectPtr target,
 
 	GameMap->clearCellDebugs(2);
 
-	startTime = GetCycles();
+	PROFILE_BEGIN("Goal Fire Position");
 	if (noLOF && hasWeaponNode()) {
 		int targetPos[2], maxPos[2], bestCell[4][2];
 		float castRange;
@@ -4956,9 +4946,7 @@ long Mover::calcMoveGoal (GameObjectPtr target,
 		}
 	}
 	GameMap->setCellDebug(curGoalCell[0], curGoalCell[1], 3, 2);			
-#ifdef LAB_ONLY
-	MCTimeCalcGoal6Update += (GetCycles() - startTime);
-#endif	
+	PROFILE_END("Goal Fire Position");
 	//--------------------------------------------
 	// Let's calc the woorld coord of this cell...
 	land->cellToWorld(curGoalCell[0], curGoalCell[1], newGoal);
@@ -5052,6 +5040,8 @@ int Mover::calcMovePath (MovePathPtr path,
 			int goalCell[2];
 			if (numOffsets > 8)
 				result = PathFindMap[SIMPLE_PATHMAP]->calcPathJUMP(path, NULL, goalCell);
+			else if (moveParams & MOVEPARAM_RECALC)
+				result = PathReplanner->calcPath(PathFindMap[SIMPLE_PATHMAP], path, NULL, goalCell);
 			else
 				result = PathFindMap[SIMPLE_PATHMAP]->calcPath(path, NULL, goalCell);
 			PathFindMap[SIMPLE_PATHMAP]->setMover(0);
@@ -5128,6 +5118,8 @@ int Mover::calcMovePath (MovePathPtr path,
 
 			if (numOffsets > 8)
 				result = PathFindMap[SECTOR_PATHMAP]->calcPathJUMP(path, NULL, goalCell);
+			else if (moveParams & MOVEPARAM_RECALC)
+				result = PathReplanner->calcPath(PathFindMap[SECTOR_PATHMAP], path, NULL, goalCell);
 			else
 				result = PathFindMap[SECTOR_PATHMAP]->calcPath(path, NULL, goalCell);
 			PathFindMap[SECTOR_PATHMAP]->setMover(0);
@@ -5339,6 +5331,48 @@ void Mover::updatePathLock (bool set)
 
 //---------------------------------------------------------------------------
 
+void Mover::suspendPathLock (PathLockState& state) {
+
+	//-----------------------------------------------------------------
+	// Same as updatePathLock(false), but remembers the lock bits it is
+	// about to clear. Unlike updatePathLock(true), restorePathLock()
+	// puts back exactly what was there, so a speculative setUp done
+	// between the two leaves no trace on the map...
+	state.suspended = false;
+	if (getObjectClass() == BATTLEMECH)
+		if (((BattleMechPtr)this)->inJump)
+			return;
+
+	if (!pathLocks)
+		return;
+
+	long lockLevel = (moveLevel == 2);
+	state.suspended = true;
+	state.cellLocked = GameMap->getPathlock(lockLevel, cellPositionRow, cellPositionCol);
+	state.pathLockLength = pathLockLength;
+	for (long i = 0; i < pathLockLength; i++)
+		state.rangeLocked[i] = GameMap->getPathlock(lockLevel, pathLockList[i][0], pathLockList[i][1]);
+
+	updatePathLock(false);
+}
+
+//---------------------------------------------------------------------------
+
+void Mover::restorePathLock (PathLockState& state) {
+
+	if (!state.suspended)
+		return;
+
+	long lockLevel = (moveLevel == 2);
+	GameMap->setPathlock(lockLevel, cellPositionRow, cellPositionCol, state.cellLocked);
+	for (long i = 0; i < state.pathLockLength; i++)
+		GameMap->setPathlock(lockLevel, pathLockList[i][0], pathLockList[i][1], state.rangeLocked[i]);
+	pathLockLength = state.pathLockLength;
+	state.suspended = false;
+}
+
+//---------------------------------------------------------------------------
+
 bool Mover::getPathRangeBlocked (long range, bool* reachedEnd) {
 
 	if (moveLevel > 0)
@@ -5421,6 +5455,72 @@ long Mover::bounceToAdjCell (void) {
 
 //---------------------------------------------------------------------------
 
+long Mover::setUpMovePath (Stuff::Vector3D start,
+						   long thruArea[2],
+						   long goalDoor,
+						   Stuff::Vector3D finalGoal,
+						   unsigned long moveParams,
+						   long& numOffsets) {
+
+	//---------------------------------------------------------------------
+	// Sets up PathFindMap[SECTOR_PATHMAP] for a door path. Returns 0 if we
+	// can't move at all, -1 if the goal door is blocked and 1 if the map
+	// is ready to solve (still set to this mover)...
+	float cellLength = (Terrain::worldUnitsPerCell * metersPerWorldUnit);
+	long clearCost = 0;
+	if (maxMoveSpeed != 0)
+		clearCost = (long)(cellLength / maxMoveSpeed * 50.0);
+	if (clearCost <= 0)
+		return(0);
+
+	long jumpCost = 0;
+	numOffsets = 8;
+	if (!pilot->onHomeTeam() && !MPlayer)
+		getJumpRange(&numOffsets, &jumpCost);
+
+	int posCellR, posCellC;
+	land->worldToCell(start, posCellR, posCellC);
+
+	#ifdef USE_ELEMENTALS
+	if (getObjectClass() == ELEMENTAL) {
+		GameObjectPtr target = pilot->getLastTarget();
+		if (target && (distanceFrom(target->getPosition()) < ElementalTargetNoJumpDistance)) {
+			jumpCost = 0;
+			numOffsets = 8;
+			}
+		else
+			JumpOnBlocked = true;
+	}
+	#endif
+
+	if (isMineSweeper())
+		moveParams |= MOVEPARAM_SWEEP_MINES;
+	if (followRoads)
+		moveParams |= MOVEPARAM_FOLLOW_ROADS;
+	if (isMech())
+		moveParams |= MOVEPARAM_WATER_SHALLOW;
+	if (moveLevel == 1)
+		moveParams |= (MOVEPARAM_WATER_SHALLOW + MOVEPARAM_WATER_DEEP);
+	PathFindMap[SECTOR_PATHMAP]->setMover(getWatchID(), getTeamId(), isLayingMines());
+	long result = PathFindMap[SECTOR_PATHMAP]->setUp(
+								moveLevel,
+								&start,
+								posCellR,
+								posCellC,
+								thruArea,
+								goalDoor,
+								finalGoal,
+								clearCost,
+								jumpCost,
+								numOffsets,
+								moveParams);
+	if (result == -1)
+		return(-1);
+	return(1);
+}
+
+//---------------------------------------------------------------------------
+
 int Mover::calcMovePath (MovePathPtr path,
 						  Stuff::Vector3D start,
 						  long thruArea[2],
@@ -5443,62 +5543,25 @@ int Mover::calcMovePath (MovePathPtr path,
 	long result = 0;
 	path->clear();
 
-	float cellLength = (Terrain::worldUnitsPerCell * metersPerWorldUnit);
-	long clearCost = 0;
-	if (maxMoveSpeed != 0)
-		clearCost = (long)(cellLength / maxMoveSpeed * 50.0);
-	if (clearCost > 0) {
-		long jumpCost = 0;
-		long numOffsets = 8;
-		if (!pilot->onHomeTeam() && !MPlayer)
-			getJumpRange(&numOffsets, &jumpCost);
-
-		int posCellR, posCellC;
-		land->worldToCell(start, posCellR, posCellC);
-
-		#ifdef USE_ELEMENTALS
-		if (getObjectClass() == ELEMENTAL) {
-			GameObjectPtr target = pilot->getLastTarget();
-			if (target && (distanceFrom(target->getPosition()) < ElementalTargetNoJumpDistance)) {
-				jumpCost = 0;
-				numOffsets = 8;
-				}
-			else
-				JumpOnBlocked = true;
-		}
-		#endif
-
-		if (isMineSweeper())
-			moveParams |= MOVEPARAM_SWEEP_MINES;
-		if (followRoads)
-			moveParams |= MOVEPARAM_FOLLOW_ROADS;
-		if (isMech())
-			moveParams |= MOVEPARAM_WATER_SHALLOW;
-		if (moveLevel == 1)
-			moveParams |= (MOVEPARAM_WATER_SHALLOW + MOVEPARAM_WATER_DEEP);
-		PathFindMap[SECTOR_PATHMAP]->setMover(getWatchID(), getTeamId(), isLayingMines());
-		result = PathFindMap[SECTOR_PATHMAP]->setUp(
-									moveLevel,
-									&start,
-									posCellR,
-									posCellC,
-									thruArea,
-									goalDoor,
-									finalGoal,
-									clearCost,
-									jumpCost,
-									numOffsets,
-									moveParams);
-		if (result == -1) {
-			//-------------------------------------------------------
-			// Goal door is blocked. Can't get thru, at the moment...
-			JumpOnBlocked = false;
-			return(-999);
-		}
+	long numOffsets = 8;
+	long setUpResult = setUpMovePath(start, thruArea, goalDoor, finalGoal, moveParams, numOffsets);
+	if (setUpResult == -1) {
+		//-------------------------------------------------------
+		// Goal door is blocked. Can't get thru, at the moment...
+		JumpOnBlocked = false;
+		return(-999);
+	}
 
+	if (setUpResult > 0) {
+		//-------------------------------------------------------------------
+		// The path manager may already have solved this exact set up on a
+		// worker thread. If so, take its result instead of solving again. A
+		// recalc repairs the mover's last search rather than starting over...
 		if (numOffsets > 8)
 			result = PathFindMap[SECTOR_PATHMAP]->calcPathJUMP(path, goal, goalCell);
-		else
+		else if (moveParams & MOVEPARAM_RECALC)
+			result = PathReplanner->calcPath(PathFindMap[SECTOR_PATHMAP], path, goal, goalCell);
+		else if (!PathManager->getJobPath(getWatchID(), PathFindMap[SECTOR_PATHMAP], path, goal, goalCell, result))
 			result = PathFindMap[SECTOR_PATHMAP]->calcPath(path, goal, goalCell);
 		//if ((goalCell[0] == -1) || (goalCell[1] == -1))
 		//	STOP(("Mover.calcMovePath: bad goal cell--get GLENN!"));
@@ -593,6 +593,16 @@ class StatusChunk {
 #define	MAX_ATTACK_INCREMENTS		32
 #define	RANGED_CELLS_DIM			(MAX_ATTACK_CELLRANGE * 2 + 1) * (MAX_ATTACK_CELLRANGE * 2 + 1)
 
+//---------------------------------------------------------------------------
+// What suspendPathLock() cleared, so restorePathLock() can put the map back
+// exactly as it was...
+typedef struct _PathLockState {
+	bool				suspended;
+	bool				cellLocked;
+	long				pathLockLength;
+	bool				rangeLocked[MAX_LOCK_RANGE];
+} PathLockState;
+
 typedef struct _MoverData : public GameObjectData
 {
 	bool				killed;
@@ -1168,6 +1178,10 @@ class Mover : public GameObject {
 
 		virtual void updatePathLock (bool set);
 
+		void suspendPathLock (PathLockState& state);
+
+		void restorePathLock (PathLockState& state);
+
 		virtual bool getPathRangeLock (long range, bool* reachedEnd = NULL);
 
 		virtual long setPathRangeLock (bool set, long range = 0);
@@ -1485,6 +1499,13 @@ class Mover : public GameObject {
 									 unsigned long moveParams,
 									 Stuff::Vector3D& escapeGoal);
 
+		long setUpMovePath (Stuff::Vector3D start,
+							long thruArea[2],
+							long goalDoor,
+							Stuff::Vector3D finalGoal,
+							unsigned long moveParams,
+							long& numOffsets);
+
 		virtual int calcMovePath (MovePathPtr path,
 								   Stuff::Vector3D start,
 								   long thruArea[2],
@@ -1771,6 +1792,7 @@ class Mover : public GameObject {
 		virtual void setOnGUI (bool onGui)
 		{
 			isOnGui = onGui;
+			statusChanges++;
 		}
 		
 		virtual void Save (PacketFilePtr file, long packetNum);
@@ -58,6 +58,14 @@ unsigned long CObjective::s_blinkColor = SB_YELLOW;
 aFont* CObjective::s_markerFont = 0;
 float MaxExtractUnitDistance = 0.0f;
 
+unsigned long CBooleanArray::changes = 0;
+DWORD CObjectiveCondition::evaluations = 0;
+DWORD CObjectiveCondition::cacheHits = 0;
+
+#ifdef LAB_ONLY
+bool verifyObjectiveCache = false;		//Re-evaluate cached conditions and compare
+#endif
+
 static const char *g_actionSpeciesStringArray[] = {
 	"PlayBIK",
 	"PlayWAV",
@@ -359,6 +367,34 @@ void CBooleanArray::load (long alignment, FitIniFile *file)
 			result = sReadIdString(file,stringName,tmpECStr);
 		}
 	}
+	changes++;
+}
+
+objective_status_type CObjectiveCondition::CachedStatus()
+{
+	/*Most conditions scan every mover, but only what they read can change their answer. We
+	keep the last answer until one of the change counters named by Triggers() moves.*/
+	unsigned long triggers = Triggers();
+	unsigned long unitChanges = GameObject::statusChanges + MechWarrior::statusChanges;
+	if (triggers && m_cacheValid
+		&& (!(triggers & OBJECTIVE_TRIGGER_UNITS) || (m_unitChanges == unitChanges))
+		&& (!(triggers & OBJECTIVE_TRIGGER_POSITIONS) || (m_positionChanges == GameObject::positionChanges))
+		&& (!(triggers & OBJECTIVE_TRIGGER_FLAGS) || (m_flagChanges == CBooleanArray::changes))) {
+		cacheHits++;
+#ifdef LAB_ONLY
+		if (verifyObjectiveCache && (Status() != m_cachedStatus))
+			PAUSE(("Cached objective condition %s is stale", Description().Data()));
+#endif
+		return m_cachedStatus;
+	}
+
+	evaluations++;
+	m_cachedStatus = Status();
+	m_cacheValid = true;
+	m_unitChanges = unitChanges;
+	m_positionChanges = GameObject::positionChanges;
+	m_flagChanges = CBooleanArray::changes;
+	return m_cachedStatus;
 }
 
 
@@ -865,6 +901,60 @@ objective_status_type CGuardSpecificStructure::Status()
 	}
 }
 
+CAreaObjectiveCondition *CAreaObjectiveCondition::s_areas[MAX_OBJECTIVE_AREAS];
+int CAreaObjectiveCondition::s_numAreas = 0;
+int CAreaObjectiveCondition::s_numUnwatchedAreas = 0;
+
+CAreaObjectiveCondition::CAreaObjectiveCondition(int alignment) : CObjectiveCondition(alignment)
+{
+	m_targetCenterX = 0.0; m_targetCenterY = 0.0; m_targetRadius = 0.0;
+	if (s_numAreas < MAX_OBJECTIVE_AREAS) {
+		s_areas[s_numAreas] = this;
+		s_numAreas += 1;
+	} else {
+		/*we can't watch this one's edge, so every move has to count*/
+		s_numUnwatchedAreas += 1;
+	}
+}
+
+CAreaObjectiveCondition::~CAreaObjectiveCondition()
+{
+	int i;
+	for (i = 0; i < s_numAreas; i += 1) {
+		if (s_areas[i] == this) {
+			s_numAreas -= 1;
+			s_areas[i] = s_areas[s_numAreas];
+			return;
+		}
+	}
+	s_numUnwatchedAreas -= 1;
+}
+
+bool CAreaObjectiveCondition::EdgeCrossed(const Stuff::Vector3D &from, const Stuff::Vector3D &to)
+{
+	/*Same sums as the area Status() tests, so a mover that doesn't cross can't change their answer.
+	The any-unit test wants inside (<) and the all-units tests want not outside (>), so check both.*/
+	if (s_numUnwatchedAreas > 0) {
+		return true;
+	}
+	int i;
+	for (i = 0; i < s_numAreas; i += 1) {
+		CAreaObjectiveCondition *pArea = s_areas[i];
+		float radiusSquared = pArea->m_targetRadius*pArea->m_targetRadius;
+		float dx = from.x - pArea->m_targetCenterX;
+		float dy = from.y - pArea->m_targetCenterY;
+		float fromSquared = dx*dx + dy*dy;
+		dx = to.x - pArea->m_targetCenterX;
+		dy = to.y - pArea->m_targetCenterY;
+		float toSquared = dx*dx + dy*dy;
+		if (((fromSquared < radiusSquared) != (toSquared < radiusSquared))
+			|| ((fromSquared > radiusSquared) != (toSquared > radiusSquared))) {
+			return true;
+		}
+	}
+	return false;
+}
+
 bool CAreaObjectiveCondition::Read( FitIniFile* missionFile )
 {
 	long result = 0;
@@ -1879,7 +1969,7 @@ objective_status_type CObjective::Status() {
 			/*evaluate the status of the success conditions*/
 			EIterator it = Begin();
 			while (!it.IsDone()) {
-				objective_status_type conditionStatus = (*it)->Status();
+				objective_status_type conditionStatus = (*it)->CachedStatus();
 				if (OS_FAILED == conditionStatus) {
 					objectiveStatus = OS_FAILED;
 					break;
@@ -1894,7 +1984,7 @@ objective_status_type CObjective::Status() {
 			objective_status_type failureStatus = OS_SUCCESSFUL;
 			EIterator it = m_failureConditionList.Begin();
 			while (!it.IsDone()) {
-				objective_status_type conditionStatus = (*it)->Status();
+				objective_status_type conditionStatus = (*it)->CachedStatus();
 				if (OS_FAILED == conditionStatus) {
 					failureStatus = OS_FAILED;
 					break;
@@ -88,11 +88,13 @@ private:
 	CEStringList m_FlagIDList;
 	CBoolList m_valueList;
 public:
+	static unsigned long changes;		/*bumped whenever any flag array is written*/
 	CBooleanArray() {}
 	~CBooleanArray() {}
 	void Clear() {
 		m_FlagIDList.Clear();
 		m_valueList.Clear();
+		changes++;
 	}
 	int elementPos(EString element) {
 		bool elementFound = false;
@@ -119,6 +121,7 @@ public:
 			m_FlagIDList.Append(element);
 			m_valueList.Append(value);
 		}
+		changes++;
 	}
 	bool getElementValue(EString element) {
 		int pos = elementPos(element);
@@ -135,14 +138,32 @@ public:
 	void load (long alignment, FitIniFile *file);
 };
 
+/*What a condition's Status() reads, so CachedStatus() knows when it has to look again.*/
+#define OBJECTIVE_TRIGGER_UNITS			0x01	/*mover list, or status, team, commander or pilot of any mover*/
+#define OBJECTIVE_TRIGGER_POSITIONS		0x02	/*a mover crossed the edge of an objective area*/
+#define OBJECTIVE_TRIGGER_FLAGS			0x04	/*any boolean flag was set*/
+
+#define MAX_OBJECTIVE_AREAS				64
+
 class CObjectiveCondition {
 private:
 	int m_alignment;
-public:
-	CObjectiveCondition(int alignment) { m_alignment = alignment; }
+	bool m_cacheValid;
+	objective_status_type m_cachedStatus;
+	unsigned long m_unitChanges;
+	unsigned long m_positionChanges;
+	unsigned long m_flagChanges;
+public:
+	static DWORD evaluations;
+	static DWORD cacheHits;
+	CObjectiveCondition(int alignment) { m_alignment = alignment; m_cacheValid = false; m_cachedStatus = OS_UNDETERMINED; }
 	virtual ~CObjectiveCondition() {}
 	int Alignment() { return m_alignment; }
-	void Alignment(int alignment) { m_alignment = alignment; }
+	void Alignment(int alignment) { m_alignment = alignment; m_cacheValid = false; }
+	/*zero means Status() is cheap or depends on time, and is called every time*/
+	virtual unsigned long Triggers() { return 0; }
+	objective_status_type CachedStatus();
+	void Invalidate() { m_cacheValid = false; }
 	virtual condition_species_type Species() = 0;
 	virtual bool Init() { return true; }
 	virtual bool Read( FitIniFile* missionFile ) { return true; }
@@ -162,6 +183,7 @@ public:
 	CDestroyAllEnemyUnits(int alignment) : CObjectiveCondition(alignment) {}
 	condition_species_type Species() { return DESTROY_ALL_ENEMY_UNITS; }
 	objective_status_type Status();
+	unsigned long Triggers() { return OBJECTIVE_TRIGGER_UNITS; }
 	EString Description() {
 		EString retval = "DestroyAllEnemyUnits"; /* needs to be put somewhere localizable */
 		return retval;
@@ -184,6 +206,7 @@ public:
 	CDestroyNumberOfEnemyUnits(int alignment) : CNumberOfUnitsObjectiveCondition(alignment) {}
 	condition_species_type Species() { return DESTROY_NUMBER_OF_ENEMY_UNITS; }
 	objective_status_type Status();
+	unsigned long Triggers() { return OBJECTIVE_TRIGGER_UNITS; }
 	EString Description() {
 		EString retval = "DestroyNumberOfEnemyUnits"; /* needs to be put somewhere localizable */
 		return retval;
@@ -254,6 +277,7 @@ public:
 	CCaptureOrDestroyAllEnemyUnits(int alignment) : CObjectiveCondition(alignment) {}
 	condition_species_type Species() { return CAPTURE_OR_DESTROY_ALL_ENEMY_UNITS; }
 	objective_status_type Status();
+	unsigned long Triggers() { return OBJECTIVE_TRIGGER_UNITS; }
 	EString Description() {
 		EString retval = "CaptureOrDestroyAllEnemyUnits"; /* needs to be put somewhere localizable */
 		return retval;
@@ -265,6 +289,7 @@ public:
 	CCaptureOrDestroyNumberOfEnemyUnits(int alignment) : CNumberOfUnitsObjectiveCondition(alignment) {}
 	condition_species_type Species() { return CAPTURE_OR_DESTROY_NUMBER_OF_ENEMY_UNITS; }
 	objective_status_type Status();
+	unsigned long Triggers() { return OBJECTIVE_TRIGGER_UNITS; }
 	EString Description() {
 		EString retval = "CaptureOrDestroyNumberOfEnemyUnits"; /* needs to be put somewhere localizable */
 		return retval;
@@ -300,6 +325,7 @@ public:
 	CDeadOrFledAllEnemyUnits(int alignment) : CObjectiveCondition(alignment) {}
 	condition_species_type Species() { return DEAD_OR_FLED_ALL_ENEMY_UNITS; }
 	objective_status_type Status();
+	unsigned long Triggers() { return OBJECTIVE_TRIGGER_UNITS; }
 	EString Description() {
 		EString retval = "DeadOrFledAllEnemyUnits"; /* needs to be put somewhere localizable */
 		return retval;
@@ -311,6 +337,7 @@ public:
 	CDeadOrFledNumberOfEnemyUnits(int alignment) : CNumberOfUnitsObjectiveCondition(alignment) {}
 	condition_species_type Species() { return DEAD_OR_FLED_NUMBER_OF_ENEMY_UNITS; }
 	objective_status_type Status();
+	unsigned long Triggers() { return OBJECTIVE_TRIGGER_UNITS; }
 	EString Description() {
 		EString retval = "DeadOrFledNumberOfEnemyUnits"; /* needs to be put somewhere localizable */
 		return retval;
@@ -376,14 +403,21 @@ public:
 };
 
 class CAreaObjectiveCondition: public CObjectiveCondition { /*abstract class*/
+private:
+	/*every live area condition, so a mover can tell when it crosses an edge one of them tests*/
+	static CAreaObjectiveCondition *s_areas[MAX_OBJECTIVE_AREAS];
+	static int s_numAreas;
+	static int s_numUnwatchedAreas;
 protected:
 	float m_targetCenterX;
 	float m_targetCenterY;
 	float m_targetRadius;
 public:
-	CAreaObjectiveCondition(int alignment) : CObjectiveCondition(alignment) { m_targetCenterX = 0.0; m_targetCenterY = 0.0; m_targetRadius = 0.0; }
+	CAreaObjectiveCondition(int alignment);
+	virtual ~CAreaObjectiveCondition();
+	static bool EdgeCrossed(const Stuff::Vector3D &from, const Stuff::Vector3D &to);
 	virtual bool SetParams(float targetCenterX, float targetCenterY, float targetRadius) {
-		m_targetCenterX = targetCenterX; m_targetCenterY = targetCenterY; m_targetRadius = targetRadius; return true;
+		m_targetCenterX = targetCenterX; m_targetCenterY = targetCenterY; m_targetRadius = targetRadius; Invalidate(); return true;
 	}
 	virtual bool Read( FitIniFile* missionFile );
 	virtual bool Save( FitIniFile* file );
@@ -401,6 +435,7 @@ public:
 	CMoveAnyUnitToArea(int alignment) : CAreaObjectiveCondition(alignment) {}
 	condition_species_type Species() { return MOVE_ANY_UNIT_TO_AREA; }
 	objective_status_type Status();
+	unsigned long Triggers() { return OBJECTIVE_TRIGGER_UNITS | OBJECTIVE_TRIGGER_POSITIONS; }
 	EString Description() {
 		EString retval = "MoveAnyUnitToArea"; /* needs to be put somewhere localizable */
 		return retval;
@@ -412,6 +447,7 @@ public:
 	CMoveAllUnitsToArea(int alignment) : CAreaObjectiveCondition(alignment) {}
 	condition_species_type Species() { return MOVE_ALL_UNITS_TO_AREA; }
 	objective_status_type Status();
+	unsigned long Triggers() { return OBJECTIVE_TRIGGER_UNITS | OBJECTIVE_TRIGGER_POSITIONS; }
 	EString Description() {
 		EString retval = "MoveAllUnitsToArea"; /* needs to be put somewhere localizable */
 		return retval;
@@ -423,6 +459,7 @@ public:
 	CMoveAllSurvivingUnitsToArea(int alignment) : CAreaObjectiveCondition(alignment) {}
 	condition_species_type Species() { return MOVE_ALL_SURVIVING_UNITS_TO_AREA; }
 	objective_status_type Status();
+	unsigned long Triggers() { return OBJECTIVE_TRIGGER_UNITS | OBJECTIVE_TRIGGER_POSITIONS; }
 	EString Description() {
 		EString retval = "MoveAllSurvivingUnitsToArea"; /* needs to be put somewhere localizable */
 		return retval;
@@ -434,6 +471,7 @@ public:
 	CMoveAllSurvivingMechsToArea(int alignment) : CAreaObjectiveCondition(alignment) {}
 	condition_species_type Species() { return MOVE_ALL_SURVIVING_MECHS_TO_AREA; }
 	objective_status_type Status();
+	unsigned long Triggers() { return OBJECTIVE_TRIGGER_UNITS | OBJECTIVE_TRIGGER_POSITIONS; }
 	EString Description() {
 		EString retval = "MoveAllSurvivingMechsToArea"; /* needs to be put somewhere localizable */
 		return retval;
@@ -450,6 +488,7 @@ public:
 	bool Read( FitIniFile* missionFile );
 	bool Save( FitIniFile* file );
 	objective_status_type Status();
+	unsigned long Triggers() { return OBJECTIVE_TRIGGER_FLAGS; }
 	EString Description() {
 		EString retval = "BooleanFlagIsSet"; /* needs to be put somewhere localizable */
 		return retval;
@@ -104,6 +104,10 @@
 #include"mission.h"
 #endif
 
+#ifndef ZONEPROF_H
+#include"zoneprof.h"
+#endif
+
 #define BRIDGE_OBJTYPE				448
 #define MINE1						60
 #define MINE2						251
@@ -139,6 +143,7 @@ extern bool	renderObjects;
 extern GameObjectPtr MoverRoster[MAX_MOVER_PART_ID - MIN_MOVER_PART_ID + 1];
 extern bool MaxObjectsDrawn;
 extern bool drawOldWay;
+extern long turn;
 
 /*
 ObjectQueuePtr objectList = NULL;
@@ -150,6 +155,10 @@ ObjectQueueNodePtr weaponList = NULL;
 
 #define	VISIBLE_THRESHOLD	1
 
+#ifdef LAB_ONLY
+bool verifyObjectLookups = false;		//Check the hashed lookups against a full scan
+#endif
+
 GameObjectManagerPtr ObjectManager = NULL;
 GameObjectPtr* collisionList = NULL;
 long numCollidables = 0;
@@ -250,6 +259,31 @@ void GameObjectManager::init (void) {
 	objList = NULL;
 	collidableList = NULL;
 	numCollidables = 0;
+
+	moverLOSKnown = NULL;
+	moverLOSSeen = NULL;
+	moverLOSRowWords = 0;
+	moverLOSRowTurn = NULL;
+	moverLOSCell = NULL;
+
+	pickTurn = -1;
+	pickHandles = NULL;
+	maxPickHandles = 0;
+	staticCells = NULL;
+	numStaticCells = 0;
+	dynamicHandles = NULL;
+	numDynamicHandles = 0;
+	numLookupObjects = 0;
+	lookupBucketMask = 0;
+	partIdBuckets = NULL;
+	partIdNext = NULL;
+	partIdKeys = NULL;
+	typeHandleBuckets = NULL;
+	typeHandleNext = NULL;
+	typeHandleKeys = NULL;
+	tickPositions = NULL;
+	numTickPositions = 0;
+	maxTickPositions = 0;
 	numGoodMovers = 0;
 	numBadMovers = 0;
 	numMovers = 0;
@@ -487,9 +521,8 @@ void GameObjectManager::setNumObjects (long nMechs,
 	}
 
 	useMoverLineOfSightTable = true;
-	moverLineOfSightTable = (char*)systemHeap->Malloc(maxMovers * maxMovers);
-	if (!moverLineOfSightTable)
-		Fatal(numGates, " GameObjectManager.setNumObjects: cannot malloc moverLineOfSightTable ");
+	initMoverLOSCache();
+	destroyObjectIndices();
 
 	GameObject::setInitialize(false);
 }
@@ -602,6 +635,7 @@ void GameObjectManager::freeMover (MoverPtr mover) {
 		mover->setExists(false);
 		mover->setFlag(OBJECT_FLAG_REMOVED, true);
 		mover->setPartId(0);
+		indexObject(mover);
 		watchList[mover->watchID] = NULL;
 		mover->watchID = 0;
 	}
@@ -628,6 +662,7 @@ void GameObjectManager::tradeMover (MoverPtr mover, long newTeamID, long newComm
 		Team::teams[newTeamID]->addToRoster(mover);
 	mover->setCommanderId(newCommanderID);
 	modifyMoverLists(mover, MOVERLIST_TRADE);
+	indexObject(mover);
 }
 
 //---------------------------------------------------------------------------
@@ -1390,8 +1425,8 @@ void GameObjectManager::destroy (void)
 	delete collisionSystem;
 	collisionSystem = NULL;
 
-	systemHeap->Free(moverLineOfSightTable);
-	moverLineOfSightTable = NULL;
+	destroyMoverLOSCache();
+	destroyObjectIndices();
 }
 
 //---------------------------------------------------------------------------
@@ -1630,45 +1665,24 @@ void GameObjectManager::renderShadows (bool terrain, bool movers, bool other) {
 
 //---------------------------------------------------------------------------
 #ifdef LAB_ONLY
-extern __int64 MCTimeTerrainObjectsUpdate;
-extern __int64 MCTimeMechsUpdate;
-extern __int64 MCTimeVehiclesUpdate;
-extern __int64 MCTimeTurretsUpdate;
-
-extern __int64 MCTimeTerrainObjectsTL;
-extern __int64 MCTimeMechsTL;
-extern __int64 MCTimeVehiclesTL;
-extern __int64 MCTimeTurretsTL;
-
-extern __int64 MCTimeAllElseUpdate;
-__int64 MCTimeCaptureListUpdate		= 0;
-extern __int64 MCTimeTransformandLight;
-extern __int64 MCTimeAnimationandMatrix;
-extern __int64 MCTimePerShapeTransform;
-
 unsigned long bldgCount = 0;
 #endif
 
 void GameObjectManager::update (bool terrain, bool movers, bool other) 
 {
+	//-------------------------------------------------
+	// Everyone's about to figure out if they're on
+	// screen again, so the pick index is no good.
+	pickTurn = -1;
+
 	//----------------------------
 	// Now, update game objects...
-	#ifdef LAB_ONLY
-	__int64 x;
-	x=GetCycles();
-	#endif
-	
-	updateCaptureList();
-	
-	#ifdef LAB_ONLY
-	x=GetCycles()-x;
-	MCTimeCaptureListUpdate = x;
-	
-	x=GetCycles(); 
-	#endif
+	PROFILE_CALL("Capture List Update", updateCaptureList());
 	
  	if (terrain && renderObjects) 
 	{
+		PROFILE_ZONE("TerrainObject Update");
+
 		#ifdef LAB_ONLY
 		bldgCount = 0;
 		#endif
@@ -1681,9 +1695,6 @@ void GameObjectManager::update (bool terrain, bool movers, bool other)
 			{
 			#ifdef LAB_ONLY
 				bldgCount++;
-				MCTimeAnimationandMatrix =
-				MCTimePerShapeTransform =
-				MCTimeTransformandLight = 0;
 			#endif
 				if (!specialBuildings[spBuilding]->update()) 
 				{
@@ -1691,9 +1702,6 @@ void GameObjectManager::update (bool terrain, bool movers, bool other)
 					// Update failed, so it no longer exists...
 					specialBuildings[spBuilding]->setExists(false);
 				}
-			#ifdef LAB_ONLY
-				MCTimeTerrainObjectsTL += MCTimeTransformandLight;
-			#endif
 			}
 		}
 
@@ -1706,9 +1714,6 @@ void GameObjectManager::update (bool terrain, bool movers, bool other)
 			{
 			#ifdef LAB_ONLY
 				bldgCount++;
-				MCTimeAnimationandMatrix =
-				MCTimePerShapeTransform =
-				MCTimeTransformandLight = 0;
 			#endif
 				if (!gates[nGates]->update()) 
 				{
@@ -1716,9 +1721,6 @@ void GameObjectManager::update (bool terrain, bool movers, bool other)
 					// Update failed, so it no longer exists...
 					gates[nGates]->setExists(false);
 				}
-			#ifdef LAB_ONLY
-				MCTimeTerrainObjectsTL += MCTimeTransformandLight;
-			#endif
 			}
 		}
 		
@@ -1736,10 +1738,6 @@ void GameObjectManager::update (bool terrain, bool movers, bool other)
 					{
 			#ifdef LAB_ONLY
 				bldgCount++;
-				
-				MCTimeAnimationandMatrix =
-				MCTimePerShapeTransform =
-				MCTimeTransformandLight = 0;
 			#endif
 						
 						if (!objList[objIndex]->update()) 
@@ -1748,86 +1746,49 @@ void GameObjectManager::update (bool terrain, bool movers, bool other)
 							// Update failed, so it no longer exists...
 							objList[objIndex]->setExists(false);
 						}
-						
-			#ifdef LAB_ONLY
-				MCTimeTerrainObjectsTL += MCTimeTransformandLight;
-			#endif
 					}
 				}
 			}
 		}
 	}
-
-	#ifdef LAB_ONLY
-	x=GetCycles()-x;
-	MCTimeTerrainObjectsUpdate = x;
-	#endif
 	
  	if (movers) {
 		static MoverPtr removeList[MAX_MOVERS];
 		long numRemoved = 0;
 		
-		#ifdef LAB_ONLY
-		x=GetCycles();
-		#endif
-		
 		if (mechs)
 		{
+			PROFILE_ZONE("Mech Update");
+
 			for (long i = 0; i < numMechs; i++) 
 			{
 				MoverPtr mover = mechs[i];
 				if (mover && mover->getExists()) 
 				{
-			#ifdef LAB_ONLY
-				MCTimeAnimationandMatrix =
-				MCTimePerShapeTransform =
-				MCTimeTransformandLight = 0;
-			#endif
 					if (!mover->update())
 						mover->setExists(false);
-			#ifdef LAB_ONLY
-				MCTimeMechsTL += MCTimeTransformandLight;
-			#endif
 					if (mover->getFlag(OBJECT_FLAG_REMOVED))
 						removeList[numRemoved++] = mover;
 				}
 			}
 		}
-
-		#ifdef LAB_ONLY
-		x=GetCycles()-x;
-		MCTimeMechsUpdate = x;
-		
-		x=GetCycles(); 
-		#endif
 	
 		if (vehicles)
 		{
+			PROFILE_ZONE("Vehicle Update");
+
 			for (long i = 0; i < maxVehicles; i++) 
 			{
 				MoverPtr mover = vehicles[i];
 				if (mover && mover->getExists()) 
 				{
-			#ifdef LAB_ONLY
-				MCTimeAnimationandMatrix =
-				MCTimePerShapeTransform =
-				MCTimeTransformandLight = 0;
-			#endif
 					if (!mover->update())
 						mover->setExists(false);
-			#ifdef LAB_ONLY
-				MCTimeVehiclesTL += MCTimeTransformandLight;
-			#endif
 					if (mover->getFlag(OBJECT_FLAG_REMOVED))
 						removeList[numRemoved++] = mover;
 				}
 			}
 		}
-			
-		#ifdef LAB_ONLY
-		x=GetCycles()-x;
-		MCTimeVehiclesUpdate = x;
-		#endif
 		
 		for (long i = 0; i < numRemoved; i++)
 			mission->removeMover(removeList[i]);
@@ -1836,38 +1797,22 @@ void GameObjectManager::update (bool terrain, bool movers, bool other)
 	if (other) {
 		//---------------------------------------
 		// All other objects should be updated...
-		#ifdef LAB_ONLY
-		__int64 x;
-		x=GetCycles();
-		#endif
-	
 		if (turrets) 
 		{
+			PROFILE_ZONE("Turret Update");
+
 			for (long i=0;i<numTurrets;i++) 
 			{
 				if (turrets[i] && turrets[i]->getExists()) 
 				{
-			#ifdef LAB_ONLY
-				MCTimeAnimationandMatrix =
-				MCTimePerShapeTransform =
-				MCTimeTransformandLight = 0;
-			#endif
 					if (!turrets[i]->update())
 						turrets[i]->setExists(false);
-			#ifdef LAB_ONLY
-				MCTimeTurretsTL += MCTimeTransformandLight;
-			#endif
 				}
 			}
 		}
 		
-		#ifdef LAB_ONLY
-		x=GetCycles()-x;
-		MCTimeTurretsUpdate = x;
-		
-		x=GetCycles(); 
-		#endif
-		
+		PROFILE_BEGIN("Everything else Update");
+
 		if (weapons) {
 			for (long i=0;i<numWeapons;i++) {
 				if (weapons[i] && weapons[i]->getExists()) {
@@ -1904,10 +1849,7 @@ void GameObjectManager::update (bool terrain, bool movers, bool other)
 			}
 		}
 		
-		#ifdef LAB_ONLY
-		x=GetCycles()-x;
-		MCTimeAllElseUpdate = x;
-		#endif
+		PROFILE_END("Everything else Update");
 	}
 }
 
@@ -1923,8 +1865,117 @@ GameObjectPtr GameObjectManager::get (GameObjectHandle handle) {
 
 //---------------------------------------------------------------------------
 
+void GameObjectManager::initMoverLOSCache (void) {
+
+	//---------------------------------------------------------
+	// Mover handles run from 1 thru maxMovers, so size for both...
+	moverLOSRowWords = (maxMovers + 1 + 31) >> 5;
+	long numWords = (maxMovers + 1) * moverLOSRowWords;
+
+	moverLOSKnown = (unsigned int*)systemHeap->Malloc(sizeof(unsigned int) * numWords);
+	if (!moverLOSKnown)
+		Fatal(maxMovers, " GameObjectManager.initMoverLOSCache: cannot malloc moverLOSKnown ");
+	memset(moverLOSKnown, 0, sizeof(unsigned int) * numWords);
+
+	moverLOSSeen = (unsigned int*)systemHeap->Malloc(sizeof(unsigned int) * numWords);
+	if (!moverLOSSeen)
+		Fatal(maxMovers, " GameObjectManager.initMoverLOSCache: cannot malloc moverLOSSeen ");
+	memset(moverLOSSeen, 0, sizeof(unsigned int) * numWords);
+
+	moverLOSRowTurn = (long*)systemHeap->Malloc(sizeof(long) * (maxMovers + 1));
+	if (!moverLOSRowTurn)
+		Fatal(maxMovers, " GameObjectManager.initMoverLOSCache: cannot malloc moverLOSRowTurn ");
+	moverLOSCell = (short*)systemHeap->Malloc(sizeof(short) * 2 * (maxMovers + 1));
+	if (!moverLOSCell)
+		Fatal(maxMovers, " GameObjectManager.initMoverLOSCache: cannot malloc moverLOSCell ");
+	for (long i = 0; i <= maxMovers; i++) {
+		moverLOSRowTurn[i] = 0;
+		moverLOSCell[i * 2] = -1;
+		moverLOSCell[i * 2 + 1] = -1;
+	}
+}
+
+//---------------------------------------------------------------------------
+
+void GameObjectManager::destroyMoverLOSCache (void) {
+
+	if (moverLOSKnown) {
+		systemHeap->Free(moverLOSKnown);
+		moverLOSKnown = NULL;
+	}
+	if (moverLOSSeen) {
+		systemHeap->Free(moverLOSSeen);
+		moverLOSSeen = NULL;
+	}
+	if (moverLOSRowTurn) {
+		systemHeap->Free(moverLOSRowTurn);
+		moverLOSRowTurn = NULL;
+	}
+	if (moverLOSCell) {
+		systemHeap->Free(moverLOSCell);
+		moverLOSCell = NULL;
+	}
+	moverLOSRowWords = 0;
+}
+
+//---------------------------------------------------------------------------
+
+void GameObjectManager::clearMoverLOSRow (long viewer) {
+
+	memset(&moverLOSKnown[viewer * moverLOSRowWords], 0, sizeof(unsigned int) * moverLOSRowWords);
+	moverLOSRowTurn[viewer] = turn;
+}
+
+//---------------------------------------------------------------------------
+
+void GameObjectManager::clearMoverLOSColumn (long target) {
+
+	long word = target >> 5;
+	unsigned int mask = ~(1u << (target & 31));
+	for (long i = 0; i <= maxMovers; i++)
+		moverLOSKnown[i * moverLOSRowWords + word] &= mask;
+}
+
+//---------------------------------------------------------------------------
+
+void GameObjectManager::updateMoverLOSCache (void) {
+
+	if (!moverLOSKnown)
+		return;
+
+	//--------------------------------------------------------------------
+	// Rows age out on their own stamps, so they don't all go at once. LOS
+	// only depends on where the two movers are, so anyone who has moved
+	// more than a cell since their entries were figured starts over...
+	for (long i = 0; i < numMovers; i++) {
+		MoverPtr mover = moverList[i];
+		if (!mover)
+			continue;
+		long handle = mover->getHandle();
+		if ((handle < 1) || (handle > maxMovers))
+			continue;
+		int cellRow, cellCol;
+		mover->getCellPosition(cellRow, cellCol);
+		short* lastCell = &moverLOSCell[handle * 2];
+		if ((lastCell[0] < 0) || (abs(cellRow - lastCell[0]) > 1) || (abs(cellCol - lastCell[1]) > 1)) {
+			clearMoverLOSRow(handle);
+			clearMoverLOSColumn(handle);
+			lastCell[0] = (short)cellRow;
+			lastCell[1] = (short)cellCol;
+			}
+		else if ((turn - moverLOSRowTurn[handle]) >= MOVER_LOS_CACHE_TURNS)
+			clearMoverLOSRow(handle);
+	}
+}
+
+//---------------------------------------------------------------------------
+
 long GameObjectManager::buildMoverLists (void) {
 
+	//-------------------------------------------------------------
+	// Objectives cache their results against the mover list, too.
+	GameObject::statusChanges++;
+
 	numMovers = 0;
 	numGoodMovers = 0;
 	numBadMovers = 0;
@@ -1958,6 +2009,8 @@ long GameObjectManager::buildMoverLists (void) {
 
 bool GameObjectManager::modifyMoverLists (MoverPtr mover, long action) {
 
+	GameObject::statusChanges++;
+
 	switch (action) {
 		case MOVERLIST_DELETE: {
 			bool foundIt = false;
@@ -2079,18 +2132,91 @@ GameObjectPtr GameObjectManager::findObject (Stuff::Vector3D position) {
 
 //---------------------------------------------------------------------------
 
+static inline long lookupBucket (long key, long mask) {
+
+	unsigned long hash = (unsigned long)key;
+	hash ^= (hash >> 16);
+	hash *= 0x45d9f3b;
+	hash ^= (hash >> 16);
+	return(long(hash & mask));
+}
+
+//---------------------------------------------------------------------------
+
+static void linkLookup (long* buckets, long* next, long bucket, long objIndex) {
+
+	//-------------------------------------------
+	// Keep the chain in ascending handle order...
+	long* link = &buckets[bucket];
+	while (*link && (*link < objIndex))
+		link = &next[*link];
+	next[objIndex] = *link;
+	*link = objIndex;
+}
+
+//---------------------------------------------------------------------------
+
+static void unlinkLookup (long* buckets, long* next, long bucket, long objIndex) {
+
+	long* link = &buckets[bucket];
+	while (*link && (*link != objIndex))
+		link = &next[*link];
+	if (*link)
+		*link = next[objIndex];
+	next[objIndex] = 0;
+}
+
+//---------------------------------------------------------------------------
+
 GameObjectPtr GameObjectManager::findObjectByTypeHandle (long typeHandle) {
 
 	//-------------------------------------------------
 	// This function was called findObjectId() in MC...
 
-	long numObjects = getMaxObjects();
-	for (long objIndex = 1; objIndex <= numObjects; objIndex++) {
+	if (!partIdBuckets)
+		buildLookupIndex();
+
+	GameObjectPtr result = NULL;
+	long objIndex = typeHandleBuckets[lookupBucket(typeHandle, lookupBucketMask)];
+	while (objIndex) {
 		GameObjectPtr obj = objList[objIndex];
-		if (obj->getExists() && (obj->getTypeHandle() == typeHandle))
-			return(obj);
+		if (obj->getExists() && (obj->getTypeHandle() == typeHandle)) {
+			result = obj;
+			break;
+		}
+		objIndex = typeHandleNext[objIndex];
 	}
-	return(NULL);
+
+	//--------------------------------------------------------------
+	// Weapons, carnage and artillery aren't indexed (they change
+	// type with every shot), but their handles come after everything
+	// that is, so checking them last keeps the old scan order...
+	if (!result) {
+		long numObjects = getMaxObjects();
+		for (objIndex = numLookupObjects + 1; objIndex <= numObjects; objIndex++) {
+			GameObjectPtr obj = objList[objIndex];
+			if (obj && obj->getExists() && (obj->getTypeHandle() == typeHandle)) {
+				result = obj;
+				break;
+			}
+		}
+	}
+
+#ifdef LAB_ONLY
+	if (verifyObjectLookups) {
+		GameObjectPtr slowResult = NULL;
+		long numObjects = getMaxObjects();
+		for (long i = 1; i <= numObjects; i++)
+			if (objList[i] && objList[i]->getExists() && (objList[i]->getTypeHandle() == typeHandle)) {
+				slowResult = objList[i];
+				break;
+			}
+		if (slowResult != result)
+			PAUSE(("Type handle lookup mismatch for type %d",typeHandle));
+	}
+#endif
+
+	return(result);
 }
 
 //---------------------------------------------------------------------------
@@ -2100,14 +2226,42 @@ GameObjectPtr GameObjectManager::findByPartId (long partId) {
 	if (partId == 0)
 		return(NULL);
 
-	long numObjects = getMaxObjects();
-	for (long objIndex = 1; objIndex <= numObjects; objIndex++) 
+	//--------------------------------------------------------
+	// Weapons, carnage and artillery always have a part id of
+	// zero, so the index covers everything we can find...
+	if (!partIdBuckets)
+		buildLookupIndex();
+
+	GameObjectPtr result = NULL;
+	long objIndex = partIdBuckets[lookupBucket(partId, lookupBucketMask)];
+	while (objIndex) 
 	{
 		GameObjectPtr obj = objList[objIndex];
-		if (obj && obj->getExists() && (obj->getPartId() == partId))
-			return(obj);
+		if (obj->getExists() && (obj->getPartId() == partId))
+		{
+			result = obj;
+			break;
+		}
+		objIndex = partIdNext[objIndex];
 	}
-	return(NULL);
+
+#ifdef LAB_ONLY
+	if (verifyObjectLookups)
+	{
+		GameObjectPtr slowResult = NULL;
+		long numObjects = getMaxObjects();
+		for (long i = 1; i <= numObjects; i++)
+			if (objList[i] && objList[i]->getExists() && (objList[i]->getPartId() == partId))
+			{
+				slowResult = objList[i];
+				break;
+			}
+		if (slowResult != result)
+			PAUSE(("Part id lookup mismatch for part %d",partId));
+	}
+#endif
+
+	return(result);
 }
 
 //---------------------------------------------------------------------------
@@ -2126,19 +2280,60 @@ GameObjectPtr GameObjectManager::findByCellPosition (long row, long col)
 {
 	//-------------------------------------------------------------------------------------
 	// Must implement for Linkage code.  10/20/99 -fs
-	// PLEASE DO NOT CALL EVERY FRAME. THIS ONE WILL BE SLOWER THEN CHRISTMAS!!!!!!!!!!!!
-	// Store the pointer if at all possible.  YOU HAVE BEEN WARNED!
-	long numObjects = getMaxObjects();
-	for (long objIndex = 1; objIndex <= numObjects; objIndex++)
+	// Static objects are looked up in the cell index.  Anything that moves still
+	// gets checked by hand, so the first one in handle order wins like it always has.
+	if (!staticCells)
+		buildCellIndex();
+
+	unsigned long cell = ((unsigned long)row << 16) | ((unsigned long)col & 0x0000ffff);
+
+	//------------------------------------
+	// Find the first static in this cell.
+	long lo = 0;
+	long hi = numStaticCells;
+	while (lo < hi)
 	{
+		long mid = (lo + hi) >> 1;
+		if (staticCells[mid].cell < cell)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	long curStatic = lo;
+	long curDynamic = 0;
+	while (true)
+	{
+		long staticHandle = 0x7fffffff;
+		if ((curStatic < numStaticCells) && (staticCells[curStatic].cell == cell))
+			staticHandle = staticCells[curStatic].handle;
+
+		long dynamicHandle = 0x7fffffff;
+		if (curDynamic < numDynamicHandles)
+			dynamicHandle = dynamicHandles[curDynamic];
+
+		long objIndex;
+		if (staticHandle < dynamicHandle)
+		{
+			objIndex = staticHandle;
+			curStatic++;
+		}
+		else if (dynamicHandle != 0x7fffffff)
+		{
+			objIndex = dynamicHandle;
+			curDynamic++;
+		}
+		else
+			break;
+
 		GameObjectPtr obj = objList[objIndex];
-		if (obj->getExists())
+		if (obj && obj->getExists())
 		{
 			int cellR, cellC;
-			objList[objIndex]->getCellPosition(cellR,cellC);
+			obj->getCellPosition(cellR,cellC);
 
 			if ((cellR == row) && (cellC == col))
-				return objList[objIndex];
+				return obj;
 		}
 	}
 
@@ -2147,6 +2342,247 @@ GameObjectPtr GameObjectManager::findByCellPosition (long row, long col)
 
 //---------------------------------------------------------------------------
 
+static int compareObjectCells (const void* elem1, const void* elem2)
+{
+	const ObjectCellRec* rec1 = (const ObjectCellRec*)elem1;
+	const ObjectCellRec* rec2 = (const ObjectCellRec*)elem2;
+
+	if (rec1->cell != rec2->cell)
+		return((rec1->cell < rec2->cell) ? -1 : 1);
+	return(rec1->handle - rec2->handle);
+}
+
+//---------------------------------------------------------------------------
+
+void GameObjectManager::buildCellIndex (void)
+{
+	long numObjects = getMaxObjects();
+
+	//--------------------------------------------------------
+	// Mark which handles belong to things that never move...
+	bool* isStatic = (bool*)systemHeap->Malloc(sizeof(bool) * (numObjects + 1));
+	if (!isStatic)
+		Fatal(numObjects, " GameObjectManager.buildCellIndex: cannot malloc isStatic ");
+	memset(isStatic, 0, sizeof(bool) * (numObjects + 1));
+
+	long numStatic = 0;
+	for (long i = 0; i < numTerrainObjects; i++)
+		if (terrainObjects && terrainObjects[i] && (terrainObjects[i]->getHandle() > 0) && (terrainObjects[i]->getHandle() <= numObjects))
+			isStatic[terrainObjects[i]->getHandle()] = true;
+	for (long i = 0; i < numBuildings; i++)
+		if (buildings && buildings[i] && (buildings[i]->getHandle() > 0) && (buildings[i]->getHandle() <= numObjects))
+			isStatic[buildings[i]->getHandle()] = true;
+	for (long i = 0; i < numTurrets; i++)
+		if (turrets && turrets[i] && (turrets[i]->getHandle() > 0) && (turrets[i]->getHandle() <= numObjects))
+			isStatic[turrets[i]->getHandle()] = true;
+	for (long i = 0; i < numGates; i++)
+		if (gates && gates[i] && (gates[i]->getHandle() > 0) && (gates[i]->getHandle() <= numObjects))
+			isStatic[gates[i]->getHandle()] = true;
+
+	for (long objIndex = 1; objIndex <= numObjects; objIndex++)
+		if (isStatic[objIndex] && (objList[objIndex] == NULL))
+			isStatic[objIndex] = false;
+		else if (isStatic[objIndex])
+			numStatic++;
+
+	staticCells = (ObjectCellRec*)systemHeap->Malloc(sizeof(ObjectCellRec) * (numStatic + 1));
+	if (!staticCells)
+		Fatal(numStatic, " GameObjectManager.buildCellIndex: cannot malloc staticCells ");
+	dynamicHandles = (long*)systemHeap->Malloc(sizeof(long) * (numObjects - numStatic + 1));
+	if (!dynamicHandles)
+		Fatal(numObjects, " GameObjectManager.buildCellIndex: cannot malloc dynamicHandles ");
+
+	numStaticCells = 0;
+	numDynamicHandles = 0;
+	for (long objIndex = 1; objIndex <= numObjects; objIndex++)
+	{
+		if (isStatic[objIndex])
+		{
+			int cellR, cellC;
+			objList[objIndex]->getCellPosition(cellR,cellC);
+			staticCells[numStaticCells].cell = ((unsigned long)cellR << 16) | ((unsigned long)cellC & 0x0000ffff);
+			staticCells[numStaticCells].handle = objIndex;
+			numStaticCells++;
+		}
+		else
+			dynamicHandles[numDynamicHandles++] = objIndex;
+	}
+
+	qsort(staticCells, numStaticCells, sizeof(ObjectCellRec), compareObjectCells);
+
+	systemHeap->Free(isStatic);
+}
+
+//---------------------------------------------------------------------------
+
+void GameObjectManager::destroyObjectIndices (void)
+{
+	if (pickHandles)
+	{
+		systemHeap->Free(pickHandles);
+		pickHandles = NULL;
+	}
+	maxPickHandles = 0;
+	pickTurn = -1;
+
+	if (staticCells)
+	{
+		systemHeap->Free(staticCells);
+		staticCells = NULL;
+	}
+	numStaticCells = 0;
+
+	if (dynamicHandles)
+	{
+		systemHeap->Free(dynamicHandles);
+		dynamicHandles = NULL;
+	}
+	numDynamicHandles = 0;
+
+	if (partIdBuckets)
+	{
+		systemHeap->Free(partIdBuckets);
+		partIdBuckets = NULL;
+	}
+	if (partIdNext)
+	{
+		systemHeap->Free(partIdNext);
+		partIdNext = NULL;
+	}
+	if (typeHandleBuckets)
+	{
+		systemHeap->Free(typeHandleBuckets);
+		typeHandleBuckets = NULL;
+	}
+	if (typeHandleNext)
+	{
+		systemHeap->Free(typeHandleNext);
+		typeHandleNext = NULL;
+	}
+	if (partIdKeys)
+	{
+		systemHeap->Free(partIdKeys);
+		partIdKeys = NULL;
+	}
+	if (typeHandleKeys)
+	{
+		systemHeap->Free(typeHandleKeys);
+		typeHandleKeys = NULL;
+	}
+	lookupBucketMask = 0;
+	numLookupObjects = 0;
+
+	if (tickPositions)
+	{
+		systemHeap->Free(tickPositions);
+		tickPositions = NULL;
+	}
+	numTickPositions = 0;
+	maxTickPositions = 0;
+}
+
+//---------------------------------------------------------------------------
+
+void GameObjectManager::buildLookupIndex (void)
+{
+	//--------------------------------------------------------------
+	// Same handle order setNumObjects hands them out in, everything
+	// but weapons, carnage and artillery...
+	long numObjects = maxMechs + maxVehicles + numElementals + numTerrainObjects +
+					  numBuildings + numTurrets + numGates;
+
+	if (!partIdBuckets)
+	{
+		long numBuckets = 64;
+		while (numBuckets < (numObjects + 1) * 2)
+			numBuckets <<= 1;
+		lookupBucketMask = numBuckets - 1;
+
+		partIdBuckets = (long*)systemHeap->Malloc(sizeof(long) * numBuckets);
+		if (!partIdBuckets)
+			Fatal(numBuckets, " GameObjectManager.buildLookupIndex: cannot malloc partIdBuckets ");
+		typeHandleBuckets = (long*)systemHeap->Malloc(sizeof(long) * numBuckets);
+		if (!typeHandleBuckets)
+			Fatal(numBuckets, " GameObjectManager.buildLookupIndex: cannot malloc typeHandleBuckets ");
+		partIdNext = (long*)systemHeap->Malloc(sizeof(long) * (numObjects + 1));
+		if (!partIdNext)
+			Fatal(numObjects, " GameObjectManager.buildLookupIndex: cannot malloc partIdNext ");
+		typeHandleNext = (long*)systemHeap->Malloc(sizeof(long) * (numObjects + 1));
+		if (!typeHandleNext)
+			Fatal(numObjects, " GameObjectManager.buildLookupIndex: cannot malloc typeHandleNext ");
+		partIdKeys = (long*)systemHeap->Malloc(sizeof(long) * (numObjects + 1));
+		if (!partIdKeys)
+			Fatal(numObjects, " GameObjectManager.buildLookupIndex: cannot malloc partIdKeys ");
+		typeHandleKeys = (long*)systemHeap->Malloc(sizeof(long) * (numObjects + 1));
+		if (!typeHandleKeys)
+			Fatal(numObjects, " GameObjectManager.buildLookupIndex: cannot malloc typeHandleKeys ");
+		numLookupObjects = numObjects;
+	}
+	numObjects = numLookupObjects;
+
+	for (long i = 0; i <= lookupBucketMask; i++)
+	{
+		partIdBuckets[i] = 0;
+		typeHandleBuckets[i] = 0;
+	}
+
+	//-----------------------------------------------------------
+	// Push from the top down so every chain runs in handle order.
+	// Handle 0 is never an object, so it ends a chain.
+	for (long objIndex = numObjects; objIndex > 0; objIndex--)
+	{
+		partIdNext[objIndex] = 0;
+		typeHandleNext[objIndex] = 0;
+		partIdKeys[objIndex] = 0;
+		typeHandleKeys[objIndex] = 0;
+
+		GameObjectPtr obj = objList[objIndex];
+		if (!obj)
+			continue;
+
+		partIdKeys[objIndex] = obj->getPartId();
+		long bucket = lookupBucket(partIdKeys[objIndex], lookupBucketMask);
+		partIdNext[objIndex] = partIdBuckets[bucket];
+		partIdBuckets[bucket] = objIndex;
+
+		typeHandleKeys[objIndex] = obj->getTypeHandle();
+		bucket = lookupBucket(typeHandleKeys[objIndex], lookupBucketMask);
+		typeHandleNext[objIndex] = typeHandleBuckets[bucket];
+		typeHandleBuckets[bucket] = objIndex;
+	}
+}
+
+//---------------------------------------------------------------------------
+
+void GameObjectManager::indexObject (GameObjectPtr obj)
+{
+	//-------------------------------------------------------------
+	// Refile one object after its part id or type handle changed.
+	// Nothing to do until the first lookup builds the tables...
+	if (!partIdBuckets)
+		return;
+
+	long objIndex = obj->getHandle();
+	if ((objIndex < 1) || (objIndex > numLookupObjects) || (objList[objIndex] != obj))
+		return;
+
+	if (partIdKeys[objIndex] != obj->getPartId())
+	{
+		unlinkLookup(partIdBuckets, partIdNext, lookupBucket(partIdKeys[objIndex], lookupBucketMask), objIndex);
+		partIdKeys[objIndex] = obj->getPartId();
+		linkLookup(partIdBuckets, partIdNext, lookupBucket(partIdKeys[objIndex], lookupBucketMask), objIndex);
+	}
+
+	if (typeHandleKeys[objIndex] != obj->getTypeHandle())
+	{
+		unlinkLookup(typeHandleBuckets, typeHandleNext, lookupBucket(typeHandleKeys[objIndex], lookupBucketMask), objIndex);
+		typeHandleKeys[objIndex] = obj->getTypeHandle();
+		linkLookup(typeHandleBuckets, typeHandleNext, lookupBucket(typeHandleKeys[objIndex], lookupBucketMask), objIndex);
+	}
+}
+
+//---------------------------------------------------------------------------
+
 GameObjectPtr GameObjectManager::findByUnitInfo (long commander, long group, long mate) {
 
 	//----------------------------------------
@@ -2157,64 +2593,262 @@ GameObjectPtr GameObjectManager::findByUnitInfo (long commander, long group, lon
 
 //---------------------------------------------------------------------------
 
-GameObjectPtr GameObjectManager::findObjectByMouse (long mouseX,
-													long mouseY,
-													GameObjectPtr* searchList,
-													long listSize,
-													bool skipDisabled) {
+bool GameObjectManager::objectUnderMouse (GameObjectPtr obj, long mouseX, long mouseY, bool skipDisabled) {
 
-	if (!searchList)
-		Fatal(0, " GameObjectManager.findObjectByMouse: NULL searchList ");
+	if (obj && obj->getExists()) 
+	{
+		AppearancePtr objAppearance = obj->getAppearance();
+		if (objAppearance && objAppearance->canBeSeen()) 
+		{
+			if (obj->getWindowsVisible() == (turn - VISIBLE_THRESHOLD))
+			{
+				//-----------------------------------------------------
+				float tlx = objAppearance->upperLeft.x;
+				float tly = objAppearance->upperLeft.y;
+				float brx = objAppearance->lowerRight.x;
+				float bry = objAppearance->lowerRight.y;
+					
+				if ((mouseX >= tlx) && 
+					(mouseX <= brx) &&
+					(mouseY >= tly) &&
+					(mouseY <= bry)) 
+				{
+					//---------------------------
+					// We're on it, so save it...
+					if (!obj->isMover() || (obj->isMover() && obj->isOnGUI() && Terrain::IsGameSelectTerrainPosition(obj->getPosition())))
+					{
+						if (skipDisabled) 
+						{
+							if (!obj->isDisabled() && 
+								(obj->getObjectClass() != TREE) && 
+								(obj->getDamageLevel() != 36000000) && 				//We are a rock clump
+								objAppearance->PerPolySelect(mouseX, mouseY))
+								return(true);
+						}
+						else
+						{
+							//Do not target trees or artillery strikes!!
+							if ((obj->getObjectClass() != TREE) && 
+								(obj->getObjectClass() != ARTILLERY) &&
+								(obj->getDamageLevel() != 36000000) && 				//We are a rock clump
+								objAppearance->PerPolySelect(mouseX, mouseY))
+								return(true);
+						}
+					}
+				}
+			}
+		}
+	}
 
-	for (long objIndex = 0; objIndex < listSize; objIndex++) 
+	return(false);
+}
+
+//---------------------------------------------------------------------------
+
+bool GameObjectManager::moverUnderMouse (GameObjectPtr obj, long mouseX, long mouseY, long commanderId, bool skipDisabled) {
+
+	if (obj && obj->getExists()) 
 	{
-		if (searchList[objIndex] && searchList[objIndex]->getExists()) 
+		if ((commanderId != -1) && (obj->getCommanderId() == commanderId))
+			return(false);
+		AppearancePtr objAppearance = obj->getAppearance();
+		if (objAppearance && objAppearance->canBeSeen()) 
 		{
-			GameObjectPtr obj = searchList[objIndex];
-			Assert(obj != NULL, objIndex, " GameObjectManager.findObjectByMouse: NULL obj ");
-			AppearancePtr objAppearance = obj->getAppearance();
-			if (objAppearance && objAppearance->canBeSeen()) 
+			if (obj->getWindowsVisible() == (turn - VISIBLE_THRESHOLD)) 
 			{
-				if (obj->getWindowsVisible() == (turn - VISIBLE_THRESHOLD))
+				//-----------------------------------------------------
+				float tlx = objAppearance->upperLeft.x;
+				float tly = objAppearance->upperLeft.y;
+				float brx = objAppearance->lowerRight.x;
+				float bry = objAppearance->lowerRight.y;
+					
+				if ((mouseX >= tlx) && 
+					(mouseX <= brx) &&
+					(mouseY >= tly) &&
+					(mouseY <= bry)) 
 				{
-					//-----------------------------------------------------
-					float tlx = objAppearance->upperLeft.x;
-					float tly = objAppearance->upperLeft.y;
-					float brx = objAppearance->lowerRight.x;
-					float bry = objAppearance->lowerRight.y;
-						
-					if ((mouseX >= tlx) && 
-						(mouseX <= brx) &&
-						(mouseY >= tly) &&
-						(mouseY <= bry)) 
+					//---------------------------
+					// We're on it, so save it...
+					// Movers are NOT per poly!!
+					if (!obj->isMover() || (obj->isMover() && obj->isOnGUI() && Terrain::IsGameSelectTerrainPosition(obj->getPosition())))
 					{
-						//---------------------------
-						// We're on it, so save it...
-						if (!obj->isMover() || (obj->isMover() && obj->isOnGUI() && Terrain::IsGameSelectTerrainPosition(obj->getPosition())))
+						if (skipDisabled) 
 						{
-							if (skipDisabled) 
-							{
-								if (!obj->isDisabled() && 
-									(obj->getObjectClass() != TREE) && 
-									(obj->getDamageLevel() != 36000000) && 				//We are a rock clump
-									objAppearance->PerPolySelect(mouseX, mouseY))
-									return(obj);
-							}
-							else
-							{
-								//Do not target trees or artillery strikes!!
-								if ((obj->getObjectClass() != TREE) && 
-									(obj->getObjectClass() != ARTILLERY) &&                                  									(obj->getDamageLevel() != 36000000) && 				//We are a rock clump
-									(obj->getDamageLevel() != 36000000) && 				//We are a rock clump
-									objAppearance->PerPolySelect(mouseX, mouseY))
-									return(obj);
-							}
+							if (!obj->isDisabled())
+								return(true);
 						}
+						else
+							return(true);
 					}
 				}
 			}
 		}
 	}
+
+	return(false);
+}
+
+//---------------------------------------------------------------------------
+
+static long pickSquareX (long x) {
+
+	long square = (x * PICK_GRID_WIDTH) / Environment.screenWidth;
+	if (square < 0)
+		square = 0;
+	if (square > PICK_GRID_WIDTH - 1)
+		square = PICK_GRID_WIDTH - 1;
+	return(square);
+}
+
+static long pickSquareY (long y) {
+
+	long square = (y * PICK_GRID_HEIGHT) / Environment.screenHeight;
+	if (square < 0)
+		square = 0;
+	if (square > PICK_GRID_HEIGHT - 1)
+		square = PICK_GRID_HEIGHT - 1;
+	return(square);
+}
+
+//---------------------------------------------------------------------------
+
+static bool getPickRect (AppearancePtr objAppearance, long& left, long& top, long& right, long& bottom) {
+
+	//-----------------------------------------------------------------
+	// Whole pixels the mouse can be on and still be inside the bounds.
+	// Anything off screen (or garbage) can't be picked.
+	float tlx = objAppearance->upperLeft.x;
+	float tly = objAppearance->upperLeft.y;
+	float brx = objAppearance->lowerRight.x;
+	float bry = objAppearance->lowerRight.y;
+	if (!((tlx <= brx) && (tly <= bry)))
+		return(false);
+	if ((brx < 0.0f) || (bry < 0.0f) || (tlx >= Environment.screenWidth) || (tly >= Environment.screenHeight))
+		return(false);
+
+	left = (tlx < 0.0f) ? 0 : long(floor(tlx));
+	top = (tly < 0.0f) ? 0 : long(floor(tly));
+	right = (brx >= Environment.screenWidth) ? (Environment.screenWidth - 1) : long(floor(brx));
+	bottom = (bry >= Environment.screenHeight) ? (Environment.screenHeight - 1) : long(floor(bry));
+	return(true);
+}
+
+//---------------------------------------------------------------------------
+
+void GameObjectManager::buildPickIndex (void) {
+
+	//-----------------------------------------------------------------
+	// Only things drawn last frame can be picked, so that's all we
+	// bucket. First count what lands in each square, then fill them.
+	// Handles go in ascending, so every square stays in handle order.
+	long numSquares = PICK_GRID_WIDTH * PICK_GRID_HEIGHT;
+	for (long i = 0; i <= numSquares; i++)
+		pickBinStart[i] = 0;
+
+	long numObjects = getMaxObjects();
+	long numEntries = 0;
+	for (long objIndex = 1; objIndex <= numObjects; objIndex++) {
+		GameObjectPtr obj = objList[objIndex];
+		if (obj && obj->getExists() && (obj->getWindowsVisible() == (turn - VISIBLE_THRESHOLD))) {
+			AppearancePtr objAppearance = obj->getAppearance();
+			long left, top, right, bottom;
+			if (objAppearance && objAppearance->canBeSeen() && getPickRect(objAppearance, left, top, right, bottom)) {
+				for (long y = pickSquareY(top); y <= pickSquareY(bottom); y++)
+					for (long x = pickSquareX(left); x <= pickSquareX(right); x++) {
+						pickBinStart[y * PICK_GRID_WIDTH + x + 1]++;
+						numEntries++;
+					}
+			}
+		}
+	}
+
+	if (numEntries > maxPickHandles) {
+		if (pickHandles)
+			systemHeap->Free(pickHandles);
+		maxPickHandles = numEntries + (numEntries >> 1) + 64;
+		pickHandles = (long*)systemHeap->Malloc(sizeof(long) * maxPickHandles);
+		if (!pickHandles)
+			Fatal(maxPickHandles, " GameObjectManager.buildPickIndex: cannot malloc pickHandles ");
+	}
+
+	long squareFill[PICK_GRID_WIDTH * PICK_GRID_HEIGHT];
+	for (long i = 0; i < numSquares; i++) {
+		pickBinStart[i + 1] += pickBinStart[i];
+		squareFill[i] = pickBinStart[i];
+	}
+
+	for (long objIndex = 1; objIndex <= numObjects; objIndex++) {
+		GameObjectPtr obj = objList[objIndex];
+		if (obj && obj->getExists() && (obj->getWindowsVisible() == (turn - VISIBLE_THRESHOLD))) {
+			AppearancePtr objAppearance = obj->getAppearance();
+			long left, top, right, bottom;
+			if (objAppearance && objAppearance->canBeSeen() && getPickRect(objAppearance, left, top, right, bottom)) {
+				for (long y = pickSquareY(top); y <= pickSquareY(bottom); y++)
+					for (long x = pickSquareX(left); x <= pickSquareX(right); x++)
+						pickHandles[squareFill[y * PICK_GRID_WIDTH + x]++] = objIndex;
+			}
+		}
+	}
+
+	pickTurn = turn;
+}
+
+//---------------------------------------------------------------------------
+
+bool GameObjectManager::getPickBin (long mouseX, long mouseY, long& first, long& last) {
+
+	//-------------------------------------------------------
+	// Off screen, the caller has to look at everything.
+	if ((mouseX < 0) || (mouseY < 0) || (mouseX >= Environment.screenWidth) || (mouseY >= Environment.screenHeight))
+		return(false);
+
+	if (pickTurn != turn)
+		buildPickIndex();
+
+	long square = pickSquareY(mouseY) * PICK_GRID_WIDTH + pickSquareX(mouseX);
+	first = pickBinStart[square];
+	last = pickBinStart[square + 1];
+	return(true);
+}
+
+//---------------------------------------------------------------------------
+
+GameObjectPtr GameObjectManager::findObjectByMouse (long mouseX,
+													long mouseY,
+													GameObjectPtr* searchList,
+													long listSize,
+													bool skipDisabled) {
+
+	if (!searchList)
+		Fatal(0, " GameObjectManager.findObjectByMouse: NULL searchList ");
+
+	//----------------------------------------------------------------
+	// Searching part of the object list?  Just look in the mouse's
+	// square of the pick index, which only holds what's on screen.
+	long first, last;
+	if ((searchList >= &objList[1]) && ((searchList + listSize) <= &objList[getMaxObjects() + 1]) &&
+		getPickBin(mouseX, mouseY, first, last))
+	{
+		long firstHandle = searchList - objList;
+		long lastHandle = firstHandle + listSize;
+		for (long i = first; i < last; i++) 
+		{
+			long objIndex = pickHandles[i];
+			if (objIndex < firstHandle)
+				continue;
+			if (objIndex >= lastHandle)
+				break;
+			if (objectUnderMouse(objList[objIndex], mouseX, mouseY, skipDisabled))
+				return(objList[objIndex]);
+		}
+		return(NULL);
+	}
+
+	for (long objIndex = 0; objIndex < listSize; objIndex++) 
+	{
+		if (objectUnderMouse(searchList[objIndex], mouseX, mouseY, skipDisabled))
+			return(searchList[objIndex]);
+	}
 	
 	return(NULL);
 }
@@ -2234,89 +2868,25 @@ GameObjectPtr GameObjectManager::findMoverByMouse (long mouseX,
 	if (!searchList)
 		return(NULL);
 
-	if (commanderId == -1)
-		for (long objIndex = 0; objIndex < numMovers; objIndex++) 
-		{
-			if (searchList[objIndex] && searchList[objIndex]->getExists()) 
-			{
-				GameObjectPtr obj = searchList[objIndex];
-				Assert(obj != NULL, objIndex, " GameObjectManager.findObjectByMouse: NULL obj ");
-				AppearancePtr objAppearance = obj->getAppearance();
-				if (objAppearance && objAppearance->canBeSeen()) 
-				{
-					if (obj->getWindowsVisible() == (turn - VISIBLE_THRESHOLD)) 
-					{
-						//-----------------------------------------------------
-						float tlx = objAppearance->upperLeft.x;
-						float tly = objAppearance->upperLeft.y;
-						float brx = objAppearance->lowerRight.x;
-						float bry = objAppearance->lowerRight.y;
-							
-						if ((mouseX >= tlx) && 
-							(mouseX <= brx) &&
-							(mouseY >= tly) &&
-							(mouseY <= bry)) 
-						{
-							//---------------------------
-							// We're on it, so save it...
-							// Movers are NOT per poly!!
-							if (!obj->isMover() || (obj->isMover() && obj->isOnGUI() && Terrain::IsGameSelectTerrainPosition(obj->getPosition())))
-							{
-								if (skipDisabled) 
-								{
-									if (!obj->isDisabled())
-										return(obj);
-								}
-								else
-									return(obj);
-							}
-						}
-					}
-				}
-			}
-		}
-	else
-		for (long objIndex = 0; objIndex < numMovers; objIndex++) 
+	long first, last;
+	if (getPickBin(mouseX, mouseY, first, last))
+	{
+		for (long i = first; i < last; i++) 
 		{
-			if (searchList[objIndex] && searchList[objIndex]->getExists()) 
-			{
-				GameObjectPtr obj = searchList[objIndex];
-				Assert(obj != NULL, objIndex, " GameObjectManager.findObjectByMouse: NULL obj ");
-				if (obj->getCommanderId() == commanderId)
-					continue;
-				AppearancePtr objAppearance = obj->getAppearance();
-				if (objAppearance && objAppearance->canBeSeen()) 
-				{
-					if (obj->getWindowsVisible() == (turn - VISIBLE_THRESHOLD)) 
-					{
-						//-----------------------------------------------------
-						float tlx = objAppearance->upperLeft.x;
-						float tly = objAppearance->upperLeft.y;
-						float brx = objAppearance->lowerRight.x;
-						float bry = objAppearance->lowerRight.y;
-							
-						if ((mouseX >= tlx) && 
-							(mouseX <= brx) &&
-							(mouseY >= tly) &&
-							(mouseY <= bry)) 
-						{
-							if (!obj->isMover() || (obj->isMover() && obj->isOnGUI() && Terrain::IsGameSelectTerrainPosition(obj->getPosition())))
-							{
-								//---------------------------
-								// We're on it, so save it...
-								if (skipDisabled) 
-								{
-									if (!obj->isDisabled())
-										return(obj);
-								}
-								else
-									return(obj);
-							}
-						}
-					}
-				}
-			}
+			long objIndex = pickHandles[i];
+			if (objIndex > numMovers)
+				break;
+			if (moverUnderMouse(objList[objIndex], mouseX, mouseY, commanderId, skipDisabled))
+				return(objList[objIndex]);
 		}
+		return(NULL);
+	}
+
+	for (long objIndex = 0; objIndex < numMovers; objIndex++) 
+	{
+		if (moverUnderMouse(searchList[objIndex], mouseX, mouseY, commanderId, skipDisabled))
+			return(searchList[objIndex]);
+	}
 
 	return(NULL);
 }
@@ -2502,6 +3072,7 @@ void GameObjectManager::setPartId (GameObjectPtr obj, long param1, long param2,
 	// should we have any reason to modify or test 'em as missions are loaded.
 	long partId = calcPartId(obj->getObjectClass(), param1, param2, param3);
 	obj->setPartId(partId);
+	indexObject(obj);
 }
 
 //---------------------------------------------------------------------------
@@ -2772,8 +3343,80 @@ ArtilleryPtr GameObjectManager::createArtillery (long artilleryType, Stuff::Vect
 	return(artillery);
 }
 
+//---------------------------------------------------------------------------
+
+void GameObjectManager::saveTickPositions (void)
+{
+	if (!tickPositions)
+	{
+		maxTickPositions = maxMechs + maxVehicles;
+		if (!maxTickPositions)
+			return;
+		tickPositions = (TickPositionRec*)systemHeap->Malloc(sizeof(TickPositionRec) * maxTickPositions);
+		gosASSERT(tickPositions != NULL);
+	}
+
+	numTickPositions = 0;
+	for (long i = 0; i < numMechs; i++)
+		if (mechs[i] && mechs[i]->getExists())
+		{
+			tickPositions[numTickPositions].watchID = mechs[i]->getWatchID();
+			tickPositions[numTickPositions].position = mechs[i]->getPosition();
+			tickPositions[numTickPositions].rotation = mechs[i]->getRotation();
+			numTickPositions++;
+		}
+
+	for (long i = 0; i < numVehicles; i++)
+		if (vehicles[i] && vehicles[i]->getExists())
+		{
+			tickPositions[numTickPositions].watchID = vehicles[i]->getWatchID();
+			tickPositions[numTickPositions].position = vehicles[i]->getPosition();
+			tickPositions[numTickPositions].rotation = vehicles[i]->getRotation();
+			numTickPositions++;
+		}
+}
+
+//---------------------------------------------------------------------------
+
+void GameObjectManager::interpolateMovers (float alpha)
+{
+	//-------------------------------------------------------------------
+	// Place each mover's appearance alpha of the way from where it was at
+	// the start of the last tick to where it is now. Nothing here may
+	// advance the simulation, so the appearances see no time pass...
+	float savedFrameLength = frameLength;
+	frameLength = 0.0f;
+
+	for (long i = 0; i < numTickPositions; i++)
+	{
+		MoverPtr mover = (MoverPtr)getByWatchID(tickPositions[i].watchID);
+		if (!mover || !mover->getExists() || !mover->getAppearance())
+			continue;
+
+		Stuff::Vector3D pos;
+		pos.Lerp(tickPositions[i].position, mover->getPosition(), alpha);
+
+		float delta = mover->getRotation() - tickPositions[i].rotation;
+		if (delta > 180.0f)
+			delta -= 360.0f;
+		else if (delta < -180.0f)
+			delta += 360.0f;
+		float rot = tickPositions[i].rotation + delta * alpha;
+
+		int teamID = mover->getTeamId();
+		mover->getAppearance()->setObjectParameters(pos,rot,mover->drawFlags,teamID,Team::getRelation(teamID, Team::home->getId()));
+		mover->getAppearance()->update( false );
+	}
+
+	frameLength = savedFrameLength;
+	pickTurn = -1;
+}
+
+//---------------------------------------------------------------------------
+
 void GameObjectManager::updateAppearancesOnly( bool terrain, bool movers, bool other)
 {
+	pickTurn = -1;
 
 	if (terrain && renderObjects) 
 	{
@@ -3126,9 +3769,8 @@ long GameObjectManager::Load (PacketFilePtr file, long packetNum)
 	}
 
 	useMoverLineOfSightTable = true;
-	moverLineOfSightTable = (char*)systemHeap->Malloc(maxMovers * maxMovers);
-	if (!moverLineOfSightTable)
-		Fatal(numGates, " GameObjectManager.setNumObjects: cannot malloc moverLineOfSightTable ");
+	initMoverLOSCache();
+	destroyObjectIndices();
 
 	long curTerrObjNum = 0;
 	long curBuildingNum = 0;
@@ -3627,6 +4269,11 @@ long GameObjectManager::Load (PacketFilePtr file, long packetNum)
 	free(watchSave);
 	watchSave = NULL;
 
+	//------------------------------------------------------------
+	// Handles, part ids and type handles all came back with the
+	// objects, so file them in one go...
+	buildLookupIndex();
+
 	return packetNum;
 }
 
@@ -77,6 +77,13 @@ class PacketFile;
 
 //---------------------------------------------------------------------------
 
+#define	MOVER_LOS_CACHE_TURNS	4
+
+//---------------------------------------------------------------------------
+// Mouse picking buckets the screen into a grid of this many squares
+#define	PICK_GRID_WIDTH			16
+#define	PICK_GRID_HEIGHT		12
+
 #define	MOVERLIST_DELETE	0
 #define	MOVERLIST_ADD		1
 #define	MOVERLIST_TRADE		2
@@ -168,6 +175,17 @@ typedef struct _RemovedMoverRec {
 	int			partID;
 } RemovedMoverRec;
 
+typedef struct _ObjectCellRec {
+	unsigned long	cell;				// row << 16 | col
+	long			handle;
+} ObjectCellRec;
+
+typedef struct _TickPositionRec {
+	GameObjectWatchID	watchID;
+	Stuff::Vector3D		position;		// where the mover was when the last tick started
+	float				rotation;
+} TickPositionRec;
+
 typedef struct _ObjectManagerData
 {
 	int					maxObjects;
@@ -229,9 +247,60 @@ class GameObjectManager {
 		long					numPowerGenerators;
 		long					numSpecialBuildings;
 
-		char*					moverLineOfSightTable;
+		//-------------------------------------------------------------------
+		// Mover line of sight cache. Two bits per viewer/target pair--known
+		// and seen--a row of words per viewer, so nothing is cleared whole
+		// each frame. A viewer's row is good for MOVER_LOS_CACHE_TURNS from
+		// its stamp. A mover that strays more than a cell from where it was
+		// when its entries were figured drops its row and column...
+		unsigned int*			moverLOSKnown;
+		unsigned int*			moverLOSSeen;
+		long					moverLOSRowWords;
+		long*					moverLOSRowTurn;
+		short*					moverLOSCell;					// row, col per mover (-1 == not placed)
 		bool					useMoverLineOfSightTable;
 
+		//-------------------------------------------------------------------
+		// Mouse picking index. Whatever was on screen last frame, bucketed
+		// by its screen rectangle, in handle order within each square.
+		// Built by the first pick of a frame, dropped by the next update...
+		long					pickTurn;
+		long					pickBinStart[PICK_GRID_WIDTH * PICK_GRID_HEIGHT + 1];
+		long*					pickHandles;
+		long					maxPickHandles;
+
+		//-------------------------------------------------------------------
+		// Cell index for findByCellPosition. Buildings, turrets, gates and
+		// terrain objects never leave their cell, so they're sorted by it
+		// once. Everything else is checked by hand, in handle order...
+		ObjectCellRec*			staticCells;
+		long					numStaticCells;
+		long*					dynamicHandles;
+		long					numDynamicHandles;
+
+		//-------------------------------------------------------------------
+		// Part id and type handle hash tables over the movers and terrain
+		// objects. Weapons, carnage and artillery come after them and are
+		// never indexed. Each bucket chains handles in ascending order
+		// through the next arrays, and the key arrays remember what each
+		// handle is filed under so indexObject can refile just that one.
+		// Existence is checked when we look...
+		long					numLookupObjects;
+		long					lookupBucketMask;
+		long*					partIdBuckets;
+		long*					partIdNext;
+		long*					partIdKeys;
+		long*					typeHandleBuckets;
+		long*					typeHandleNext;
+		long*					typeHandleKeys;
+
+		//-------------------------------------------------------------------
+		// Mech and vehicle positions from the start of the last fixed step
+		// tick, so appearances can be drawn between ticks...
+		TickPositionRec*		tickPositions;
+		long					numTickPositions;
+		long					maxTickPositions;
+
 		GameObjectPtr*			objList;
 		GameObjectPtr*			collidableList;
 		MoverPtr				moverList[MAX_MOVERS];
@@ -278,6 +347,20 @@ class GameObjectManager {
 												long mouseY,
 												bool skipDisabled = false);
 
+		bool objectUnderMouse (GameObjectPtr obj, long mouseX, long mouseY, bool skipDisabled);
+
+		bool moverUnderMouse (GameObjectPtr obj, long mouseX, long mouseY, long commanderId, bool skipDisabled);
+
+		void buildPickIndex (void);
+
+		bool getPickBin (long mouseX, long mouseY, long& first, long& last);
+
+		void buildCellIndex (void);
+
+		void destroyObjectIndices (void);
+
+		void buildLookupIndex (void);
+
 		void addObject(ObjDataLoader *objData, long& objIndex, long& buildIndex, 
 			long &turretIndex, long &gateIndex, long& curCollideHandle, long& curNonCollideHandle);
 
@@ -481,6 +564,9 @@ class GameObjectManager {
 		void update (bool terrain, bool movers, bool other);
 		void updateAppearancesOnly( bool terrain, bool mover, bool other);
 
+		void saveTickPositions (void);
+		void interpolateMovers (float alpha);
+
 		GameObjectPtr get (GameObjectHandle handle);
 
 		GameObjectPtr getByWatchID (unsigned long watchID) {
@@ -489,6 +575,36 @@ class GameObjectManager {
 			return(NULL);
 		}
 
+		void initMoverLOSCache (void);
+
+		void destroyMoverLOSCache (void);
+
+		void clearMoverLOSRow (long viewer);
+
+		void clearMoverLOSColumn (long target);
+
+		void updateMoverLOSCache (void);
+
+		long getMoverLOS (long viewer, long target) {
+			//-------------------------------------------------
+			// Returns -1 if not known yet, else 0 or 1...
+			long index = viewer * moverLOSRowWords + (target >> 5);
+			unsigned int bit = 1u << (target & 31);
+			if (!(moverLOSKnown[index] & bit))
+				return(-1);
+			return((moverLOSSeen[index] & bit) ? 1 : 0);
+		}
+
+		void setMoverLOS (long viewer, long target, bool seen) {
+			long index = viewer * moverLOSRowWords + (target >> 5);
+			unsigned int bit = 1u << (target & 31);
+			moverLOSKnown[index] |= bit;
+			if (seen)
+				moverLOSSeen[index] |= bit;
+			else
+				moverLOSSeen[index] &= ~bit;
+		}
+
 		long buildMoverLists (void);
 
 		bool modifyMoverLists (MoverPtr mover, long action);
@@ -533,6 +649,8 @@ class GameObjectManager {
 
 		void setPartId (GameObjectPtr obj, long param1 = 0, long param2 = 0, long param3 = 0);
 
+		void indexObject (GameObjectPtr obj);
+
 		long buildCollidableList (void);
 
 		long initCollisionSystem (FitIniFile* missionFile);
@@ -0,0 +1,661 @@
+//***************************************************************************
+//
+//	replay.cpp -- File contains the mission record/replay code
+//
+//	MechCommander 2
+//
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+#ifndef MCLIB_H
+#include"mclib.h"
+#endif
+
+#ifndef REPLAY_H
+#include"replay.h"
+#endif
+
+#ifndef MOVER_H
+#include"mover.h"
+#endif
+
+#ifndef WARRIOR_H
+#include"warrior.h"
+#endif
+
+#ifndef TACORDR_H
+#include"tacordr.h"
+#endif
+
+#ifndef OBJMGR_H
+#include"objmgr.h"
+#endif
+
+#ifndef MOVEMGR_H
+#include"movemgr.h"
+#endif
+
+#ifndef ARTLRY_H
+#include"artlry.h"
+#endif
+
+#include"gameos.hpp"
+#include"toolos.hpp"
+
+//***************************************************************************
+
+#define	REPLAY_MAGIC					0x5232434d		// "MC2R"
+#define	REPLAY_VERSION					1
+
+#define	REPLAY_STEP_RATE				30.0f			// used when recording without a FixedStepRate
+#define	REPLAY_PATHS_PER_TICK			8				// used when recording without a fixedPathsPerFrame
+
+typedef enum {
+	REPLAY_EVENT_SEED,
+	REPLAY_EVENT_ORDER,
+	REPLAY_EVENT_STRIKE,
+	REPLAY_EVENT_CHECK,
+	REPLAY_EVENT_END
+} ReplayEventType;
+
+extern float FixedStepRate;
+
+//---------------------------------------------------------------------------
+
+static File*			replayFile = NULL;
+static File*			tickFile = NULL;
+static bool				recording = false;
+static bool				replaying = false;
+static bool				inMission = false;
+static bool				finished = false;
+
+static char				replayMissionName[1024];
+static float			replayStepRate = 0.0f;
+static long				replayPathsPerTick = 0;
+static unsigned long	replaySeed = 0;
+
+static long				replayTick = 0;
+static long				nextEventType = REPLAY_EVENT_END;
+static long				nextEventTick = 0;
+
+static long				numOrders = 0;
+static long				numSeeds = 0;
+static long				numChecks = 0;
+static long				numCheckMisses = 0;
+static long				numSeedMisses = 0;
+static long				firstMissTick = -1;
+
+static double			tickStartTime = 0.0;
+static double			tickTotalTime = 0.0;
+static double			tickWorstTime = 0.0;
+static long				tickWorst = 0;
+
+//***************************************************************************
+// Log reading/writing
+//***************************************************************************
+
+static void writeEvent (long type) {
+
+	replayFile->writeByte((unsigned char)type);
+	replayFile->writeInt(replayTick);
+}
+
+//---------------------------------------------------------------------------
+
+static void readEvent (void) {
+
+	if (replayFile->eof()) {
+		nextEventType = REPLAY_EVENT_END;
+		nextEventTick = replayTick;
+		return;
+	}
+
+	nextEventType = replayFile->readByte();
+	nextEventTick = replayFile->readInt();
+}
+
+//---------------------------------------------------------------------------
+
+static void writeOrder (TacticalOrderPtr tacOrder) {
+
+	unsigned char flags = 0;
+	if (tacOrder->unitOrder)
+		flags |= 0x01;
+	if (tacOrder->subOrder)
+		flags |= 0x02;
+	if (tacOrder->moveParams.faceObject)
+		flags |= 0x04;
+	if (tacOrder->moveParams.wait)
+		flags |= 0x08;
+	if (tacOrder->moveParams.escapeTile)
+		flags |= 0x10;
+	if (tacOrder->moveParams.jump)
+		flags |= 0x20;
+	if (tacOrder->moveParams.keepMoving)
+		flags |= 0x40;
+
+	unsigned char attackFlags = 0;
+	if (tacOrder->attackParams.pursue)
+		attackFlags |= 0x01;
+	if (tacOrder->attackParams.obliterate)
+		attackFlags |= 0x02;
+
+	replayFile->writeByte((unsigned char)tacOrder->origin);
+	replayFile->writeByte((unsigned char)tacOrder->code);
+	replayFile->writeByte(flags);
+	replayFile->writeByte((unsigned char)tacOrder->stage);
+	replayFile->writeInt(tacOrder->targetWID);
+	replayFile->writeInt(tacOrder->targetObjectClass);
+	replayFile->writeInt(tacOrder->selectionIndex);
+	replayFile->writeInt(tacOrder->groupFlags);
+	replayFile->writeInt(tacOrder->data[0]);
+	replayFile->writeInt(tacOrder->data[1]);
+
+	//-----------------------------------------------------
+	// Only the way points in use, not the whole array...
+	WayPath& wayPath = tacOrder->moveParams.wayPath;
+	replayFile->writeByte((unsigned char)wayPath.numPoints);
+	replayFile->writeByte((unsigned char)wayPath.curPoint);
+	for (long i = 0; i < wayPath.numPoints; i++) {
+		replayFile->writeFloat(wayPath.points[i * 3]);
+		replayFile->writeFloat(wayPath.points[i * 3 + 1]);
+		replayFile->writeFloat(wayPath.points[i * 3 + 2]);
+		replayFile->writeByte(wayPath.mode[i]);
+	}
+	if (wayPath.numPoints == 0)
+		replayFile->writeByte(wayPath.mode[0]);
+	replayFile->writeByte((unsigned char)tacOrder->moveParams.mode);
+	replayFile->writeInt(tacOrder->moveParams.fromArea);
+
+	replayFile->writeByte((unsigned char)tacOrder->attackParams.type);
+	replayFile->writeByte((unsigned char)tacOrder->attackParams.method);
+	replayFile->writeByte((unsigned char)(tacOrder->attackParams.range + 4));
+	replayFile->writeByte((unsigned char)tacOrder->attackParams.tactic);
+	replayFile->writeByte((unsigned char)(tacOrder->attackParams.aimLocation + 2));
+	replayFile->writeByte(attackFlags);
+	replayFile->writeFloat(tacOrder->attackParams.targetPoint.x);
+	replayFile->writeFloat(tacOrder->attackParams.targetPoint.y);
+	replayFile->writeFloat(tacOrder->attackParams.targetPoint.z);
+}
+
+//---------------------------------------------------------------------------
+
+static void readOrder (TacticalOrder& tacOrder) {
+
+	OrderOriginType origin = (OrderOriginType)replayFile->readByte();
+	TacticalOrderCode code = (TacticalOrderCode)replayFile->readByte();
+	unsigned char flags = replayFile->readByte();
+	tacOrder.init(origin, code, (flags & 0x01) != 0);
+
+	tacOrder.subOrder = (flags & 0x02) != 0;
+	tacOrder.moveParams.faceObject = (flags & 0x04) != 0;
+	tacOrder.moveParams.wait = (flags & 0x08) != 0;
+	tacOrder.moveParams.escapeTile = (flags & 0x10) != 0;
+	tacOrder.moveParams.jump = (flags & 0x20) != 0;
+	tacOrder.moveParams.keepMoving = (flags & 0x40) != 0;
+	tacOrder.stage = replayFile->readByte();
+	tacOrder.targetWID = replayFile->readInt();
+	tacOrder.targetObjectClass = replayFile->readInt();
+	tacOrder.selectionIndex = replayFile->readInt();
+	tacOrder.groupFlags = replayFile->readInt();
+	tacOrder.data[0] = replayFile->readInt();
+	tacOrder.data[1] = replayFile->readInt();
+
+	WayPath& wayPath = tacOrder.moveParams.wayPath;
+	wayPath.numPoints = replayFile->readByte();
+	wayPath.curPoint = replayFile->readByte();
+	if (wayPath.numPoints > MAX_WAYPTS)
+		STOP(("REPLAY: bad way path in replay log (%d points)", wayPath.numPoints));
+	for (long i = 0; i < wayPath.numPoints; i++) {
+		wayPath.points[i * 3] = replayFile->readFloat();
+		wayPath.points[i * 3 + 1] = replayFile->readFloat();
+		wayPath.points[i * 3 + 2] = replayFile->readFloat();
+		wayPath.mode[i] = replayFile->readByte();
+	}
+	if (wayPath.numPoints == 0)
+		wayPath.mode[0] = replayFile->readByte();
+	tacOrder.moveParams.mode = (SpecialMoveMode)replayFile->readByte();
+	tacOrder.moveParams.fromArea = replayFile->readInt();
+
+	tacOrder.attackParams.type = (AttackType)replayFile->readByte();
+	tacOrder.attackParams.method = (AttackMethod)replayFile->readByte();
+	tacOrder.attackParams.range = (FireRangeType)(replayFile->readByte() - 4);
+	tacOrder.attackParams.tactic = (TacticType)replayFile->readByte();
+	tacOrder.attackParams.aimLocation = replayFile->readByte() - 2;
+	unsigned char attackFlags = replayFile->readByte();
+	tacOrder.attackParams.pursue = (attackFlags & 0x01) != 0;
+	tacOrder.attackParams.obliterate = (attackFlags & 0x02) != 0;
+	tacOrder.attackParams.targetPoint.x = replayFile->readFloat();
+	tacOrder.attackParams.targetPoint.y = replayFile->readFloat();
+	tacOrder.attackParams.targetPoint.z = replayFile->readFloat();
+}
+
+//---------------------------------------------------------------------------
+
+static DWORD floatBits (float value) {
+
+	DWORD bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return(bits);
+}
+
+//---------------------------------------------------------------------------
+// Cheap fingerprint of where every mover is and how beat up it is.  Two
+// runs that agree on this every REPLAY_CHECK_TICKS ticks haven't drifted.
+
+static DWORD moverChecksum (void) {
+
+	DWORD sum = 0;
+	for (long i = 0; i < ObjectManager->getNumMovers(); i++) {
+		MoverPtr mover = ObjectManager->getMover(i);
+		if (!mover)
+			continue;
+		Stuff::Vector3D position = mover->getPosition();
+		sum = sum * 31 + floatBits(position.x);
+		sum = sum * 31 + floatBits(position.y);
+		sum = sum * 31 + floatBits(position.z);
+		sum = sum * 31 + floatBits(mover->getDamage());
+		sum = sum * 31 + mover->getStatus();
+	}
+	return(sum);
+}
+
+//---------------------------------------------------------------------------
+
+static void noteMiss (void) {
+
+	if (firstMissTick == -1) {
+		firstMissTick = replayTick;
+		printf("REPLAY: %s went off the recording at tick %ld\n", replayMissionName, replayTick);
+	}
+}
+
+//***************************************************************************
+// Playing orders
+//***************************************************************************
+
+static void doPlayerOrder (MoverPtr mover, TacticalOrderPtr tacOrder, long action) {
+
+	MechWarriorPtr pilot = mover->getPilot();
+	switch (action) {
+		case REPLAY_ORDER_HANDLE:
+			mover->handleTacticalOrder(*tacOrder);
+			break;
+		case REPLAY_ORDER_QUEUE:
+			pilot->setExecutingQueue(FALSE);
+			pilot->addQueuedTacOrder(*tacOrder);
+			break;
+		case REPLAY_ORDER_QUEUE_EXECUTE:
+			pilot->addQueuedTacOrder(*tacOrder);
+			pilot->setExecutingQueue(TRUE);
+			break;
+		case REPLAY_ORDER_EXECUTE_QUEUE:
+			pilot->setExecutingQueue(true);
+			pilot->executeTacOrderQueue();
+			break;
+	}
+}
+
+//---------------------------------------------------------------------------
+
+static void playOrder (void) {
+
+	long action = replayFile->readByte();
+	GameObjectWatchID moverWID = replayFile->readInt();
+	TacticalOrder tacOrder;
+	if (action != REPLAY_ORDER_EXECUTE_QUEUE)
+		readOrder(tacOrder);
+
+	//-------------------------------------------------------
+	// If the mover's gone we've already drifted.  Carry on
+	// and let the checksums say how badly...
+	GameObjectPtr obj = ObjectManager->getByWatchID(moverWID);
+	if (!obj || !obj->isMover()) {
+		noteMiss();
+		return;
+	}
+
+	doPlayerOrder((MoverPtr)obj, &tacOrder, action);
+}
+
+//---------------------------------------------------------------------------
+
+static void skipEvent (void) {
+
+	switch (nextEventType) {
+		case REPLAY_EVENT_SEED:
+		case REPLAY_EVENT_CHECK:
+			replayFile->readInt();
+			break;
+		case REPLAY_EVENT_ORDER: {
+			long action = replayFile->readByte();
+			replayFile->readInt();
+			if (action != REPLAY_ORDER_EXECUTE_QUEUE) {
+				TacticalOrder tacOrder;
+				readOrder(tacOrder);
+			}
+			}
+			break;
+		case REPLAY_EVENT_STRIKE:
+			replayFile->readInt();
+			replayFile->readFloat();
+			replayFile->readFloat();
+			replayFile->readFloat();
+			break;
+	}
+}
+
+//***************************************************************************
+// REPLAY interface routines
+//***************************************************************************
+
+long REPLAY_init (const char* fileName, bool record, const char* tickFileName) {
+
+	replayFile = new File;
+	if (record) {
+		if (replayFile->createWithCase(fileName) != NO_ERR)
+			return(-1);
+		recording = true;
+		}
+	else {
+		if (replayFile->open(fileName, READ, 50, true) != NO_ERR)
+			return(-1);
+
+		if ((replayFile->readInt() != REPLAY_MAGIC) || (replayFile->readInt() != REPLAY_VERSION))
+			return(-2);
+
+		replayFile->readString((MemoryPtr)replayMissionName);
+		replayStepRate = replayFile->readFloat();
+		replayPathsPerTick = replayFile->readInt();
+		replaySeed = (DWORD)replayFile->readInt();
+		readEvent();
+		replaying = true;
+	}
+
+	if (tickFileName) {
+		tickFile = new File;
+		if (tickFile->createWithCase(tickFileName) != NO_ERR)
+			return(-3);
+		tickFile->writeString("tick,time,ms\n");
+	}
+
+	return(NO_ERR);
+}
+
+//---------------------------------------------------------------------------
+
+const char* REPLAY_getMissionName (void) {
+
+	return(replayMissionName);
+}
+
+//---------------------------------------------------------------------------
+
+bool REPLAY_isRecording (void) {
+
+	return(recording);
+}
+
+//---------------------------------------------------------------------------
+
+bool REPLAY_isReplaying (void) {
+
+	return(replaying);
+}
+
+//---------------------------------------------------------------------------
+
+bool REPLAY_finished (void) {
+
+	return(finished);
+}
+
+//---------------------------------------------------------------------------
+// Called before the mission loads, since loading rolls dice too.  Pins down
+// the clock the log needs: a fixed step and a fixed number of path solves a
+// tick, rather than whatever fits in the path manager's time budget.
+
+void REPLAY_beginMission (const char* missionName) {
+
+	if (!recording && !replaying)
+		return;
+
+	if (recording) {
+		strncpy(replayMissionName, missionName, 1023);
+		replayStepRate = (FixedStepRate > 0.0f) ? FixedStepRate : REPLAY_STEP_RATE;
+		replayPathsPerTick = (MovePathManager::fixedPathsPerFrame > 0) ? MovePathManager::fixedPathsPerFrame : REPLAY_PATHS_PER_TICK;
+		replaySeed = timeGetTime();
+
+		replayFile->writeInt(REPLAY_MAGIC);
+		replayFile->writeInt(REPLAY_VERSION);
+		replayFile->writeString(replayMissionName);
+		replayFile->writeByte(0);
+		replayFile->writeFloat(replayStepRate);
+		replayFile->writeInt(replayPathsPerTick);
+		replayFile->writeInt((int)replaySeed);
+	}
+
+	FixedStepRate = replayStepRate;
+	MovePathManager::fixedPathsPerFrame = replayPathsPerTick;
+
+	replayTick = 0;
+	inMission = true;
+	gos_srand(replaySeed);
+}
+
+//---------------------------------------------------------------------------
+
+void REPLAY_endMission (void) {
+
+	if (!inMission)
+		return;
+
+	inMission = false;
+	if (recording) {
+		writeEvent(REPLAY_EVENT_END);
+		printf("RECORD: %s %ld ticks, %ld orders, %ld seeds\n", replayMissionName, replayTick, numOrders, numSeeds);
+		}
+	else {
+		printf("REPLAY: %s %ld ticks, %.3f ms/tick, worst %.3f ms (tick %ld)\n", replayMissionName, replayTick,
+			replayTick ? tickTotalTime / replayTick : 0.0, tickWorstTime, tickWorst);
+		printf("REPLAY: %ld of %ld checkpoints matched, %ld seeds used, %ld seeds missed\n", numChecks - numCheckMisses, numChecks,
+			numSeeds, numSeedMisses);
+	}
+
+	replayFile->close();
+	delete replayFile;
+	replayFile = NULL;
+
+	if (tickFile) {
+		tickFile->close();
+		delete tickFile;
+		tickFile = NULL;
+	}
+}
+
+//---------------------------------------------------------------------------
+// Effects and weather roll the same dice as the simulation, but once a
+// frame, and frames don't line up with ticks from one run to the next.
+// So the dice get a fresh seed off the tick number before anything that
+// counts, and whatever was rolled in between doesn't carry over.
+
+static void seedTick (long salt) {
+
+	gos_srand(replaySeed + (DWORD)replayTick * 2654435761u + salt);
+}
+
+//---------------------------------------------------------------------------
+// Feeds in whatever the player did before the coming tick.  Called where
+// the orders come in when recording: once a frame before the interface is
+// updated, and again before each extra tick the frame runs.
+
+void REPLAY_update (void) {
+
+	if (!inMission)
+		return;
+
+	seedTick(0);
+	if (!replaying)
+		return;
+
+	while (!finished && (nextEventTick <= replayTick)) {
+		switch (nextEventType) {
+			case REPLAY_EVENT_ORDER:
+				playOrder();
+				break;
+			case REPLAY_EVENT_STRIKE: {
+				long strikeID = replayFile->readInt();
+				Stuff::Vector3D strikeLoc;
+				strikeLoc.x = replayFile->readFloat();
+				strikeLoc.y = replayFile->readFloat();
+				strikeLoc.z = replayFile->readFloat();
+				IfaceCallStrike(strikeID, &strikeLoc, NULL);
+				}
+				break;
+			case REPLAY_EVENT_END:
+				finished = true;
+				return;
+			case REPLAY_EVENT_SEED:
+				//--------------------------------------------------
+				// Scripts seed during the tick, after the orders are
+				// in.  Leave this tick's seed for REPLAY_seedRandom.
+				if (nextEventTick == replayTick)
+					return;
+				noteMiss();
+				skipEvent();
+				break;
+			default:
+				//--------------------------------------------------
+				// A checkpoint the replay never got to...
+				noteMiss();
+				skipEvent();
+				break;
+		}
+		readEvent();
+	}
+}
+
+//---------------------------------------------------------------------------
+
+void REPLAY_startTick (void) {
+
+	if (!inMission)
+		return;
+
+	seedTick(1);
+	tickStartTime = gos_GetHiResTime();
+}
+
+//---------------------------------------------------------------------------
+
+void REPLAY_endTick (void) {
+
+	if (!inMission)
+		return;
+
+	double tickTime = (gos_GetHiResTime() - tickStartTime) * 1000.0;
+	tickTotalTime += tickTime;
+	if (tickTime > tickWorstTime) {
+		tickWorstTime = tickTime;
+		tickWorst = replayTick;
+	}
+	if (tickFile) {
+		char s[64];
+		sprintf(s, "%ld,%.3f,%.4f\n", replayTick, scenarioTime, tickTime);
+		tickFile->writeString(s);
+	}
+
+	replayTick++;
+	if (replaying && (nextEventType == REPLAY_EVENT_END) && (nextEventTick <= replayTick))
+		finished = true;
+
+	if ((replayTick % REPLAY_CHECK_TICKS) != 0)
+		return;
+
+	if (recording) {
+		writeEvent(REPLAY_EVENT_CHECK);
+		replayFile->writeInt((int)moverChecksum());
+		}
+	else if ((nextEventType == REPLAY_EVENT_CHECK) && (nextEventTick == replayTick)) {
+		numChecks++;
+		if ((DWORD)replayFile->readInt() != moverChecksum()) {
+			numCheckMisses++;
+			noteMiss();
+		}
+		readEvent();
+		if ((nextEventType == REPLAY_EVENT_END) && (nextEventTick <= replayTick))
+			finished = true;
+	}
+}
+
+//---------------------------------------------------------------------------
+// Everything the player tells a mover to do comes through here.  While
+// replaying, the log does the talking and live orders are dropped.
+
+void REPLAY_playerOrder (MoverPtr mover, TacticalOrderPtr tacOrder, long action) {
+
+	if (replaying && inMission)
+		return;
+
+	if (recording && inMission) {
+		writeEvent(REPLAY_EVENT_ORDER);
+		replayFile->writeByte((unsigned char)action);
+		replayFile->writeInt(mover->getWatchID());
+		if (action != REPLAY_ORDER_EXECUTE_QUEUE)
+			writeOrder(tacOrder);
+		numOrders++;
+	}
+
+	doPlayerOrder(mover, tacOrder, action);
+}
+
+//---------------------------------------------------------------------------
+
+void REPLAY_playerStrike (long strikeID, Stuff::Vector3D strikeLoc) {
+
+	if (replaying && inMission)
+		return;
+
+	if (recording && inMission) {
+		writeEvent(REPLAY_EVENT_STRIKE);
+		replayFile->writeInt(strikeID);
+		replayFile->writeFloat(strikeLoc.x);
+		replayFile->writeFloat(strikeLoc.y);
+		replayFile->writeFloat(strikeLoc.z);
+		numOrders++;
+	}
+
+	IfaceCallStrike(strikeID, &strikeLoc, NULL);
+}
+
+//---------------------------------------------------------------------------
+// Scripts can reseed the dice, sometimes off the system clock.  Record the
+// seed they used, and hand the same one back on replay.
+
+unsigned long REPLAY_seedRandom (unsigned long seed) {
+
+	if (!inMission)
+		return(seed);
+
+	if (recording) {
+		writeEvent(REPLAY_EVENT_SEED);
+		replayFile->writeInt((int)seed);
+		numSeeds++;
+		return(seed);
+	}
+
+	if ((nextEventType == REPLAY_EVENT_SEED) && (nextEventTick == replayTick)) {
+		seed = (DWORD)replayFile->readInt();
+		numSeeds++;
+		readEvent();
+		}
+	else {
+		numSeedMisses++;
+		noteMiss();
+	}
+
+	return(seed);
+}
+
+//***************************************************************************
@@ -0,0 +1,76 @@
+//***************************************************************************
+//
+//	replay.h -- File contains the mission record/replay header
+//
+//	MechCommander 2
+//
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+//--------------
+// Include Files
+
+#ifndef DMOVER_H
+#include"dmover.h"
+#endif
+
+#ifndef DTACORDR_H
+#include"dtacordr.h"
+#endif
+
+#include<stuff/stuff.hpp>
+
+//***************************************************************************
+
+//---------------------------------------------------------------------------
+// A replay log holds the seed the mission was started with and every player
+// order and strike, each stamped with the simulation tick it was given on.
+// Both recording and replay run the mission in fixed steps, so feeding the
+// log back in at the same ticks plays the mission out the same way.  Every
+// REPLAY_CHECK_TICKS ticks the log also keeps a checksum of the movers, so
+// a replay can tell where it went off the rails.
+
+#define	REPLAY_CHECK_TICKS				30
+
+typedef enum {
+	REPLAY_ORDER_HANDLE,				// Mover::handleTacticalOrder()
+	REPLAY_ORDER_QUEUE,					// added to the waypoint queue, queue on hold
+	REPLAY_ORDER_QUEUE_EXECUTE,			// added to the queue, queue running (mines)
+	REPLAY_ORDER_EXECUTE_QUEUE			// waypoint key let go, run the queue
+} ReplayOrderAction;
+
+//---------------------------------------------------------------------------
+
+long REPLAY_init (const char* fileName, bool record, const char* tickFileName = NULL);
+
+const char* REPLAY_getMissionName (void);
+
+bool REPLAY_isRecording (void);
+
+bool REPLAY_isReplaying (void);
+
+bool REPLAY_finished (void);
+
+void REPLAY_beginMission (const char* missionName);
+
+void REPLAY_endMission (void);
+
+void REPLAY_update (void);
+
+void REPLAY_startTick (void);
+
+void REPLAY_endTick (void);
+
+void REPLAY_playerOrder (MoverPtr mover, TacticalOrderPtr tacOrder, long action = REPLAY_ORDER_HANDLE);
+
+void REPLAY_playerStrike (long strikeID, Stuff::Vector3D strikeLoc);
+
+unsigned long REPLAY_seedRandom (unsigned long seed);
+
+//***************************************************************************
+
+#endif
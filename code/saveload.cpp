@@ -765,6 +765,14 @@ void Mission::load (const char *loadFileName)
 	result = gameSystemFile->readIdFloat("FireVisualRange",fireVisualRange);
 	gosASSERT(result == NO_ERR);
 
+	result = gameSystemFile->readIdLong("SensorUpdateFrames",SensorSystemManager::updateFrames);
+	if (result != NO_ERR)
+		SensorSystemManager::updateFrames = 0;
+
+	result = gameSystemFile->readIdLong("SensorScanBudget",SensorSystemManager::scanBudget);
+	if (result != NO_ERR)
+		SensorSystemManager::scanBudget = 0;
+
 	result = gameSystemFile->readIdFloatArray("WeaponRange", WeaponRange, NUM_FIRERANGES);
 	gosASSERT(result == NO_ERR);
 
@@ -70,6 +70,14 @@
 #include"warrior.h"
 #endif
 
+#ifndef THREADPOOL_H
+#include"threadpool.h"
+#endif
+
+#ifndef ZONEPROF_H
+#include"zoneprof.h"
+#endif
+
 char Team::relations[MAX_TEAMS][MAX_TEAMS] = {
 	{0, 2, RELATION_NEUTRAL, 2, 2, 2, 2, 2},
 	{2, 0, 2, 2, 2, 2, 2, 2},
@@ -86,6 +94,10 @@ long			Team::numTeams = 0;
 TeamPtr			Team::home = NULL;
 TeamPtr			Team::teams[MAX_TEAMS] = {NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL};
 SortListPtr		Team::sortList = NULL;
+float*			Team::losHeightBound = NULL;
+long			Team::losHeightBoundRows = 0;
+long			Team::losHeightBoundCols = 0;
+float*			Team::losHorizon = NULL;
 
 bool			useRealLOS = true;
 #ifdef LAB_ONLY
@@ -763,6 +775,9 @@ bool Team::teamLineOfSight (Stuff::Vector3D tPos, float extRad)
 {
 	//-----------------------------------------------------------
 	// For each member of the team, check LOS to point provided.
+	// The rays of everyone in range are checked as one batch.
+	TeamLOSQuery rays[MAX_MOVERS_PER_TEAM];
+	long numRays = 0;
 	for (long i = 0; i < rosterSize; i++) 
 	{
 		MoverPtr obj = (MoverPtr)ObjectManager->getByWatchID(roster[i]);
@@ -803,12 +818,18 @@ bool Team::teamLineOfSight (Stuff::Vector3D tPos, float extRad)
 		
 			if (dist <= (radius * 25.0f * worldUnitsPerMeter))
 			{
-				if (lineOfSight(obj->getLOSPosition(),tPos,id,extRad,0.0f,false))
-					return true;
+				rays[numRays].start = obj->getLOSPosition();
+				rays[numRays].end = tPos;
+				rays[numRays].extRad = extRad;
+				rays[numRays].startExtRad = 0.0f;
+				numRays++;
 			}
 		}
 	}
 
+	if (numRays && lineOfSight(rays,numRays,id,true))
+		return true;
+
 	//-------------------------------------------------------------------------
 	// Check the lookout towers now.  You can find them in special Buildings!!
 	for (long spBuilding = 0; spBuilding < ObjectManager->numSpecialBuildings; spBuilding++)
@@ -867,9 +888,85 @@ bool Team::teamLineOfSight (Stuff::Vector3D tPos, float extRad)
 	return false;
 }
 
-#ifdef LAB_ONLY
-extern __int64 MCTimeLOSCalc;
-#endif
+//---------------------------------------------------------------------------
+// Cells off the height bound grid always take the terrain sample.
+#define LOS_NO_HEIGHT_BOUND			(1.0e+30f)
+// Covers float rounding in the triangle interpolation of MapData.
+#define LOS_HEIGHT_BOUND_SLACK		1.0f
+
+//---------------------------------------------------------------------------
+// Horizon table.  LOS_HORIZON_SECTORS MUST be a power of two.
+#define LOS_HORIZON_SECTORS			16
+#define LOS_HORIZON_RANGE			16
+#define LOS_HORIZON_MAX_OFFSETS		((LOS_HORIZON_RANGE * 2 + 1) * (LOS_HORIZON_RANGE * 2 + 1))
+// Cells are grown by this many world units (and angles by this many radians)
+// so rounding can't move a ray step out of the cell the table used for it.
+#define LOS_HORIZON_CELL_SLACK		0.5f
+#define LOS_HORIZON_ANGLE_SLACK		0.0001f
+// How far the ray must stay above the horizon to skip the terrain.
+#define LOS_HORIZON_SLACK			0.5f
+
+bool useLOSHorizon = true;
+
+//---------------------------------------------------------------------------
+// Rays cast by Team::checkLOSHeightBound.  Both ends stay within this many
+// cells of each other, and each end gets up to this much local height.
+#define LOS_CHECK_RANGE				64
+#define LOS_CHECK_MAX_LOCAL			40
+
+typedef struct _LOSHorizonOffset {
+	short		row;
+	short		col;
+	short		firstSector;
+	short		numSectors;
+	float		minDist;						// closest and farthest the cell gets to the center of the start cell
+	float		maxDist;
+} LOSHorizonOffset;
+
+typedef struct _LOSHorizonJob {
+	long		firstRow;
+	long		lastRow;
+	float*		cellBase;						// terrain elevation at each cell center
+	float*		cellTop;						// height bound plus local height of each cell
+} LOSHorizonJob;
+
+LOSHorizonOffset	losHorizonOffsets[LOS_HORIZON_MAX_OFFSETS];
+long				numLOSHorizonOffsets = 0;
+float				losHorizonNear = 0.0f;		// Ray steps closer to the start than this (the start cell's
+float				losHorizonFar = 0.0f;		// neighbors) or farther than this are always checked.
+
+inline float getLOSHeightBound (long cellRow, long cellCol)
+{
+	if ((cellRow < 0) || (cellRow >= Team::losHeightBoundRows) || (cellCol < 0) || (cellCol >= Team::losHeightBoundCols))
+		return(LOS_NO_HEIGHT_BOUND);
+	return(Team::losHeightBound[cellRow * Team::losHeightBoundCols + cellCol]);
+}
+
+inline long getLOSHorizonSector (float angle)
+{
+	long sector = (long)floor((angle + PI) * (LOS_HORIZON_SECTORS / (2.0 * PI)));
+	return(sector & (LOS_HORIZON_SECTORS - 1));
+}
+
+inline float getLOSHorizonSlope (float rise, LOSHorizonOffset* offset)
+{
+	//---------------------------------------------------------------
+	// Must hold for any point of the cell, so a rise is divided by the
+	// closest distance and a drop by the farthest.
+	if (rise > 0.0f)
+		return(rise / offset->minDist);
+	return(rise / offset->maxDist);
+}
+
+inline void raiseLOSHorizon (float* horizon, LOSHorizonOffset* offset, float slope)
+{
+	for (long i = 0; i < offset->numSectors; i++)
+	{
+		float* sectorSlope = &horizon[(offset->firstSector + i) & (LOS_HORIZON_SECTORS - 1)];
+		if (slope > *sectorSlope)
+			*sectorSlope = slope;
+	}
+}
 
 //#define USE_OLD_LOS
 
@@ -878,9 +975,7 @@ extern __int64 MCTimeLOSCalc;
 //---------------------------------------------------------------------------
 bool Team::lineOfSight (float startLocal, long mCellRow, long mCellCol, long tCellRow, long tCellCol, long teamId, float extRad, bool checkVisibleBits)
 {
-	#ifdef LAB_ONLY
-	__int64 x=GetCycles();
-	#endif
+	PROFILE_ZONE_FINE("LOS Calc");
 	
 	//-----------------------------------------------------
 	// Once we allow teams to have alliances (for contacts,
@@ -929,10 +1024,6 @@ bool Team::lineOfSight (float startLocal, long mCellRow, long mCellCol, long tCe
 
 		if (!losResult)
 		{
-	#ifdef LAB_ONLY
-	x=GetCycles()-x;
-	MCTimeLOSCalc += x;
-	#endif
 			return losResult;
 		}
 	}
@@ -1014,10 +1105,6 @@ bool Team::lineOfSight (float startLocal, long mCellRow, long mCellCol, long tCe
 				
 				if (startHeight+startLocal < currentPos.z)
 				{
-	#ifdef LAB_ONLY
-	x=GetCycles()-x;
-	MCTimeLOSCalc += x;
-	#endif
 #ifdef LAB_ONLY
 		if (drawTerrainGrid)
 		{
@@ -1055,11 +1142,6 @@ bool Team::lineOfSight (float startLocal, long mCellRow, long mCellCol, long tCe
 #endif
 	}
 	
-	#ifdef LAB_ONLY
-	x=GetCycles()-x;
-	MCTimeLOSCalc += x;
-	#endif
-	
 	return true;
 }
 
@@ -1067,12 +1149,180 @@ bool Team::lineOfSight (float startLocal, long mCellRow, long mCellCol, long tCe
 
 #define ACCURACY_ADJUST		1.5f
 const float HALF_CELL_DIST	= (128.0f / 6.0f);
+
+//---------------------------------------------------------------------------
+// Marches the ray from startPos to endPos one step at a time and returns
+// false if the terrain (plus local height) blocks it.  The terrain sample is
+// the expensive part, so with useHeightBound it is only taken when the ray
+// is below the cell's height bound or close enough for the extent check.
+// Without it this is the original per-step test, kept for verification.
+static bool marchLOS (Stuff::Vector3D& startPos, Stuff::Vector3D& endPos, long deltaCellRow, long deltaCellCol, float extRad, float startExtRad, float startLocal, float horizon, bool useHeightBound)
+{
+	Stuff::Vector3D deltaCellVec;
+	deltaCellVec.y = deltaCellRow;
+	deltaCellVec.x = deltaCellCol;
+	deltaCellVec.z = 0.0f;
+	float startHeight = startPos.z;
+	
+	float length = deltaCellVec.GetApproximateLength();
+	length *= ACCURACY_ADJUST;
+	
+	if (length <= Stuff::SMALL)
+		return true;
+
+	float colLength = (endPos.x - startPos.x) / length;
+	float rowLength = (endPos.y - startPos.y) / length;
+	float heightLen = (endPos.z - startPos.z) / (length + ACCURACY_ADJUST);
+	
+	Stuff::Vector3D currentPos = startPos;
+	bool haveElevation = false;
+	long maxDistIter = (length - 0.5f);
+	long maxTrees = 0;
+
+	Stuff::Vector3D dist;
+	bool checkExtent = (extRad > Stuff::SMALL);
+	bool checkStart = (startExtRad > Stuff::SMALL);
+	extRad += HALF_CELL_DIST;
+
+	//---------------------------------------------------------------------
+	// Steps horizonFirst to horizonLast are covered by the start cell's
+	// horizon.  The ray height and the horizon are both linear in the step,
+	// so if the ray is above the horizon at both ends it can't be blocked
+	// anywhere in between.
+	long horizonFirst = maxDistIter;
+	long horizonLast = -1;
+	if (useHeightBound && (horizon < LOS_NO_HEIGHT_BOUND))
+	{
+		float stepLength = sqrt(colLength * colLength + rowLength * rowLength);
+		if (stepLength > Stuff::SMALL)
+		{
+			long first = (long)ceil(losHorizonNear / stepLength);
+			long last = (long)floor(losHorizonFar / stepLength);
+			if (last >= maxDistIter)
+				last = maxDistIter - 1;
+
+			if (first <= last)
+			{
+				float clearFirst = startLocal + heightLen * (first + 1) - horizon * stepLength * first;
+				float clearLast = startLocal + heightLen * (last + 1) - horizon * stepLength * last;
+				if ((clearFirst >= LOS_HORIZON_SLACK) && (clearLast >= LOS_HORIZON_SLACK))
+				{
+					horizonFirst = first;
+					horizonLast = last;
+				}
+			}
+		}
+	}
+
+	for (long distIter = 0;distIter < maxDistIter;distIter++)
+	{
+		bool outsideStartRadius = true;
+		if (checkStart)
+		{
+			Stuff::Vector3D distance;
+			distance.Subtract(currentPos,startPos);
+			distance.z = 0.0f;
+			float dist = distance.GetApproximateLength();
+			if (dist <= startExtRad)
+				outsideStartRadius = false;
+		}
+
+		startHeight += heightLen;
+
+		//First, check if we are now inside the extent radius of the thing we are calcing LOS to.
+		// If we are and we haven't returned false since we're here, we can see it!!!!
+		// The distance with height is never shorter than the flat one, so the
+		// terrain is only sampled once the flat distance is in range.
+		if (checkExtent)
+		{
+			dist.Subtract(endPos,currentPos);
+			dist.z = 0.0f;
+			if (!useHeightBound || (dist.GetApproximateLength() <= extRad))
+			{
+				if (!haveElevation)
+				{
+					currentPos.z = land->getTerrainElevation(currentPos);
+					haveElevation = true;
+				}
+
+				dist.z = endPos.z - currentPos.z;
+				if (dist.GetApproximateLength() <= extRad)
+					break;
+			}
+		}
+
+		if (outsideStartRadius && ((distIter < horizonFirst) || (distIter > horizonLast)))
+		{
+			int curCellRow, curCellCol;
+			land->worldToCell(currentPos,curCellRow, curCellCol);
+
+			float localElev = (worldUnitsPerMeter * 4.0f * (float)GameMap->getLocalHeight(curCellRow,curCellCol)); 
+
+			if (!useHeightBound || (startHeight < (getLOSHeightBound(curCellRow,curCellCol) + localElev)))
+			{
+				if (!haveElevation)
+				{
+					currentPos.z = land->getTerrainElevation(currentPos);
+					haveElevation = true;
+				}
+
+				float thisHeight = currentPos.z + localElev;
+				if (startHeight < thisHeight)
+				{
+					bool isTree = false;
+					if (GameMap->getForest(curCellRow,curCellCol))
+					{
+						maxTrees++;
+						isTree = true;
+					}
+
+					if (!isTree || (maxTrees >= MaxTreeLOSCellBlock))
+						return false;
+				}
+			}
+		}
+
+		currentPos.x += colLength;
+		currentPos.y += rowLength;
+		haveElevation = false;
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Puts the ray's ends at the cell centers plus local height and returns the
+// start cell's horizon slope toward the end (LOS_NO_HEIGHT_BOUND if none).
+float Team::setupLOS (float startLocal, long mCellRow, long mCellCol, float endLocal, long tCellRow, long tCellCol, Stuff::Vector3D& startPos, Stuff::Vector3D& endPos)
+{
+	startPos.Zero();
+	endPos.Zero();
+	
+	land->getCellPos(tCellRow,tCellCol,endPos);
+	land->getCellPos(mCellRow,mCellCol,startPos);
+	startPos.z += startLocal;
+	endPos.z += endLocal;
+
+	if (!losHeightBound)
+		initLOSHeightBound();
+
+	if (GameMap->numRaisedCells)
+		updateLOSHorizon();
+
+	float horizon = LOS_NO_HEIGHT_BOUND;
+	if (losHorizon && (mCellRow >= 0) && (mCellRow < losHeightBoundRows) && (mCellCol >= 0) && (mCellCol < losHeightBoundCols))
+	{
+		long sector = getLOSHorizonSector(atan2(endPos.y - startPos.y,endPos.x - startPos.x));
+		horizon = losHorizon[(mCellRow * losHeightBoundCols + mCellCol) * LOS_HORIZON_SECTORS + sector];
+	}
+
+	return(horizon);
+}
+
 //---------------------------------------------------------------------------
 bool Team::lineOfSight (float startLocal, long mCellRow, long mCellCol, float endLocal, long tCellRow, long tCellCol, long teamId, float extRad, float startExtRad, bool checkVisibleBits)
 {
-	#ifdef LAB_ONLY
-	__int64 x=GetCycles();
-	#endif
+	PROFILE_ZONE_FINE("LOS Calc");
 	
 	//-----------------------------------------------------
 	// Once we allow teams to have alliances (for contacts,
@@ -1122,10 +1372,6 @@ bool Team::lineOfSight (float startLocal, long mCellRow, long mCellCol, float en
 
 		if (!losResult)
 		{
-	#ifdef LAB_ONLY
-	x=GetCycles()-x;
-	MCTimeLOSCalc += x;
-	#endif
 			return losResult;
 		}
 	}
@@ -1139,108 +1385,9 @@ bool Team::lineOfSight (float startLocal, long mCellRow, long mCellCol, float en
 		// Find deltaCellRow and deltaCellCol and iterate over them from source to dest.
 		// If the magic line ever goes BELOW the terrainElevation PLUS localElevation return false.
 		Stuff::Vector3D startPos, endPos;
-		startPos.Zero();
-		endPos.Zero();
-		
-		land->getCellPos(tCellRow,tCellCol,endPos);
-		land->getCellPos(mCellRow,mCellCol,startPos);
-		startPos.z += startLocal;
-		endPos.z += endLocal;
-
-		Stuff::Vector3D deltaCellVec;
-		deltaCellVec.y = tCellRow - mCellRow;
-		deltaCellVec.x = tCellCol - mCellCol;
-		deltaCellVec.z = 0.0f;
-		float startHeight = startPos.z;
-		
-		float length = deltaCellVec.GetApproximateLength();
-		length *= ACCURACY_ADJUST;
-		
-		if (length > Stuff::SMALL)
-		{
-			float colLength = (endPos.x - startPos.x) / length;
-			float rowLength = (endPos.y - startPos.y) / length;
-			float heightLen = (endPos.z - startPos.z) / (length + ACCURACY_ADJUST);
-			
-			Stuff::Vector3D currentPos = startPos;
-			currentPos.z = land->getTerrainElevation(currentPos);
-			long maxDistIter = (length - 0.5f);
-			long maxTrees = 0;
-
-			Stuff::Vector3D dist;
-			dist.Subtract(endPos,currentPos);
-			
-			float remainingDist = dist.GetApproximateLength();
-			bool checkExtent = (extRad > Stuff::SMALL);
-			bool checkStart = (startExtRad > Stuff::SMALL);
-			extRad += HALF_CELL_DIST;
-			for (long distIter = 0;distIter < maxDistIter;distIter++)
-			{
-				bool outsideStartRadius = true;
-				if (checkStart)
-				{
-					Stuff::Vector3D distance;
-					distance.Subtract(currentPos,startPos);
-					distance.z = 0.0f;
-					float dist = distance.GetApproximateLength();
-					if (dist <= startExtRad)
-						outsideStartRadius = false;
-				}
-
-				startHeight += heightLen;
-
-				int curCellRow, curCellCol;
-				land->worldToCell(currentPos,curCellRow, curCellCol);
-
-				float localElev = (worldUnitsPerMeter * 4.0f * (float)GameMap->getLocalHeight(curCellRow,curCellCol)); 
-				float thisHeight = currentPos.z + localElev;
-
-				//First, check if we are now inside the extent radius of the thing we are calcing LOS to.
-				// If we are and we haven't returned false since we're here, we can see it!!!!
-				if (checkExtent)
-				{
-					dist.Subtract(endPos,currentPos);
-					remainingDist = dist.GetApproximateLength();
-					if (remainingDist <= extRad)
-						break;
-				}
-
-				if (outsideStartRadius && (startHeight < thisHeight))
-				{
-					bool isTree = false;
-					if (GameMap->getForest(curCellRow,curCellCol))
-					{
-						maxTrees++;
-						isTree = true;
-					}
+		float horizon = setupLOS(startLocal,mCellRow,mCellCol,endLocal,tCellRow,tCellCol,startPos,endPos);
 
-					if (!isTree || (maxTrees >= MaxTreeLOSCellBlock))
-					{
-#ifdef LAB_ONLY
-						x=GetCycles()-x;
-						MCTimeLOSCalc += x;
-#endif
-		
-#ifdef LAB_ONLY
-						if (drawTerrainGrid)
-						{
-							Stuff::Vector3D realStart = startPos;
-							Stuff::Vector4D lineStart, lineEnd;
-							eye->projectZ(realStart,lineStart);
-							eye->projectZ(endPos,lineEnd);
-						
-							debugLines[currentLineElement++] = new LineElement(lineStart,lineEnd,SD_RED,NULL,-1);
-						}
-#endif
-						return false;
-					}
-				}
-
-				currentPos.x += colLength;
-				currentPos.y += rowLength;
-				currentPos.z = land->getTerrainElevation(currentPos);
-			}
-		}
+		bool result = marchLOS(startPos,endPos,tCellRow - mCellRow,tCellCol - mCellCol,extRad,startExtRad,startLocal,horizon,true);
 
 #ifdef LAB_ONLY
 		if (drawTerrainGrid)
@@ -1250,18 +1397,73 @@ bool Team::lineOfSight (float startLocal, long mCellRow, long mCellCol, float en
 			eye->projectZ(realStart,lineStart);
 			eye->projectZ(endPos,lineEnd);
 					
-			debugLines[currentLineElement++] = new LineElement(lineStart,lineEnd,SD_GREEN,NULL,-1);
+			debugLines[currentLineElement++] = new LineElement(lineStart,lineEnd,result ? SD_GREEN : SD_RED,NULL,-1);
 		}
 #endif
+
+		if (!result)
+		{
+			return false;
+		}
 	}
 	
-	#ifdef LAB_ONLY
-	x=GetCycles()-x;
-	MCTimeLOSCalc += x;
-	#endif
-	
 	return true;
 }
+
+//---------------------------------------------------------------------------
+// Casts a fixed, seeded set of rays over the loaded map, once with the
+// height bound and horizon skips and once with the original per-step
+// march, and returns how many of them came out differently.
+long Team::checkLOSHeightBound (long numRays)
+{
+	if (!GameMap || !land)
+		return(0);
+
+	long mapHeight = GameMap->getHeight();
+	long mapWidth = GameMap->getWidth();
+	unsigned long seed = 1;
+	long numMismatches = 0;
+	for (long i = 0; i < numRays; i++)
+	{
+		long values[8];
+		for (long j = 0; j < 8; j++)
+		{
+			seed = seed * 1103515245 + 12345;
+			values[j] = (seed >> 16) & 0x7fff;
+		}
+
+		long mCellRow = values[0] % mapHeight;
+		long mCellCol = values[1] % mapWidth;
+		long tCellRow = mCellRow + (values[2] % (LOS_CHECK_RANGE * 2 + 1)) - LOS_CHECK_RANGE;
+		long tCellCol = mCellCol + (values[3] % (LOS_CHECK_RANGE * 2 + 1)) - LOS_CHECK_RANGE;
+		if (tCellRow < 0)
+			tCellRow = 0;
+		else if (tCellRow >= mapHeight)
+			tCellRow = mapHeight - 1;
+		if (tCellCol < 0)
+			tCellCol = 0;
+		else if (tCellCol >= mapWidth)
+			tCellCol = mapWidth - 1;
+
+		float startLocal = (float)(values[4] % (LOS_CHECK_MAX_LOCAL + 1));
+		float endLocal = (float)(values[5] % (LOS_CHECK_MAX_LOCAL + 1));
+
+		//------------------------------------------------------------
+		// Every other ray checks for the target's extent, and every
+		// fourth one for the looker's too.
+		float extRad = (i & 1) ? (float)(values[6] % 64) : 0.0f;
+		float startExtRad = ((i & 3) == 3) ? (float)(values[7] % 64) : 0.0f;
+
+		Stuff::Vector3D startPos, endPos;
+		float horizon = setupLOS(startLocal,mCellRow,mCellCol,endLocal,tCellRow,tCellCol,startPos,endPos);
+
+		bool result = marchLOS(startPos,endPos,tCellRow - mCellRow,tCellCol - mCellCol,extRad,startExtRad,startLocal,horizon,true);
+		if (result != marchLOS(startPos,endPos,tCellRow - mCellRow,tCellCol - mCellCol,extRad,startExtRad,startLocal,horizon,false))
+			numMismatches++;
+	}
+
+	return(numMismatches);
+}
 #endif
 
 //---------------------------------------------------------------------------
@@ -1281,6 +1483,311 @@ bool Team::lineOfSight (Stuff::Vector3D position, Stuff::Vector3D targetPosition
 	return(lineOfSight(localStart,posCellR, posCellC, localEnd, tarCellR, tarCellC,teamId,extRad, startExtRad, checkVisibleBits));
 }
 
+//---------------------------------------------------------------------------
+long Team::lineOfSight (TeamLOSQuery* queries, long numQueries, long teamId, bool stopAtFirstVisible)
+{
+	//-------------------------------------------------------------
+	// Rays after the first visible one are not checked (and report
+	// false) when stopAtFirstVisible is set.
+	if (!losHeightBound)
+		initLOSHeightBound();
+
+	long numVisible = 0;
+	long i = 0;
+	for (;i < numQueries;i++)
+	{
+		queries[i].result = lineOfSight(queries[i].start,queries[i].end,teamId,queries[i].extRad,queries[i].startExtRad,false);
+		if (queries[i].result)
+		{
+			numVisible++;
+			if (stopAtFirstVisible)
+			{
+				i++;
+				break;
+			}
+		}
+	}
+
+	for (;i < numQueries;i++)
+		queries[i].result = false;
+
+	return(numVisible);
+}
+
+//---------------------------------------------------------------------------
+void Team::initLOSHeightBound (void)
+{
+	destroyLOSHeightBound();
+
+	if (!GameMap || !land || !Terrain::mapData)
+		return;
+
+	losHeightBoundRows = GameMap->getHeight();
+	losHeightBoundCols = GameMap->getWidth();
+	losHeightBound = (float*)systemHeap->Malloc(sizeof(float) * losHeightBoundRows * losHeightBoundCols);
+	gosASSERT(losHeightBound != NULL);
+
+	//-----------------------------------------------------------------
+	// A cell's terrain comes from the tile under it, but worldToCell and
+	// the elevation lookup round differently at tile edges, so take the
+	// highest vertex of the neighboring tiles too.  Off the mesh the
+	// elevation is zero.
+	long vertSide = Terrain::realVerticesMapSide;
+	for (long cellRow = 0; cellRow < losHeightBoundRows; cellRow += MAPCELL_DIM)
+	{
+		for (long cellCol = 0; cellCol < losHeightBoundCols; cellCol += MAPCELL_DIM)
+		{
+			long tileRow = cellRow / MAPCELL_DIM;
+			long tileCol = cellCol / MAPCELL_DIM;
+			float maxElevation = 0.0f;
+			for (long vertRow = tileRow - 1; vertRow <= tileRow + 2; vertRow++)
+			{
+				if ((vertRow < 0) || (vertRow >= vertSide))
+					continue;
+				for (long vertCol = tileCol - 1; vertCol <= tileCol + 2; vertCol++)
+				{
+					if ((vertCol < 0) || (vertCol >= vertSide))
+						continue;
+					float elevation = Terrain::mapData->terrainElevation(vertRow,vertCol);
+					if (elevation > maxElevation)
+						maxElevation = elevation;
+				}
+			}
+
+			maxElevation += LOS_HEIGHT_BOUND_SLACK;
+			for (long r = cellRow; (r < cellRow + MAPCELL_DIM) && (r < losHeightBoundRows); r++)
+				for (long c = cellCol; (c < cellCol + MAPCELL_DIM) && (c < losHeightBoundCols); c++)
+					losHeightBound[r * losHeightBoundCols + c] = maxElevation;
+		}
+	}
+
+	initLOSHorizon();
+}
+
+//---------------------------------------------------------------------------
+void Team::destroyLOSHeightBound (void)
+{
+	if (losHorizon)
+	{
+		systemHeap->Free(losHorizon);
+		losHorizon = NULL;
+	}
+
+	if (losHeightBound)
+	{
+		systemHeap->Free(losHeightBound);
+		losHeightBound = NULL;
+	}
+
+	losHeightBoundRows = 0;
+	losHeightBoundCols = 0;
+}
+
+//---------------------------------------------------------------------------
+static void initLOSHorizonOffsets (void)
+{
+	//---------------------------------------------------------------------
+	// The cells around a start cell, each with the sectors it overlaps and
+	// its distance from the start cell's center.  The start cell and its
+	// neighbors are left out--the march always checks those.
+	float cellSize = Terrain::worldUnitsPerCell;
+	float halfCell = cellSize * 0.5f + LOS_HORIZON_CELL_SLACK;
+	numLOSHorizonOffsets = 0;
+	for (long r = -LOS_HORIZON_RANGE; r <= LOS_HORIZON_RANGE; r++)
+	{
+		for (long c = -LOS_HORIZON_RANGE; c <= LOS_HORIZON_RANGE; c++)
+		{
+			if ((abs(r) <= 1) && (abs(c) <= 1))
+				continue;
+
+			LOSHorizonOffset* offset = &losHorizonOffsets[numLOSHorizonOffsets++];
+			offset->row = r;
+			offset->col = c;
+
+			//Rows run down the map, world Y runs up.
+			float centerX = c * cellSize;
+			float centerY = -r * cellSize;
+			float nearX = fabs(centerX) - halfCell;
+			float nearY = fabs(centerY) - halfCell;
+			if (nearX < 0.0f)
+				nearX = 0.0f;
+			if (nearY < 0.0f)
+				nearY = 0.0f;
+			float farX = fabs(centerX) + halfCell;
+			float farY = fabs(centerY) + halfCell;
+			offset->minDist = sqrt(nearX * nearX + nearY * nearY);
+			offset->maxDist = sqrt(farX * farX + farY * farY);
+
+			float centerAngle = atan2(centerY,centerX);
+			float minAngle = 0.0f;
+			float maxAngle = 0.0f;
+			for (long corner = 0; corner < 4; corner++)
+			{
+				float cornerX = centerX + ((corner & 1) ? halfCell : -halfCell);
+				float cornerY = centerY + ((corner & 2) ? halfCell : -halfCell);
+				float angle = atan2(cornerY,cornerX) - centerAngle;
+				if (angle > PI)
+					angle -= 2.0 * PI;
+				if (angle < -PI)
+					angle += 2.0 * PI;
+				if (angle < minAngle)
+					minAngle = angle;
+				if (angle > maxAngle)
+					maxAngle = angle;
+			}
+
+			long firstSector = (long)floor((centerAngle + minAngle - LOS_HORIZON_ANGLE_SLACK + PI) * (LOS_HORIZON_SECTORS / (2.0 * PI)));
+			long lastSector = (long)floor((centerAngle + maxAngle + LOS_HORIZON_ANGLE_SLACK + PI) * (LOS_HORIZON_SECTORS / (2.0 * PI)));
+			offset->firstSector = firstSector & (LOS_HORIZON_SECTORS - 1);
+			offset->numSectors = lastSector - firstSector + 1;
+		}
+	}
+
+	losHorizonNear = (1.5f * cellSize + LOS_HORIZON_CELL_SLACK) * 1.4142136f;
+	losHorizonFar = LOS_HORIZON_RANGE * cellSize;
+}
+
+//---------------------------------------------------------------------------
+void CalcLOSHorizonJob (void* data)
+{
+	LOSHorizonJob* job = (LOSHorizonJob*)data;
+	long rows = Team::losHeightBoundRows;
+	long cols = Team::losHeightBoundCols;
+	for (long r = job->firstRow; r < job->lastRow; r++)
+	{
+		for (long c = 0; c < cols; c++)
+		{
+			float* horizon = &Team::losHorizon[(r * cols + c) * LOS_HORIZON_SECTORS];
+			for (long s = 0; s < LOS_HORIZON_SECTORS; s++)
+				horizon[s] = -LOS_NO_HEIGHT_BOUND;
+
+			float base = job->cellBase[r * cols + c];
+			for (long i = 0; i < numLOSHorizonOffsets; i++)
+			{
+				LOSHorizonOffset* offset = &losHorizonOffsets[i];
+				long cellRow = r + offset->row;
+				long cellCol = c + offset->col;
+				if ((cellRow < 0) || (cellRow >= rows) || (cellCol < 0) || (cellCol >= cols))
+					continue;
+				raiseLOSHorizon(horizon,offset,getLOSHorizonSlope(job->cellTop[cellRow * cols + cellCol] - base,offset));
+			}
+		}
+	}
+}
+
+//---------------------------------------------------------------------------
+void Team::initLOSHorizon (void)
+{
+	//---------------------------------------------------------------------
+	// For each cell and each of LOS_HORIZON_SECTORS directions, the steepest
+	// slope from the terrain at the cell's center to the top (height bound
+	// plus local height) of any cell within LOS_HORIZON_RANGE in that
+	// direction.  A ray from the cell that stays above that slope can't be
+	// blocked there, so lineOfSight skips those steps.  Raising a local
+	// height raises the slopes around it (updateLOSHorizon); lowering one
+	// leaves them conservative until the next mission.
+	if (losHorizon)
+	{
+		systemHeap->Free(losHorizon);
+		losHorizon = NULL;
+	}
+
+	if (!useLOSHorizon || !losHeightBound)
+		return;
+
+	initLOSHorizonOffsets();
+
+	long numCells = losHeightBoundRows * losHeightBoundCols;
+	float* cellBase = (float*)systemHeap->Malloc(sizeof(float) * numCells);
+	gosASSERT(cellBase != NULL);
+	float* cellTop = (float*)systemHeap->Malloc(sizeof(float) * numCells);
+	gosASSERT(cellTop != NULL);
+	for (long r = 0; r < losHeightBoundRows; r++)
+	{
+		for (long c = 0; c < losHeightBoundCols; c++)
+		{
+			Stuff::Vector3D cellPos;
+			land->getCellPos(r,c,cellPos);
+			cellBase[r * losHeightBoundCols + c] = cellPos.z;
+			cellTop[r * losHeightBoundCols + c] = losHeightBound[r * losHeightBoundCols + c] + (worldUnitsPerMeter * 4.0f * (float)GameMap->getLocalHeight(r,c));
+		}
+	}
+
+	losHorizon = (float*)systemHeap->Malloc(sizeof(float) * numCells * LOS_HORIZON_SECTORS);
+	gosASSERT(losHorizon != NULL);
+
+	//-----------------------------------------------------------
+	// Every cell is independent, so split the rows across the
+	// worker threads (if we have any)...
+	LOSHorizonJob jobs[MAX_THREADPOOL_THREADS + 1];
+	long numJobs = 1;
+	if (WorkerThreads)
+		numJobs += WorkerThreads->getNumThreads();
+	for (long i = 0; i < numJobs; i++)
+	{
+		jobs[i].firstRow = (losHeightBoundRows * i) / numJobs;
+		jobs[i].lastRow = (losHeightBoundRows * (i + 1)) / numJobs;
+		jobs[i].cellBase = cellBase;
+		jobs[i].cellTop = cellTop;
+		if (WorkerThreads)
+			WorkerThreads->submit(CalcLOSHorizonJob,&jobs[i]);
+		else
+			CalcLOSHorizonJob(&jobs[i]);
+	}
+	if (WorkerThreads)
+		WorkerThreads->wait();
+
+	systemHeap->Free(cellTop);
+	systemHeap->Free(cellBase);
+
+	GameMap->numRaisedCells = 0;
+}
+
+//---------------------------------------------------------------------------
+void Team::updateLOSHorizon (void)
+{
+	if (!GameMap || !GameMap->numRaisedCells)
+		return;
+
+	if (!losHorizon)
+	{
+		GameMap->numRaisedCells = 0;
+		return;
+	}
+
+	//Too many to track (whole base went up?), so start over.
+	if (GameMap->numRaisedCells > MAX_RAISED_CELLS)
+	{
+		initLOSHorizon();
+		return;
+	}
+
+	for (long i = 0; i < GameMap->numRaisedCells; i++)
+	{
+		long cellRow = GameMap->raisedCells[i] / losHeightBoundCols;
+		long cellCol = GameMap->raisedCells[i] % losHeightBoundCols;
+		float top = losHeightBound[GameMap->raisedCells[i]] + (worldUnitsPerMeter * 4.0f * (float)GameMap->getLocalHeight(cellRow,cellCol));
+
+		//-----------------------------------------------------
+		// Every cell that has this one in its table looks at it
+		// from the opposite offset.
+		for (long j = 0; j < numLOSHorizonOffsets; j++)
+		{
+			LOSHorizonOffset* offset = &losHorizonOffsets[j];
+			long r = cellRow - offset->row;
+			long c = cellCol - offset->col;
+			if ((r < 0) || (r >= losHeightBoundRows) || (c < 0) || (c >= losHeightBoundCols))
+				continue;
+
+			Stuff::Vector3D cellPos;
+			land->getCellPos(r,c,cellPos);
+			raiseLOSHorizon(&losHorizon[(r * losHeightBoundCols + c) * LOS_HORIZON_SECTORS],offset,getLOSHorizonSlope(top - cellPos.z,offset));
+		}
+	}
+
+	GameMap->numRaisedCells = 0;
+}
+
 //***************************************************************************
 
 void disableHomeTeamTargets (void) {
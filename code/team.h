@@ -59,6 +59,18 @@ typedef struct _TeamStaticData
 	bool		noPain[MAX_TEAMS];
 } TeamStaticData;
 
+//---------------------------------------------------------------------------
+// One ray for the batched Team::lineOfSight.  Positions are world positions,
+// result is filled in by the call.
+
+typedef struct _TeamLOSQuery {
+	Stuff::Vector3D		start;
+	Stuff::Vector3D		end;
+	float				extRad;
+	float				startExtRad;
+	bool				result;
+} TeamLOSQuery;
+
 class Team {
 
 	public:
@@ -83,6 +95,20 @@ class Team {
 		static char			relations[MAX_TEAMS][MAX_TEAMS];
 		static bool			noPain[MAX_TEAMS];
 
+		//----------------------------------------------------------------
+		// Highest the terrain can be under each map cell (without local
+		// height).  Lets the LOS march skip the terrain sample wherever
+		// the ray is clearly above the ground.
+		static float*		losHeightBound;
+		static long			losHeightBoundRows;
+		static long			losHeightBoundCols;
+
+		//----------------------------------------------------------------
+		// Per cell horizon: for each of LOS_HORIZON_SECTORS directions, the
+		// steepest slope of any obstruction within LOS_HORIZON_RANGE cells
+		// (see initLOSHorizon).
+		static float*		losHorizon;
+
 	public:
 
 		virtual void init (void);
@@ -150,6 +176,20 @@ class Team {
 
 		static bool lineOfSight (Stuff::Vector3D myPos, Stuff::Vector3D targetPosition, long teamId, float targetRadius, float startRadius = 0.0f, bool checkVisibleBits = true);
 
+		static long lineOfSight (TeamLOSQuery* queries, long numQueries, long teamId, bool stopAtFirstVisible = false);
+
+		static float setupLOS (float startLocal, long mCellRow, long mCellCol, float endLocal, long tCellRow, long tCellCol, Stuff::Vector3D& startPos, Stuff::Vector3D& endPos);
+
+		static long checkLOSHeightBound (long numRays);
+
+		static void initLOSHeightBound (void);
+
+		static void destroyLOSHeightBound (void);
+
+		static void initLOSHorizon (void);
+
+		static void updateLOSHorizon (void);
+
 		//-------------------------------------------		
 		// Can anyone on my team see this position?
 		// Used for cursors, artillery, indirect fire.
@@ -94,6 +94,10 @@
 #include"bldng.h"
 #endif
 
+#ifndef ZONEPROF_H
+#include"zoneprof.h"
+#endif
+
 #ifdef USE_ELEMENTALS
 #ifndef ELEMNTL_H
 #include"elemntl.h"
@@ -284,6 +288,7 @@ int32_t			MechWarrior::increaseCap = 100;
 float			MechWarrior::maxVisualRadius = 100.0;
 int32_t			MechWarrior::curEventID = 0;
 int32_t			MechWarrior::curEventTrigger = 0;
+unsigned long	MechWarrior::statusChanges = 0;
 MechWarrior*	MechWarrior::warriorList[MAX_WARRIORS];
 
 long LastMoveCalcErr = 0;
@@ -326,6 +331,7 @@ extern float WeaponHit;
 extern float SensorSkill;
 
 extern long RamObjectWID;
+extern bool JumpOnBlocked;
 
 extern UserHeapPtr missionHeap;
 
@@ -878,6 +884,7 @@ void MechWarrior::init (bool create) {
 	wounds = 0.0;
 	health = 0.0;
 	status = WARRIOR_STATUS_NORMAL;
+	statusChanges++;
 	escapesThruEjection = false;
 	radioLog.lastMessage = -1;
 	radioLog.lastUnderFire = -1000.0f;
@@ -1399,6 +1406,7 @@ void MechWarrior::clear (void) {
 	wounds = 0.0;
 	health = 0.0;
 	status = WARRIOR_STATUS_NORMAL;
+	statusChanges++;
 	escapesThruEjection = false;
 	radioLog.lastMessage = -1;
 	radioLog.lastUnderFire = -1000.0;
@@ -1980,6 +1988,7 @@ bool MechWarrior::injure (float numWounds, bool checkEject) {
 		{
 			radioMessage(RADIO_DEATH);
 			status = WARRIOR_STATUS_DEAD;
+			statusChanges++;
 
 			if (myVehicle)
 				myVehicle->disable(PILOT_DEATH);
@@ -2024,6 +2033,7 @@ void MechWarrior::eject (void) {
 		radioMessage(RADIO_EJECTING);
 		status = WARRIOR_STATUS_EJECTED;
 	}
+	statusChanges++;
 
 
 	//------------------------------------------
@@ -2116,7 +2126,6 @@ long MechWarrior::setBrain (long brainHandle) {
 }
 
 //---------------------------------------------------------------------------
-extern __int64 MCTimeRunBrainUpdate;
 
 long MechWarrior::runBrain (void) {
 
@@ -2152,10 +2161,11 @@ long MechWarrior::runBrain (void) {
 	ModuleInfo moduleInfo;
 	brain->getInfo(&moduleInfo);
 
+	PROFILE_BEGIN_FINE("Brain Execute");
 	brain->execute();
-#ifdef LAB_ONLY
-	__int64 startTime = GetCycles();
-#endif
+	PROFILE_END("Brain Execute");
+
+	PROFILE_BEGIN_FINE("RunBrain Goal Plan");
 	//--------------------------------------------------------------
 	// Well, we'll just set it every frame so it doesn't screw up :)
 	setUseGoalPlan(!MPlayer && (getCommander() != Commander::home));
@@ -2176,9 +2186,7 @@ long MechWarrior::runBrain (void) {
 			clearCurTacOrder();
 		}
 	}
-#ifdef LAB_ONLY
-	MCTimeRunBrainUpdate += (GetCycles() - startTime);
-#endif
+	PROFILE_END("RunBrain Goal Plan");
 
 	CurGroup = NULL;
 	CurObject = NULL;
@@ -2533,7 +2541,7 @@ void MechWarrior::rethinkPath (unsigned long strategy) {
 			unsigned long params = MOVEPARAM_RECALC | MOVEPARAM_AVOID_PATHLOCKS | MOVEPARAM_FACE_TARGET;
 			if (curTacOrder.moveParams.jump)
 				params |= MOVEPARAM_JUMP;
-			requestMovePath(curTacOrder.selectionIndex, params, 2);
+			requestMovePath(curTacOrder.selectionIndex, params);
 		}
 		}
 	else if (moveOrders.pathType == MOVEPATH_COMPLEX) {
@@ -2566,7 +2574,7 @@ void MechWarrior::rethinkPath (unsigned long strategy) {
 				unsigned long params = MOVEPARAM_RECALC | MOVEPARAM_AVOID_PATHLOCKS | MOVEPARAM_FACE_TARGET;
 				if (curTacOrder.moveParams.jump)
 					params |= MOVEPARAM_JUMP;
-				requestMovePath(curTacOrder.selectionIndex, params, 3);
+				requestMovePath(curTacOrder.selectionIndex, params);
 //			}
 		}
 	}
@@ -2738,19 +2746,12 @@ void MechWarrior::setMoveGlobalPath (GlobalPathStepPtr path, long numSteps) {
 
 //---------------------------------------------------------------------------
 
-void MechWarrior::requestMovePath (long selectionIndex, unsigned long moveParams, long source) {
+void MechWarrior::requestMovePath (long selectionIndex, unsigned long moveParams, long priority) {
 
-	PathManager->request(this, selectionIndex, moveParams, source);
+	PathManager->request(this, selectionIndex, moveParams, priority);
 }
 
 //---------------------------------------------------------------------------
-#ifdef LAB_ONLY
-extern __int64 MCTimePath1Update;
-extern __int64 MCTimePath2Update;
-extern __int64 MCTimePath3Update;
-extern __int64 MCTimePath4Update;
-extern __int64 MCTimePath5Update;
-#endif
 long MechWarrior::calcMovePath (long selectionIndex, unsigned long moveParams) {
 
  	MoverPtr myVehicle = getVehicle();
@@ -2858,7 +2859,6 @@ long MechWarrior::calcMovePath (long selectionIndex, unsigned long moveParams) {
 			pathNum = 1;
 	}
 
-	__int64 startTime = 0;
 	//----------------------------------------------------------------------
 	// Before we do anything else, check if we already have a global path...
 	if (moveOrders.pathType == MOVEPATH_UNDEFINED/*numGlobalSteps == 0*/) {
@@ -2869,14 +2869,12 @@ long MechWarrior::calcMovePath (long selectionIndex, unsigned long moveParams) {
 			long result = NO_ERR;
 			if ((myVehicle->getCommander() == Commander::home) && (curTacOrder.code != TACTICAL_ORDER_NONE) && (curTacOrder.origin == ORDER_ORIGIN_PLAYER))
 				moveParams |= MOVEPARAM_PLAYER;
-			startTime = GetCycles();
+			PROFILE_BEGIN("Path Move Goal");
 			if (myVehicle->moveRadius > 0.0)
 				result = myVehicle->calcMoveGoal(target, myVehicle->moveCenter, myVehicle->moveRadius, goal, selectionIndex, goal, lastGoalPathSize, lastGoalPath, moveParams);
 			else
 				result = myVehicle->calcMoveGoal(target, goal, -1.0, goal, selectionIndex, goal, lastGoalPathSize, lastGoalPath, moveParams);
-#ifdef LAB_ONLY
-			MCTimePath1Update += (GetCycles() - startTime);
-#endif
+			PROFILE_END("Path Move Goal");
 			if (result != NO_ERR) {
 				LastMoveCalcErr = MOVEPATH_ERR_NO_VALID_GOAL;
 				triggerAlarm(PILOT_ALARM_NO_MOVEPATH, LastMoveCalcErr);
@@ -2990,11 +2988,9 @@ long MechWarrior::calcMovePath (long selectionIndex, unsigned long moveParams) {
 				((MoverPtr)ramObject)->updatePathLock(false);
 			if (myVehicle->getObjectClass() != ELEMENTAL)
 				moveParams |= MOVEPARAM_AVOID_PATHLOCKS;
-			startTime = GetCycles();
+			PROFILE_BEGIN("Path Simple");
 			long numSteps = myVehicle->calcMovePath(moveOrders.path[pathNum], MOVEPATH_SIMPLE, start, goal, NULL, moveParams | MOVEPARAM_STATIONARY_MOVERS);
-#ifdef LAB_ONLY
-			MCTimePath2Update += (GetCycles() - startTime);
-#endif
+			PROFILE_END("Path Simple");
 			if (ramObject && ramObject->isMover())
 				((MoverPtr)ramObject)->updatePathLock(true);
 			myVehicle->updatePathLock(true);
@@ -3069,7 +3065,7 @@ long MechWarrior::calcMovePath (long selectionIndex, unsigned long moveParams) {
 						GlobalMoveMap[myVehicle->getMoveLevel()]->useClosedAreas = true;
 
 				GlobalMoveMap[myVehicle->getMoveLevel()]->moverTeamID = myVehicle->getTeamId();
-				startTime = GetCycles();
+				PROFILE_BEGIN("Path Global");
 				if (GlobalMap::logEnabled) {
 					static char s[256];
 					sprintf(s, "[%.2f] calcPath: [%05d]%s", scenarioTime, myVehicle->getPartId(), myVehicle->getName());
@@ -3082,9 +3078,7 @@ long MechWarrior::calcMovePath (long selectionIndex, unsigned long moveParams) {
 																			  posCellC,
 																			  goalCellR,
 																			  goalCellC);
-#ifdef LAB_ONLY
-				MCTimePath3Update += (GetCycles() - startTime);
-#endif
+				PROFILE_END("Path Global");
 				GlobalMoveMap[myVehicle->getMoveLevel()]->useClosedAreas = false;
 			}
 			if (numSteps == -1) {
@@ -3164,7 +3158,7 @@ long MechWarrior::calcMovePath (long selectionIndex, unsigned long moveParams) {
 				setMoveWayPath(NULL, 0);
 				setMoveTimeOfLastStep(scenarioTime);
 				setMoveGlobalPath(NULL, 0);
-				PathManager->request(this, selectionIndex, MOVEPARAM_RECALC + MOVEPARAM_FACE_TARGET, 19);
+				PathManager->request(this, selectionIndex, MOVEPARAM_RECALC + MOVEPARAM_FACE_TARGET);
 				triggerAlarm(PILOT_ALARM_NO_MOVEPATH, LastMoveCalcErr);
 				return(LastMoveCalcErr);
 			}
@@ -3182,7 +3176,7 @@ long MechWarrior::calcMovePath (long selectionIndex, unsigned long moveParams) {
 				((MoverPtr)ramObject)->updatePathLock(false);
 			if (myVehicle->getObjectClass() != ELEMENTAL)
 				moveParams |= MOVEPARAM_AVOID_PATHLOCKS;
-			startTime = GetCycles();
+			PROFILE_BEGIN("Path Area");
 			long thruArea[2] = {-1, -1};
 			long goalDoor = -1;
 			if (curGlobalStep == (numGlobalSteps - 2)) {
@@ -3197,9 +3191,7 @@ long MechWarrior::calcMovePath (long selectionIndex, unsigned long moveParams) {
 			}
 			numSteps = myVehicle->calcMovePath(
                     moveOrders.path[pathNum], start, thruArea, goalDoor, moveOrders.globalGoalLocation, &goal, globalStep->goalCell, moveParams | MOVEPARAM_STATIONARY_MOVERS);
-#ifdef LAB_ONLY
-			MCTimePath4Update += (GetCycles() - startTime);
-#endif
+			PROFILE_END("Path Area");
 			if (ramObject && ramObject->isMover())
 				((MoverPtr)ramObject)->updatePathLock(true);
 			myVehicle->updatePathLock(true);
@@ -3218,11 +3210,9 @@ long MechWarrior::calcMovePath (long selectionIndex, unsigned long moveParams) {
 				((MoverPtr)ramObject)->updatePathLock(false);
 			if (myVehicle->getObjectClass() != ELEMENTAL)
 				moveParams |= MOVEPARAM_AVOID_PATHLOCKS;
-			startTime = GetCycles();
+			PROFILE_BEGIN("Path Complex");
 			numSteps = myVehicle->calcMovePath(moveOrders.path[pathNum], MOVEPATH_COMPLEX, start, goal, globalStep->goalCell, moveParams | MOVEPARAM_STATIONARY_MOVERS);
-#ifdef LAB_ONLY
-			MCTimePath5Update += (GetCycles() - startTime);
-#endif
+			PROFILE_END("Path Complex");
 			if (ramObject && ramObject->isMover())
 				((MoverPtr)ramObject)->updatePathLock(true);
 			myVehicle->updatePathLock(true);
@@ -3300,6 +3290,80 @@ long MechWarrior::calcMovePath (long selectionIndex, unsigned long moveParams) {
 
 //---------------------------------------------------------------------------
 
+bool MechWarrior::prepareMovePathJob (unsigned long moveParams, MoveMapPtr jobMap) {
+
+	//---------------------------------------------------------------------------
+	// If the pending calcMovePath() for this pilot will be the next door-to-door
+	// step of a complex path, set up the sector map the way it will and copy it
+	// into jobMap, so the solve can be done ahead of time. Everything we touch
+	// to get there (pathlocks, RamObjectWID) is put back exactly. Returns false
+	// if the request isn't one we can do this for...
+	MoverPtr myVehicle = getVehicle();
+	if (!myVehicle)
+		return(false);
+
+	if (moveParams & (MOVEPARAM_INIT + MOVEPARAM_RECALC + MOVEPARAM_ESCAPE_TILE))
+		return(false);
+
+	if (moveOrders.pathType != MOVEPATH_COMPLEX)
+		return(false);
+
+	Stuff::Vector3D goal;
+	GameObjectPtr goalObject;
+	unsigned long goalType = getMoveGoal(&goal, &goalObject);
+	if (goalType == MOVEGOAL_NONE)
+		return(false);
+	if ((goalType > 0) && !goalObject && !ObjectManager->get(goalType))
+		return(false);
+	if (goal.x < -666000.0)
+		return(false);
+
+	long curGlobalStep = moveOrders.curGlobalStep + 1;
+	long numGlobalSteps = moveOrders.numGlobalSteps;
+	if ((curGlobalStep < 1) || (curGlobalStep >= (numGlobalSteps - 2)))
+		return(false);
+
+	GlobalPathStepPtr globalStep = &moveOrders.globalPath[curGlobalStep];
+	if (!GlobalMoveMap[myVehicle->getMoveLevel()]->doors[globalStep->goalDoor].open)
+		return(false);
+
+	Stuff::Vector3D start;
+	GlobalPathStepPtr prevGlobalStep = &moveOrders.globalPath[curGlobalStep - 1];
+	land->cellToWorld(prevGlobalStep->goalCell[0], prevGlobalStep->goalCell[1], start);
+
+	long thruArea[2] = {globalStep->thruArea, moveOrders.globalPath[curGlobalStep + 1].thruArea};
+	long goalDoor = moveOrders.globalPath[curGlobalStep + 1].goalDoor;
+
+	PathLockState vehicleLocks, ramLocks;
+	myVehicle->suspendPathLock(vehicleLocks);
+	if ((curTacOrder.code == TACTICAL_ORDER_ATTACK_OBJECT) && (curTacOrder.attackParams.method == ATTACKMETHOD_RAMMING))
+		RamObjectWID = curTacOrder.targetWID;
+	else
+		RamObjectWID = 0;
+	GameObjectPtr ramObject = ObjectManager->getByWatchID(RamObjectWID);
+	if (ramObject && ramObject->isMover())
+		((MoverPtr)ramObject)->suspendPathLock(ramLocks);
+	if (myVehicle->getObjectClass() != ELEMENTAL)
+		moveParams |= MOVEPARAM_AVOID_PATHLOCKS;
+
+	long numOffsets = 8;
+	long result = myVehicle->setUpMovePath(start, thruArea, goalDoor, moveOrders.globalGoalLocation, moveParams | MOVEPARAM_STATIONARY_MOVERS, numOffsets);
+	bool prepared = (result > 0) && (numOffsets <= 8);
+	if (prepared)
+		jobMap->copySetUp(PathFindMap[SECTOR_PATHMAP]);
+	PathFindMap[SECTOR_PATHMAP]->setMover(0);
+	JumpOnBlocked = false;
+
+	if (ramObject && ramObject->isMover())
+		((MoverPtr)ramObject)->restorePathLock(ramLocks);
+	myVehicle->restorePathLock(vehicleLocks);
+	RamObjectWID = 0;
+
+	return(prepared);
+}
+
+//---------------------------------------------------------------------------
+
 bool MechWarrior::getNextWayPoint (Stuff::Vector3D& nextPoint, bool incWayPoint) {
 
 	if (!curTacOrder.isWayPathOrder())
@@ -3954,7 +4018,7 @@ bool MechWarrior::movementDecisionTree (void) {
 				unsigned long params = MOVEPARAM_RECALC | MOVEPARAM_FACE_TARGET;
 				if (curTacOrder.moveParams.jump)
 					params |= MOVEPARAM_JUMP;
-				requestMovePath(curTacOrder.selectionIndex, params, 4);
+				requestMovePath(curTacOrder.selectionIndex, params);
 			}
 		}
 	}
@@ -3975,7 +4039,7 @@ bool MechWarrior::movementDecisionTree (void) {
 					unsigned long params = MOVEPARAM_FACE_TARGET;
 					if (curTacOrder->moveParams.jump)
 						params |= MOVEPARAM_JUMP;
-					requestMovePath(curTacOrder->selectionIndex, params, 5);
+					requestMovePath(curTacOrder->selectionIndex, params);
 				}
 			}
 		}
@@ -4022,7 +4086,7 @@ bool MechWarrior::movementDecisionTree (void) {
 			unsigned long params = MOVEPARAM_INIT | MOVEPARAM_FACE_TARGET;
 			if (curTacOrder.moveParams.jump)
 				params |= MOVEPARAM_JUMP;
-			requestMovePath(curTacOrder.selectionIndex, params, 6);
+			requestMovePath(curTacOrder.selectionIndex, params);
 			}
 		else if (curTacOrder.code == TACTICAL_ORDER_MOVETO_POINT) {
 			long msg;
@@ -4061,9 +4125,9 @@ bool MechWarrior::movementDecisionTree (void) {
 			if (curTacOrder.moveParams.jump)
 				params |= MOVEPARAM_JUMP;
 			if (!moveTarget->isMover())
-				requestMovePath(curTacOrder.selectionIndex, params | MOVEPARAM_STEP_ADJACENT_TARGET, 7);
+				requestMovePath(curTacOrder.selectionIndex, params | MOVEPARAM_STEP_ADJACENT_TARGET);
 			else
-				requestMovePath(curTacOrder.selectionIndex, params, 8);
+				requestMovePath(curTacOrder.selectionIndex, params);
 			}
 		else if (curTacOrder.isCombatOrder()) {
 			Stuff::Vector3D targetPosition;
@@ -4080,7 +4144,7 @@ bool MechWarrior::movementDecisionTree (void) {
 				unsigned long params = MOVEPARAM_INIT | MOVEPARAM_FACE_TARGET;
 				if (curTacOrder.moveParams.jump)
 					params |= MOVEPARAM_JUMP;
-				requestMovePath(curTacOrder.selectionIndex, params, 9);
+				requestMovePath(curTacOrder.selectionIndex, params);
 				}
 			else if (/*!getAttackPursuit() && */!curTacOrder.attackParams.pursue)
 				setMoveStateGoal(MOVESTATE_PIVOT_TARGET);
@@ -4198,14 +4262,14 @@ bool MechWarrior::movementDecisionTree (void) {
 						setMoveGoal(target->getWatchID(), &targetPosition, target);
 						if (curTacOrder.moveParams.jump)
 							moveParams |= MOVEPARAM_JUMP;
-						requestMovePath(curTacOrder.selectionIndex, moveParams | MOVEPARAM_INIT | MOVEPARAM_FACE_TARGET, 10);
+						requestMovePath(curTacOrder.selectionIndex, moveParams | MOVEPARAM_INIT | MOVEPARAM_FACE_TARGET);
 						}
 					else {
 						setMoveGoal(MOVEGOAL_LOCATION, &targetPosition);
 						unsigned long params = MOVEPARAM_INIT | MOVEPARAM_FACE_TARGET;
 						if (curTacOrder.moveParams.jump)
 							params |= MOVEPARAM_JUMP;
-						requestMovePath(curTacOrder.selectionIndex, params, 11);
+						requestMovePath(curTacOrder.selectionIndex, params);
 					}
 				}
 			}
@@ -4225,7 +4289,7 @@ bool MechWarrior::movementDecisionTree (void) {
 				unsigned long params = MOVEPARAM_INIT | MOVEPARAM_FACE_TARGET;
 				if (curTacOrder.moveParams.jump)
 					params |= MOVEPARAM_JUMP;
-				requestMovePath(curTacOrder.selectionIndex, params, 12);
+				requestMovePath(curTacOrder.selectionIndex, params);
 			}
 		}
 		}
@@ -4245,7 +4309,7 @@ bool MechWarrior::movementDecisionTree (void) {
 					unsigned long params = MOVEPARAM_INIT | MOVEPARAM_FACE_TARGET;
 					if (curTacOrder.moveParams.jump)
 						params |= MOVEPARAM_JUMP;
-					requestMovePath(curTacOrder.selectionIndex, params, 13);
+					requestMovePath(curTacOrder.selectionIndex, params);
 					}
 				else if (getMovePath()->numStepsWhenNotPaused == 0) {
 					Stuff::Vector3D pos = goalObject->getPosition();
@@ -4253,7 +4317,7 @@ bool MechWarrior::movementDecisionTree (void) {
 					unsigned long params = MOVEPARAM_INIT | MOVEPARAM_FACE_TARGET;
 					if (curTacOrder.moveParams.jump)
 						params |= MOVEPARAM_JUMP;
-					requestMovePath(curTacOrder.selectionIndex, params, 13);
+					requestMovePath(curTacOrder.selectionIndex, params);
 				}
 				}
 			else {
@@ -4380,7 +4444,7 @@ bool MechWarrior::movementDecisionTree (void) {
 						setMoveGoal(target->getWatchID(), &pos, target);
 						if (curTacOrder.moveParams.jump)
 							moveParams |= MOVEPARAM_JUMP;
-						requestMovePath(curTacOrder.selectionIndex, moveParams | MOVEPARAM_INIT | MOVEPARAM_FACE_TARGET, 14);
+						requestMovePath(curTacOrder.selectionIndex, moveParams | MOVEPARAM_INIT | MOVEPARAM_FACE_TARGET);
 					}
 				}
 			}
@@ -5344,7 +5408,7 @@ long MechWarrior::coreMoveTo (Stuff::Vector3D location, unsigned long params) {
 	unsigned long moveParams = MOVEPARAM_INIT | MOVEPARAM_FACE_TARGET;
 	if (jump)
 		moveParams |= MOVEPARAM_JUMP;
-	PathManager->request(this, -1, moveParams, 20);
+	PathManager->request(this, -1, moveParams);
 	if (setOrder) {
 		setGeneralTacOrder(tacOrder);
 		if (useGoalPlan)
@@ -5435,7 +5499,7 @@ long MechWarrior::coreMoveToObject (GameObjectPtr object, unsigned long params)
 		moveParams |= MOVEPARAM_FACE_TARGET;
 	if (setOrder && !object->isMover())
 		moveParams |= MOVEPARAM_STEP_ADJACENT_TARGET;
-	requestMovePath(-1, moveParams, 15);
+	requestMovePath(-1, moveParams);
 	moveOrders.goalObjectPosition = object->getPosition();
 	if (setOrder) {
 		setGeneralTacOrder(tacOrder);
@@ -6012,7 +6076,7 @@ long MechWarrior::orderMoveToPoint (bool unitOrder, bool setTacOrder, long origi
 	if (setTacOrder && (origin == ORDER_ORIGIN_PLAYER))
 		if (!unitOrder || (getPoint() == getVehicle()))
 			moveParams |= MOVEPARAM_RADIO_RESULT;
-		PathManager->request(this, selectionIndex, moveParams, setTacOrder ? 21 : 23);
+		PathManager->request(this, selectionIndex, moveParams, (setTacOrder && (origin == ORDER_ORIGIN_PLAYER)) ? PATH_PRIORITY_PLAYER : PATH_PRIORITY_NONE);
 	if (setTacOrder && (result == TACORDER_FAILURE) && (origin == ORDER_ORIGIN_COMMANDER))
 		setGeneralTacOrder(tacOrder);
 
@@ -6112,7 +6176,7 @@ long MechWarrior::orderMoveToObject (bool unitOrder, bool setTacOrder, long orig
 	if (setTacOrder && (origin == ORDER_ORIGIN_PLAYER))
 		if (!unitOrder || (getPoint() == getVehicle()))
 				moveParams |= MOVEPARAM_RADIO_RESULT;
-	requestMovePath(selectionIndex, moveParams, 16);
+	requestMovePath(selectionIndex, moveParams, (setTacOrder && (origin == ORDER_ORIGIN_PLAYER)) ? PATH_PRIORITY_PLAYER : PATH_PRIORITY_NONE);
 	moveOrders.goalObjectPosition = target->getPosition();
 	if (setTacOrder && (result == TACORDER_FAILURE) && (origin == ORDER_ORIGIN_COMMANDER))
 		setGeneralTacOrder(tacOrder);
@@ -6235,7 +6299,7 @@ long MechWarrior::orderTraversePath (bool unitOrder, bool setTacOrder, long orig
 	if (setTacOrder)
 		clearAttackOrders();
 
-	requestMovePath(-1, MOVEPARAM_INIT | MOVEPARAM_FACE_TARGET, 17);
+	requestMovePath(-1, MOVEPARAM_INIT | MOVEPARAM_FACE_TARGET);
 	if (setTacOrder && (result == TACORDER_FAILURE) && (origin == ORDER_ORIGIN_COMMANDER))
 		setGeneralTacOrder(tacOrder);
 
@@ -6266,7 +6330,7 @@ long MechWarrior::orderPatrolPath (bool unitOrder, bool setTacOrder, long origin
 	if (setTacOrder)
 		clearAttackOrders();
 
-	requestMovePath(-1, MOVEPARAM_INIT | MOVEPARAM_FACE_TARGET, 18);
+	requestMovePath(-1, MOVEPARAM_INIT | MOVEPARAM_FACE_TARGET);
 	if (setTacOrder && (result == TACORDER_FAILURE) && (origin == ORDER_ORIGIN_COMMANDER))
 		setGeneralTacOrder(tacOrder);
 
@@ -8277,6 +8341,7 @@ void MechWarrior::copyFromData (MechWarriorData &data)
 	wounds = data.wounds;
 	health = data.health;
 	status = data.status;
+	statusChanges++;
 	escapesThruEjection = data.escapesThruEjection;
 	radioLog = data.radioLog;
 	notMineYet = data.notMineYet;
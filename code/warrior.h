@@ -939,6 +939,7 @@ class MechWarrior {
 		static float			maxVisualRadius;
 		static int32_t			curEventID;
 		static int32_t			curEventTrigger;
+		static unsigned long	statusChanges;			//Bumped when any warrior's status changes
 
 		static MechWarrior*		warriorList[MAX_WARRIORS];
 		static GoalManager*		goalManager;
@@ -1101,6 +1102,8 @@ class MechWarrior {
 		}
 
 		void setStatus (long _status) {
+			if (status != _status)
+				statusChanges++;
 			status = _status;
 		}
 
@@ -1688,10 +1691,12 @@ class MechWarrior {
 			return(moveOrders.path[0]->globalStep);
 		}
 
-		void requestMovePath (long selectionIndex, unsigned long moveParams, long source);
+		void requestMovePath (long selectionIndex, unsigned long moveParams, long priority = PATH_PRIORITY_NONE);
 
 		long calcMovePath (long selectionIndex, unsigned long moveParams = MOVEPARAM_NONE);
 
+		bool prepareMovePathJob (unsigned long moveParams, MoveMapPtr jobMap);
+
 		long calcMoveSpeedState (void) {
 			//-------------------------------------------------
 			// Assumes we want to go as fast as orders allow...
@@ -0,0 +1,157 @@
+#include "gameos.hpp"
+#include "toolos.hpp"
+
+#include "mclib.h"
+#include <stdio.h>
+
+
+UserHeapPtr systemHeap = NULL;
+FastFile** fastFiles = NULL;
+long numFastFiles = 0;
+long maxFastFiles = 0;
+
+// Mission paks keep the move data from packet 4 on (see Mission::init)
+#define MOVEDATA_FIRST_PACKET   4
+
+struct PakPacket {
+    unsigned char*  data;
+    int             size;
+    int             storageType;
+};
+
+//---------------------------------------------------------------------------
+
+void usage(char** argv) {
+    printf("%s -f mission.pak [-o out.pak]\n", argv[0]);
+    printf("   loads the move data of a mission and writes it back with its build info\n");
+    printf("   (map hash, area graph hash and area components) so the game can skip\n");
+    printf("   finding the components at load. Without -o the pak is rewritten in place.\n");
+}
+
+static void freePackets(PakPacket* packets, int numPackets) {
+
+    for(int i=0;i<numPackets;++i)
+        delete[] packets[i].data;
+    delete[] packets;
+}
+
+int main(int argc, char** argv)
+{
+    const char* pak_file = nullptr;
+    const char* out_file = nullptr;
+
+    if(argc < 2) {
+        usage(argv);
+        return 1;
+    }
+
+    systemHeap = new UserHeap();
+    if(!systemHeap) {
+        STOP(("Failed to initialize system heap"));
+        return -1;
+    }
+    systemHeap->init(64*1024*1024);
+
+    Environment.checkCDForFiles = false;
+
+    for(int i=1;i<argc;++i) {
+        if(0 == strcmp(argv[i], "-f") && i+1 < argc) {
+           pak_file = argv[i+1];
+           ++i;
+        }
+        else if(0 == strcmp(argv[i], "-o") && i+1 < argc) {
+           out_file = argv[i+1];
+           ++i;
+        }
+    }
+
+    if(!pak_file) {
+        usage(argv);
+        return 1;
+    }
+    if(!out_file)
+        out_file = pak_file;
+
+    PacketFile pakFile;
+    if(NO_ERR != pakFile.open(pak_file)) {
+        PAUSE(("Cannot open mission pak: %s\n", pak_file));
+        return 1;
+    }
+
+    if(pakFile.seekPacket(MOVEDATA_FIRST_PACKET) != NO_ERR || pakFile.getPacketSize() == 0) {
+        PAUSE(("Mission has no movement data: %s\n", pak_file));
+        pakFile.close();
+        return 1;
+    }
+
+    // Everything is read up front, so the pak can be rewritten in place
+    int numPackets = pakFile.getNumPackets();
+    PakPacket* packets = new PakPacket[numPackets];
+    for(int i=0;i<numPackets;++i) {
+        pakFile.seekPacket(i);
+        packets[i].size = pakFile.getPacketSize();
+        packets[i].storageType = pakFile.getStorageType();
+        packets[i].data = nullptr;
+        if(packets[i].size > 0) {
+            packets[i].data = new unsigned char[packets[i].size];
+            pakFile.readPacket(i, packets[i].data);
+        }
+    }
+
+    MOVE_init(SimpleMovePathRange);
+    long numReadPackets = MOVE_readData(&pakFile, MOVEDATA_FIRST_PACKET);
+    pakFile.close();
+    if(GlobalMoveMap[0]->badLoad) {
+        PAUSE(("Old version of move data (re-save map): %s\n", pak_file));
+        freePackets(packets, numPackets);
+        MOVE_cleanup();
+        return 1;
+    }
+
+    // MOVE_saveData counts the build info packet, MOVE_readData only if it found one
+    long numMovePackets = MOVE_saveData(NULL) - 1;
+    bool hadBuildInfo = (numReadPackets > numMovePackets);
+    int firstTrailingPacket = MOVEDATA_FIRST_PACKET + numReadPackets;
+    if(!hadBuildInfo && (firstTrailingPacket < numPackets)) {
+        // Inserting the build info would move whatever follows the move data
+        PAUSE(("Packets follow the move data, cannot add build info: %s\n", pak_file));
+        freePackets(packets, numPackets);
+        MOVE_cleanup();
+        return 1;
+    }
+
+    PacketFile outFile;
+    if(NO_ERR != outFile.create(out_file)) {
+        PAUSE(("Cannot create mission pak: %s\n", out_file));
+        freePackets(packets, numPackets);
+        MOVE_cleanup();
+        return 1;
+    }
+
+    int numOutPackets = firstTrailingPacket + (hadBuildInfo ? 0 : 1) + (numPackets - firstTrailingPacket);
+    outFile.reserve(numOutPackets);
+    int packet = 0;
+    for(int i=0;i<MOVEDATA_FIRST_PACKET + numMovePackets;++i,++packet) {
+        if(packets[i].size > 0)
+            outFile.writePacket(packet, packets[i].data, packets[i].size, packets[i].storageType);
+        else
+            outFile.writePacket(packet, nullptr, 0, STORAGE_TYPE_NUL);
+    }
+    MOVE_writeBuildInfo(&outFile, packet++);
+    for(int i=firstTrailingPacket;i<numPackets;++i,++packet) {
+        if(packets[i].size > 0)
+            outFile.writePacket(packet, packets[i].data, packets[i].size, packets[i].storageType);
+        else
+            outFile.writePacket(packet, nullptr, 0, STORAGE_TYPE_NUL);
+    }
+    outFile.close();
+
+    printf("%s: %d/%d/%d areas, build info %s\n", out_file,
+           GlobalMoveMap[0]->numAreas, GlobalMoveMap[1]->numAreas, GlobalMoveMap[2]->numAreas,
+           hadBuildInfo ? "updated" : "added");
+
+    freePackets(packets, numPackets);
+    MOVE_cleanup();
+
+    return 0;
+}
@@ -0,0 +1,335 @@
+#include "gameos.hpp"
+#include "toolos.hpp"
+
+#include "mclib.h"
+#include <stdio.h>
+#include <chrono>
+
+
+UserHeapPtr systemHeap = NULL;
+FastFile** fastFiles = NULL;
+long numFastFiles = 0;
+long maxFastFiles = 0;
+
+extern bool JumpPointSearch;
+
+// Same cost a medium mech gets in Mover::calcMovePath (cellLength / speed * 50)
+#define BENCH_CLEAR_COST    10
+#define BENCH_MAX_TRIES     1000
+
+enum {
+    QUERY_GLOBAL_GROUND,
+    QUERY_GLOBAL_HOVER,
+    QUERY_SIMPLE,
+    QUERY_SECTOR,
+    NUM_QUERY_CLASSES
+};
+
+static const char* QueryClassName[NUM_QUERY_CLASSES] = {
+    "global_ground",
+    "global_hover",
+    "simple",
+    "sector"
+};
+
+struct QueryStats {
+    long        queries;
+    long        found;
+    double      totalUs;
+    double      minUs;
+    double      maxUs;
+    double      totalNodes;
+    long        peakOpen;
+    double      totalLength;
+};
+
+//---------------------------------------------------------------------------
+// No objects are loaded, so every gate is treated as an open, enabled gate.
+
+static bool benchIsGateDisabled(int objectWID) {
+    return false;
+}
+
+static bool benchIsGateOpen(int objectWID) {
+    return true;
+}
+
+//---------------------------------------------------------------------------
+// Own generator, so the query set only depends on the seed and the map.
+
+static unsigned long benchSeed = 1;
+
+static long benchRandom(long range) {
+    benchSeed = benchSeed * 1103515245 + 12345;
+    return (long)((benchSeed >> 16) & 0x7fff) % range;
+}
+
+static bool pickCell(long moveLevel, long minR, long minC, long maxR, long maxC, long& row, long& col) {
+
+    for (long i = 0; i < BENCH_MAX_TRIES; i++) {
+        row = minR + benchRandom(maxR - minR + 1);
+        col = minC + benchRandom(maxC - minC + 1);
+        if (!GameMap->getPassable(row, col) || GameMap->getOffMap(row, col))
+            continue;
+        long area = GlobalMoveMap[moveLevel]->calcArea(row, col);
+        if ((area < 0) || !GlobalMoveMap[moveLevel]->areas[area].open)
+            continue;
+        return true;
+    }
+    return false;
+}
+
+static void addSample(QueryStats& stats, double us, long nodes, long peakOpen, bool found, long length) {
+
+    stats.queries++;
+    stats.totalUs += us;
+    if ((stats.queries == 1) || (us < stats.minUs))
+        stats.minUs = us;
+    if (us > stats.maxUs)
+        stats.maxUs = us;
+    stats.totalNodes += nodes;
+    if (peakOpen > stats.peakOpen)
+        stats.peakOpen = peakOpen;
+    if (found) {
+        stats.found++;
+        stats.totalLength += length;
+    }
+}
+
+//---------------------------------------------------------------------------
+
+static bool runGlobalQuery(long moveLevel, QueryStats& stats) {
+
+    GlobalMapPtr globalMap = GlobalMoveMap[moveLevel];
+
+    long startR, startC, goalR, goalC;
+    if (!pickCell(moveLevel, 0, 0, GameMap->height - 1, GameMap->width - 1, startR, startC))
+        return false;
+    long startArea = globalMap->calcArea(startR, startC);
+
+    // calcPath returns 0 steps for no path, so the goal must be in another area
+    long goalArea = startArea;
+    for (long i = 0; (i < BENCH_MAX_TRIES) && (goalArea == startArea); i++) {
+        if (!pickCell(moveLevel, 0, 0, GameMap->height - 1, GameMap->width - 1, goalR, goalC))
+            return false;
+        goalArea = globalMap->calcArea(goalR, goalC);
+    }
+    if (goalArea == startArea)
+        return false;
+
+    GlobalPathStep path[MAX_GLOBAL_PATH];
+    globalMap->moverTeamID = 0;
+
+    std::chrono::high_resolution_clock::time_point t0 = std::chrono::high_resolution_clock::now();
+    long numSteps = globalMap->calcPath(startArea, goalArea, path, startR, startC, goalR, goalC);
+    std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+
+    double us = std::chrono::duration<double, std::micro>(t1 - t0).count();
+    addSample(stats, us, globalMap->numNodesExpanded, globalMap->peakOpenNodes, numSteps > 0, numSteps);
+    return true;
+}
+
+//---------------------------------------------------------------------------
+
+static bool runLocalQuery(long whichMap, QueryStats& stats) {
+
+    long dim = (whichMap == SIMPLE_PATHMAP) ? (SimpleMovePathRange * 2 + 1) : (SECTOR_DIM * 2);
+    if ((GameMap->height < dim) || (GameMap->width < dim))
+        return false;
+
+    long startR, startC;
+    if (!pickCell(0, 0, 0, GameMap->height - 1, GameMap->width - 1, startR, startC))
+        return false;
+
+    //--------------------------------------------------------------
+    // Window placement mirrors Mover::calcMovePath, clamped to the map.
+    long mapULr = startR - dim / 2;
+    long mapULc = startC - dim / 2;
+    if (mapULr < 0)
+        mapULr = 0;
+    if (mapULc < 0)
+        mapULc = 0;
+    if (mapULr + dim > GameMap->height)
+        mapULr = GameMap->height - dim;
+    if (mapULc + dim > GameMap->width)
+        mapULc = GameMap->width - dim;
+
+    long goalR, goalC;
+    if (!pickCell(0, mapULr, mapULc, mapULr + dim - 1, mapULc + dim - 1, goalR, goalC))
+        return false;
+
+    MoveMapPtr moveMap = PathFindMap[whichMap];
+    Stuff::Vector3D goalPos;
+    goalPos.Zero();
+    moveMap->setMover(0, 0, false);
+    moveMap->setUp(mapULr,
+                   mapULc,
+                   dim,
+                   dim,
+                   0,
+                   NULL,
+                   startR,
+                   startC,
+                   goalPos,
+                   goalR - mapULr,
+                   goalC - mapULc,
+                   BENCH_CLEAR_COST,
+                   0,
+                   8,
+                   MOVEPARAM_WATER_SHALLOW);
+
+    MovePath path;
+    path.init();
+    Stuff::Vector3D goalWorldPos;
+    int goalCell[2];
+
+    std::chrono::high_resolution_clock::time_point t0 = std::chrono::high_resolution_clock::now();
+    long result = moveMap->calcPath(&path, &goalWorldPos, goalCell);
+    std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+
+    double us = std::chrono::duration<double, std::micro>(t1 - t0).count();
+    addSample(stats, us, moveMap->numNodesExpanded, moveMap->peakOpenNodes, result > 0, path.numStepsWhenNotPaused);
+    return true;
+}
+
+//---------------------------------------------------------------------------
+
+void usage(char** argv) {
+    printf("%s -f mission.pak [-s seed] [-n queries_per_class] [-o out.csv] [-nojps] [-nocache]\n", argv[0]);
+    printf("   loads the move data (packet 4) of a mission and times seeded path queries\n");
+}
+
+int main(int argc, char** argv)
+{
+    const char* pak_file = nullptr;
+    const char* out_file = nullptr;
+    unsigned long seed = 1;
+    long numQueries = 500;
+
+    if(argc < 2) {
+        usage(argv);
+        return 1;
+    }
+
+    systemHeap = new UserHeap();
+    if(!systemHeap) {
+        STOP(("Failed to initialize system heap"));
+        return -1;
+    }
+    systemHeap->init(64*1024*1024);
+
+    Environment.checkCDForFiles = false;
+
+    for(int i=1;i<argc;++i) {
+        if(0 == strcmp(argv[i], "-f") && i+1 < argc) {
+           pak_file = argv[i+1];
+           ++i;
+        }
+        else if(0 == strcmp(argv[i], "-o") && i+1 < argc) {
+           out_file = argv[i+1];
+           ++i;
+        }
+        else if(0 == strcmp(argv[i], "-s") && i+1 < argc) {
+           seed = strtoul(argv[i+1], nullptr, 10);
+           ++i;
+        }
+        else if(0 == strcmp(argv[i], "-n") && i+1 < argc) {
+           numQueries = atol(argv[i+1]);
+           ++i;
+        }
+        else if(0 == strcmp(argv[i], "-nojps"))
+            JumpPointSearch = false;
+        else if(0 == strcmp(argv[i], "-nocache"))
+            GlobalMap::usePathCache = false;
+    }
+
+    if(!pak_file || numQueries < 1) {
+        usage(argv);
+        return 1;
+    }
+
+    PacketFile pakFile;
+    if(NO_ERR != pakFile.open(pak_file)) {
+        PAUSE(("Cannot open mission pak: %s\n", pak_file));
+        return 1;
+    }
+
+    if(pakFile.seekPacket(4) != NO_ERR || pakFile.getPacketSize() == 0) {
+        PAUSE(("Mission has no movement data: %s\n", pak_file));
+        pakFile.close();
+        return 1;
+    }
+
+    MOVE_init(SimpleMovePathRange);
+    MOVE_readData(&pakFile, 4);
+    pakFile.close();
+    if(GlobalMoveMap[0]->badLoad) {
+        PAUSE(("Old version of move data (re-save map): %s\n", pak_file));
+        MOVE_cleanup();
+        return 1;
+    }
+
+    for(int i=0;i<3;++i) {
+        GlobalMoveMap[i]->isGateDisabledCallback = benchIsGateDisabled;
+        GlobalMoveMap[i]->isGateOpenCallback = benchIsGateOpen;
+    }
+
+    QueryStats stats[NUM_QUERY_CLASSES];
+    memset(stats, 0, sizeof(stats));
+
+    // Each class gets its own stream, so adding a class does not change the others
+    for(long qc=0;qc<NUM_QUERY_CLASSES;++qc) {
+        benchSeed = seed + qc * 7919;
+        for(long q=0;q<numQueries;++q) {
+            bool ran = false;
+            switch(qc) {
+                case QUERY_GLOBAL_GROUND:
+                    ran = runGlobalQuery(0, stats[qc]);
+                    break;
+                case QUERY_GLOBAL_HOVER:
+                    ran = runGlobalQuery(1, stats[qc]);
+                    break;
+                case QUERY_SIMPLE:
+                    ran = runLocalQuery(SIMPLE_PATHMAP, stats[qc]);
+                    break;
+                case QUERY_SECTOR:
+                    ran = runLocalQuery(SECTOR_PATHMAP, stats[qc]);
+                    break;
+            }
+            if(!ran)
+                break;
+        }
+    }
+
+    FILE* fh = stdout;
+    if(out_file) {
+        fh = fopen(out_file, "w");
+        if(!fh) {
+            PAUSE(("Cannot open file: \'%s\'\n", out_file));
+            MOVE_cleanup();
+            return 1;
+        }
+    }
+
+    fprintf(fh, "# map=%s cells=%dx%d areas=%d/%d seed=%lu jps=%d cache=%d\n",
+            pak_file, GameMap->height, GameMap->width,
+            GlobalMoveMap[0]->numAreas, GlobalMoveMap[1]->numAreas,
+            seed, JumpPointSearch ? 1 : 0, GlobalMap::usePathCache ? 1 : 0);
+    fprintf(fh, "class,queries,found,avg_us,min_us,max_us,avg_nodes_expanded,peak_open,avg_path_length\n");
+    for(long qc=0;qc<NUM_QUERY_CLASSES;++qc) {
+        const QueryStats& s = stats[qc];
+        double n = s.queries ? (double)s.queries : 1.0;
+        double found = s.found ? (double)s.found : 1.0;
+        fprintf(fh, "%s,%ld,%ld,%.2f,%.2f,%.2f,%.1f,%ld,%.1f\n",
+                QueryClassName[qc], s.queries, s.found,
+                s.totalUs / n, s.minUs, s.maxUs,
+                s.totalNodes / n, s.peakOpen, s.totalLength / found);
+    }
+
+    if(fh != stdout)
+        fclose(fh);
+
+    MOVE_cleanup();
+
+    return 0;
+}
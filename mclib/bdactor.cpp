@@ -2972,7 +2972,7 @@ void BldgAppearance::markLOS (bool clearIt)
 						cellLocalHeight = 15.0f;
 
 					if (cellLocalHeight > currentCellHeight)
-						curCell->setLocalHeight(cellLocalHeight+0.5f);
+						GameMap->setLocalHeight(cellR, cellC, cellLocalHeight+0.5f);
 				}
 				else	//We want to clear all LOS height INFO.  We're about to change shape!!
 				{
@@ -4293,7 +4293,7 @@ void TreeAppearance::markLOS (bool clearIt)
 				if (!clearIt)
 				{
 					if (cellLocalHeight > currentCellHeight)
-						curCell->setLocalHeight(cellLocalHeight+0.5f);
+						GameMap->setLocalHeight(cellR, cellC, cellLocalHeight+0.5f);
 				}
 				else	//We want to clear all LOS height INFO.  We're about to change shape!!
 				{
@@ -17,6 +17,18 @@
 
 typedef struct _PathQueueRec* PathQueueRecPtr;
 
+//------------------------------------------------------------------------
+// Path requests are served lowest priority class first. A request gains
+// one class for every MovePathManager::agingFrames frames it waits, so
+// nothing starves.
+typedef enum {
+	PATH_PRIORITY_NONE = -1,
+	PATH_PRIORITY_PLAYER,				// player issued orders
+	PATH_PRIORITY_COMBAT,				// AI attack/combat repaths
+	PATH_PRIORITY_IDLE,					// everything else (repositioning, etc.)
+	NUM_PATH_PRIORITIES
+} PathPriority;
+
 class MoveMap;
 typedef MoveMap* MoveMapPtr;
 
@@ -78,6 +78,10 @@
 #include"gvactor.h"
 #endif
 
+#ifndef ZONEPROF_H
+#include"zoneprof.h"
+#endif
+
 //-------------------------------------------------------------------------------
 // Static Globals
 extern float worldUnitsPerMeter;
@@ -2862,10 +2866,6 @@ long Mech3DAppearance::renderShadows (void)
 }
 
 bool oneMechPlease = false;
-#ifdef LAB_ONLY
-__int64 MCTimeAnimationCalc = 0;
-__int64 x;
-#endif
 
 //-----------------------------------------------------------------------------
 void Mech3DAppearance::setObjStatus (long oStatus)
@@ -2970,9 +2970,8 @@ void Mech3DAppearance::setObjStatus (long oStatus)
 //-----------------------------------------------------------------------------
 void Mech3DAppearance::updateGeometry (void)
 {
-	#ifdef LAB_ONLY
-	x=GetCycles();
-	#endif
+	PROFILE_ZONE_FINE("Animation Calc");
+
 	//Always override with our local instance.
 	mechShape->SetTextureHandle(0,localTextureHandle);
 	
@@ -3647,11 +3646,6 @@ void Mech3DAppearance::updateGeometry (void)
 			isDusting = false;
 		}
 	}
-	 
-	#ifdef LAB_ONLY
-	x=GetCycles()-x;
-	MCTimeAnimationCalc += x;
-	#endif
 }	
 
 #ifdef _DEBUG
@@ -24,6 +24,16 @@
 #endif
 #endif
 
+#ifndef THREADPOOL_H
+#include"threadpool.h"
+#endif
+
+#ifndef ZONEPROF_H
+#include"zoneprof.h"
+#endif
+
+#include<atomic>
+
 //***************************************************************************
 
 #define	USE_SEPARATE_WATER_MAPS	FALSE
@@ -38,6 +48,15 @@ typedef enum {
 #define	MAX_TEAMS						8
 #endif
 
+#define	FNV_OFFSET_BASIS	0xcbf29ce484222325ULL
+#define	FNV_PRIME			0x100000001b3ULL
+
+inline void hashValue (uint64_t& hash, unsigned int value) {
+
+	hash ^= value;
+	hash *= FNV_PRIME;
+}
+
 //------------
 // EXTERN vars
 
@@ -54,6 +73,14 @@ int GlobalMap::minCol = 0;
 int GlobalMap::maxCol = 0;
 GameLogPtr GlobalMap::log = NULL;
 bool GlobalMap::logEnabled = false;
+bool GlobalMap::usePathCache = true;
+long GlobalMap::pathCacheHits = 0;
+long GlobalMap::pathCacheMisses = 0;
+long GlobalMap::flowFieldBuilds = 0;
+long GlobalMap::flowFieldPaths = 0;
+long MoveReplanner::numRepairs = 0;
+long MoveReplanner::numRebuilds = 0;
+long MoveReplanner::numFallbacks = 0;
 //------------
 // GLOBAL vars
 bool ZeroHPrime = false;
@@ -63,12 +90,13 @@ const float LOSincrement = 0.33f;		// based upon cell size
 const float LOFincrement = 0.33f;		// based upon cell size
 const float LOSensorIncrement = 2.0;	// based upon cell size (big, since we care only about tiles)
 bool debugMoveMap = false;
-bool ClearBridgeTiles = false;
 
 long RamObjectWID = 0;
 
 PriorityQueuePtr openList = NULL;
 bool JumpOnBlocked = false;
+bool JumpPointSearch = true;
+bool IncrementalReplan = true;
 bool FindingEscapePath = false;
 bool BlockWallTiles = true;
 MissionMapPtr GameMap = NULL;
@@ -314,23 +342,15 @@ char TeamRelations[MAX_TEAMS][MAX_TEAMS] = {
 bool GoalIsDoor = false;
 long numNodesVisited = 0;
 long topOpenNodes = 0;
-long MaxHPrime = 1000;
 bool PreserveMapTiles = false;
 
 MoveMapPtr PathFindMap[2] = {NULL, NULL};
+MoveReplannerPtr PathReplanner = NULL;
 
 float MoveMap::distanceFloat[DISTANCE_TABLE_DIM][DISTANCE_TABLE_DIM];
 int MoveMap::distanceInt[DISTANCE_TABLE_DIM][DISTANCE_TABLE_DIM];
 int MoveMap::forestCost = 50;
 
-#ifdef LAB_ONLY
-__int64 MCTimeCalcPath1Update = 0;
-__int64 MCTimeCalcPath2Update = 0;
-__int64 MCTimeCalcPath3Update = 0;
-__int64 MCTimeCalcPath4Update = 0;
-__int64 MCTimeCalcPath5Update = 0;
-#endif
-
 static const char* typeString[] = {
     "normal area",
     "wall area",
@@ -514,6 +534,23 @@ void MOVE_init (long moveRange) {
 	if (SimpleMovePathRange <= 20)
 		Fatal(0, " MOVE_Init: MoveRange TOO SMALL. Go see Glenn. ");
 	PathFindMap[SIMPLE_PATHMAP]->init(SimpleMovePathRange * 2 + 1, SimpleMovePathRange * 2 + 1);
+
+	PathReplanner = new MoveReplanner;
+	if (!PathReplanner)
+		Fatal(0, " MOVE_Init: Cannot initialize PathReplanner ");
+	long maxReplanDim = SECTOR_DIM * 2;
+	if (maxReplanDim < (SimpleMovePathRange * 2 + 1))
+		maxReplanDim = SimpleMovePathRange * 2 + 1;
+	PathReplanner->init(maxReplanDim * maxReplanDim);
+
+	//--------------------------------------------------
+	// Worker threads for off-main-thread path solves...
+	if (!WorkerThreads) {
+		WorkerThreads = new ThreadPool;
+		if (!WorkerThreads)
+			Fatal(0, " MOVE_Init: Cannot initialize WorkerThreads ");
+		WorkerThreads->init(-1);
+	}
 }
 
 //---------------------------------------------------------------------------
@@ -621,7 +658,7 @@ long MOVE_saveData (PacketFile* packetFile, long whichPacket) {
 	if (!GlobalMoveMap[0])
 		Fatal(0, " MOVE_SaveData: Cannot initialize GlobalMoveMap ");
 	if (!packetFile)
-		return(GameMap->write(NULL) + GlobalMoveMap[0]->write(NULL) + GlobalMoveMap[1]->write(NULL) + GlobalMoveMap[2]->write(NULL) + 2);
+		return(GameMap->write(NULL) + GlobalMoveMap[0]->write(NULL) + GlobalMoveMap[1]->write(NULL) + GlobalMoveMap[2]->write(NULL) + 3);
 
 	//-----------------------
 	// Just some debugging...
@@ -648,7 +685,97 @@ long MOVE_saveData (PacketFile* packetFile, long whichPacket) {
 	if (result <= 0)
 		Fatal(result, " MOVE_saveData: Unable to write special area footprints ");
 
-	return(numMissionMapPackets + numGlobalMap0Packets + numGlobalMap1Packets + numGlobalMap2Packets + 2);
+	MOVE_writeBuildInfo(packetFile, whichPacket + numMissionMapPackets + numGlobalMap0Packets + numGlobalMap1Packets + numGlobalMap2Packets + 2);
+
+	return(numMissionMapPackets + numGlobalMap0Packets + numGlobalMap1Packets + numGlobalMap2Packets + 3);
+}
+
+//---------------------------------------------------------------------------
+
+long MOVE_writeBuildInfo (PacketFile* packetFile, long whichPacket) {
+
+	//---------------------------------------------------------------
+	// Header, then each map's area components in GlobalMoveMap order...
+	long numBytes = sizeof(MoveDataBuildInfo);
+	for (long i = 0; i < 3; i++)
+		numBytes += sizeof(short) * GlobalMoveMap[i]->numAreas;
+
+	unsigned char* buildInfoData = (unsigned char*)systemHeap->Malloc(numBytes);
+	gosASSERT(buildInfoData != NULL);
+	MoveDataBuildInfo* buildInfo = (MoveDataBuildInfo*)buildInfoData;
+	buildInfo->id = MOVEDATA_BUILDINFO_ID;
+	buildInfo->version = MOVEDATA_BUILDINFO_VERSION;
+	buildInfo->mapHash = GameMap->calcHash();
+	short* components = (short*)(buildInfoData + sizeof(MoveDataBuildInfo));
+	for (long i = 0; i < 3; i++) {
+		GlobalMapPtr globalMap = GlobalMoveMap[i];
+		buildInfo->topologyHash[i] = globalMap->calcTopologyHash();
+		buildInfo->numAreas[i] = globalMap->numAreas;
+		if (!globalMap->areaComponent)
+			globalMap->calcAreaComponents();
+		memcpy(components, globalMap->areaComponent, sizeof(short) * globalMap->numAreas);
+		components += globalMap->numAreas;
+	}
+
+	long result = packetFile->writePacket(whichPacket, buildInfoData, numBytes);
+	systemHeap->Free(buildInfoData);
+	if (result <= 0)
+		Fatal(result, " MOVE_writeBuildInfo: Unable to write build info ");
+	return(1);
+}
+
+//---------------------------------------------------------------------------
+
+long MOVE_readBuildInfo (PacketFile* packetFile, long whichPacket) {
+
+	//---------------------------------------------------------------------
+	// Move data saved before the build info existed simply doesn't have
+	// the packet (or has whatever the mission put after it), so anything
+	// that doesn't look like ours is left alone and we return 0 packets
+	// read. If it IS ours, it must match the map we just loaded...
+	if (whichPacket >= packetFile->getNumPackets())
+		return(0);
+	if (packetFile->seekPacket(whichPacket) != NO_ERR)
+		return(0);
+	long numBytes = packetFile->getPacketSize();
+	if (numBytes < (long)sizeof(MoveDataBuildInfo))
+		return(0);
+
+	unsigned char* buildInfoData = (unsigned char*)systemHeap->Malloc(numBytes);
+	gosASSERT(buildInfoData != NULL);
+	packetFile->readPacket(whichPacket, buildInfoData);
+	MoveDataBuildInfo* buildInfo = (MoveDataBuildInfo*)buildInfoData;
+	if (buildInfo->id != MOVEDATA_BUILDINFO_ID) {
+		systemHeap->Free(buildInfoData);
+		return(0);
+	}
+	if (buildInfo->version != MOVEDATA_BUILDINFO_VERSION) {
+		//-------------------------------------------------------------
+		// An older tool wrote it. The move data itself is still fine,
+		// we just have to find the components ourselves...
+		systemHeap->Free(buildInfoData);
+		return(1);
+	}
+
+	long expectedBytes = sizeof(MoveDataBuildInfo);
+	for (long i = 0; i < 3; i++)
+		expectedBytes += sizeof(short) * buildInfo->numAreas[i];
+	if (numBytes != expectedBytes)
+		Fatal(numBytes, " MOVE_readBuildInfo: Bad build info size (re-save map) ");
+	if (buildInfo->mapHash != GameMap->calcHash())
+		Fatal(0, " MOVE_readBuildInfo: Move data does not match map cells (re-save map) ");
+	for (long i = 0; i < 3; i++)
+		if ((buildInfo->numAreas[i] != GlobalMoveMap[i]->numAreas) || (buildInfo->topologyHash[i] != GlobalMoveMap[i]->calcTopologyHash()))
+			Fatal(i, " MOVE_readBuildInfo: Move data does not match area map (re-save map) ");
+
+	short* components = (short*)(buildInfoData + sizeof(MoveDataBuildInfo));
+	for (long i = 0; i < 3; i++) {
+		GlobalMoveMap[i]->setAreaComponents(components);
+		components += buildInfo->numAreas[i];
+	}
+
+	systemHeap->Free(buildInfoData);
+	return(1);
 }
 
 //---------------------------------------------------------------------------
@@ -688,6 +815,7 @@ long MOVE_readData (PacketFile* packetFile, long whichPacket) {
 	long numGlobalMap0Packets = GlobalMoveMap[0]->init(packetFile, whichPacket + numMissionMapPackets);
 	long numGlobalMap1Packets = 0;
 	long numGlobalMap2Packets = 0;
+	long numBuildInfoPackets = 0;
 	if (!GlobalMoveMap[0]->badLoad) {
 		//---------------------------------
 		// Let's read the hover move map...
@@ -732,6 +860,10 @@ long MOVE_readData (PacketFile* packetFile, long whichPacket) {
 				Fatal(numBytes, " MOVE_readData: Unable to read num special areas ");
 		}
 
+		numBuildInfoPackets = MOVE_readBuildInfo(packetFile, whichPacket + numMissionMapPackets + numGlobalMap0Packets + numGlobalMap1Packets + numGlobalMap2Packets + 2);
+		for (long i = 0; i < 3; i++)
+			if (!GlobalMoveMap[i]->areaComponent)
+				GlobalMoveMap[i]->calcAreaComponents();
 	}
 
 	//-----------------------
@@ -742,7 +874,7 @@ long MOVE_readData (PacketFile* packetFile, long whichPacket) {
 	//		if (GameMap->getOffMap(r, c))
 	//			numOffMap[0]++;
 
-	return(numMissionMapPackets + numGlobalMap0Packets + numGlobalMap1Packets + numGlobalMap2Packets + 2);
+	return(numMissionMapPackets + numGlobalMap0Packets + numGlobalMap1Packets + numGlobalMap2Packets + 2 + numBuildInfoPackets);
 }
 
 //---------------------------------------------------------------------------
@@ -779,6 +911,16 @@ void MOVE_cleanup (void) {
 		delete PathFindMap[SIMPLE_PATHMAP];
 		PathFindMap[SIMPLE_PATHMAP] = NULL;
 	}
+
+	if (PathReplanner) {
+		delete PathReplanner;
+		PathReplanner = NULL;
+	}
+
+	if (WorkerThreads) {
+		delete WorkerThreads;
+		WorkerThreads = NULL;
+	}
 #ifdef DEBUG_GLOBALMAP_BUILD
 	GameLog::cleanup();
 #endif
@@ -898,6 +1040,25 @@ long MissionMap::write (PacketFile* packetFile, long whichPacket) {
 
 //---------------------------------------------------------------------------
 
+#define	MAPCELL_RUNTIME_MASK	(MAPCELL_MOVER_MASK | MAPCELL_PATHLOCK_MASK | MAPCELL_DEBUG_MASK)
+
+uint64_t MissionMap::calcHash (void) {
+
+	//-----------------------------------------------------------------
+	// Movers, pathlocks and debug marks come and go while playing, so
+	// they don't count...
+	uint64_t hash = FNV_OFFSET_BASIS;
+	hashValue(hash, height);
+	hashValue(hash, width);
+	hashValue(hash, planet);
+	long numCells = height * width;
+	for (long i = 0; i < numCells; i++)
+		hashValue(hash, map[i].data & (MAPCELL_RUNTIME_MASK ^ 0xFFFFFFFF));
+	return(hash);
+}
+
+//---------------------------------------------------------------------------
+
 bool MissionMap::getPassable (Stuff::Vector3D cellPosition) {
 
 	int row, col;
@@ -1266,11 +1427,13 @@ void MovePath::operator delete (void* us) {
 long MovePath::init (long numberOfSteps) {
 
 	numSteps = numStepsWhenNotPaused = numberOfSteps;
-	static long maxNumberOfSteps = 0;
-	if (numberOfSteps > maxNumberOfSteps) {
-		maxNumberOfSteps = numberOfSteps;
-		return(maxNumberOfSteps);
-	}
+	//-------------------------------------------------------------
+	// Atomic, since path job solves may init paths on any thread...
+	static std::atomic<long> maxNumberOfSteps(0);
+	long prevMaxSteps = maxNumberOfSteps.load();
+	while (numberOfSteps > prevMaxSteps)
+		if (maxNumberOfSteps.compare_exchange_weak(prevMaxSteps, numberOfSteps))
+			return(numberOfSteps);
 	for (int i = 0; i < MAX_STEPS_PER_MOVEPATH; i++) {
 		stepList[i].distanceToGoal = 0.0;
 		stepList[i].destination.x = 0.0;
@@ -1483,6 +1646,7 @@ void GlobalMap::init (long w, long h) {
 	doors = NULL;
 	doorBuildList = NULL;
 	pathExistsTable = NULL;
+	areaComponent = NULL;
 #ifdef USE_PATH_COST_TABLE
 	pathCostTable = NULL;
 #endif
@@ -1952,20 +2116,20 @@ long GlobalMap::setTempArea (long tileR, long tileC, long cost) {
 
 //------------------------------------------------------------------------------------------
 
-bool GlobalMap::fillSpecialArea (long row, long col, long area, long specialID) {
+bool GlobalMap::fillSpecialArea (GlobalSectorAreaJobPtr job, long row, long col, long area, long specialID) {
 
 	//----------------------------------------------------------------------
 	// This is used to fill any dynamic or "special" areas. Currently, these
 	// are: wall, gate and forest.
-	areaMap[row * width + col] = area;
+	job->cellArea[(row - job->minRow) * SECTOR_DIM + (col - job->minCol)] = (short)area;
 	GameMap->setBuildNotSet(row, col, false);
 
 	for (long dir = 0; dir < 4; dir ++) {
 		long adjR = row + adjTile[dir][0];
 		long adjC = col + adjTile[dir][1];
-		if ((adjR >= minRow) && (adjR < maxRow) && (adjC >= minCol) && (adjC < maxCol))
+		if ((adjR >= job->minRow) && (adjR < job->maxRow) && (adjC >= job->minCol) && (adjC < job->maxCol))
 			if (GameMap->getBuildNotSet(adjR, adjC) && (areaMap[adjR * width + adjC] == specialID))
-				fillSpecialArea(adjR, adjC, area, specialID);
+				fillSpecialArea(job, adjR, adjC, area, specialID);
 	}
 	
 	return(true);
@@ -1973,9 +2137,9 @@ bool GlobalMap::fillSpecialArea (long row, long col, long area, long specialID)
 
 //------------------------------------------------------------------------------------------
 
-bool GlobalMap::fillArea (long row, long col, long area, bool offMap) {
+bool GlobalMap::fillArea (GlobalSectorAreaJobPtr job, long row, long col, long area, bool offMap) {
 
-	if ((row < minRow) || (row >= maxRow) || (col < minCol) || (col >= maxCol))
+	if ((row < job->minRow) || (row >= job->maxRow) || (col < job->minCol) || (col >= job->maxCol))
 		return(false);
 
 	//---------------------------------------------------------------------
@@ -2012,13 +2176,13 @@ bool GlobalMap::fillArea (long row, long col, long area, bool offMap) {
 	}
 
 	gosASSERT(area != -1);
-	areaMap[row * width + col] = area;
+	job->cellArea[(row - job->minRow) * SECTOR_DIM + (col - job->minCol)] = (short)area;
 	for (long dir = 0; dir < 4; dir ++) {
 		long adjR = row + adjTile[dir][0];
 		long adjC = col + adjTile[dir][1];
-		if ((adjR >= minRow) && (adjR < maxRow) && (adjC >= minCol) && (adjC < maxCol))
+		if ((adjR >= job->minRow) && (adjR < job->maxRow) && (adjC >= job->minCol) && (adjC < job->maxCol))
 			if (GameMap->getBuildNotSet(adjR, adjC))
-				fillArea(adjR, adjC, area, offMap);
+				fillArea(job, adjR, adjC, area, offMap);
 	}
 	
 	return(true);
@@ -2026,24 +2190,33 @@ bool GlobalMap::fillArea (long row, long col, long area, bool offMap) {
 
 //------------------------------------------------------------------------------------------
 
-void GlobalMap::calcSectorAreas (long sectorR, long sectorC) {
+void GlobalMap::calcSectorAreas (GlobalSectorAreaJobPtr job) {
 
-	minRow = sectorR * SECTOR_DIM;
-	maxRow = minRow + SECTOR_DIM;
-	minCol = sectorC * SECTOR_DIM;
-	maxCol = minCol + SECTOR_DIM;
+	//-----------------------------------------------------------------------
+	// May run on a worker thread. Only this sector's cells are touched, and
+	// areas are numbered from 0 within the sector--calcAreas renumbers them.
+	// Special sub areas are just listed here, since other sectors add to the
+	// same special areas...
+	job->minRow = job->sectorR * SECTOR_DIM;
+	job->maxRow = job->minRow + SECTOR_DIM;
+	job->minCol = job->sectorC * SECTOR_DIM;
+	job->maxCol = job->minCol + SECTOR_DIM;
+	job->numAreas = 0;
+	job->numSubAreas = 0;
+	for (long i = 0; i < (SECTOR_DIM * SECTOR_DIM); i++)
+		job->cellArea[i] = -1;
 
 	if (blank) {
-		for (long r = minRow; r < maxRow; r++)
-			for (long c = minCol; c < maxCol; c++)
+		for (long r = job->minRow; r < job->maxRow; r++)
+			for (long c = job->minCol; c < job->maxCol; c++)
 				if (GameMap->getBuildNotSet(r, c)) {
-					if (fillArea(r, c, numAreas, GameMap->getOffMap(r, c)))
-						numAreas++;
+					if (fillArea(job, r, c, job->numAreas, GameMap->getOffMap(r, c)))
+						job->numAreas++;
 				}
 		}
 	else {
-		for (long r = minRow; r < maxRow; r++)
-			for (long c = minCol; c < maxCol; c++)
+		for (long r = job->minRow; r < job->maxRow; r++)
+			for (long c = job->minCol; c < job->maxCol; c++)
 				if (GameMap->getBuildNotSet(r, c)) {
 					if (GameMap->getBuildSpecial(r, c)) {
 						long specialHere = areaMap[r * width + c];
@@ -2051,34 +2224,76 @@ void GlobalMap::calcSectorAreas (long sectorR, long sectorC) {
 						//-------------------------------------------------
 						// List this new area as part of the region covered
 						// by this gate or wall or forest...
-						if (specialAreas[specialHere].numSubAreas == MAX_SPECIAL_SUB_AREAS)
-							Fatal(MAX_SPECIAL_SUB_AREAS, " GlobalMap.calcSectorAreas: too many special subareas ");
-						specialAreas[specialHere].subAreas[specialAreas[specialHere].numSubAreas] = numAreas;
-						specialAreas[specialHere].numSubAreas++;
+						job->subAreaSpecial[job->numSubAreas] = (short)specialHere;
+						job->subAreaLocal[job->numSubAreas] = (short)job->numAreas;
+						job->numSubAreas++;
 						//-------------------
 						// Now, fill it in...
-						fillSpecialArea(r, c, numAreas++, specialHere);
+						fillSpecialArea(job, r, c, job->numAreas++, specialHere);
 						}
-					else if (fillArea(r, c, numAreas, GameMap->getOffMap(r, c)))
-						numAreas++;
+					else if (fillArea(job, r, c, job->numAreas, GameMap->getOffMap(r, c)))
+						job->numAreas++;
 				}
 	}
 }
 
 //------------------------------------------------------------------------------------------
 
+void CalcSectorAreasJob (void* data) {
+
+	GlobalSectorAreaJobPtr job = (GlobalSectorAreaJobPtr)data;
+	job->globalMap->calcSectorAreas(job);
+}
+
+//------------------------------------------------------------------------------------------
+
 void GlobalMap::calcAreas (void) {
 
 	//----------------------------------------------------------------------
 	// Large area maps use -1 and -2 to indicate blocked area. CalcArea will
 	// always return -1 for blocked-area cells.
 
-	//-----------------------------------------
-	// First, process each sector's area map...
-
+	//-----------------------------------------------------------------
+	// First, process each sector's area map. The sectors don't share
+	// any cells, so they're filled on the worker threads if we have any...
+	long numSectors = sectorHeight * sectorWidth;
+	GlobalSectorAreaJobPtr sectorJobs = (GlobalSectorAreaJobPtr)systemHeap->Malloc(sizeof(GlobalSectorAreaJob) * numSectors);
+	gosASSERT(sectorJobs != NULL);
 	for (long r = 0; r < sectorHeight; r++)
-		for (long c = 0; c < sectorWidth; c++)
-			calcSectorAreas(r, c);
+		for (long c = 0; c < sectorWidth; c++) {
+			GlobalSectorAreaJobPtr job = &sectorJobs[r * sectorWidth + c];
+			job->globalMap = this;
+			job->sectorR = r;
+			job->sectorC = c;
+			if (WorkerThreads)
+				WorkerThreads->submit(CalcSectorAreasJob, job);
+			else
+				calcSectorAreas(job);
+		}
+	if (WorkerThreads)
+		WorkerThreads->wait();
+
+	//------------------------------------------------------------------
+	// Now, number the areas in sector order, just as if each sector had
+	// been filled in turn...
+	for (long i = 0; i < numSectors; i++) {
+		GlobalSectorAreaJobPtr job = &sectorJobs[i];
+		job->firstArea = numAreas;
+		for (long r = job->minRow; r < job->maxRow; r++)
+			for (long c = job->minCol; c < job->maxCol; c++) {
+				long localArea = job->cellArea[(r - job->minRow) * SECTOR_DIM + (c - job->minCol)];
+				if (localArea > -1)
+					areaMap[r * width + c] = job->firstArea + localArea;
+			}
+		for (long j = 0; j < job->numSubAreas; j++) {
+			GlobalSpecialAreaInfo* specialArea = &specialAreas[job->subAreaSpecial[j]];
+			if (specialArea->numSubAreas == MAX_SPECIAL_SUB_AREAS)
+				Fatal(MAX_SPECIAL_SUB_AREAS, " GlobalMap.calcSectorAreas: too many special subareas ");
+			specialArea->subAreas[specialArea->numSubAreas] = job->firstArea + job->subAreaLocal[j];
+			specialArea->numSubAreas++;
+		}
+		numAreas += job->numAreas;
+	}
 
 	//-----------------------------------------------------------------------
 	// NOTE: We allocate one extra area--this is used by the calcPath routine
@@ -2103,21 +2318,20 @@ void GlobalMap::calcAreas (void) {
 
 	//-----------------------------------------
 	// Set each area's sector row and column...
-	for (long sectorR = 0; sectorR < sectorHeight; sectorR++)
-		for (long sectorC = 0; sectorC < sectorWidth; sectorC++) {
-			minRow = sectorR * SECTOR_DIM;
-			maxRow = minRow + SECTOR_DIM;
-			minCol = sectorC * SECTOR_DIM;
-			maxCol = minCol + SECTOR_DIM;
-			for (long r = minRow; r < maxRow; r++)
-				for (long c = minCol; c < maxCol; c++) {
-					long curArea = areaMap[r * width + c];
-					if (curArea > -1) {
-						areas[curArea].sectorR = sectorR;
-						areas[curArea].sectorC = sectorC;
-					}
+	for (long i = 0; i < numSectors; i++) {
+		GlobalSectorAreaJobPtr job = &sectorJobs[i];
+		for (long r = job->minRow; r < job->maxRow; r++)
+			for (long c = job->minCol; c < job->maxCol; c++) {
+				long curArea = areaMap[r * width + c];
+				if (curArea > -1) {
+					areas[curArea].sectorR = job->sectorR;
+					areas[curArea].sectorC = job->sectorC;
 				}
-		}
+			}
+	}
+
+	systemHeap->Free(sectorJobs);
+	sectorJobs = NULL;
 }
 
 //------------------------------------------------------------------------------------------
@@ -2413,7 +2627,7 @@ void GlobalMap::calcAreaDoors (void) {
 
 //------------------------------------------------------------------------------------------
 
-long GlobalMap::calcLinkCost (long startDoor, long thruArea, long goalDoor) {
+long GlobalMap::calcLinkCost (long startDoor, long thruArea, long goalDoor, MoveMapPtr moveMap) {
 
 	if ((doors[startDoor].area[0] != thruArea) && (doors[startDoor].area[1] != thruArea))
 		return(-1);
@@ -2466,13 +2680,18 @@ long GlobalMap::calcLinkCost (long startDoor, long thruArea, long goalDoor) {
 
 	long cost = 9999;
 	
-	if (!PathFindMap[SECTOR_PATHMAP]) {
-		PathFindMap[SECTOR_PATHMAP] = new MoveMap;
-		PathFindMap[SECTOR_PATHMAP]->init(30, 30);
-	}
-	if (!PathFindMap[SIMPLE_PATHMAP]) {
-		PathFindMap[SIMPLE_PATHMAP] = new MoveMap;
-		PathFindMap[SIMPLE_PATHMAP]->init(SimpleMovePathRange * 2 + 1, SimpleMovePathRange * 2 + 1);
+	//--------------------------------------------------------------
+	// Door link jobs bring their own map (and must not allocate)...
+	if (!moveMap) {
+		if (!PathFindMap[SECTOR_PATHMAP]) {
+			PathFindMap[SECTOR_PATHMAP] = new MoveMap;
+			PathFindMap[SECTOR_PATHMAP]->init(30, 30);
+		}
+		if (!PathFindMap[SIMPLE_PATHMAP]) {
+			PathFindMap[SIMPLE_PATHMAP] = new MoveMap;
+			PathFindMap[SIMPLE_PATHMAP]->init(SimpleMovePathRange * 2 + 1, SimpleMovePathRange * 2 + 1);
+		}
+		moveMap = PathFindMap[SECTOR_PATHMAP];
 	}
 
 	//-------------------------------------------------------------------------
@@ -2491,7 +2710,7 @@ long GlobalMap::calcLinkCost (long startDoor, long thruArea, long goalDoor) {
 		newPath.cost = 10;
 		}
 	else {
-		ClearBridgeTiles = true;
+		moveMap->clearBridgeTiles = true;
 		long mapULr = areas[thruArea].sectorR * SECTOR_DIM;
 		long mapULc = areas[thruArea].sectorC * SECTOR_DIM;
 		long moveParams = MOVEPARAM_NONE;
@@ -2502,7 +2721,7 @@ long GlobalMap::calcLinkCost (long startDoor, long thruArea, long goalDoor) {
 #if USE_SEPARATE_WATER_MAPS
 		// To REALLY fix the separate water maps, we should do this for vehicles and mechs separately (and vehicles
 		// don't use shallow). But, if nothing else, this fixes the bug where we weren't passing in the moveParams.
-		PathFindMap[SECTOR_PATHMAP]->setUp(mapULr,
+		moveMap->setUp(mapULr,
 					   mapULc,
 					   SECTOR_DIM,
 					   SECTOR_DIM,
@@ -2518,7 +2737,7 @@ long GlobalMap::calcLinkCost (long startDoor, long thruArea, long goalDoor) {
 					   8,
 					   moveParams);
 #else
-		PathFindMap[SECTOR_PATHMAP]->setUp(mapULr,
+		moveMap->setUp(mapULr,
 					   mapULc,
 					   SECTOR_DIM,
 					   SECTOR_DIM,
@@ -2535,8 +2754,8 @@ long GlobalMap::calcLinkCost (long startDoor, long thruArea, long goalDoor) {
 					   MOVEPARAM_NONE);
 #endif
 		int goalCell[2];
-		PathFindMap[SECTOR_PATHMAP]->calcPath(&newPath, NULL, goalCell);
-		ClearBridgeTiles = false;
+		moveMap->calcPath(&newPath, NULL, goalCell);
+		moveMap->clearBridgeTiles = false;
 	}
 
 	//-------------------------------------------------------------------------
@@ -2572,19 +2791,54 @@ void GlobalMap::changeAreaLinkCost (long area, long cost) {
 	GlobalMapAreaPtr thruArea = &areas[area];
     DoorInfoPtr thruDoorInfo = areas_doors[area];
 	long numDoors = thruArea->numDoors;
+	bool changed = false;
 	for (long i = 0; i < numDoors; i++) {
 		//GlobalMapDoorPtr curDoor = &doors[thruArea->doors[i].doorIndex];
 		//long doorSide = thruArea->doors[i].doorSide;
 		GlobalMapDoorPtr curDoor = &doors[thruDoorInfo[i].doorIndex];
 		DoorInfoLinksPtr& curDoor_links = doors_links[thruDoorInfo[i].doorIndex];
 		long doorSide = thruDoorInfo[i].doorSide;
-		for (long j = 0; j < curDoor->numLinks[doorSide]; j++)
+		for (long j = 0; j < curDoor->numLinks[doorSide]; j++) {
+			if (curDoor_links[doorSide][j].cost != cost)
+				changed = true;
 			curDoor_links[doorSide][j].cost = cost;
+		}
+	}
+	if (changed)
+		touchArea(area);
+}
+
+//------------------------------------------------------------------------------------------
+
+void GlobalMap::calcDoorLinkCosts (GlobalDoorLinkJobPtr job) {
+
+	//---------------------------------------------------------------------
+	// May run on a worker thread. The links are already allocated and set
+	// up by calcDoorLinks, we just fill in the costs for our doors...
+	for (long d = job->firstDoor; d < numDoors; d += job->doorStep) {
+		GlobalMapDoorPtr thisDoor = &doors[d];
+		DoorInfoLinksPtr& thisDoor_links = doors_links[d];
+		for (long s = 0; s < 2; s++) {
+			long area = thisDoor->area[s];
+			for (long i = 0; i < thisDoor->numLinks[s]; i++) {
+				DoorLinkPtr link = &thisDoor_links[s][i];
+				link->cost = calcLinkCost(d, area, link->doorIndex, job->moveMap);
+				link->openCost = link->cost;
+			}
+		}
 	}
 }
 
 //------------------------------------------------------------------------------------------
 
+void CalcDoorLinkCostsJob (void* data) {
+
+	GlobalDoorLinkJobPtr job = (GlobalDoorLinkJobPtr)data;
+	job->globalMap->calcDoorLinkCosts(job);
+}
+
+//------------------------------------------------------------------------------------------
+
 void GlobalMap::calcDoorLinks (void) {
 
 	numDoorLinks = 0;
@@ -2615,8 +2869,8 @@ void GlobalMap::calcDoorLinks (void) {
 					if (curDoor != thisDoor) {
 						thisDoor_links[s][linkIndex].doorIndex = doorIndex;
 						thisDoor_links[s][linkIndex].doorSide = (curDoor->area[1] == area);
-						thisDoor_links[s][linkIndex].cost = calcLinkCost(d, area, doorIndex);
-						thisDoor_links[s][linkIndex].openCost = thisDoor_links[s][linkIndex].cost;
+						thisDoor_links[s][linkIndex].cost = 0;
+						thisDoor_links[s][linkIndex].openCost = 0;
 						linkIndex++;
 					}
 				}
@@ -2626,6 +2880,35 @@ void GlobalMap::calcDoorLinks (void) {
 		}
 	}
 
+	//-------------------------------------------------------------------
+	// Each link cost is a sector path solve that only reads the maps, so
+	// the doors are dealt out to the worker threads, each with a sector
+	// map of its own. The main thread's map takes the first share...
+	long numLinkJobs = 1;
+	if (WorkerThreads && (WorkerThreads->getNumThreads() > 0) && PathFindMap[SECTOR_PATHMAP])
+		numLinkJobs = WorkerThreads->getNumThreads() + 1;
+	GlobalDoorLinkJob linkJobs[MAX_THREADPOOL_THREADS + 1];
+	for (long i = 0; i < numLinkJobs; i++) {
+		linkJobs[i].globalMap = this;
+		linkJobs[i].moveMap = NULL;
+		linkJobs[i].firstDoor = i;
+		linkJobs[i].doorStep = numLinkJobs;
+		if (i > 0) {
+			linkJobs[i].moveMap = new MoveMap;
+			gosASSERT(linkJobs[i].moveMap != NULL);
+			linkJobs[i].moveMap->init(PathFindMap[SECTOR_PATHMAP]->maxHeight, PathFindMap[SECTOR_PATHMAP]->maxWidth);
+			linkJobs[i].moveMap->initOpenList();
+			WorkerThreads->submit(CalcDoorLinkCostsJob, &linkJobs[i]);
+		}
+	}
+	calcDoorLinkCosts(&linkJobs[0]);
+	if (numLinkJobs > 1)
+		WorkerThreads->wait();
+	for (long i = 1; i < numLinkJobs; i++) {
+		delete linkJobs[i].moveMap;
+		linkJobs[i].moveMap = NULL;
+	}
+
 	//----------------------------------------
 	// Now, set up the start and goal doors...
 	doors[numDoors + DOOR_OFFSET_START].numLinks[0] = maxDoors;
@@ -2944,7 +3227,104 @@ unsigned char GlobalMap::getPathExists (long fromArea, long toArea) {
 	pathByte += (rowWidth * fromArea + (toArea / 4));
 	unsigned char pathShift = (toArea % 4) * 2;
 	unsigned char pathBit = 0x03 << pathShift;
-	return(*pathByte & pathBit);
+	//-------------------------------------------------------------
+	// Shifted down, so it compares against GLOBALPATH_EXISTS_* for
+	// every toArea and not only those with toArea % 4 == 0...
+	unsigned char pathExists = (*pathByte & pathBit) >> pathShift;
+	if ((pathExists == GLOBALPATH_EXISTS_UNKNOWN) && areaComponent && (areaComponent[fromArea] != areaComponent[toArea]))
+		return(GLOBALPATH_EXISTS_FALSE);
+	return(pathExists);
+}
+
+//------------------------------------------------------------------------------------------
+
+void GlobalMap::calcAreaComponents (void) {
+
+	//----------------------------------------------------------------------
+	// Union-find over every door, open or not. Two areas in different
+	// components can never reach each other, whatever the gates are doing...
+	if (areaComponent) {
+		systemHeap->Free(areaComponent);
+		areaComponent = NULL;
+	}
+	if (numAreas < 1)
+		return;
+	areaComponent = (short*)systemHeap->Malloc(sizeof(short) * numAreas);
+	gosASSERT(areaComponent != NULL);
+	for (long i = 0; i < numAreas; i++)
+		areaComponent[i] = (short)i;
+
+	for (long d = 0; d < numDoors; d++) {
+		long root[2];
+		for (long side = 0; side < 2; side++) {
+			long area = doors[d].area[side];
+			if ((area < 0) || (area >= numAreas)) {
+				root[side] = -1;
+				break;
+			}
+			while (areaComponent[area] != area) {
+				areaComponent[area] = areaComponent[areaComponent[area]];
+				area = areaComponent[area];
+			}
+			root[side] = area;
+		}
+		if ((root[0] < 0) || (root[1] < 0) || (root[0] == root[1]))
+			continue;
+		//----------------------------------------------------
+		// Lower index wins, so the result doesn't depend on
+		// the order the doors were built in...
+		if (root[0] < root[1])
+			areaComponent[root[1]] = (short)root[0];
+		else
+			areaComponent[root[0]] = (short)root[1];
+	}
+
+	for (long i = 0; i < numAreas; i++)
+		areaComponent[i] = areaComponent[areaComponent[i]];
+}
+
+//------------------------------------------------------------------------------------------
+
+void GlobalMap::setAreaComponents (short* components) {
+
+	if (areaComponent) {
+		systemHeap->Free(areaComponent);
+		areaComponent = NULL;
+	}
+	if (numAreas < 1)
+		return;
+	areaComponent = (short*)systemHeap->Malloc(sizeof(short) * numAreas);
+	gosASSERT(areaComponent != NULL);
+	memcpy(areaComponent, components, sizeof(short) * numAreas);
+}
+
+//------------------------------------------------------------------------------------------
+
+uint64_t GlobalMap::calcTopologyHash (void) {
+
+	uint64_t hash = FNV_OFFSET_BASIS;
+	hashValue(hash, width);
+	hashValue(hash, height);
+	hashValue(hash, numAreas);
+	hashValue(hash, numDoors);
+	if (areaMap) {
+		long numCells = width * height;
+		for (long i = 0; i < numCells; i++)
+			hashValue(hash, (unsigned short)areaMap[i]);
+	}
+	if (areas)
+		for (long i = 0; i < numAreas; i++) {
+			hashValue(hash, areas[i].sectorR);
+			hashValue(hash, areas[i].sectorC);
+			hashValue(hash, areas[i].type);
+			hashValue(hash, areas[i].numDoors);
+		}
+	if (doors)
+		for (long i = 0; i < numDoors; i++) {
+			hashValue(hash, (unsigned short)doors[i].area[0]);
+			hashValue(hash, (unsigned short)doors[i].area[1]);
+		}
+	return(hash);
 }
 
 //------------------------------------------------------------------------------------------
@@ -3139,6 +3519,8 @@ void GlobalMap::setStartDoor (long startArea) {
 	startDoor->numLinks[1] = 0;
 	startDoor->fromAreaIndex = 1;
 
+	startDoorPick = -1;
+	long startDoorPickCost = 0;
 	for (long curLink = 0; curLink < startDoor->numLinks[0]; curLink++) {
 		//---------------------------------------------
 		// Point the goal "door" to its area's doors...
@@ -3157,6 +3539,11 @@ void GlobalMap::setStartDoor (long startArea) {
 				costSum += (startCell[1] - curDoor->col);
 			else
 				costSum += (curDoor->col - startCell[1]);
+
+			if ((startDoorPick == -1) || (costSum < startDoorPickCost)) {
+				startDoorPick = doorIndex;
+				startDoorPickCost = costSum;
+			}
 		}
 
 		//startDoor->links[0][curLink].doorIndex = doorIndex;
@@ -3213,7 +3600,12 @@ void GlobalMap::setAreaTeamID (long area, char teamID) {
 	const DoorInfoPtr curArea_doors = areas_doors[area];
 	curArea->teamID = teamID;
 	for (long d = 0; d < curArea->numDoors; d++) {
-		doors[curArea_doors[d].doorIndex].teamID = teamID;
+		GlobalMapDoorPtr curDoor = &doors[curArea_doors[d].doorIndex];
+		if (curDoor->teamID != teamID) {
+			touchArea(curDoor->area[0]);
+			touchArea(curDoor->area[1]);
+		}
+		curDoor->teamID = teamID;
 	}
 	//opens = true;
 }
@@ -3258,6 +3650,8 @@ void GlobalMap::setGoalDoor (long goalArea) {
 	goalDoor->numLinks[0] = areas[goalArea].numDoors;
 	goalDoor->numLinks[1] = 0;
 	
+	goalDoorPick = -1;
+	long goalDoorPickCost = 0;
 	for (long curLink = 0; curLink < goalDoor->numLinks[0]; curLink++) {
 		//---------------------------------------------
 		// Point the goal "door" to its area's doors...
@@ -3277,6 +3671,11 @@ void GlobalMap::setGoalDoor (long goalArea) {
 				costSum += (goalCell[1] - curDoor->col);
 			else
 				costSum += (curDoor->col - goalCell[1]);
+
+			if ((goalDoorPick == -1) || (costSum < goalDoorPickCost)) {
+				goalDoorPick = doorIndex;
+				goalDoorPickCost = costSum;
+			}
 		}
 		goalDoor_links[0][curLink].doorIndex = doorIndex;
 		goalDoor_links[0][curLink].doorSide = doorSide;
@@ -3347,7 +3746,8 @@ inline void GlobalMap::propogateCost (long door, long cost, long fromAreaIndex,
 				sprintf(s, "GlobalMap.propogateCost: Cannot find globalmap door [%d, %d, %d, %d] for change\n", door, cost, fromAreaIndex, g);
 				gosASSERT(openIndex != 0);
 			}
-			openList->change(door, curMapDoor->fPrime);
+			else
+				openList->change(openIndex, curMapDoor->fPrime);
 			}
 		else {
 			long toAreaIndex = 1 - fromAreaIndex;
@@ -3403,6 +3803,9 @@ long GlobalMap::calcPath (long startArea,
 	//systemHeap->walkHeap(false,false,"GlobalMap:calc BAD HEAP1\n");
 	#endif
 
+	numNodesExpanded = 0;
+	peakOpenNodes = 0;
+
 	if ((startArea == -1) || (goalArea == -1))
 		return(-1);
 
@@ -3467,6 +3870,18 @@ long GlobalMap::calcPath (long startArea,
 	if (!isGateOpenCallback || !isGateDisabledCallback)
 		STOP(("Globalmap.calcPath: NULL gate callback"));
 
+	//--------------------------------------------------------------------
+	// Off map areas are opened just for this search, so don't bother
+	// caching paths that start or end in one...
+	bool cachePath = usePathCache && !areas[startArea].offMap && !areas[goalArea].offMap;
+	if (cachePath && !pathCache)
+		initPathCache();
+
+	//-------------------------------------------------------------------
+	// The gates are set for this mover's team on every search, so teams
+	// taking turns would otherwise keep staling each other's paths. Only
+	// a change in what this team sees of a gate stales its own paths...
+	touchAreas = false;
 	for (long i = 0; i < numAreas; i++)
 		if (areas[i].type == AREA_TYPE_GATE) {
 			if ((areas[i].teamID == moverTeamID) || (areas[i].teamID == -1)) {
@@ -3483,7 +3898,60 @@ long GlobalMap::calcPath (long startArea,
 				openArea(i);
 			else
 				closeArea(i);
+			setGateSeen(i, areas[i].open);
+		}
+	touchAreas = true;
+
+	//------------------------------------------------------------------
+	// Now that the gates are set for this mover, see if we already have
+	// a path whose areas haven't changed since we calced it...
+	if (cachePath) {
+		GlobalPathCacheEntryPtr entry = findPathCacheEntry(startArea, goalArea);
+		if (entry) {
+			resetStartDoor(startArea);
+			resetGoalDoor(goalArea);
+			pathCacheHits++;
+			for (long i = 0; i < entry->numSteps; i++) {
+				path[i].thruArea = entry->steps[i].thruArea;
+				path[i].goalDoor = entry->steps[i].goalDoor;
+				path[i].costToGoal = entry->steps[i].costToGoal;
+			}
+			if (logEnabled) {
+				char s[50];
+				sprintf(s, "     CACHED PATH: %d steps", entry->numSteps);
+				log->write(s);
+				log->write(" ");
+			}
+			return(entry->numSteps);
+		}
+
+		//-------------------------------------------------------------
+		// If a group was just sent to this area, read the path off its
+		// flow field...
+		if (startArea != goalArea) {
+			GlobalFlowFieldPtr field = getFlowField(goalArea);
+			if (field) {
+				long numSteps = calcFlowFieldPath(field, startArea, path);
+				if (numSteps > -1) {
+					resetStartDoor(startArea);
+					resetGoalDoor(goalArea);
+					flowFieldPaths++;
+					if (logEnabled) {
+						char s[50];
+						sprintf(s, "     FLOW FIELD PATH: %d steps", numSteps);
+						log->write(s);
+						log->write(" ");
+					}
+					return(numSteps);
+				}
+			}
 		}
+		pathCacheMisses++;
+		pathCacheNumAreas = 0;
+		addPathCacheArea(startArea);
+		addPathCacheArea(goalArea);
+	}
+	unsigned long searchStamp = pathCacheStamp;
 
 	//-------------------------------------------------------------
 	// Start with the area we're in, and process the possible doors
@@ -3509,6 +3977,10 @@ long GlobalMap::calcPath (long startArea,
 	bool goalFound = false;
 
 	while (!openList->isEmpty()) {
+		if (peakOpenNodes < openList->getNumItems())
+			peakOpenNodes = openList->getNumItems();
+		numNodesExpanded++;
+
 		//----------------------
 		// Grab the best node...
 		PQNode bestPQNode;
@@ -3538,6 +4010,8 @@ long GlobalMap::calcPath (long startArea,
 		long toAreaIndex = 1 - fromAreaIndex;
 		long thruArea = bestMapDoor->area[toAreaIndex];
 		long numLinks = bestMapDoor->numLinks[toAreaIndex];
+		if (cachePath)
+			addPathCacheArea(thruArea);
 		
 		if (logEnabled) {
 			char s[50];
@@ -3699,6 +4173,9 @@ long GlobalMap::calcPath (long startArea,
 			curPathDoor--;
 		}
 
+		if (cachePath)
+			storePathCacheEntry(startArea, goalArea, searchStamp, path, numDoors);
+
 		#ifdef _DEBUG
 		//systemHeap->walkHeap(false,false,"GlobalMap:calc BAD HEAP2\n");
 		#endif
@@ -3738,6 +4215,8 @@ long GlobalMap::calcPath (long startArea,
 			}
 		}
 #endif
+		if (cachePath)
+			storePathCacheEntry(startArea, goalArea, searchStamp, path, 0);
 		if (logEnabled)
 			log->write("     NO PATH FOUND");
 	}
@@ -3764,6 +4243,10 @@ long GlobalMap::calcPath (Stuff::Vector3D start, Stuff::Vector3D goal, GlobalPat
 
 void GlobalMap::openDoor (long door) {
 
+	if (!doors[door].open) {
+		touchArea(doors[door].area[0]);
+		touchArea(doors[door].area[1]);
+	}
 	doors[door].cost = 10;
 	doors[door].open = true;
 }
@@ -3772,6 +4255,10 @@ void GlobalMap::openDoor (long door) {
 
 void GlobalMap::closeDoor (long door) {
 
+	if (doors[door].open) {
+		touchArea(doors[door].area[0]);
+		touchArea(doors[door].area[1]);
+	}
 	doors[door].open = false;
 }
 
@@ -3784,6 +4271,8 @@ void GlobalMap::closeArea (long area) {
 
 	GlobalMapAreaPtr closedArea = &areas[area];
     const DoorInfoPtr& closedArea_doors = areas_doors[area];
+	if (closedArea->open)
+		touchArea(area);
 	closedArea->open = false;
 	for (long d = 0; d < closedArea->numDoors; d++)
 		closeDoor(closedArea_doors[d].doorIndex);
@@ -3792,8 +4281,11 @@ void GlobalMap::closeArea (long area) {
 		GlobalMapDoorPtr curDoor = &doors[closedArea_doors[i].doorIndex];
 		DoorInfoLinksPtr& curDoor_links = doors_links[closedArea_doors[i].doorIndex];
 		long doorSide = closedArea_doors[i].doorSide;
-		for (long j = 0; j < curDoor->numLinks[doorSide]; j++)
+		for (long j = 0; j < curDoor->numLinks[doorSide]; j++) {
+			if (curDoor_links[doorSide][j].cost != 1000)
+				touchArea(area);
 			curDoor_links[doorSide][j].cost = 1000;
+		}
 	}
 
 	closes = true;
@@ -3809,6 +4301,8 @@ void GlobalMap::openArea (long area) {
 	GlobalMapAreaPtr openedArea = &areas[area];
     const DoorInfoPtr& openedArea_doors = areas_doors[area];
 
+	if (!openedArea->open)
+		touchArea(area);
 	openedArea->open = true;
 	for (long d = 0; d < openedArea->numDoors; d++) {
 		long areaSide1 = doors[openedArea_doors[d].doorIndex].area[0];
@@ -3821,8 +4315,11 @@ void GlobalMap::openArea (long area) {
 		GlobalMapDoorPtr curDoor = &doors[openedArea_doors[i].doorIndex];
 		DoorInfoLinksPtr& curDoor_links = doors_links[openedArea_doors[i].doorIndex];
 		long doorSide = openedArea_doors[i].doorSide;
-		for (long j = 0; j < curDoor->numLinks[doorSide]; j++)
+		for (long j = 0; j < curDoor->numLinks[doorSide]; j++) {
+			if (curDoor_links[doorSide][j].cost != curDoor_links[doorSide][j].openCost)
+				touchArea(area);
 			curDoor_links[doorSide][j].cost = curDoor_links[doorSide][j].openCost;
+		}
 	}
 
 	opens = true;
@@ -3830,117 +4327,617 @@ void GlobalMap::openArea (long area) {
 
 //---------------------------------------------------------------------------
 
-void GlobalMap::print (char* fileName) {
-
-	if (areaMap)
-		return;
+void GlobalMap::initPathCache (void) {
 
-	File* debugFile = new File;
-	debugFile->create(fileName);
+	destroyPathCache();
 
-	char outString[500];
-	for (long row = 0; row < height; row++) {
-		outString[0] = '\0';
-		for (long col = 0; col < width; col++) {
-			if (areaMap[row * width + col] == -2)
-				strcat(outString, ">< ");
-			else if (areaMap[row * width + col] == -1)
-				strcat(outString, "** ");
-			else {
-				char chStr[8];
-				sprintf(chStr, "%02x ", areaMap[row * width + col]);
-				strcat(outString, chStr);
-			}
-		}
-		strcat(outString, "\n");
-		debugFile->writeString(outString);
+	pathCache = (GlobalPathCacheEntryPtr)systemHeap->Malloc(sizeof(GlobalPathCacheEntry) * GLOBAL_PATH_CACHE_SIZE);
+	gosASSERT(pathCache != NULL);
+	for (long i = 0; i < GLOBAL_PATH_CACHE_SIZE; i++) {
+		pathCache[i].valid = false;
+		pathCache[i].numSteps = 0;
+		pathCache[i].numAreas = 0;
+		pathCache[i].steps = (GlobalPathCacheStep*)systemHeap->Malloc(sizeof(GlobalPathCacheStep) * MAX_GLOBAL_PATH);
+		pathCache[i].areaList = (short*)systemHeap->Malloc(sizeof(short) * GLOBAL_PATH_CACHE_MAX_AREAS);
+		gosASSERT((pathCache[i].steps != NULL) && (pathCache[i].areaList != NULL));
 	}
-	debugFile->writeString("\n");
 
-	debugFile->close();
-	delete debugFile;
-	debugFile = NULL;
+	//------------------------------------------------------------------
+	// Every area starts at stamp 0, so nothing cached so far is stale...
+	areaStamp = (unsigned long*)systemHeap->Malloc(sizeof(unsigned long) * numAreas);
+	gosASSERT(areaStamp != NULL);
+	memset(areaStamp, 0, sizeof(unsigned long) * numAreas);
+	lastAreaStamp = 0;
+	gateStamp = (unsigned long*)systemHeap->Malloc(sizeof(unsigned long) * numAreas * GLOBAL_PATH_CACHE_TEAMS);
+	gosASSERT(gateStamp != NULL);
+	memset(gateStamp, 0, sizeof(unsigned long) * numAreas * GLOBAL_PATH_CACHE_TEAMS);
+	for (long i = 0; i < GLOBAL_PATH_CACHE_TEAMS; i++)
+		lastGateStamp[i] = 0;
+	gateSeen = (unsigned char*)systemHeap->Malloc(numAreas * GLOBAL_PATH_CACHE_TEAMS);
+	gosASSERT(gateSeen != NULL);
+	memset(gateSeen, 0, numAreas * GLOBAL_PATH_CACHE_TEAMS);
+	pathCacheStamp = 0;
+	pathCacheTick = 0;
+
+	pathCacheAreaList = (short*)systemHeap->Malloc(sizeof(short) * GLOBAL_PATH_CACHE_MAX_AREAS);
+	gosASSERT(pathCacheAreaList != NULL);
+	pathCacheNumAreas = 0;
+	pathCacheAreaMark = (unsigned char*)systemHeap->Malloc(numAreas);
+	gosASSERT(pathCacheAreaMark != NULL);
+	memset(pathCacheAreaMark, 0, numAreas);
 }
 
 //---------------------------------------------------------------------------
 
-void GlobalMap::destroy (void) {
-
-	#ifdef _DEBUG
-//	systemHeap->walkHeap(false,false,"GlobalMap BAD HEAP1\n");
-	#endif
+void GlobalMap::destroyPathCache (void) {
 
-	if (areaMap) {
-		systemHeap->Free(areaMap);
-		areaMap = NULL;
+	if (pathCache) {
+		for (long i = 0; i < GLOBAL_PATH_CACHE_SIZE; i++) {
+			systemHeap->Free(pathCache[i].steps);
+			systemHeap->Free(pathCache[i].areaList);
+		}
+		systemHeap->Free(pathCache);
+		pathCache = NULL;
 	}
 
-	if (areas) {
-		if (!doorInfos) {
-			for (long i = 0; i < (numAreas + 1); i++) {
-				if (areas_cellsCovered[i]) {
-					systemHeap->Free(areas_cellsCovered[i]);
-				    areas_cellsCovered[i] = NULL;
-				}
-				if (areas_doors[i]) {
-					systemHeap->Free(areas_doors[i]);
-					areas_doors[i] = NULL;
-				}
-			}
-		}
-		systemHeap->Free(areas);
-		areas = NULL;
-        areas_doors = NULL;
+	if (areaStamp) {
+		systemHeap->Free(areaStamp);
+		areaStamp = NULL;
 	}
 
-	if (doors) {
-		if (!doorLinks) {
-			for (long i = 0; i < (numDoors + NUM_DOOR_OFFSETS); i++)
-				for (long s = 0; s < 2; s++) {
-					if (doors_links[i][s]) {
-						systemHeap->Free(doors_links[i][s]);
-						doors_links[i][s] = NULL;
-					}
-				}
-		}
-		systemHeap->Free(doors);
-		doors = NULL;
-        doors_links = NULL;
+	if (gateStamp) {
+		systemHeap->Free(gateStamp);
+		gateStamp = NULL;
 	}
 
-	if (doorInfos) {
-		systemHeap->Free(doorInfos);
-		doorInfos = NULL;
+	if (gateSeen) {
+		systemHeap->Free(gateSeen);
+		gateSeen = NULL;
 	}
 
-	if (doorLinks) {
-		systemHeap->Free(doorLinks);
-		doorLinks = NULL;
+	if (pathCacheAreaList) {
+		systemHeap->Free(pathCacheAreaList);
+		pathCacheAreaList = NULL;
 	}
 
-	if (pathExistsTable) {
-		systemHeap->Free(pathExistsTable);
-		pathExistsTable = NULL;
+	if (pathCacheAreaMark) {
+		systemHeap->Free(pathCacheAreaMark);
+		pathCacheAreaMark = NULL;
 	}
+	pathCacheNumAreas = 0;
+}
 
-#ifdef USE_PATH_COST_TABLE
-	if (pathCostTable) {
-		systemHeap->Free(pathCostTable);
-		pathCostTable = NULL;
+//---------------------------------------------------------------------------
+
+void GlobalMap::addPathCacheArea (long area) {
+
+	//-----------------------------------------------------------------
+	// Once the search has looked thru too many areas, the path won't be
+	// cached (pathCacheNumAreas stays past the max as a flag)...
+	if ((area < 0) || (area >= numAreas) || pathCacheAreaMark[area])
+		return;
+	if (pathCacheNumAreas < GLOBAL_PATH_CACHE_MAX_AREAS) {
+		pathCacheAreaMark[area] = 1;
+		pathCacheAreaList[pathCacheNumAreas] = (short)area;
 	}
-#endif
+	pathCacheNumAreas++;
 }
 
-//----------------------------------------------------------------------------------
+//---------------------------------------------------------------------------
 
-bool GlobalMap::toggleLog (void) {
+void GlobalMap::setGateSeen (long area, bool open) {
 
-	if (!log) {
-		GameLog::setup();
-		log = GameLog::getNewFile();
-		if (!log)
-			Fatal(0, " Couldn't create lrmove log ");
-		long err = log->open("lrmove.log");
+	if (!gateSeen)
+		return;
+
+	//----------------------------------------------------------------
+	// A gate opening or closing changes the doors into the areas on
+	// either side, so the mover's team sees all of them as changed...
+	long team = moverTeamID + 1;
+	gosASSERT((team >= 0) && (team < GLOBAL_PATH_CACHE_TEAMS));
+	unsigned char state = open ? 2 : 1;
+	if (gateSeen[team * numAreas + area] == state)
+		return;
+	gateSeen[team * numAreas + area] = state;
+
+	unsigned long* teamGateStamp = &gateStamp[team * numAreas];
+	unsigned long stamp = ++pathCacheStamp;
+	teamGateStamp[area] = stamp;
+	const DoorInfoPtr area_doors = areas_doors[area];
+	for (long d = 0; d < areas[area].numDoors; d++) {
+		GlobalMapDoorPtr curDoor = &doors[area_doors[d].doorIndex];
+		teamGateStamp[curDoor->area[0]] = stamp;
+		teamGateStamp[curDoor->area[1]] = stamp;
+	}
+	lastGateStamp[team] = stamp;
+}
+
+//---------------------------------------------------------------------------
+
+GlobalPathCacheEntryPtr GlobalMap::findPathCacheEntry (long startArea, long goalArea) {
+
+	//---------------------------------------------------------------------
+	// The start and goal cells set the cost to the first and last doors,
+	// so paths are only shared between cells closest to the same doors...
+	unsigned long* teamGateStamp = &gateStamp[(moverTeamID + 1) * numAreas];
+	for (long i = 0; i < GLOBAL_PATH_CACHE_SIZE; i++) {
+		GlobalPathCacheEntryPtr entry = &pathCache[i];
+		if (!entry->valid)
+			continue;
+		if ((entry->startArea != startArea) || (entry->goalArea != goalArea))
+			continue;
+		if ((entry->startDoor != startDoorPick) || (entry->goalDoor != goalDoorPick))
+			continue;
+		if ((entry->moverTeamID != moverTeamID) || (entry->useClosedAreas != useClosedAreas))
+			continue;
+		//-------------------------------------------------------------
+		// If any area the search looked thru has changed, or a gate
+		// next to one has changed for this team, it's stale...
+		for (long j = 0; j < entry->numAreas; j++)
+			if ((areaStamp[entry->areaList[j]] > entry->stamp) || (teamGateStamp[entry->areaList[j]] > entry->stamp)) {
+				entry->valid = false;
+				break;
+			}
+		if (!entry->valid)
+			return(NULL);
+		entry->lastUsed = ++pathCacheTick;
+		return(entry);
+	}
+	return(NULL);
+}
+
+//---------------------------------------------------------------------------
+
+void GlobalMap::storePathCacheEntry (long startArea, long goalArea, unsigned long stamp, GlobalPathStepPtr path, long numSteps) {
+
+	for (long i = 0; i < pathCacheNumAreas && i < GLOBAL_PATH_CACHE_MAX_AREAS; i++)
+		pathCacheAreaMark[pathCacheAreaList[i]] = 0;
+
+	if ((pathCacheNumAreas > GLOBAL_PATH_CACHE_MAX_AREAS) || (numSteps >= MAX_GLOBAL_PATH))
+		return;
+
+	//---------------------------------------------------
+	// Take an empty slot, or the least recently used...
+	GlobalPathCacheEntryPtr entry = &pathCache[0];
+	for (long i = 0; i < GLOBAL_PATH_CACHE_SIZE; i++) {
+		if (!pathCache[i].valid) {
+			entry = &pathCache[i];
+			break;
+		}
+		if (pathCache[i].lastUsed < entry->lastUsed)
+			entry = &pathCache[i];
+	}
+
+	entry->startArea = (short)startArea;
+	entry->goalArea = (short)goalArea;
+	entry->moverTeamID = moverTeamID;
+	entry->useClosedAreas = useClosedAreas;
+	entry->startDoor = (short)startDoorPick;
+	entry->goalDoor = (short)goalDoorPick;
+	entry->stamp = stamp;
+	entry->lastUsed = ++pathCacheTick;
+	entry->numSteps = (short)numSteps;
+	for (long i = 0; i < numSteps; i++) {
+		entry->steps[i].thruArea = (short)path[i].thruArea;
+		entry->steps[i].goalDoor = (short)path[i].goalDoor;
+		entry->steps[i].costToGoal = path[i].costToGoal;
+	}
+	entry->numAreas = (short)pathCacheNumAreas;
+	memcpy(entry->areaList, pathCacheAreaList, sizeof(short) * pathCacheNumAreas);
+	entry->valid = true;
+}
+
+//---------------------------------------------------------------------------
+
+void GlobalMap::requestFlowField (long goalArea) {
+
+	if ((goalArea < 0) || (goalArea >= numAreas) || !usePathCache)
+		return;
+
+	//-------------------------------------------------------------
+	// Refresh it if it's already requested, otherwise bump the one
+	// closest to expiring...
+	long slot = -1;
+	for (long i = 0; i < MAX_FLOW_FIELDS; i++)
+		if (flowGoalArea[i] == goalArea) {
+			slot = i;
+			break;
+		}
+	if (slot == -1) {
+		slot = 0;
+		for (long i = 1; i < MAX_FLOW_FIELDS; i++)
+			if (flowGoalExpireTime[i] < flowGoalExpireTime[slot])
+				slot = i;
+	}
+
+	flowGoalArea[slot] = goalArea;
+	flowGoalExpireTime[slot] = scenarioTime + FLOW_FIELD_LIFETIME;
+}
+
+//---------------------------------------------------------------------------
+
+void GlobalMap::destroyFlowFields (void) {
+
+	if (flowFields) {
+		for (long i = 0; i < MAX_FLOW_FIELDS; i++) {
+			systemHeap->Free(flowFields[i].costToGoal);
+			systemHeap->Free(flowFields[i].nextDoor);
+		}
+		systemHeap->Free(flowFields);
+		flowFields = NULL;
+	}
+
+	if (flowOpenList) {
+		delete flowOpenList;
+		flowOpenList = NULL;
+	}
+
+	for (long i = 0; i < MAX_FLOW_FIELDS; i++) {
+		flowGoalArea[i] = -1;
+		flowGoalExpireTime[i] = 0.0;
+	}
+}
+
+//---------------------------------------------------------------------------
+
+GlobalFlowFieldPtr GlobalMap::getFlowField (long goalArea) {
+
+	float expireTime = -1.0;
+	for (long i = 0; i < MAX_FLOW_FIELDS; i++)
+		if ((flowGoalArea[i] == goalArea) && (flowGoalExpireTime[i] > scenarioTime))
+			expireTime = flowGoalExpireTime[i];
+	if (expireTime < 0.0)
+		return(NULL);
+
+	if (!flowFields) {
+		flowFields = (GlobalFlowFieldPtr)systemHeap->Malloc(sizeof(GlobalFlowField) * MAX_FLOW_FIELDS);
+		gosASSERT(flowFields != NULL);
+		for (long i = 0; i < MAX_FLOW_FIELDS; i++) {
+			flowFields[i].valid = false;
+			flowFields[i].expireTime = 0.0;
+			flowFields[i].costToGoal = (long*)systemHeap->Malloc(sizeof(long) * numDoors * 2);
+			flowFields[i].nextDoor = (long*)systemHeap->Malloc(sizeof(long) * numDoors * 2);
+			gosASSERT((flowFields[i].costToGoal != NULL) && (flowFields[i].nextDoor != NULL));
+		}
+	}
+
+	//-----------------------------------------------------------------
+	// The field is only good for the gate and door states it was calced
+	// with, so any area change since, or gate change for this team,
+	// means a recalc...
+	GlobalFlowFieldPtr field = NULL;
+	for (long i = 0; i < MAX_FLOW_FIELDS; i++) {
+		GlobalFlowFieldPtr curField = &flowFields[i];
+		if (curField->valid && (curField->goalArea == goalArea) && (curField->moverTeamID == moverTeamID) && (curField->useClosedAreas == useClosedAreas)) {
+			if ((curField->stamp >= lastAreaStamp) && (curField->stamp >= lastGateStamp[moverTeamID + 1])) {
+				curField->expireTime = expireTime;
+				return(curField);
+			}
+			field = curField;
+			break;
+		}
+	}
+	if (!field) {
+		field = &flowFields[0];
+		for (long i = 0; i < MAX_FLOW_FIELDS; i++) {
+			if (!flowFields[i].valid) {
+				field = &flowFields[i];
+				break;
+			}
+			if (flowFields[i].expireTime < field->expireTime)
+				field = &flowFields[i];
+		}
+	}
+
+	field->goalArea = goalArea;
+	field->moverTeamID = moverTeamID;
+	field->useClosedAreas = useClosedAreas;
+	field->expireTime = expireTime;
+	calcFlowField(field);
+	flowFieldBuilds++;
+	return(field);
+}
+
+//---------------------------------------------------------------------------
+
+void GlobalMap::calcFlowField (GlobalFlowFieldPtr field) {
+
+	if (!pathCache)
+		initPathCache();
+
+	if (!flowOpenList) {
+		flowOpenList = new PriorityQueue;
+		gosASSERT(flowOpenList != NULL);
+		flowOpenList->init(numDoors * 2 + 1);
+	}
+
+	//---------------------------------------------------------------------
+	// Each door is tracked twice, once for each side we can enter it from
+	// (door * 2 + fromAreaIndex), just like the doors in calcPath(). We run
+	// calcPath()'s search backwards from the goal area's doors, using the
+	// same link costs and door rules, so every door ends up knowing its
+	// cost to the goal and the next door to head for. Start and goal cells
+	// aren't known here, so the goal link costs 1 (as if no cell was given).
+	long numStates = numDoors * 2;
+	for (long i = 0; i < numStates; i++) {
+		field->costToGoal[i] = COST_BLOCKED * 1000;
+		field->nextDoor[i] = -1;
+	}
+
+	flowOpenList->clear();
+	const DoorInfoPtr goalArea_doors = areas_doors[field->goalArea];
+	for (long i = 0; i < areas[field->goalArea].numDoors; i++) {
+		long door = goalArea_doors[i].doorIndex;
+		if (door >= numDoors)
+			continue;
+		long state = door * 2 + (1 - goalArea_doors[i].doorSide);
+		field->costToGoal[state] = 1;
+		PQNode vertex;
+		vertex.key = 1;
+		vertex.id = state;
+		vertex.row = 0;
+		vertex.col = 0;
+		flowOpenList->insert(vertex);
+	}
+
+	while (!flowOpenList->isEmpty()) {
+		PQNode bestPQNode;
+		flowOpenList->remove(bestPQNode);
+		long bestState = bestPQNode.id;
+		long bestDoor = bestState / 2;
+		long bestFromAreaIndex = bestState % 2;
+		long bestCost = field->costToGoal[bestState];
+		GlobalMapDoorPtr bestMapDoor = &doors[bestDoor];
+
+		//---------------------------------------------------------------
+		// Going forward, this door is entered from the area on this side,
+		// so any door of that area can lead to it...
+		long doorCost = -1;
+		if (field->useClosedAreas) {
+			if (bestMapDoor->teamID > -1)
+				if (TeamRelations[bestMapDoor->teamID][field->moverTeamID] == RELATION_FRIENDLY)
+					doorCost = 50;
+			if (!bestMapDoor->open)
+				doorCost = 1000;
+			}
+		else {
+			if ((bestMapDoor->teamID > -1) && (bestMapDoor->teamID != field->moverTeamID))
+				doorCost = COST_BLOCKED;
+			if (!bestMapDoor->open)
+				doorCost = COST_BLOCKED;
+		}
+
+		const DoorInfoLinksPtr& bestMapDoor_links = doors_links[bestDoor];
+		for (long curLink = 0; curLink < bestMapDoor->numLinks[bestFromAreaIndex]; curLink++) {
+			long predDoor = bestMapDoor_links[bestFromAreaIndex][curLink].doorIndex;
+			if (predDoor >= numDoors)
+				continue;
+			long predSide = bestMapDoor_links[bestFromAreaIndex][curLink].doorSide;
+
+			//------------------------------------------------------
+			// Use the link cost as calcPath() would see it, going
+			// from the predecessor door thru this area to this door...
+			long linkCost = -1;
+			const DoorInfoLinksPtr& predDoor_links = doors_links[predDoor];
+			for (long j = 0; j < doors[predDoor].numLinks[predSide]; j++)
+				if (predDoor_links[predSide][j].doorIndex == bestDoor) {
+					linkCost = predDoor_links[predSide][j].cost;
+					break;
+				}
+			if (linkCost < 0)
+				continue;
+			if (doorCost > -1)
+				linkCost = doorCost;
+			if (linkCost >= COST_BLOCKED)
+				continue;
+
+			long predState = predDoor * 2 + (1 - predSide);
+			long predCost = bestCost + linkCost;
+			if (predCost < field->costToGoal[predState]) {
+				field->costToGoal[predState] = predCost;
+				field->nextDoor[predState] = bestState;
+				long openIndex = flowOpenList->find(predState);
+				if (openIndex)
+					flowOpenList->change(openIndex, predCost);
+				else {
+					PQNode predPQNode;
+					predPQNode.key = predCost;
+					predPQNode.id = predState;
+					predPQNode.row = 0;
+					predPQNode.col = 0;
+					flowOpenList->insert(predPQNode);
+				}
+			}
+		}
+	}
+
+	field->stamp = pathCacheStamp;
+	field->valid = true;
+}
+
+//---------------------------------------------------------------------------
+
+long GlobalMap::calcFlowFieldPath (GlobalFlowFieldPtr field, long startArea, GlobalPathStepPtr path) {
+
+	//------------------------------------------------------------------
+	// Pick the start area door that's cheapest to reach (from our start
+	// cell, if we have one) plus its cost to the goal...
+	long bestState = -1;
+	long bestCost = COST_BLOCKED * 1000;
+	const DoorInfoPtr startArea_doors = areas_doors[startArea];
+	for (long i = 0; i < areas[startArea].numDoors; i++) {
+		long door = startArea_doors[i].doorIndex;
+		if (door >= numDoors)
+			continue;
+		GlobalMapDoorPtr curDoor = &doors[door];
+		long cost = 1;
+		if (startCell[0] > -1)
+			cost += labs(startCell[0] - curDoor->row) + labs(startCell[1] - curDoor->col);
+		if (field->useClosedAreas) {
+			if (curDoor->teamID > -1)
+				if (TeamRelations[curDoor->teamID][field->moverTeamID] == RELATION_FRIENDLY)
+					cost = 50;
+			if (!curDoor->open)
+				cost = 1000;
+			}
+		else if (((curDoor->teamID > -1) && (curDoor->teamID != field->moverTeamID)) || !curDoor->open)
+			continue;
+		long state = door * 2 + startArea_doors[i].doorSide;
+		if (field->costToGoal[state] >= COST_BLOCKED * 1000)
+			continue;
+		if ((cost + field->costToGoal[state]) < bestCost) {
+			bestCost = cost + field->costToGoal[state];
+			bestState = state;
+		}
+	}
+
+	if (bestState == -1)
+		return(0);
+
+	long numSteps = 0;
+	long curState = bestState;
+	long thruArea = startArea;
+	while (curState != -1) {
+		if (numSteps >= (MAX_GLOBAL_PATH - 1))
+			return(-1);
+		path[numSteps].thruArea = thruArea;
+		path[numSteps].goalDoor = curState / 2;
+		path[numSteps].costToGoal = field->costToGoal[curState];
+		numSteps++;
+		thruArea = doors[curState / 2].area[1 - (curState % 2)];
+		curState = field->nextDoor[curState];
+	}
+
+	//------------------------------------------------
+	// And the last step, into the goal area itself...
+	path[numSteps].thruArea = field->goalArea;
+	path[numSteps].goalDoor = numDoors + DOOR_OFFSET_GOAL;
+	path[numSteps].costToGoal = 0;
+	numSteps++;
+	return(numSteps);
+}
+
+//---------------------------------------------------------------------------
+
+void GlobalMap::print (char* fileName) {
+
+	if (areaMap)
+		return;
+
+	File* debugFile = new File;
+	debugFile->create(fileName);
+
+	char outString[500];
+	for (long row = 0; row < height; row++) {
+		outString[0] = '\0';
+		for (long col = 0; col < width; col++) {
+			if (areaMap[row * width + col] == -2)
+				strcat(outString, ">< ");
+			else if (areaMap[row * width + col] == -1)
+				strcat(outString, "** ");
+			else {
+				char chStr[8];
+				sprintf(chStr, "%02x ", areaMap[row * width + col]);
+				strcat(outString, chStr);
+			}
+		}
+		strcat(outString, "\n");
+		debugFile->writeString(outString);
+	}
+	debugFile->writeString("\n");
+
+	debugFile->close();
+	delete debugFile;
+	debugFile = NULL;
+}
+
+//---------------------------------------------------------------------------
+
+void GlobalMap::destroy (void) {
+
+	#ifdef _DEBUG
+//	systemHeap->walkHeap(false,false,"GlobalMap BAD HEAP1\n");
+	#endif
+
+	if (areaMap) {
+		systemHeap->Free(areaMap);
+		areaMap = NULL;
+	}
+
+	if (areas) {
+		if (!doorInfos) {
+			for (long i = 0; i < (numAreas + 1); i++) {
+				if (areas_cellsCovered[i]) {
+					systemHeap->Free(areas_cellsCovered[i]);
+				    areas_cellsCovered[i] = NULL;
+				}
+				if (areas_doors[i]) {
+					systemHeap->Free(areas_doors[i]);
+					areas_doors[i] = NULL;
+				}
+			}
+		}
+		systemHeap->Free(areas);
+		areas = NULL;
+        areas_doors = NULL;
+	}
+
+	if (doors) {
+		if (!doorLinks) {
+			for (long i = 0; i < (numDoors + NUM_DOOR_OFFSETS); i++)
+				for (long s = 0; s < 2; s++) {
+					if (doors_links[i][s]) {
+						systemHeap->Free(doors_links[i][s]);
+						doors_links[i][s] = NULL;
+					}
+				}
+		}
+		systemHeap->Free(doors);
+		doors = NULL;
+        doors_links = NULL;
+	}
+
+	if (doorInfos) {
+		systemHeap->Free(doorInfos);
+		doorInfos = NULL;
+	}
+
+	if (doorLinks) {
+		systemHeap->Free(doorLinks);
+		doorLinks = NULL;
+	}
+
+	if (pathExistsTable) {
+		systemHeap->Free(pathExistsTable);
+		pathExistsTable = NULL;
+	}
+
+	if (areaComponent) {
+		systemHeap->Free(areaComponent);
+		areaComponent = NULL;
+	}
+
+#ifdef USE_PATH_COST_TABLE
+	if (pathCostTable) {
+		systemHeap->Free(pathCostTable);
+		pathCostTable = NULL;
+	}
+#endif
+
+	destroyPathCache();
+	destroyFlowFields();
+}
+
+//----------------------------------------------------------------------------------
+
+bool GlobalMap::toggleLog (void) {
+
+	if (!log) {
+		GameLog::setup();
+		log = GameLog::getNewFile();
+		if (!log)
+			Fatal(0, " Couldn't create lrmove log ");
+		long err = log->open("lrmove.log");
 		if (err)
 			Fatal(0, " Couldn't open lrmove log ");
 #if 1
@@ -4063,6 +5060,12 @@ void MoveMap::init (long maxW, long maxH) {
 			distanceInt[i][j] = (int)distanceFloat[i][j];
 		}
 
+	//-------------------------------------------------------------------
+	// Filled here, rather than lazily by calcPath, so path solves never
+	// write to it...
+	for (long i = 0; i < NUM_CELL_OFFSETS; i++)
+		cellShiftDistance[i] = agsqrt(cellShift[i * 2], cellShift[i * 2 + 1]) * cellLength;
+
 	clear();
 }
 
@@ -4078,6 +5081,9 @@ void MoveMap::clear (void) {
 		// DON'T NEED TO SET THIS SINCE IS SET IN SETUP...
 		node->cost = COST_BLOCKED;
 		node->parent = -1;
+		node->jumpLength = 1;
+		for (int j = 0; j < NUM_ADJ_CELLS / 2; j++)
+			node->jumpRun[j] = 0;
 		node->flags = 0;
 		node->hPrime = initHPrime;
 	}
@@ -4090,6 +5096,99 @@ void MoveMap::clear (void) {
 
 //---------------------------------------------------------------------------
 
+void MoveMap::initOpenList (void) {
+
+	//-----------------------------------------------------------------
+	// The slot table is sized for every cell up front, so a calcPath()
+	// on this map never has to allocate...
+	openList = new PriorityQueue;
+	gosASSERT(openList != NULL);
+	openList->init(5000);
+	openList->reserve(maxWidth * maxHeight);
+}
+
+//---------------------------------------------------------------------------
+
+void MoveMap::copySetUp (MoveMapPtr source) {
+
+	//----------------------------------------------------------------------
+	// Copies everything setUp() produces, so calcPath() on this map gives
+	// the same result as it would on the source. Both maps must have been
+	// init'ed to the same max dimensions (the row/col/adj tables are not
+	// copied)...
+	gosASSERT((maxWidth == source->maxWidth) && (maxHeight == source->maxHeight));
+
+	ULr = source->ULr;
+	ULc = source->ULc;
+	width = source->width;
+	height = source->height;
+	minRow = source->minRow;
+	maxRow = source->maxRow;
+	minCol = source->minCol;
+	maxCol = source->maxCol;
+	moveLevel = source->moveLevel;
+	start = source->start;
+	startR = source->startR;
+	startC = source->startC;
+	goal = source->goal;
+	goalR = source->goalR;
+	goalC = source->goalC;
+	thruAreas[0] = source->thruAreas[0];
+	thruAreas[1] = source->thruAreas[1];
+	door = source->door;
+	doorSide = source->doorSide;
+	doorDirection = source->doorDirection;
+	target = source->target;
+	clearCost = source->clearCost;
+	jumpCost = source->jumpCost;
+	numOffsets = source->numOffsets;
+	overlayWeightTable = source->overlayWeightTable;
+	moverWID = source->moverWID;
+	moverTeamID = source->moverTeamID;
+	moverLayingMines = source->moverLayingMines;
+	moverWithdrawing = source->moverWithdrawing;
+	travelOffMap = source->travelOffMap;
+	cannotEnterOffMap = source->cannotEnterOffMap;
+
+	memcpy(map, source->map, sizeof(MoveMapNode) * maxWidth * height);
+}
+
+//---------------------------------------------------------------------------
+
+uint64_t MoveMap::calcSetUpChecksum (void) {
+
+	//------------------------------------------------------------------------
+	// FNV-1a (a word at a time) over the setUp() state calcPath() reads. Two
+	// maps with the same checksum solve to the same path. The g and fPrime
+	// fields are skipped, since they are scratch written by the search...
+	uint64_t hash = FNV_OFFSET_BASIS;
+	int scalars[] = {ULr, ULc, width, height, minRow, maxRow, minCol, maxCol, moveLevel,
+					 startR, startC, goalR, goalC, thruAreas[0], thruAreas[1], door, doorSide,
+					 doorDirection, clearCost, jumpCost, numOffsets, moverWID, moverTeamID,
+					 moverLayingMines, moverWithdrawing, travelOffMap, cannotEnterOffMap};
+	for (long i = 0; i < (long)(sizeof(scalars) / sizeof(int)); i++)
+		hashValue(hash, scalars[i]);
+
+	float vectors[] = {goal.x, goal.y, goal.z, target.x, target.y, target.z};
+	for (long i = 0; i < 6; i++) {
+		unsigned int bits;
+		memcpy(&bits, &vectors[i], sizeof(bits));
+		hashValue(hash, bits);
+	}
+
+	long numMapCells = maxWidth * height;
+	for (long i = 0; i < numMapCells; i++) {
+		MoveMapNodePtr node = &map[i];
+		hashValue(hash, node->cost);
+		hashValue(hash, node->parent);
+		hashValue(hash, node->flags);
+		hashValue(hash, node->hPrime);
+	}
+	return(hash);
+}
+
+//---------------------------------------------------------------------------
+
 void MoveMap::setTarget (Stuff::Vector3D targetPos) {
 
 	target = targetPos;
@@ -4518,15 +5617,13 @@ long MoveMap::setUp (long mapULr,
 	else
 		map[goalR * maxWidth + goalC].setFlag(MOVEFLAG_GOAL);
 
-	__int64 startTime = GetCycles();
+	PROFILE_BEGIN("Place Stationary Movers");
 
 	if (params & MOVEPARAM_STATIONARY_MOVERS)
 		if (placeStationaryMoversCallback)
 			(*placeStationaryMoversCallback)(this);
 
-#ifdef LAB_ONLY
-	MCTimeCalcPath1Update += (GetCycles() - startTime);
-#endif
+	PROFILE_END("Place Stationary Movers");
 
 	return(NO_ERR);
 }
@@ -4545,7 +5642,7 @@ long MoveMap::setUp (long level,
 					 long offsets,
 					 unsigned long params) {
 
-	__int64 startTime = GetCycles();
+	PROFILE_ZONE("Move Map Setup");
 
 	//-----------------------------------------------------------------------------
 	// If the map has not been allocated yet, then the tile height and width passed
@@ -4743,9 +5840,6 @@ long MoveMap::setUp (long level,
 		if (placeStationaryMoversCallback)
 			(*placeStationaryMoversCallback)(this);
 
-#ifdef LAB_ONLY
-	MCTimeCalcPath2Update += (GetCycles() - startTime);
-#endif
 	return(NO_ERR);
 }
 
@@ -4805,7 +5899,6 @@ inline bool MoveMap::adjacentCellOpenJUMP (long r, long c, long dir) {
 //---------------------------------------------------------------------------
 
 inline int MoveMap::calcHPrime (int r, int c) {
-	__int64 startTime = GetCycles();
 	long sum = 0;
 	if (r > goalR)
 		sum += (r - goalR);
@@ -4816,9 +5909,6 @@ inline int MoveMap::calcHPrime (int r, int c) {
 		sum += (c - goalC);
 	else
 		sum += (goalC - c);
-#ifdef LAB_ONLY
-	MCTimeCalcPath3Update += (GetCycles() - startTime);		
-#endif
 	return(sum);
 }
 
@@ -4881,7 +5971,7 @@ inline void MoveMap::propogateCost (long mapCellIndex, long cost, long g) {
 				if (succCellIndex > -1) {
 					MoveMapNodePtr succMapNode = &map[succCellIndex];
 					if (succMapNode->cost < COST_BLOCKED)
-						if ((succMapNode->hPrime != HPRIME_NOT_CALCED) && (succMapNode->hPrime < MaxHPrime)) {
+						if ((succMapNode->hPrime != HPRIME_NOT_CALCED) && (succMapNode->hPrime < maxHPrime)) {
 							char dirToParent = reverseShift[dir];
 							long cost = succMapNode->cost;
 							//------------------------------------
@@ -4889,10 +5979,11 @@ inline void MoveMap::propogateCost (long mapCellIndex, long cost, long g) {
 							gosASSERT(cost > 0);
 							if (isDiagonalWalk)
 								cost += (cost << 1);
-							if (dirToParent == succMapNode->parent)
+							if ((dirToParent == succMapNode->parent) && (succMapNode->jumpLength == 1))
 								propogateCost(succCellIndex, cost, curMapNode->g);
 							else if ((curMapNode->g + cost) < succMapNode->g) {
 								succMapNode->parent = dirToParent;
+								succMapNode->jumpLength = 1;
 								propogateCost(succCellIndex, cost, curMapNode->g);
 							}
 						}
@@ -4946,7 +6037,7 @@ inline void MoveMap::propogateCostJUMP (long r, long c, long cost, long g) {
 				if (inMapBounds(succRow, succCol, height, width)) {
 					MoveMapNodePtr succMapNode = &map[succRow * maxWidth + succCol];
 					if (succMapNode->cost < COST_BLOCKED)
-						if ((succMapNode->hPrime != HPRIME_NOT_CALCED) && (succMapNode->hPrime < MaxHPrime)) {
+						if ((succMapNode->hPrime != HPRIME_NOT_CALCED) && (succMapNode->hPrime < maxHPrime)) {
 							char dirToParent = reverseShift[dir];
 
 							bool jumping = false;
@@ -4985,6 +6076,243 @@ inline void MoveMap::propogateCostJUMP (long r, long c, long cost, long g) {
 //#define TIME_PATH
 //#define DEBUG_MOVE_MAP
 
+inline bool MoveMap::isUniformCell (long mapCellIndex) {
+
+	//-----------------------------------------------------------------
+	// A cell is uniform if it, and every cell around it, is a plain
+	// clear cell we can walk into. Jump point search only skips across
+	// these, so every path thru them costs the same either way. Figured
+	// the first time a search asks. setUp() sets every cost and flag on
+	// the map (its clear() resets these and the jump runs), so they hold
+	// until the next one...
+	MoveMapNodePtr curMapNode = &map[mapCellIndex];
+	if (curMapNode->flags & MOVEFLAG_UNIFORM_CHECKED)
+		return((curMapNode->flags & MOVEFLAG_UNIFORM) != 0);
+	curMapNode->setFlag(MOVEFLAG_UNIFORM_CHECKED);
+
+	const unsigned int specialFlags = MOVEFLAG_GOAL | MOVEFLAG_MOVER_HERE | MOVEFLAG_GOAL_BLOCKED | MOVEFLAG_OFFMAP;
+	if ((curMapNode->cost != clearCost) || (curMapNode->flags & specialFlags))
+		return(false);
+	if (!inBounds(mapRowTable[mapCellIndex], mapColTable[mapCellIndex]))
+		return(false);
+	for (long dir = 0; dir < NUM_ADJ_CELLS; dir++) {
+		long adjCellIndex = curMapNode->adjCells[dir];
+		if (adjCellIndex == -1)
+			return(false);
+		MoveMapNodePtr adjMapNode = &map[adjCellIndex];
+		if ((adjMapNode->cost != clearCost) || (adjMapNode->flags & specialFlags))
+			return(false);
+		if (!inBounds(mapRowTable[adjCellIndex], mapColTable[adjCellIndex]))
+			return(false);
+	}
+
+	curMapNode->setFlag(MOVEFLAG_UNIFORM);
+	return(true);
+}
+
+//---------------------------------------------------------------------------
+
+inline bool MoveMap::isJumpDeadEnd (long mapCellIndex, long dir) {
+
+	//-----------------------------------------------------------------------
+	// A straight jump ends on the first cell that isn't uniform. The cells
+	// beside and behind that cell are all around the uniform cell we came
+	// from, so they're plain clear cells. If none of the three cells ahead
+	// can be entered either, the jump just ran into a wall (or the edge of
+	// the map) and there's nothing there a diagonal jump has to stop for...
+	for (long turn = NUM_ADJ_CELLS - 1; turn <= NUM_ADJ_CELLS + 1; turn++) {
+		long aheadCellIndex = map[mapCellIndex].adjCells[(dir + turn) % NUM_ADJ_CELLS];
+		if (aheadCellIndex == -1)
+			continue;
+		if (!inBounds(mapRowTable[aheadCellIndex], mapColTable[aheadCellIndex]))
+			continue;
+		if (map[aheadCellIndex].cost < COST_BLOCKED)
+			return(false);
+	}
+	return(true);
+}
+
+//---------------------------------------------------------------------------
+
+long MoveMap::findStraightJumpPoint (long mapCellIndex, long dir, long& length) {
+
+	//-----------------------------------------------------------------------
+	// The straight walk of findJumpPoint. Diagonal jumps walk the same runs
+	// from cell after cell, so every cell walked over keeps how many cells
+	// it is from the end of its run (negated if the run goes past maxHPrime
+	// instead) and the next walk over it can stop right there...
+	long run = dir >> 1;
+	long numSteps = 0;
+	long runLength = 0;
+	long curCellIndex = mapCellIndex;
+	while (true) {
+		long knownLength = map[curCellIndex].jumpRun[run];
+		if (knownLength != 0) {
+			runLength = (knownLength > 0) ? (numSteps + knownLength) : (knownLength - numSteps);
+			break;
+		}
+		long succCellIndex = map[curCellIndex].adjCells[dir];
+		MoveMapNodePtr succMapNode = &map[succCellIndex];
+		if (succMapNode->hPrime == HPRIME_NOT_CALCED)
+			succMapNode->hPrime = calcHPrime(mapRowTable[succCellIndex], mapColTable[succCellIndex]);
+		numSteps++;
+		if (succMapNode->hPrime >= maxHPrime) {
+			runLength = -numSteps;
+			break;
+		}
+		if (!isUniformCell(succCellIndex)) {
+			runLength = numSteps;
+			break;
+		}
+		curCellIndex = succCellIndex;
+	}
+
+	long step = map[mapCellIndex].adjCells[dir] - mapCellIndex;
+	long runCellIndex = mapCellIndex;
+	long cellsLeft = (runLength > 0) ? runLength : -runLength;
+	for (long i = 0; i < numSteps; i++) {
+		map[runCellIndex].jumpRun[run] = (short)((runLength > 0) ? (cellsLeft - i) : (i - cellsLeft));
+		runCellIndex += step;
+	}
+
+	if (runLength < 0)
+		return(-1);
+	length = runLength;
+	return(mapCellIndex + step * runLength);
+}
+
+//---------------------------------------------------------------------------
+
+long MoveMap::findJumpPoint (long mapCellIndex, long dir, long& length) {
+
+	//-----------------------------------------------------------------------
+	// Walk from a uniform cell in the given direction until we reach a cell
+	// that isn't uniform (the edge of the open stretch) or, when moving
+	// diagonally, a cell from which a straight walk finds such an edge with
+	// something past it. Straight walks that only hit a wall don't stop us.
+	// Since we start from a uniform cell, the next cell is always open...
+	if (!IsDiagonalStep[dir])
+		return(findStraightJumpPoint(mapCellIndex, dir, length));
+
+	length = 0;
+	long curCellIndex = mapCellIndex;
+	while (true) {
+		long succCellIndex = map[curCellIndex].adjCells[dir];
+		MoveMapNodePtr succMapNode = &map[succCellIndex];
+		if (succMapNode->hPrime == HPRIME_NOT_CALCED)
+			succMapNode->hPrime = calcHPrime(mapRowTable[succCellIndex], mapColTable[succCellIndex]);
+		if (succMapNode->hPrime >= maxHPrime)
+			return(-1);
+		length++;
+
+		if (!isUniformCell(succCellIndex))
+			return(succCellIndex);
+
+		for (long half = 0; half < 2; half++) {
+			long straightDir = StepAdjDir[dir + half];
+			long straightLength;
+			long edgeCellIndex = findStraightJumpPoint(succCellIndex, straightDir, straightLength);
+			if ((edgeCellIndex > -1) && !isJumpDeadEnd(edgeCellIndex, straightDir))
+				return(succCellIndex);
+		}
+		curCellIndex = succCellIndex;
+	}
+	return(-1);
+}
+
+//---------------------------------------------------------------------------
+
+void MoveMap::addJumpPoints (long mapCellIndex) {
+
+	MoveMapNodePtr curMapNode = &map[mapCellIndex];
+	long curNodeG = curMapNode->g;
+
+	//----------------------------------------------------------------------
+	// With nothing but clear cells around us, the only directions worth
+	// trying are the one we came in on (and its two halves, if diagonal).
+	// Anything else is reached at least as cheaply straight from our parent.
+	// The start cell has no parent, so it tries them all...
+	long dirList[NUM_ADJ_CELLS];
+	long numDirs = 0;
+	if (curMapNode->parent == -1) {
+		for (long dir = 0; dir < NUM_ADJ_CELLS; dir++)
+			dirList[numDirs++] = dir;
+		}
+	else {
+		long travelDir = reverseShift[curMapNode->parent];
+		dirList[numDirs++] = travelDir;
+		if (IsDiagonalStep[travelDir]) {
+			dirList[numDirs++] = StepAdjDir[travelDir];
+			dirList[numDirs++] = StepAdjDir[travelDir + 1];
+		}
+	}
+
+	for (long i = 0; i < numDirs; i++) {
+		long dir = dirList[i];
+		long jumpLength = 0;
+		long succCellIndex = findJumpPoint(mapCellIndex, dir, jumpLength);
+		if (succCellIndex == -1)
+			continue;
+
+		#ifdef DEBUG_PATH
+			numNodesVisited++;
+		#endif
+
+		MoveMapNodePtr succMapNode = &map[succCellIndex];
+		char dirToParent = reverseShift[dir];
+
+		//-------------------------------------------------------------
+		// Every cell we jumped over costs the same as a single step...
+		long cost = clearCost;
+		if (IsDiagonalStep[dir])
+			cost += (cost / 2);
+		cost *= jumpLength;
+		long succNodeG = curNodeG + cost;
+
+		if (succMapNode->flags & MOVEFLAG_OPEN) {
+			if (succNodeG < succMapNode->g) {
+				succMapNode->parent = dirToParent;
+				succMapNode->jumpLength = (short)jumpLength;
+				succMapNode->g = succNodeG;
+				succMapNode->fPrime = succNodeG + succMapNode->hPrime;
+				long openIndex = openList->find(succCellIndex);
+				gosASSERT(openIndex != 0);
+				if (openIndex)
+					openList->change(openIndex, succMapNode->fPrime);
+			}
+			}
+		else if (succMapNode->flags & MOVEFLAG_CLOSED) {
+			//-------------------------------------------------------
+			// Only our adjacent children get the new cost propogated,
+			// same as they would in the normal expansion...
+			if (succNodeG < succMapNode->g) {
+				succMapNode->parent = dirToParent;
+				succMapNode->jumpLength = (short)jumpLength;
+				propogateCost(succCellIndex, cost, curNodeG);
+			}
+			}
+		else {
+			succMapNode->parent = dirToParent;
+			succMapNode->jumpLength = (short)jumpLength;
+			succMapNode->g = succNodeG;
+			succMapNode->fPrime = succNodeG + succMapNode->hPrime;
+			PQNode succPQNode;
+			succPQNode.key = succMapNode->fPrime;
+			succPQNode.id = succCellIndex;
+			succPQNode.row = mapRowTable[succCellIndex];
+			succPQNode.col = mapColTable[succCellIndex];
+#ifdef _DEBUG
+			long insertErr = 
+#endif
+				openList->insert(succPQNode);
+			gosASSERT(insertErr == NO_ERR);
+			succMapNode->setFlag(MOVEFLAG_OPEN);
+		}
+	}
+}
+
+//---------------------------------------------------------------------------
+
 long MoveMap::calcPath (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int* goalCell) {
 
 	#ifdef TIME_PATH
@@ -5005,18 +6333,15 @@ long MoveMap::calcPath (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int* go
 
 	//------------------------------------------------------------------
 	// Let's use their hPrime as a barrier for cutting off the search...
-	MaxHPrime = calcHPrime(startR, startC) * 2.5;
-	if (MaxHPrime < 500)
-		MaxHPrime = 500;
+	maxHPrime = calcHPrime(startR, startC) * 2.5;
+	if (maxHPrime < 500)
+		maxHPrime = 500;
 	
 	//-----------------------------------------------
 	// If we haven't already, create the OPEN list...
-	if (!openList) {
-		openList = new PriorityQueue;
-		gosASSERT(openList != NULL);
-		openList->init(5000);
-	}
-		
+	if (!openList)
+		initOpenList();
+
 	int curCol = startC;
 	int curRow = startR;
 	
@@ -5050,6 +6375,9 @@ long MoveMap::calcPath (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int* go
 		numNodesVisited = 1;
 	#endif
 
+	numNodesExpanded = 0;
+	peakOpenNodes = 0;
+
 	while (!openList->isEmpty()) {
 
 		#ifdef DEBUG_MOVE_MAP
@@ -5068,6 +6396,10 @@ long MoveMap::calcPath (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int* go
 				topOpenNodes = openList->getNumItems();
 		#endif
 
+		if (peakOpenNodes < openList->getNumItems())
+			peakOpenNodes = openList->getNumItems();
+		numNodesExpanded++;
+
 		//----------------------
 		// Grab the best node...
 		PQNode bestPQNode;
@@ -5089,6 +6421,15 @@ long MoveMap::calcPath (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int* go
 			goalFound = true;
 			break;
 		}
+
+		//---------------------------------------------------------------
+		// Out in the open, jump ahead rather than step cell by cell. Next
+		// to anything that isn't a plain clear cell (overlay weights,
+		// forest, water, pathlocks, movers, goals), expand normally...
+		if (JumpPointSearch && isUniformCell(bestPQNode.id)) {
+			addJumpPoints(bestPQNode.id);
+			continue;
+		}
 		
 		for (int dir = 0; dir < 8; dir++) {
 			//------------------------------------------------------------
@@ -5142,7 +6483,7 @@ long MoveMap::calcPath (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int* go
 					if (succMapNode->hPrime == HPRIME_NOT_CALCED)
 						succMapNode->hPrime = calcHPrime(mapRowTable[succCellIndex/*bestPQNode.id*/], mapColTable[succCellIndex/*bestPQNode.id*/]);
 
-					if (succMapNode->hPrime < MaxHPrime) {
+					if (succMapNode->hPrime < maxHPrime) {
 
 						#ifdef DEBUG_PATH
 							numNodesVisited++;
@@ -5173,6 +6514,7 @@ long MoveMap::calcPath (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int* go
 								//----------------------------
 								// This new path is cheaper...
 								succMapNode->parent = dirToParent;
+								succMapNode->jumpLength = 1;
 								succMapNode->g = succNodeG;
 								succMapNode->fPrime = succNodeG + succMapNode->hPrime;
 								int openIndex = openList->find(succCellIndex);
@@ -5196,6 +6538,7 @@ long MoveMap::calcPath (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int* go
 								//----------------------------
 								// This new path is cheaper...
 								succMapNode->parent = dirToParent;
+								succMapNode->jumpLength = 1;
 
 								//------------------------------------------
 								// Now, we have to propogate the new cost...
@@ -5207,6 +6550,7 @@ long MoveMap::calcPath (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int* go
 							// This node is neither OPEN nor CLOSED, so toss it
 							// into the OPEN list...
 							succMapNode->parent = dirToParent;
+							succMapNode->jumpLength = 1;
 							succMapNode->g = succNodeG;
 							succMapNode->fPrime = succNodeG + succMapNode->hPrime;
 							PQNode succPQNode;
@@ -5234,187 +6578,34 @@ long MoveMap::calcPath (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int* go
 			pathDebugFile->create("mm.dbg");
 			writeDebug(pathDebugFile);
 			pathDebugFile->close();
-			delete pathDebugFile;
-			pathDebugFile = NULL;
-		}
-	#endif
-	
-	if (goalFound) {
-		//-------------------------------------------
-		// First, let's count how long the path is...
-		int curRow = goalCell[0] = bestRow;
-		int curCol = goalCell[1] = bestCol;
-		int numCells = 0;
-		while ((curRow != startR) || (curCol != startC)) {
-			numCells += 1;
-			int cellOffsetIndex = (map[mapRowStartTable[curRow] + curCol].parent << 1);
-			//if ((cellOffsetIndex < 0) || (cellOffsetIndex > 14))
-			//	OutputDebugString("PathFinder: whoops\n");
-			curRow += cellShift[cellOffsetIndex++];
-			curCol += cellShift[cellOffsetIndex];
-		}
-
-		//---------------------------------------------------------------
-		// If our goal is a door, the path will be one step longer, since
-		// we need to walk "thru" the door...
-		if (doorDirection != -1)
-			numCells++;
-
-		#ifdef _DEBUG
-		if (numCells > MAX_STEPS_PER_MOVEPATH) {
-			File* pathDebugFile = new File;
-			pathDebugFile->create("longpath.dbg");
-			char s[512];
-			sprintf(s, "Path Too Long: %d steps (Max = %d) (please save longpath.dbg file:)", numCells, MAX_STEPS_PER_MOVEPATH);
-			pathDebugFile->writeString(s);
-			pathDebugFile->writeString("\n\n");
-			writeDebug(pathDebugFile);
-			pathDebugFile->close();
-			delete pathDebugFile;
-			pathDebugFile = NULL;
-			gosASSERT(numCells <= MAX_STEPS_PER_MOVEPATH);
-		}
-		#endif
-		//-----------------------------
-		// Now, let's build the path...
-
-		//-------------------------------
-		// Grab the path and return it...
-		path->init();
-		if (numCells) {
-			#ifdef _DEBUG			
-			int maxSteps = 
-			#endif
-
-			path->init(numCells);
-
-			#ifdef _DEBUG
-			if (maxSteps > -1) {
-				File* pathDebugFile = new File;
-				pathDebugFile->create("longpath.dbg");
-				char s[512];
-				sprintf(s, "New Longest Path: %d steps (Max = %d)\n\n", numCells, MAX_STEPS_PER_MOVEPATH);
-				pathDebugFile->writeString(s);
-				writeDebug(pathDebugFile);
-				pathDebugFile->close();
-				delete pathDebugFile;
-				pathDebugFile = NULL;
-			}
-			#endif
-
-			path->target = target;
-			path->cost = map[mapRowStartTable[bestRow] + bestCol].g;
-			curRow = bestRow;
-			curCol = bestCol;
-			int curCell = numCells;
-			if (doorDirection == -1) {
-				if (goalWorldPos) {
-					goalWorldPos->x = (float)(ULc + bestCol) * Terrain::worldUnitsPerCell + Terrain::worldUnitsPerCell / 2 - Terrain::worldUnitsMapSide / 2;
-					goalWorldPos->y = (Terrain::worldUnitsMapSide / 2) - ((float)(ULr + bestRow) * Terrain::worldUnitsPerCell) - Terrain::worldUnitsPerCell / 2;
-					goalWorldPos->z = 0.0f; // How do we get the elevation for this point? Do we care?
-					path->goal = *goalWorldPos;
-					}
-				else
-					path->goal = goal;
-				}
-			else {
-				//--------------------------------------------------
-				// It's a door, so it's the last on the path list...
-				curCell--;
-				path->setDirection(curCell, /*reverseShift[*/doorDirection * 2/*]*/);
-				int doorR = bestRow + adjTile[doorDirection][0];
-				int doorC = bestCol + adjTile[doorDirection][1];
-
-				goalCell[0] = ULr + doorR;
-				goalCell[1] = ULc + doorC;
-				Stuff::Vector3D stepDest;
-				stepDest.x = (float)(ULc + doorC) * Terrain::worldUnitsPerCell + Terrain::worldUnitsPerCell / 2 - Terrain::worldUnitsMapSide / 2;
-				stepDest.y = (Terrain::worldUnitsMapSide / 2) - ((float)(ULr + doorR) * Terrain::worldUnitsPerCell) - Terrain::worldUnitsPerCell / 2;
-				stepDest.z = (float)0; // How do we get the elevation for this point? Do we care?
-				path->setDestination(curCell, stepDest);
-				path->setDistanceToGoal(curCell, 0.0);
-				path->setCell(curCell, goalCell[0], goalCell[1]);
-				path->goal = stepDest;
-				if (goalWorldPos) {
-					//--------------------------------------------------------------------
-					// We didn't know the exact goal world pos coming into this, since are
-					// goal was an area door....
-					*goalWorldPos = stepDest;
-				}
-			}
-			
-			//---------------------------------------------------------
-			// We need to set this table up our first time thru here...
-			static bool setTable = false;
-			if (!setTable) {
-				float cellLength = Terrain::worldUnitsPerCell * metersPerWorldUnit;
-				for (int i = 0; i < NUM_CELL_OFFSETS; i++) {
-					float distance = agsqrt( cellShift[i * 2], cellShift[i * 2 + 1] ) * cellLength;
-					cellShiftDistance[i] = distance;
-				}
-				setTable = true;
-			}
-			
-			while ((curRow != startR) || (curCol != startC)) {
-				curCell--;
-				long parent = reverseShift[map[mapRowStartTable[curRow] + curCol].parent];
-				if (parent > 7)
-					path->setDirection(curCell, parent);
-				else
-					path->setDirection(curCell, parent);
-
-				Stuff::Vector3D stepDest;
-				int cell_r, cell_c;
-				cell_r = ULr + curRow;
-				cell_c = ULc + curCol;
-				stepDest.x = (float)(cell_c) * Terrain::worldUnitsPerCell + Terrain::worldUnitsPerCell / 2 - Terrain::worldUnitsMapSide / 2;
-				stepDest.y = (Terrain::worldUnitsMapSide / 2) - ((float)(cell_r) * Terrain::worldUnitsPerCell) - Terrain::worldUnitsPerCell / 2;
-				stepDest.z = 0.0f; // How do we get the elevation for this point? Do we care?
-				if (curCell == (numCells - 1))
-					path->setDistanceToGoal(curCell, 0.0);
-				else {
-					int tempDir = path->getDirection(curCell + 1);
-					float tempDist = path->getDistanceToGoal(curCell + 1);
-					path->setDistanceToGoal(curCell, cellShiftDistance[tempDir] + tempDist);
-				}
-				path->setDestination(curCell, stepDest);
-				path->setCell(curCell, cell_r, cell_c);
-				path->stepList[curCell].area = GlobalMoveMap[moveLevel]->calcArea(cell_r, cell_c);
-
-				map[curRow * maxWidth + curCol].setFlag(MOVEFLAG_STEP);
-				int cellOffsetIndex = map[mapRowStartTable[curRow] + curCol].parent << 1;
+			delete pathDebugFile;
+			pathDebugFile = NULL;
+		}
+	#endif
+	
+	if (goalFound) {
+		if (JumpPointSearch) {
+			//--------------------------------------------------------
+			// Fill in the cells we jumped over, so the path walk below
+			// sees a parent for every cell...
+			int curRow = bestRow;
+			int curCol = bestCol;
+			while ((curRow != startR) || (curCol != startC)) {
+				MoveMapNodePtr curMapNode = &map[mapRowStartTable[curRow] + curCol];
+				int parent = curMapNode->parent;
+				int jumpLength = curMapNode->jumpLength;
+				int cellOffsetIndex = (parent << 1);
 				curRow += cellShift[cellOffsetIndex++];
 				curCol += cellShift[cellOffsetIndex];
-				//calcAdjNode(curRow, curCol, map[curRow * maxCellWidth + curCol].parent);
-			}
-
-			if (thruAreas[1] != -1)
-				if (thruAreas[1] != path->stepList[path->numSteps - 1].area) {
-					for (int i = 0; i < path->numSteps; i++) {
-						if (path->stepList[i].area == thruAreas[1]) {
-							path->numStepsWhenNotPaused = path->numSteps = i + 1;
-							goalCell[0] = path->stepList[i].cell[0];
-							goalCell[1] = path->stepList[i].cell[1];
-							land->cellToWorld(goalCell[0], goalCell[1], *goalWorldPos);
-							break;
-						}
-					}
-				}
-			
-			#ifdef BLOCKED_PATH_TEST
-				//---------------------------------------------------------------------
-				// Let's test every path point to make sure it is not a blocked cell...
-				for (int i = 0; i < path->numSteps; i++) {
-					int tile[2], cell[2];
-					GameMap->worldToMapPos(path->stepList[i].destination, tile[0], tile[1], cell[0], cell[1]);
-					bool cellPassable = GameMap->cellPassable(tile[0], tile[0], cell[0], cell[1]);
-					if (!cellPassable)
-						cellPassable = GameMap->cellPassable(tile[0], tile[0], cell[0], cell[1]);
-					Assert(cellPassable || (i < 3), 0, " Bad Path Point ");
+				if ((jumpLength > 1) && ((curRow != startR) || (curCol != startC))) {
+					map[mapRowStartTable[curRow] + curCol].parent = parent;
+					map[mapRowStartTable[curRow] + curCol].jumpLength = jumpLength - 1;
 				}
-			#endif
+			}
 		}
 
+		long numSteps = buildPath(path, bestRow, bestCol, goalWorldPos, goalCell);
+
 		#ifdef TIME_PATH
 			QueryPerformanceCounter(calcStop);
 			calcTime = float(calcStop.LowPart - calcStart.LowPart) / float(countsPerSecond.LowPart);
@@ -5426,13 +6617,7 @@ long MoveMap::calcPath (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int* go
 			}
 		#endif
 
-		//------------------------------------------------------------------------------------
-		// If we're starting on the goal cell, set the cost to 1 as an indicator that there is
-		// a path--it's just that we were already there!
-		if (numCells == 0)
-			path->cost = 1;
-
-		return(path->numSteps);
+		return(numSteps);
 	}
 
 	#ifdef TIME_PATH
@@ -5450,6 +6635,185 @@ long MoveMap::calcPath (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int* go
 
 //---------------------------------------------------------------------------
 
+long MoveMap::buildPath (MovePathPtr path, int bestRow, int bestCol, Stuff::Vector3D* goalWorldPos, int* goalCell) {
+
+	//------------------------------------------------------------------
+	// Walks the parent links back from the goal cell (bestRow, bestCol)
+	// to the start and fills in the path. Shared by calcPath and the
+	// incremental replanner, which both leave parent links in the map...
+	//-------------------------------------------
+	// First, let's count how long the path is...
+	int curRow = goalCell[0] = bestRow;
+	int curCol = goalCell[1] = bestCol;
+	int numCells = 0;
+	while ((curRow != startR) || (curCol != startC)) {
+		numCells += 1;
+		int cellOffsetIndex = (map[mapRowStartTable[curRow] + curCol].parent << 1);
+		//if ((cellOffsetIndex < 0) || (cellOffsetIndex > 14))
+		//	OutputDebugString("PathFinder: whoops\n");
+		curRow += cellShift[cellOffsetIndex++];
+		curCol += cellShift[cellOffsetIndex];
+	}
+
+	//---------------------------------------------------------------
+	// If our goal is a door, the path will be one step longer, since
+	// we need to walk "thru" the door...
+	if (doorDirection != -1)
+		numCells++;
+
+	#ifdef _DEBUG
+	if (numCells > MAX_STEPS_PER_MOVEPATH) {
+		File* pathDebugFile = new File;
+		pathDebugFile->create("longpath.dbg");
+		char s[512];
+		sprintf(s, "Path Too Long: %d steps (Max = %d) (please save longpath.dbg file:)", numCells, MAX_STEPS_PER_MOVEPATH);
+		pathDebugFile->writeString(s);
+		pathDebugFile->writeString("\n\n");
+		writeDebug(pathDebugFile);
+		pathDebugFile->close();
+		delete pathDebugFile;
+		pathDebugFile = NULL;
+		gosASSERT(numCells <= MAX_STEPS_PER_MOVEPATH);
+	}
+	#endif
+	//-----------------------------
+	// Now, let's build the path...
+
+	//-------------------------------
+	// Grab the path and return it...
+	path->init();
+	if (numCells) {
+		#ifdef _DEBUG			
+		int maxSteps = 
+		#endif
+
+		path->init(numCells);
+
+		#ifdef _DEBUG
+		if (maxSteps > -1) {
+			File* pathDebugFile = new File;
+			pathDebugFile->create("longpath.dbg");
+			char s[512];
+			sprintf(s, "New Longest Path: %d steps (Max = %d)\n\n", numCells, MAX_STEPS_PER_MOVEPATH);
+			pathDebugFile->writeString(s);
+			writeDebug(pathDebugFile);
+			pathDebugFile->close();
+			delete pathDebugFile;
+			pathDebugFile = NULL;
+		}
+		#endif
+
+		path->target = target;
+		path->cost = map[mapRowStartTable[bestRow] + bestCol].g;
+		curRow = bestRow;
+		curCol = bestCol;
+		int curCell = numCells;
+		if (doorDirection == -1) {
+			if (goalWorldPos) {
+				goalWorldPos->x = (float)(ULc + bestCol) * Terrain::worldUnitsPerCell + Terrain::worldUnitsPerCell / 2 - Terrain::worldUnitsMapSide / 2;
+				goalWorldPos->y = (Terrain::worldUnitsMapSide / 2) - ((float)(ULr + bestRow) * Terrain::worldUnitsPerCell) - Terrain::worldUnitsPerCell / 2;
+				goalWorldPos->z = 0.0f; // How do we get the elevation for this point? Do we care?
+				path->goal = *goalWorldPos;
+				}
+			else
+				path->goal = goal;
+			}
+		else {
+			//--------------------------------------------------
+			// It's a door, so it's the last on the path list...
+			curCell--;
+			path->setDirection(curCell, /*reverseShift[*/doorDirection * 2/*]*/);
+			int doorR = bestRow + adjTile[doorDirection][0];
+			int doorC = bestCol + adjTile[doorDirection][1];
+
+			goalCell[0] = ULr + doorR;
+			goalCell[1] = ULc + doorC;
+			Stuff::Vector3D stepDest;
+			stepDest.x = (float)(ULc + doorC) * Terrain::worldUnitsPerCell + Terrain::worldUnitsPerCell / 2 - Terrain::worldUnitsMapSide / 2;
+			stepDest.y = (Terrain::worldUnitsMapSide / 2) - ((float)(ULr + doorR) * Terrain::worldUnitsPerCell) - Terrain::worldUnitsPerCell / 2;
+			stepDest.z = (float)0; // How do we get the elevation for this point? Do we care?
+			path->setDestination(curCell, stepDest);
+			path->setDistanceToGoal(curCell, 0.0);
+			path->setCell(curCell, goalCell[0], goalCell[1]);
+			path->goal = stepDest;
+			if (goalWorldPos) {
+				//--------------------------------------------------------------------
+				// We didn't know the exact goal world pos coming into this, since are
+				// goal was an area door....
+				*goalWorldPos = stepDest;
+			}
+		}
+		
+		while ((curRow != startR) || (curCol != startC)) {
+			curCell--;
+			long parent = reverseShift[map[mapRowStartTable[curRow] + curCol].parent];
+			if (parent > 7)
+				path->setDirection(curCell, parent);
+			else
+				path->setDirection(curCell, parent);
+
+			Stuff::Vector3D stepDest;
+			int cell_r, cell_c;
+			cell_r = ULr + curRow;
+			cell_c = ULc + curCol;
+			stepDest.x = (float)(cell_c) * Terrain::worldUnitsPerCell + Terrain::worldUnitsPerCell / 2 - Terrain::worldUnitsMapSide / 2;
+			stepDest.y = (Terrain::worldUnitsMapSide / 2) - ((float)(cell_r) * Terrain::worldUnitsPerCell) - Terrain::worldUnitsPerCell / 2;
+			stepDest.z = 0.0f; // How do we get the elevation for this point? Do we care?
+			if (curCell == (numCells - 1))
+				path->setDistanceToGoal(curCell, 0.0);
+			else {
+				int tempDir = path->getDirection(curCell + 1);
+				float tempDist = path->getDistanceToGoal(curCell + 1);
+				path->setDistanceToGoal(curCell, cellShiftDistance[tempDir] + tempDist);
+			}
+			path->setDestination(curCell, stepDest);
+			path->setCell(curCell, cell_r, cell_c);
+			path->stepList[curCell].area = GlobalMoveMap[moveLevel]->calcArea(cell_r, cell_c);
+
+			map[curRow * maxWidth + curCol].setFlag(MOVEFLAG_STEP);
+			int cellOffsetIndex = map[mapRowStartTable[curRow] + curCol].parent << 1;
+			curRow += cellShift[cellOffsetIndex++];
+			curCol += cellShift[cellOffsetIndex];
+			//calcAdjNode(curRow, curCol, map[curRow * maxCellWidth + curCol].parent);
+		}
+
+		if (thruAreas[1] != -1)
+			if (thruAreas[1] != path->stepList[path->numSteps - 1].area) {
+				for (int i = 0; i < path->numSteps; i++) {
+					if (path->stepList[i].area == thruAreas[1]) {
+						path->numStepsWhenNotPaused = path->numSteps = i + 1;
+						goalCell[0] = path->stepList[i].cell[0];
+						goalCell[1] = path->stepList[i].cell[1];
+						land->cellToWorld(goalCell[0], goalCell[1], *goalWorldPos);
+						break;
+					}
+				}
+			}
+		
+		#ifdef BLOCKED_PATH_TEST
+			//---------------------------------------------------------------------
+			// Let's test every path point to make sure it is not a blocked cell...
+			for (int i = 0; i < path->numSteps; i++) {
+				int tile[2], cell[2];
+				GameMap->worldToMapPos(path->stepList[i].destination, tile[0], tile[1], cell[0], cell[1]);
+				bool cellPassable = GameMap->cellPassable(tile[0], tile[0], cell[0], cell[1]);
+				if (!cellPassable)
+					cellPassable = GameMap->cellPassable(tile[0], tile[0], cell[0], cell[1]);
+				Assert(cellPassable || (i < 3), 0, " Bad Path Point ");
+			}
+		#endif
+	}
+
+	//------------------------------------------------------------------------------------
+	// If we're starting on the goal cell, set the cost to 1 as an indicator that there is
+	// a path--it's just that we were already there!
+	if (numCells == 0)
+		path->cost = 1;
+
+	return(path->numSteps);
+}
+
+//---------------------------------------------------------------------------
 long MoveMap::calcPathJUMP (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int* goalCell) {
 
 	#ifdef TIME_PATH
@@ -5489,17 +6853,14 @@ long MoveMap::calcPathJUMP (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int
 
 	//------------------------------------------------------------------
 	// Let's use their hPrime as a barrier for cutting off the search...
-	MaxHPrime = calcHPrime(startR, startC) * 2.5;
-	if (MaxHPrime < 500)
-		MaxHPrime = 500;
+	maxHPrime = calcHPrime(startR, startC) * 2.5;
+	if (maxHPrime < 500)
+		maxHPrime = 500;
 	
 	//-----------------------------------------------
 	// If we haven't already, create the OPEN list...
-	if (!openList) {
-		openList = new PriorityQueue;
-		gosASSERT(openList != NULL);
-		openList->init(5000);
-	}
+	if (!openList)
+		initOpenList();
 
     int curCol = startC;
 	int curRow = startR;
@@ -5611,7 +6972,7 @@ long MoveMap::calcPathJUMP (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int
 					if (succMapNode->hPrime == HPRIME_NOT_CALCED)
 						succMapNode->hPrime = calcHPrime(succRow, succCol);
 
-					if (succMapNode->hPrime < MaxHPrime) {
+					if (succMapNode->hPrime < maxHPrime) {
 
 						#ifdef DEBUG_PATH
 							numNodesVisited++;
@@ -5718,7 +7079,7 @@ long MoveMap::calcPathJUMP (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int
 	#endif
 
 #if 0		//REdo when bridges are done
-	if (ClearBridgeTiles) {
+	if (clearBridgeTiles) {
 		overlayWeightTable[OVERLAY_WATER_BRIDGE_NS * MAPCELL_DIM * MAPCELL_DIM + 1] += COST_BLOCKED;
 		overlayWeightTable[OVERLAY_WATER_BRIDGE_NS * MAPCELL_DIM * MAPCELL_DIM + 4] += COST_BLOCKED;
 		overlayWeightTable[OVERLAY_WATER_BRIDGE_NS * MAPCELL_DIM * MAPCELL_DIM + 7] += COST_BLOCKED;
@@ -5836,18 +7197,6 @@ long MoveMap::calcPathJUMP (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int
 				}
 			}
 			
-			//---------------------------------------------------------
-			// We need to set this table up our first time thru here...
-			static bool setTable = false;
-			if (!setTable) {
-				float cellLength = Terrain::worldUnitsPerCell * metersPerWorldUnit;
-				for (int i = 0; i < NUM_CELL_OFFSETS; i++) {
-					float distance = agsqrt( cellShift[i * 2], cellShift[i * 2 + 1] ) * cellLength;
-					cellShiftDistance[i] = distance;
-				}
-				setTable = true;
-			}
-			
 			while ((curRow != startR) || (curCol != startC)) {
 				curCell--;
 				int parent = reverseShift[map[curRow * maxWidth + curCol].parent];
@@ -5964,17 +7313,14 @@ long MoveMap::calcEscapePath (MovePathPtr path, Stuff::Vector3D* goalWorldPos, l
 
 	//------------------------------------------------------------------
 	// Let's use their hPrime as a barrier for cutting off the search...
-	MaxHPrime = 500; //float2short(calcHPrime(startR, startC) * 2.5);
-	if (MaxHPrime < 500)
-		MaxHPrime = 500;
+	maxHPrime = 500; //float2short(calcHPrime(startR, startC) * 2.5);
+	if (maxHPrime < 500)
+		maxHPrime = 500;
 	
 	//-----------------------------------------------
 	// If we haven't already, create the OPEN list...
-	if (!openList) {
-		openList = new PriorityQueue;
-		gosASSERT(openList != NULL);
-		openList->init(5000);
-	}
+	if (!openList)
+		initOpenList();
 		
 	long curCol = startC;
 	long curRow = startR;
@@ -6076,7 +7422,7 @@ long MoveMap::calcEscapePath (MovePathPtr path, Stuff::Vector3D* goalWorldPos, l
 					if (succMapNode->hPrime == HPRIME_NOT_CALCED)
 						succMapNode->hPrime = 10; //calcHPrime(succRow, succCol);
 
-					if (succMapNode->hPrime < MaxHPrime) {
+					if (succMapNode->hPrime < maxHPrime) {
 
 						#ifdef DEBUG_PATH
 							numNodesVisited++;
@@ -6183,7 +7529,7 @@ long MoveMap::calcEscapePath (MovePathPtr path, Stuff::Vector3D* goalWorldPos, l
 	#endif
 
 #if 0	//Redo when bridges are done
-	if (ClearBridgeTiles) {
+	if (clearBridgeTiles) {
 		overlayWeightTable[OVERLAY_WATER_BRIDGE_NS * MAPCELL_DIM * MAPCELL_DIM + 1] += COST_BLOCKED;
 		overlayWeightTable[OVERLAY_WATER_BRIDGE_NS * MAPCELL_DIM * MAPCELL_DIM + 4] += COST_BLOCKED;
 		overlayWeightTable[OVERLAY_WATER_BRIDGE_NS * MAPCELL_DIM * MAPCELL_DIM + 7] += COST_BLOCKED;
@@ -6298,18 +7644,6 @@ long MoveMap::calcEscapePath (MovePathPtr path, Stuff::Vector3D* goalWorldPos, l
 				}
 			}
 			
-			//---------------------------------------------------------
-			// We need to set this table up our first time thru here...
-			static bool setTable = false;
-			if (!setTable) {
-				float cellLength = Terrain::worldUnitsPerCell * metersPerWorldUnit;
-				for (long i = 0; i < NUM_CELL_OFFSETS; i++) {
-					float distance = agsqrt( cellShift[i * 2], cellShift[i * 2 + 1] ) * cellLength;
-					cellShiftDistance[i] = distance;
-				}
-				setTable = true;
-			}
-			
 			while ((curRow != startR) || (curCol != startC)) {
 				curCell--;
 				long parent = reverseShift[map[curRow * maxWidth + curCol].parent];
@@ -6496,6 +7830,471 @@ void MoveMap::destroy (void) {
 		mapColTable = NULL;
 	}
 
+	if (openList)
+	{
+		delete openList;
+		openList = NULL;
+	}
+}
+
+//---------------------------------------------------------------------------
+
+//***************************************************************************
+// MOVE REPLANNER class (D* Lite)
+//***************************************************************************
+
+void* MoveReplanner::operator new (size_t mySize) {
+
+	void* result = systemHeap->Malloc(mySize);
+	return(result);
+}
+
+//---------------------------------------------------------------------------
+
+void MoveReplanner::operator delete (void* us) {
+
+	systemHeap->Free(us);
+}
+
+//---------------------------------------------------------------------------
+
+void MoveReplanner::init (long maxMapCells) {
+
+	maxCells = maxMapCells;
+
+	slots = (ReplanSlotPtr)systemHeap->Malloc(sizeof(ReplanSlot) * MAX_REPLAN_SLOTS);
+	gosASSERT(slots != NULL);
+	for (long i = 0; i < MAX_REPLAN_SLOTS; i++) {
+		slots[i].moverWID = 0;
+		slots[i].lastUsed = 0;
+		slots[i].cost = (int*)systemHeap->Malloc(sizeof(int) * maxCells);
+		slots[i].flags = (unsigned char*)systemHeap->Malloc(maxCells);
+		slots[i].g = (int*)systemHeap->Malloc(sizeof(int) * maxCells);
+		slots[i].rhs = (int*)systemHeap->Malloc(sizeof(int) * maxCells);
+		gosASSERT(slots[i].cost && slots[i].flags && slots[i].g && slots[i].rhs);
+	}
+
+	openList = new PriorityQueue;
+	gosASSERT(openList != NULL);
+	openList->init(maxCells * 2);
+	openList->reserve(maxCells);
+}
+
+//---------------------------------------------------------------------------
+
+void MoveReplanner::destroy (void) {
+
+	if (slots) {
+		for (long i = 0; i < MAX_REPLAN_SLOTS; i++) {
+			systemHeap->Free(slots[i].cost);
+			systemHeap->Free(slots[i].flags);
+			systemHeap->Free(slots[i].g);
+			systemHeap->Free(slots[i].rhs);
+		}
+		systemHeap->Free(slots);
+		slots = NULL;
+	}
+
+	if (openList) {
+		delete openList;
+		openList = NULL;
+	}
+
+	openListSlot = NULL;
+	curSlot = NULL;
+}
+
+//---------------------------------------------------------------------------
+
+long MoveReplanner::calcH (long index) {
+
+	//---------------------------------------------------------------
+	// Octile distance from the current start at the cheapest cell cost
+	// in the window, so it never overestimates...
+	long rowDelta = index / curSlot->width - curStartR;
+	long colDelta = index % curSlot->width - curStartC;
+	if (rowDelta < 0)
+		rowDelta = -rowDelta;
+	if (colDelta < 0)
+		colDelta = -colDelta;
+	long diagSteps = (rowDelta < colDelta) ? rowDelta : colDelta;
+	long straightSteps = rowDelta + colDelta - diagSteps * 2;
+	long minCost = curSlot->minCost;
+	return(straightSteps * minCost + diagSteps * (minCost + minCost / 2));
+}
+
+//---------------------------------------------------------------------------
+
+long MoveReplanner::calcKey (long index) {
+
+	long best = curSlot->g[index];
+	if (curSlot->rhs[index] < best)
+		best = curSlot->rhs[index];
+	return(best + calcH(index) + curSlot->km);
+}
+
+//---------------------------------------------------------------------------
+
+bool MoveReplanner::getEdge (long index, long dir, long& succIndex, long& cost) {
+
+	//-----------------------------------------------------------------
+	// Same rules MoveMap::calcPath uses to step from one cell to the
+	// next: no blocked cells, no clipping corners, no stepping back
+	// into an offMap cell once we're on the map...
+	long width = curSlot->width;
+	long row = index / width + cellShift[dir * 2];
+	long col = index % width + cellShift[dir * 2 + 1];
+	if ((row < 0) || (row >= curSlot->height) || (col < 0) || (col >= width))
+		return(false);
+
+	succIndex = row * width + col;
+	if (curSlot->cost[succIndex] >= COST_BLOCKED)
+		return(false);
+
+	if ((curSlot->flags[succIndex] & REPLAN_CELL_OFFMAP) && curSlot->cannotEnterOffMap)
+		if ((curSlot->flags[index] & REPLAN_CELL_OFFMAP) == 0)
+			return(false);
+
+	cost = curSlot->cost[succIndex];
+	if (IsDiagonalStep[dir]) {
+		bool adjOpen = false;
+		for (long i = 0; i < 2; i++) {
+			long adjDir = StepAdjDir[dir + i];
+			long adjRow = index / width + cellShift[adjDir * 2];
+			long adjCol = index % width + cellShift[adjDir * 2 + 1];
+			if ((adjRow < 0) || (adjRow >= curSlot->height) || (adjCol < 0) || (adjCol >= width))
+				continue;
+			long adjIndex = adjRow * width + adjCol;
+			if ((curSlot->flags[adjIndex] & REPLAN_CELL_MOVER) == 0)
+				if (curSlot->cost[adjIndex] < COST_BLOCKED)
+					adjOpen = true;
+		}
+		if (!adjOpen)
+			return(false);
+		cost += (cost / 2);
+	}
+	return(true);
+}
+
+//---------------------------------------------------------------------------
+
+void MoveReplanner::updateVertex (long index) {
+
+	if ((curSlot->flags[index] & REPLAN_CELL_GOAL) == 0) {
+		long best = REPLAN_COST_INFINITE;
+		for (long dir = 0; dir < NUM_ADJ_CELLS; dir++) {
+			long succIndex, cost;
+			if (getEdge(index, dir, succIndex, cost))
+				if (curSlot->g[succIndex] < REPLAN_COST_INFINITE)
+					if ((cost + curSlot->g[succIndex]) < best)
+						best = cost + curSlot->g[succIndex];
+		}
+		curSlot->rhs[index] = best;
+	}
+
+	int openIndex = openList->find(index);
+	if (curSlot->g[index] != curSlot->rhs[index]) {
+		long key = calcKey(index);
+		if (openIndex)
+			openList->change(openIndex, key);
+		else {
+			PQNode node;
+			node.key = key;
+			node.id = index;
+			node.row = index / curSlot->width;
+			node.col = index % curSlot->width;
+			openList->insert(node);
+		}
+		}
+	else if (openIndex)
+		openList->removeItem(openIndex);
+}
+
+//---------------------------------------------------------------------------
+
+bool MoveReplanner::computeShortestPath (void) {
+
+	//-------------------------------------------------------------------
+	// Keys are compared on their first part only, so we keep going until
+	// the top key is past the start's rather than just up to it...
+	long startIndex = curStartR * curSlot->width + curStartC;
+	long maxExpansions = curSlot->width * curSlot->height * 8;
+	while (!openList->isEmpty()) {
+		if ((openList->getItem(1)->key > calcKey(startIndex)) && (curSlot->g[startIndex] == curSlot->rhs[startIndex]))
+			break;
+		if (++numNodesExpanded > maxExpansions)
+			return(false);
+		if (peakOpenNodes < openList->getNumItems())
+			peakOpenNodes = openList->getNumItems();
+
+		PQNode bestPQNode;
+		openList->remove(bestPQNode);
+		long index = bestPQNode.id;
+		long newKey = calcKey(index);
+		if (bestPQNode.key < newKey) {
+			bestPQNode.key = newKey;
+			openList->insert(bestPQNode);
+			}
+		else if (curSlot->g[index] > curSlot->rhs[index]) {
+			curSlot->g[index] = curSlot->rhs[index];
+			for (long dir = 0; dir < NUM_ADJ_CELLS; dir++) {
+				long row = index / curSlot->width + cellShift[dir * 2];
+				long col = index % curSlot->width + cellShift[dir * 2 + 1];
+				if ((row >= 0) && (row < curSlot->height) && (col >= 0) && (col < curSlot->width))
+					updateVertex(row * curSlot->width + col);
+			}
+			}
+		else {
+			curSlot->g[index] = REPLAN_COST_INFINITE;
+			updateVertex(index);
+			for (long dir = 0; dir < NUM_ADJ_CELLS; dir++) {
+				long row = index / curSlot->width + cellShift[dir * 2];
+				long col = index % curSlot->width + cellShift[dir * 2 + 1];
+				if ((row >= 0) && (row < curSlot->height) && (col >= 0) && (col < curSlot->width))
+					updateVertex(row * curSlot->width + col);
+			}
+		}
+	}
+	return(true);
+}
+
+//---------------------------------------------------------------------------
+
+ReplanSlotPtr MoveReplanner::getSlot (long moverWID) {
+
+	ReplanSlotPtr oldestSlot = &slots[0];
+	for (long i = 0; i < MAX_REPLAN_SLOTS; i++) {
+		if (slots[i].moverWID == moverWID)
+			return(&slots[i]);
+		if (slots[i].lastUsed < oldestSlot->lastUsed)
+			oldestSlot = &slots[i];
+	}
+	oldestSlot->moverWID = 0;
+	return(oldestSlot);
+}
+
+//---------------------------------------------------------------------------
+
+void MoveReplanner::rebuildSlot (ReplanSlotPtr slot, MoveMapPtr moveMap) {
+
+	slot->ULr = moveMap->ULr;
+	slot->ULc = moveMap->ULc;
+	slot->width = moveMap->width;
+	slot->height = moveMap->height;
+	slot->moveLevel = moveMap->moveLevel;
+	slot->doorDirection = moveMap->doorDirection;
+	slot->cannotEnterOffMap = moveMap->cannotEnterOffMap;
+	slot->lastStartR = moveMap->startR;
+	slot->lastStartC = moveMap->startC;
+	slot->km = 0;
+	slot->minCost = COST_BLOCKED;
+
+	curSlot = slot;
+	openListSlot = slot;
+	openList->clear();
+
+	for (long r = 0; r < slot->height; r++)
+		for (long c = 0; c < slot->width; c++) {
+			MoveMapNodePtr mapNode = &moveMap->map[moveMap->mapRowStartTable[r] + c];
+			long index = r * slot->width + c;
+			slot->cost[index] = mapNode->cost;
+			slot->flags[index] = 0;
+			if (mapNode->flags & MOVEFLAG_MOVER_HERE)
+				slot->flags[index] |= REPLAN_CELL_MOVER;
+			if (mapNode->flags & MOVEFLAG_OFFMAP)
+				slot->flags[index] |= REPLAN_CELL_OFFMAP;
+			if (mapNode->flags & MOVEFLAG_GOAL)
+				slot->flags[index] |= REPLAN_CELL_GOAL;
+			if (mapNode->cost < slot->minCost)
+				slot->minCost = mapNode->cost;
+			slot->g[index] = REPLAN_COST_INFINITE;
+			slot->rhs[index] = REPLAN_COST_INFINITE;
+		}
+	if (slot->minCost < 1)
+		slot->minCost = 1;
+
+	long numCells = slot->width * slot->height;
+	for (long i = 0; i < numCells; i++)
+		if (slot->flags[i] & REPLAN_CELL_GOAL) {
+			slot->rhs[i] = 0;
+			updateVertex(i);
+		}
+}
+
+//---------------------------------------------------------------------------
+
+bool MoveReplanner::repairSlot (ReplanSlotPtr slot, MoveMapPtr moveMap) {
+
+	//------------------------------------------------------------------
+	// Returns false if the set up is too different to repair, in which
+	// case the caller starts the slot over...
+	if ((slot->ULr != moveMap->ULr) || (slot->ULc != moveMap->ULc))
+		return(false);
+	if ((slot->width != moveMap->width) || (slot->height != moveMap->height))
+		return(false);
+	if ((slot->moveLevel != moveMap->moveLevel) || (slot->doorDirection != moveMap->doorDirection))
+		return(false);
+	if (slot->cannotEnterOffMap != moveMap->cannotEnterOffMap)
+		return(false);
+
+	curSlot = slot;
+	long numCells = slot->width * slot->height;
+	long numChanged = 0;
+	for (long r = 0; r < slot->height; r++)
+		for (long c = 0; c < slot->width; c++) {
+			MoveMapNodePtr mapNode = &moveMap->map[moveMap->mapRowStartTable[r] + c];
+			long index = r * slot->width + c;
+			unsigned char flags = 0;
+			if (mapNode->flags & MOVEFLAG_MOVER_HERE)
+				flags |= REPLAN_CELL_MOVER;
+			if (mapNode->flags & MOVEFLAG_OFFMAP)
+				flags |= REPLAN_CELL_OFFMAP;
+			if (mapNode->flags & MOVEFLAG_GOAL)
+				flags |= REPLAN_CELL_GOAL;
+			if ((flags ^ slot->flags[index]) & REPLAN_CELL_GOAL)
+				return(false);
+			if (mapNode->cost < slot->minCost)
+				return(false);
+			if ((slot->cost[index] != mapNode->cost) || (slot->flags[index] != flags)) {
+				//-------------------------------------------------------
+				// Just mark it for now. The rhs values are fixed up once
+				// every change is in, since a cell can see several...
+				slot->cost[index] = mapNode->cost;
+				slot->flags[index] = flags | REPLAN_CELL_CHANGED;
+				numChanged++;
+			}
+		}
+
+	//--------------------------------------------------------------
+	// If most of the window changed, a fresh search is cheaper...
+	if (numChanged > (numCells / 4))
+		return(false);
+
+	//-------------------------------------------------------------------
+	// The start has moved since the last solve, so every key in the OPEN
+	// list is off by the distance it moved...
+	curSlot->km += calcH(slot->lastStartR * slot->width + slot->lastStartC);
+	slot->lastStartR = curStartR;
+	slot->lastStartC = curStartC;
+
+	//-------------------------------------------------------------------
+	// The OPEN list is shared by every slot. If another slot has used it
+	// since, refill it: it holds exactly the cells whose g and rhs differ...
+	if (openListSlot != slot) {
+		openList->clear();
+		for (long i = 0; i < numCells; i++)
+			if (slot->g[i] != slot->rhs[i]) {
+				PQNode node;
+				node.key = calcKey(i);
+				node.id = i;
+				node.row = i / slot->width;
+				node.col = i % slot->width;
+				openList->insert(node);
+			}
+		openListSlot = slot;
+	}
+
+	//------------------------------------------------------------------
+	// A changed cell changes the edges into it and, for diagonals that
+	// would clip its corner, the edges around it. Either way, only the
+	// cell and its neighbors need a new rhs...
+	if (numChanged > 0)
+		for (long i = 0; i < numCells; i++) {
+			if ((slot->flags[i] & REPLAN_CELL_CHANGED) == 0)
+				continue;
+			slot->flags[i] &= (REPLAN_CELL_CHANGED ^ 0xFF);
+			updateVertex(i);
+			long row = i / slot->width;
+			long col = i % slot->width;
+			for (long dir = 0; dir < NUM_ADJ_CELLS; dir++) {
+				long adjRow = row + cellShift[dir * 2];
+				long adjCol = col + cellShift[dir * 2 + 1];
+				if ((adjRow >= 0) && (adjRow < slot->height) && (adjCol >= 0) && (adjCol < slot->width))
+					updateVertex(adjRow * slot->width + adjCol);
+			}
+		}
+	return(true);
+}
+
+//---------------------------------------------------------------------------
+
+long MoveReplanner::calcPath (MoveMapPtr moveMap, MovePathPtr path, Stuff::Vector3D* goalWorldPos, int* goalCell) {
+
+	//----------------------------------------------------------------------
+	// Escape paths have goals all over the map and jump maps have different
+	// steps, so leave those (and any map too big for our slots) to calcPath...
+	if (!IncrementalReplan || FindingEscapePath || (moveMap->moverWID < 1) || (moveMap->numOffsets > 8) ||
+		((moveMap->width * moveMap->height) > maxCells)) {
+		numFallbacks++;
+		return(moveMap->calcPath(path, goalWorldPos, goalCell));
+	}
+
+	tick++;
+	ReplanSlotPtr slot = getSlot(moveMap->moverWID);
+	slot->lastUsed = tick;
+	curStartR = moveMap->startR;
+	curStartC = moveMap->startC;
+	numNodesExpanded = 0;
+	peakOpenNodes = 0;
+
+	bool repaired = false;
+	if (slot->moverWID == moveMap->moverWID)
+		repaired = repairSlot(slot, moveMap);
+	if (repaired)
+		numRepairs++;
+	else {
+		slot->moverWID = moveMap->moverWID;
+		rebuildSlot(slot, moveMap);
+		numRebuilds++;
+	}
+
+	if (!computeShortestPath()) {
+		slot->moverWID = 0;
+		numFallbacks++;
+		return(moveMap->calcPath(path, goalWorldPos, goalCell));
+	}
+	moveMap->numNodesExpanded = numNodesExpanded;
+	moveMap->peakOpenNodes = peakOpenNodes;
+
+	long width = slot->width;
+	long curIndex = curStartR * width + curStartC;
+	if (slot->g[curIndex] >= REPLAN_COST_INFINITE)
+		return(0);
+
+	//----------------------------------------------------------------
+	// Walk downhill from the start to the goal, leaving parent links in
+	// the move map so it can build the path just like calcPath does...
+	long pathCost = slot->g[curIndex];
+	long numCells = width * slot->height;
+	long numSteps = 0;
+	while ((slot->flags[curIndex] & REPLAN_CELL_GOAL) == 0) {
+		long bestDir = -1;
+		long bestIndex = -1;
+		long bestCost = REPLAN_COST_INFINITE;
+		for (long dir = 0; dir < NUM_ADJ_CELLS; dir++) {
+			long succIndex, cost;
+			if (getEdge(curIndex, dir, succIndex, cost))
+				if ((cost + slot->g[succIndex]) < bestCost) {
+					bestCost = cost + slot->g[succIndex];
+					bestDir = dir;
+					bestIndex = succIndex;
+				}
+		}
+		if ((bestDir == -1) || (++numSteps > numCells)) {
+			slot->moverWID = 0;
+			numFallbacks++;
+			return(moveMap->calcPath(path, goalWorldPos, goalCell));
+		}
+		MoveMapNodePtr succMapNode = &moveMap->map[moveMap->mapRowStartTable[bestIndex / width] + (bestIndex % width)];
+		succMapNode->parent = reverseShift[bestDir];
+		succMapNode->jumpLength = 1;
+		curIndex = bestIndex;
+	}
+
+	long goalRow = curIndex / width;
+	long goalCol = curIndex % width;
+	moveMap->map[moveMap->mapRowStartTable[goalRow] + goalCol].g = pathCost;
+	return(moveMap->buildPath(path, goalRow, goalCol, goalWorldPos, goalCell));
 }
 
 //***************************************************************************
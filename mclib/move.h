@@ -80,6 +80,8 @@ typedef enum {
 #define	MOVEFLAG_MOVER_HERE		16
 #define	MOVEFLAG_GOAL_BLOCKED	32
 #define	MOVEFLAG_OFFMAP			64
+#define	MOVEFLAG_UNIFORM_CHECKED	128
+#define	MOVEFLAG_UNIFORM		256		// cell and all its neighbors are plain clear cells
 
 #define	CELLSTATE_OPEN			0
 #define	CELLSTATE_BLOCKED		1
@@ -512,6 +514,7 @@ extern float VerticesMapSideDivTwo;
 extern float MetersMapSideDivTwo;
 
 #define	MAX_DEBUG_CELLS		1000
+#define	MAX_RAISED_CELLS	256
 
 class MissionMap {
 
@@ -527,6 +530,8 @@ class MissionMap {
 		PreservedCell		preservedCells[MAX_MOVERS];
 		long				numDebugCells;
 		long				debugCells[MAX_DEBUG_CELLS][3];
+		long				numRaisedCells;						// Cells whose local height went up (may exceed MAX_RAISED_CELLS)
+		long				raisedCells[MAX_RAISED_CELLS];		// row * width + col
 
 		void				(*placeMoversCallback) (void);
 		
@@ -544,6 +549,7 @@ class MissionMap {
 			numPreservedCells = 0;
 			placeMoversCallback = NULL;
 			numDebugCells = 0;  
+			numRaisedCells = 0;
 		}
 		
 		MissionMap (void) {
@@ -568,6 +574,8 @@ class MissionMap {
 
 		long write (PacketFile* packetFile, long whichPacket = 0);
 
+		uint64_t calcHash (void);
+
 		unsigned long getTerrain (long row, long col) {
 			return(map[row * width + col].getTerrain());
 		}
@@ -635,6 +643,13 @@ class MissionMap {
 		}
 
 		void setLocalHeight (long row, long col, DWORD localElevation) {
+			//-------------------------------------------------------------
+			// Raised cells are remembered so cached LOS data can catch up.
+			if (localElevation > map[row * width + col].getLocalHeight()) {
+				if (numRaisedCells < MAX_RAISED_CELLS)
+					raisedCells[numRaisedCells] = row * width + col;
+				numRaisedCells++;
+			}
 			map[row * width + col].setLocalHeight(localElevation);
 		}
 
@@ -1095,6 +1110,109 @@ typedef struct _GlobalSpecialAreaInfo {
 } GlobalSpecialAreaInfo;
 
 typedef DoorLinkPtr DoorInfoLinksPtr[2];
+
+//------------------------------------------------------------------------------------------
+// Area-to-area path cache. Group orders send several movers from the same
+// area thru the same doors, so we remember the door sequence and only
+// re-run the search when an area it touched has changed since...
+#define	GLOBAL_PATH_CACHE_SIZE		128
+#define	GLOBAL_PATH_CACHE_MAX_AREAS	128
+#define	GLOBAL_PATH_CACHE_TEAMS		9		// MAX_TEAMS, plus no team (-1)
+
+typedef struct _GlobalPathCacheStep {
+	short					thruArea;
+	short					goalDoor;
+	int						costToGoal;
+} GlobalPathCacheStep;
+
+typedef struct _GlobalPathCacheEntry {
+	short					startArea;
+	short					goalArea;
+	short					startDoor;		// nearest door to the start cell (-1 == no cell)
+	short					goalDoor;		// nearest door to the goal cell (-1 == no cell)
+	char					moverTeamID;
+	bool					useClosedAreas;
+	bool					valid;
+	unsigned long			stamp;			// pathCacheStamp when calced
+	unsigned long			lastUsed;
+	short					numSteps;		// 0 == no path
+	short					numAreas;		// areas the search looked thru
+	GlobalPathCacheStep*	steps;
+	short*					areaList;
+} GlobalPathCacheEntry;
+
+typedef GlobalPathCacheEntry* GlobalPathCacheEntryPtr;
+
+//------------------------------------------------------------------------------------------
+// Flow fields. When a group is sent to one spot, a single reverse search from
+// the goal area gives every door its cost and next door to the goal, so each
+// member reads its global path from the field instead of running its own...
+#define	MAX_FLOW_FIELDS				4
+#define	FLOW_FIELD_LIFETIME			5.0		// in seconds
+
+typedef struct _GlobalFlowField {
+	long					goalArea;
+	char					moverTeamID;
+	bool					useClosedAreas;
+	bool					valid;
+	float					expireTime;		// scenarioTime
+	unsigned long			stamp;			// pathCacheStamp when calced
+	long*					costToGoal;		// per door * 2 + side we entered from
+	long*					nextDoor;		// same index for the next door, -1 = goal
+} GlobalFlowField;
+
+typedef GlobalFlowField* GlobalFlowFieldPtr;
+
+//------------------------------------------------------------------------------------------
+// Build info trails the move data. It ties the door graph to the map cells it
+// was built from, and carries each map's area components (one short per area
+// follows the header) so the game doesn't have to find them at load...
+#define	MOVEDATA_BUILDINFO_ID		0x4942564D		// "MVBI"
+#define	MOVEDATA_BUILDINFO_VERSION	1
+
+typedef struct _MoveDataBuildInfo {
+	uint32_t				id;
+	uint32_t				version;
+	uint64_t				mapHash;			// MissionMap::calcHash
+	uint64_t				topologyHash[3];	// GlobalMap::calcTopologyHash
+	int32_t					numAreas[3];
+} MoveDataBuildInfo;
+
+//------------------------------------------------------------------------------------------
+// Build jobs. Each sector is flood filled on its own with area numbers local
+// to the sector, then calcAreas merges them in sector order so the numbering
+// comes out just as the one-sector-at-a-time fill gave it. Door link costs
+// are split by door, each job solving on its own sector map...
+class GlobalMap;
+class MoveMap;
+
+typedef struct _GlobalSectorAreaJob {
+	GlobalMap*				globalMap;
+	long					sectorR;
+	long					sectorC;
+	long					minRow;
+	long					maxRow;
+	long					minCol;
+	long					maxCol;
+	long					numAreas;									// local to the sector
+	long					firstArea;									// set when merged
+	short					cellArea[SECTOR_DIM * SECTOR_DIM];			// local area, -1 if not filled
+	long					numSubAreas;
+	short					subAreaSpecial[SECTOR_DIM * SECTOR_DIM];	// special area...
+	short					subAreaLocal[SECTOR_DIM * SECTOR_DIM];		// ...and its local sub area
+} GlobalSectorAreaJob;
+
+typedef GlobalSectorAreaJob* GlobalSectorAreaJobPtr;
+
+typedef struct _GlobalDoorLinkJob {
+	GlobalMap*				globalMap;
+	MoveMap*				moveMap;
+	long					firstDoor;
+	long					doorStep;
+} GlobalDoorLinkJob;
+
+typedef GlobalDoorLinkJob* GlobalDoorLinkJobPtr;
+
 class GlobalMap {
 
 	public:
@@ -1127,6 +1245,7 @@ class GlobalMap {
 		unsigned char*				pathCostTable;
 #endif
 		unsigned char*				pathExistsTable;
+		short*						areaComponent;		// areas that can't reach each other differ
 
 		int						    numSpecialAreas;
 		GlobalSpecialAreaInfo*		specialAreas;	// used when building data
@@ -1153,6 +1272,36 @@ class GlobalMap {
 		bool (*isGateDisabledCallback) (int objectWID);
 		bool (*isGateOpenCallback) (int objectWID);
 
+		GlobalPathCacheEntryPtr		pathCache;
+		unsigned long*				areaStamp;			// last pathCacheStamp the area changed
+		unsigned long				lastAreaStamp;		// newest areaStamp
+		unsigned long*				gateStamp;			// per team, last pathCacheStamp a gate changed the area
+		unsigned long				lastGateStamp[GLOBAL_PATH_CACHE_TEAMS];
+		unsigned char*				gateSeen;			// per team, 0 = not yet, 1 = closed, 2 = open
+		bool						touchAreas;			// false while calcPath sets the gates for one team
+		long						startDoorPick;		// nearest start area door to startCell
+		long						goalDoorPick;		// nearest goal area door to goalCell
+		unsigned long				pathCacheStamp;
+		unsigned long				pathCacheTick;
+		short*						pathCacheAreaList;	// scratch list for the current search
+		long						pathCacheNumAreas;
+		unsigned char*				pathCacheAreaMark;
+
+		static bool					usePathCache;
+		static long					pathCacheHits;
+		static long					pathCacheMisses;
+
+		GlobalFlowFieldPtr			flowFields;
+		long						flowGoalArea[MAX_FLOW_FIELDS];
+		float						flowGoalExpireTime[MAX_FLOW_FIELDS];
+		PriorityQueuePtr			flowOpenList;
+
+		long						numNodesExpanded;	// stats for the last calcPath
+		long						peakOpenNodes;
+
+		static long					flowFieldBuilds;
+		static long					flowFieldPaths;
+
 		static int					minRow;
 		static int					maxRow;
 		static int					minCol;
@@ -1211,6 +1360,35 @@ class GlobalMap {
 
 			isGateDisabledCallback = NULL;
 			isGateOpenCallback = NULL;
+
+			pathExistsTable = NULL;
+			areaComponent = NULL;
+
+			pathCache = NULL;
+			areaStamp = NULL;
+			lastAreaStamp = 0;
+			gateStamp = NULL;
+			for (long i = 0; i < GLOBAL_PATH_CACHE_TEAMS; i++)
+				lastGateStamp[i] = 0;
+			gateSeen = NULL;
+			touchAreas = true;
+			startDoorPick = -1;
+			goalDoorPick = -1;
+			pathCacheStamp = 0;
+			pathCacheTick = 0;
+			pathCacheAreaList = NULL;
+			pathCacheNumAreas = 0;
+			pathCacheAreaMark = NULL;
+
+			flowFields = NULL;
+			for (long i = 0; i < MAX_FLOW_FIELDS; i++) {
+				flowGoalArea[i] = -1;
+				flowGoalExpireTime[i] = 0.0;
+			}
+			flowOpenList = NULL;
+
+			numNodesExpanded = 0;
+			peakOpenNodes = 0;
 		}
 
 		GlobalMap (void) {
@@ -1241,11 +1419,11 @@ class GlobalMap {
 
 		bool fillEastWestRailroadBridgeArea (long row, long col, long area);
 
-		bool fillSpecialArea (long row, long col, long area, long wallGateID);
+		bool fillSpecialArea (GlobalSectorAreaJobPtr job, long row, long col, long area, long wallGateID);
 
-		bool fillArea (long row, long col, long area, bool offMap);
+		bool fillArea (GlobalSectorAreaJobPtr job, long row, long col, long area, bool offMap);
 
-		void calcSectorAreas (long sectorR, long sectorC);
+		void calcSectorAreas (GlobalSectorAreaJobPtr job);
 
 		void beginDoorProcessing (void);
 
@@ -1269,10 +1447,12 @@ class GlobalMap {
 
 		void calcAreaDoors (void);
 
-		long calcLinkCost (long startDoor, long thruArea, long goalDoor);
+		long calcLinkCost (long startDoor, long thruArea, long goalDoor, MoveMap* moveMap = NULL);
 
 		void changeAreaLinkCost (long area, long cost);
 
+		void calcDoorLinkCosts (GlobalDoorLinkJobPtr job);
+
 		void calcDoorLinks (void);
 
         long getPathCost (int startArea, int goalArea, bool withSpecialAreas, int& confidence, bool calcIt);
@@ -1292,8 +1472,17 @@ class GlobalMap {
 #endif
 		void clearPathExistsTable (void);
 
+		void calcAreaComponents (void);
+
+		void setAreaComponents (short* components);
+
+		uint64_t calcTopologyHash (void);
+
 		void setPathExists (long fromArea, long toArea, unsigned char set);
 
+		//------------------------------------------------------------------
+		// Returns GLOBALPATH_EXISTS_UNKNOWN, _TRUE or _FALSE. Areas in
+		// different components are always _FALSE.
 		unsigned char getPathExists (long fromArea, long toArea);
 
 		long exitDirection (long doorIndex, long fromArea);
@@ -1381,6 +1570,35 @@ class GlobalMap {
 
 		bool getAdjacentAreaCell (long area, long adjacentArea, long& cellRow, long& cellCol);
 
+		void initPathCache (void);
+
+		void destroyPathCache (void);
+
+		void touchArea (long area) {
+			if (areaStamp && touchAreas && (area > -1) && (area < numAreas)) {
+				areaStamp[area] = ++pathCacheStamp;
+				lastAreaStamp = pathCacheStamp;
+			}
+		}
+
+		void setGateSeen (long area, bool open);
+
+		void addPathCacheArea (long area);
+
+		GlobalPathCacheEntryPtr findPathCacheEntry (long startArea, long goalArea);
+
+		void storePathCacheEntry (long startArea, long goalArea, unsigned long stamp, GlobalPathStepPtr path, long numSteps);
+
+		void requestFlowField (long goalArea);
+
+		void destroyFlowFields (void);
+
+		GlobalFlowFieldPtr getFlowField (long goalArea);
+
+		void calcFlowField (GlobalFlowFieldPtr field);
+
+		long calcFlowFieldPath (GlobalFlowFieldPtr field, long startArea, GlobalPathStepPtr path);
+
 		void print (char* fileName);
 
 		static bool toggleLog (void);
@@ -1405,6 +1623,8 @@ typedef struct _MoveMapNode {
 	int				fPrime;								// = g + hPrime
 
 	short		    adjCells[NUM_ADJ_CELLS];
+	short			jumpLength;							// cells back to parent node (jump point search)
+	short			jumpRun[NUM_ADJ_CELLS / 2];			// cells to the end of each straight jump (0 if not walked yet)
 
 	void setFlag (unsigned int flag) {
 		flags |= flag;
@@ -1460,6 +1680,15 @@ class MoveMap {
 		bool				moverWithdrawing;
 		bool				travelOffMap;
 		bool				cannotEnterOffMap;
+		bool				clearBridgeTiles;	// set while costing door links
+
+		//------------------------------------------------------------------
+		// Search scratch. Each MoveMap owns its own, so separate instances
+		// (e.g. path job snapshots) can be solved on separate threads...
+		PriorityQueuePtr	openList;
+		long				maxHPrime;
+		long				numNodesExpanded;	// stats for the last calcPath
+		long				peakOpenNodes;
 
 		void				(*blockedDoorCallback) (int moveLevel, int door, char* openCells);
 		void				(*placeStationaryMoversCallback) (MoveMapPtr map);
@@ -1475,6 +1704,11 @@ class MoveMap {
 		void propogateCost (long mapCellIndex, long cost, long g);
 		void propogateCostJUMP (long r, long c, long cost, long g);
 		int calcHPrime (int r, int c);
+		bool isUniformCell (long mapCellIndex);
+		bool isJumpDeadEnd (long mapCellIndex, long dir);
+		long findStraightJumpPoint (long mapCellIndex, long dir, long& length);
+		long findJumpPoint (long mapCellIndex, long dir, long& length);
+		void addJumpPoints (long mapCellIndex);
 		
 	public:
 
@@ -1514,7 +1748,12 @@ class MoveMap {
 			calcTime = 0.0;
 			travelOffMap = false;
 			cannotEnterOffMap = true;
+			clearBridgeTiles = false;
 			overlayWeightTable = NULL;
+			openList = NULL;
+			maxHPrime = 1000;
+			numNodesExpanded = 0;
+			peakOpenNodes = 0;
 			blockedDoorCallback = NULL;
 			placeStationaryMoversCallback = NULL;
 		}
@@ -1563,6 +1802,12 @@ class MoveMap {
 
 		void clear (void);
 
+		void initOpenList (void);
+
+		void copySetUp (MoveMapPtr source);
+
+		uint64_t calcSetUpChecksum (void);
+
 		void placeMovers (bool stationaryOnly);
 
 		void setOverlayWeightTable (int* table) {
@@ -1618,6 +1863,8 @@ class MoveMap {
 
 		long calcPath (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int* goalCell);
 
+		long buildPath (MovePathPtr path, int bestRow, int bestCol, Stuff::Vector3D* goalWorldPos, int* goalCell);
+
 		long calcPathJUMP (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int* goalCell);
 
 		long calcEscapePath (MovePathPtr path, Stuff::Vector3D* goalWorldPos, long* goalCell);
@@ -1644,6 +1891,114 @@ inline void MoveMap::setCost (long row, long col, long newCost) {
 	map[row * maxWidth + col].cost = newCost;
 }
 
+//---------------------------------------------------------------------------
+// Incremental replanner (D* Lite). A mover that has to recalc its path in the
+// same map window toward the same goal (pathlocked by another mover, a gate
+// closed in its face) keeps its last search, which runs backward from the
+// goal, and only the cells whose cost changed since are repaired...
+#define	MAX_REPLAN_SLOTS		32
+#define	REPLAN_COST_INFINITE	0x3FFFFFFF
+
+#define	REPLAN_CELL_MOVER		1
+#define	REPLAN_CELL_OFFMAP		2
+#define	REPLAN_CELL_GOAL		4
+#define	REPLAN_CELL_CHANGED		128
+
+typedef struct _ReplanSlot {
+	long				moverWID;			// 0 == free
+	unsigned long		lastUsed;
+	long				ULr;
+	long				ULc;
+	long				width;
+	long				height;
+	long				moveLevel;
+	long				doorDirection;
+	bool				cannotEnterOffMap;
+	long				lastStartR;
+	long				lastStartC;
+	long				km;					// heuristic offset as the start moves
+	long				minCost;
+	int*				cost;				// per cell, as of the last solve
+	unsigned char*		flags;
+	int*				g;					// cost to goal
+	int*				rhs;				// one-step lookahead of g
+} ReplanSlot;
+
+typedef ReplanSlot* ReplanSlotPtr;
+
+class MoveReplanner {
+
+	public:
+
+		ReplanSlotPtr		slots;
+		long				maxCells;
+		unsigned long		tick;
+		PriorityQueuePtr	openList;
+		ReplanSlotPtr		openListSlot;		// slot the OPEN list belongs to
+
+		ReplanSlotPtr		curSlot;			// slot being solved
+		long				curStartR;
+		long				curStartC;
+		long				numNodesExpanded;
+		long				peakOpenNodes;
+
+		static long			numRepairs;
+		static long			numRebuilds;
+		static long			numFallbacks;
+
+	protected:
+
+		long calcH (long index);
+
+		long calcKey (long index);
+
+		bool getEdge (long index, long dir, long& succIndex, long& cost);
+
+		void updateVertex (long index);
+
+		bool computeShortestPath (void);
+
+		ReplanSlotPtr getSlot (long moverWID);
+
+		void rebuildSlot (ReplanSlotPtr slot, MoveMapPtr moveMap);
+
+		bool repairSlot (ReplanSlotPtr slot, MoveMapPtr moveMap);
+
+	public:
+
+		void* operator new (size_t mySize);
+		void operator delete (void* us);
+
+		void init (void) {
+			slots = NULL;
+			maxCells = 0;
+			tick = 0;
+			openList = NULL;
+			openListSlot = NULL;
+			curSlot = NULL;
+			curStartR = 0;
+			curStartC = 0;
+			numNodesExpanded = 0;
+			peakOpenNodes = 0;
+		}
+
+		MoveReplanner (void) {
+			init();
+		}
+
+		void init (long maxMapCells);
+
+		void destroy (void);
+
+		~MoveReplanner (void) {
+			destroy();
+		}
+
+		long calcPath (MoveMapPtr moveMap, MovePathPtr path, Stuff::Vector3D* goalWorldPos, int* goalCell);
+};
+
+typedef MoveReplanner* MoveReplannerPtr;
+
 //---------------------------------------------------------------------------
 
 void SaveMapCells (char* fileName,  long height, long width,  MissionMapCellInfo* mapData);
@@ -1656,6 +2011,8 @@ void MOVE_init (long moveRange);
 void MOVE_buildData (long height, long width, MissionMapCellInfo* mapData, long numSpecialAreas, GameObjectFootPrint* specialAreaFootPrints);
 long MOVE_saveData (PacketFile* packetFile, long whichPacket = 0);
 long MOVE_readData (PacketFile* packetFile, long whichPacket);
+long MOVE_writeBuildInfo (PacketFile* packetFile, long whichPacket);
+long MOVE_readBuildInfo (PacketFile* packetFile, long whichPacket);
 void MOVE_cleanup (void);
 
 //long BuildAndSaveMoveData (char* fileName, long height, long width, MissionMapCellInfo* mapData);
@@ -1665,6 +2022,7 @@ void MOVE_cleanup (void);
 extern MissionMapPtr		GameMap;
 extern GlobalMapPtr			GlobalMoveMap[3];
 extern MoveMapPtr			PathFindMap[2];
+extern MoveReplannerPtr		PathReplanner;
 extern long					SimpleMovePathRange;
 
 //***************************************************************************
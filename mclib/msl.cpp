@@ -47,6 +47,10 @@
 #include"timing.h"
 #endif
 
+#ifndef ZONEPROF_H
+#include"zoneprof.h"
+#endif
+
 #include<toolos.hpp>
 
 
@@ -1278,19 +1282,10 @@ Stuff::UnitQuaternion moveem;
 
 float yawRotation = 0.0f;
 
-#ifdef LAB_ONLY
-__int64 MCTimeTransformandLight 	= 0;
-__int64 MCTimeAnimationandMatrix	= 0;
-__int64 MCTimePerShapeTransform		= 0;
-#endif
-
 long TG_MultiShape::TransformMultiShape (Stuff::Point3D *pos, Stuff::UnitQuaternion *rot)
 {
     //Profile T&L so I can break out GameLogic from T&L
-#ifdef LAB_ONLY
-    __int64 x;
-    x=GetCycles();
-#endif
+    PROFILE_ZONE_FINE("Transform and Light");
 
     Stuff::LinearMatrix4D 	shapeOrigin;
     Stuff::LinearMatrix4D	shadowOrigin;
@@ -1633,11 +1628,7 @@ long TG_MultiShape::TransformMultiShape (Stuff::Point3D *pos, Stuff::UnitQuatern
         shapeToClip.Multiply(listOfShapes[i].shapeToWorld,TG_Shape::s_worldToClip);
         backFacePoint.Multiply(camPosition,listOfShapes[i].worldToShape);
 
-#ifdef LAB_ONLY
-        x=GetCycles()-x;
-        MCTimeAnimationandMatrix += x;
-        x=GetCycles();
-#endif
+        PROFILE_BEGIN_FINE("Per Shape Transform");
 
         listOfShapes[i].node->MultiTransformShape(&shapeToClip,&backFacePoint,listOfShapes[i].parentNode,isHudElement,alphaValue,isClamped);
 
@@ -1646,16 +1637,9 @@ long TG_MultiShape::TransformMultiShape (Stuff::Point3D *pos, Stuff::UnitQuatern
             listOfShapes[i].node->MultiTransformShadows(pos, &(listOfShapes[i].shapeToWorld),yawRotation);
         }
 
-#ifdef LAB_ONLY
-        x=GetCycles()-x;
-        MCTimePerShapeTransform += x;
-        x=GetCycles();
-#endif
+        PROFILE_END("Per Shape Transform");
     }
 
-#ifdef LAB_ONLY
-    MCTimeTransformandLight = MCTimeAnimationandMatrix + MCTimePerShapeTransform;
-#endif
     return(0);
 }	
 
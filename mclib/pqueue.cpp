@@ -24,6 +24,7 @@
 #endif
 
 #include<gameos.hpp>
+#include<string.h>
 //***************************************************************************
 // Class PriorityQueue
 //***************************************************************************
@@ -40,12 +41,42 @@ int PriorityQueue::init (int max, int keyMinValue) {
 	// of the queue list are used as sentinels (to assist implementation
 	// execution speed)...
 	maxItems = max + 2;
+	numItems = 0;
 	keyMin = keyMinValue;
+
+	//-----------------------------------------------------------------
+	// The id -> slot table grows on demand in insert(), since the ids
+	// callers use (cell, door, goal map indices) vary widely in range.
+	slotTable = NULL;
+	slotTableSize = 0;
 	return(0);
 }
 
 //---------------------------------------------------------------------------
 
+void PriorityQueue::growSlotTable (uint32_t id) {
+
+	uint32_t newSize = slotTableSize ? slotTableSize : 1024;
+	while (newSize <= id)
+		newSize <<= 1;
+
+	int32_t* newTable = (int32_t*)systemHeap->Malloc(sizeof(int32_t) * newSize);
+	gosASSERT(newTable != NULL);
+
+	//-------------------------------------------------------------
+	// Stale entries are harmless (see find), so only copy what we
+	// had and zero the new tail...
+	if (slotTable) {
+		memcpy(newTable, slotTable, sizeof(int32_t) * slotTableSize);
+		systemHeap->Free(slotTable);
+	}
+	memset(newTable + slotTableSize, 0, sizeof(int32_t) * (newSize - slotTableSize));
+	slotTable = newTable;
+	slotTableSize = newSize;
+}
+
+//---------------------------------------------------------------------------
+
 void PriorityQueue::upHeap (int curIndex) {
 
 	PQNode startNode = pqList[curIndex];
@@ -53,13 +84,17 @@ void PriorityQueue::upHeap (int curIndex) {
 	pqList[0].key = keyMin;
 	pqList[0].id = 0xFFFFFFFF;
 	
-	//--------------------
-	// sort up the heap...
-	while (pqList[curIndex/2].key >= stopKey) {
-		pqList[curIndex] = pqList[curIndex/2];
-		curIndex /= 2;
+	//----------------------------------------------------------------
+	// sort up the heap (the parent of index 1 is the sentinel at 0)...
+	int parentIndex = (curIndex + PQ_ARITY - 2) / PQ_ARITY;
+	while (pqList[parentIndex].key >= stopKey) {
+		pqList[curIndex] = pqList[parentIndex];
+		setSlot(curIndex);
+		curIndex = parentIndex;
+		parentIndex = (curIndex + PQ_ARITY - 2) / PQ_ARITY;
 	}
 	pqList[curIndex] = startNode;
+	setSlot(curIndex);
 }
 
 //---------------------------------------------------------------------------
@@ -69,6 +104,9 @@ int PriorityQueue::insert (PQNode& item) {
 	if (numItems == maxItems)
 		return(1);
 
+	if (item.id >= slotTableSize)
+		growSlotTable(item.id);
+
 	pqList[++numItems] = item;
 	upHeap(numItems);
 	return(0);
@@ -83,18 +121,28 @@ void PriorityQueue::downHeap (int curIndex) {
 	PQNode startNode = pqList[curIndex];
 	int stopKey = startNode.key;
 
-	//----------------------
-	// Sort down the heap...
-	while (curIndex <= numItems/2) {
-		int nextIndex = curIndex << 1;
-		if ((nextIndex < numItems) && (pqList[nextIndex].key > pqList[nextIndex + 1].key))
-			nextIndex++;
+	//-----------------------------------------------------------------
+	// Sort down the heap. Children of curIndex live at
+	// [curIndex * PQ_ARITY - (PQ_ARITY - 2), curIndex * PQ_ARITY + 1]...
+	while (true) {
+		int firstChild = curIndex * PQ_ARITY - (PQ_ARITY - 2);
+		if (firstChild > numItems)
+			break;
+		int lastChild = firstChild + PQ_ARITY - 1;
+		if (lastChild > numItems)
+			lastChild = numItems;
+		int nextIndex = firstChild;
+		for (int childIndex = firstChild + 1; childIndex <= lastChild; childIndex++)
+			if (pqList[childIndex].key < pqList[nextIndex].key)
+				nextIndex = childIndex;
 		if (stopKey <= pqList[nextIndex].key)
 			break;
 		pqList[curIndex] = pqList[nextIndex];
+		setSlot(curIndex);
 		curIndex = nextIndex;
 	}
 	pqList[curIndex] = startNode;
+	setSlot(curIndex);
 }
 
 //---------------------------------------------------------------------------
@@ -103,7 +151,23 @@ void PriorityQueue::remove (PQNode& item) {
 
 	item = pqList[1];
 	pqList[1] = pqList[numItems--];
-	downHeap(1);
+	if (numItems > 0)
+		downHeap(1);
+}
+
+//---------------------------------------------------------------------------
+
+void PriorityQueue::removeItem (int itemIndex) {
+
+	//-------------------------------------------------------------
+	// Pull an item out from the middle of the heap. The last item
+	// takes its place and is sorted whichever way it needs to go...
+	pqList[itemIndex] = pqList[numItems--];
+	if (itemIndex <= numItems) {
+		setSlot(itemIndex);
+		upHeap(itemIndex);
+		downHeap(itemIndex);
+	}
 }
 
 //---------------------------------------------------------------------------
@@ -124,11 +188,15 @@ void PriorityQueue::change (int itemIndex, int newValue) {
 
 int PriorityQueue::find (unsigned int id) {
 
-	for (int index = 0; index <= numItems; index++)
-		if (pqList[index].id == id)
-        {
-			return(index);
-        }
+	if (id >= slotTableSize)
+		return(0);
+
+	//-----------------------------------------------------------------
+	// The slot table is never cleared, so only trust an entry if that
+	// slot is live and still holds this id...
+	int index = slotTable[id];
+	if ((index >= 1) && (index <= numItems) && (pqList[index].id == id))
+		return(index);
 	return(0);
 }
 
@@ -136,36 +204,31 @@ int PriorityQueue::find (unsigned int id) {
 
 int PriorityQueue::findByKey (int32_t key, uint32_t id, int startIndex/* = 1*/) {
 
-    int curIndex = startIndex;
-
-    if(key == pqList[curIndex].key && pqList[curIndex].id == id)
-        return curIndex;
-
-    int nextIndex = curIndex << 1;
-    if(nextIndex <= numItems && pqList[nextIndex].key <= key)
-    {
-        int idx = findByKey(key, id, nextIndex);
-        if(idx != 0)
-            return idx;
-    }
-    nextIndex++;
-	// no need for this check because last item is at index numItems (see e.g. find())
-    if(nextIndex <= numItems && pqList[nextIndex].key <= key)
-    {
-        int idx = findByKey(key, id, nextIndex);
-        if(idx != 0)
-            return idx;
-    }
-
-    return(0);
+	//-----------------------------------------------------------------
+	// With the slot table, the key is only needed to confirm the match.
+	// startIndex is kept for interface compatibility: only nodes in the
+	// subtree rooted there are reported.
+	int index = find(id);
+	if (!index || (pqList[index].key != key))
+		return(0);
+
+	int curIndex = index;
+	while (curIndex > startIndex)
+		curIndex = (curIndex + PQ_ARITY - 2) / PQ_ARITY;
+	return((curIndex == startIndex) ? index : 0);
 }
 
 //---------------------------------------------------------------------------
 	
 void PriorityQueue::destroy (void) {
 
-	systemHeap->Free(pqList);
+	if (pqList)
+		systemHeap->Free(pqList);
 	pqList = NULL;
+	if (slotTable)
+		systemHeap->Free(slotTable);
+	slotTable = NULL;
+	slotTableSize = 0;
 	maxItems = 0;
 	numItems = 0;
 }
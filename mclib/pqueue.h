@@ -24,6 +24,14 @@ typedef struct _PQNode {
 	int32_t         col;			// HB-specific
 } PQNode;
 
+//---------------------------------------------------------------------------
+// Indexed 4-ary min-heap. Along with the node list we keep an id -> heap slot
+// table (slotTable) so find() is O(1) and change() (decrease-key) is
+// O(log4 n). The slot table is never cleared: an entry is only trusted if the
+// slot it names is in use and holds that same id, which keeps clear() O(1).
+
+#define PQ_ARITY			4
+
 class PriorityQueue {
 
 	protected:
@@ -33,15 +41,27 @@ class PriorityQueue {
 		int32_t     numItems;
 		int32_t     keyMin;
 
+		int32_t*	slotTable;		// id -> index into pqList (may be stale)
+		uint32_t	slotTableSize;
+
 		void downHeap (int curIndex);
 
 		void upHeap (int curIndex);
 
+		void growSlotTable (uint32_t id);
+
+		void setSlot (int index) {
+			slotTable[pqList[index].id] = index;
+		}
+
 	public:
 
 		void init (void) {
 			pqList = NULL;
+			maxItems = 0;
 			numItems = 0;
+			slotTable = NULL;
+			slotTableSize = 0;
 		}
 
 		PriorityQueue (void) {
@@ -54,11 +74,21 @@ class PriorityQueue {
 
 		void remove (PQNode& item);
 
+		void removeItem (int itemIndex);
+
 		void change (int itemIndex, int newValue);
 
 		int find (unsigned int id);
 
 		int findByKey (int32_t key, uint32_t id, int startIndex = 1);
+
+		//-----------------------------------------------------------------
+		// Pre-sizes the slot table so inserts of ids below maxId never have
+		// to touch the heap (e.g. when the queue is used off the main thread).
+		void reserve (uint32_t maxId) {
+			if (maxId >= slotTableSize)
+				growSlotTable(maxId);
+		}
 		
 		void clear (void) {
 			numItems = 0;
@@ -0,0 +1,137 @@
+//***************************************************************************
+//
+//	ThreadPool.cpp -- Worker thread pool
+//
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+//***************************************************************************
+
+//--------------
+// Include Files
+
+#ifndef THREADPOOL_H
+#include"threadpool.h"
+#endif
+
+#include<gameos.hpp>
+
+//***************************************************************************
+
+ThreadPoolPtr WorkerThreads = NULL;
+
+//***************************************************************************
+// Class ThreadPool
+//***************************************************************************
+
+void ThreadPool::init (long maxThreads) {
+
+	//---------------------------------------------------------------------
+	// Leave a core for the main thread. A maxThreads of -1 means use what
+	// the machine has...
+	long hardwareThreads = (long)std::thread::hardware_concurrency() - 1;
+	if ((maxThreads < 0) || (maxThreads > hardwareThreads))
+		maxThreads = hardwareThreads;
+	if (maxThreads > MAX_THREADPOOL_THREADS)
+		maxThreads = MAX_THREADPOOL_THREADS;
+	if (maxThreads < 0)
+		maxThreads = 0;
+
+	firstJob = 0;
+	numJobs = 0;
+	numRunning = 0;
+	shuttingDown = false;
+
+	numThreads = maxThreads;
+	if (numThreads > 0) {
+		threads = new std::thread[numThreads];
+		gosASSERT(threads != NULL);
+		for (long i = 0; i < numThreads; i++)
+			threads[i] = std::thread(&ThreadPool::workerLoop, this);
+	}
+}
+
+//---------------------------------------------------------------------------
+
+void ThreadPool::workerLoop (void) {
+
+	std::unique_lock<std::mutex> guard(lock);
+	while (true) {
+		while ((numJobs == 0) && !shuttingDown)
+			jobReady.wait(guard);
+		if (numJobs == 0)
+			return;
+
+		ThreadPoolJob job = jobs[firstJob];
+		firstJob = (firstJob + 1) % MAX_THREADPOOL_JOBS;
+		numJobs--;
+		numRunning++;
+
+		guard.unlock();
+		job.func(job.data);
+		guard.lock();
+
+		numRunning--;
+		if ((numJobs == 0) && (numRunning == 0))
+			jobsDone.notify_all();
+	}
+}
+
+//---------------------------------------------------------------------------
+
+void ThreadPool::submit (ThreadPoolJobFunc func, void* data) {
+
+	//-------------------------------------------------------------
+	// No workers, or the ring is full: just do the job right here.
+	if (numThreads == 0) {
+		func(data);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		if (numJobs < MAX_THREADPOOL_JOBS) {
+			long jobIndex = (firstJob + numJobs) % MAX_THREADPOOL_JOBS;
+			jobs[jobIndex].func = func;
+			jobs[jobIndex].data = data;
+			numJobs++;
+			jobReady.notify_one();
+			return;
+		}
+	}
+	func(data);
+}
+
+//---------------------------------------------------------------------------
+
+void ThreadPool::wait (void) {
+
+	if (numThreads == 0)
+		return;
+
+	std::unique_lock<std::mutex> guard(lock);
+	while ((numJobs > 0) || (numRunning > 0))
+		jobsDone.wait(guard);
+}
+
+//---------------------------------------------------------------------------
+
+void ThreadPool::destroy (void) {
+
+	if (threads) {
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			shuttingDown = true;
+		}
+		jobReady.notify_all();
+		for (long i = 0; i < numThreads; i++)
+			threads[i].join();
+		delete [] threads;
+		threads = NULL;
+	}
+	numThreads = 0;
+	numJobs = 0;
+}
+
+//***************************************************************************
@@ -0,0 +1,99 @@
+//***************************************************************************
+//
+//	ThreadPool.h -- Prototype for the worker thread pool
+//
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+//***************************************************************************
+
+//--------------
+// Include Files
+
+#include<thread>
+#include<mutex>
+#include<condition_variable>
+
+//--------------------------------
+// Structure and Class Definitions
+
+#define	MAX_THREADPOOL_THREADS	7
+#define	MAX_THREADPOOL_JOBS		256
+
+typedef void (*ThreadPoolJobFunc) (void* data);
+
+typedef struct _ThreadPoolJob {
+	ThreadPoolJobFunc	func;
+	void*				data;
+} ThreadPoolJob;
+
+//---------------------------------------------------------------------------
+// Fixed set of worker threads pulling jobs off a ring. Jobs must not touch
+// the heap or any game state the main thread may change while they run--the
+// caller hands each job everything it needs and collects the results after
+// wait(). With no worker threads (single core), submit() runs the job inline.
+
+class ThreadPool {
+
+	protected:
+
+		std::thread*				threads;
+		long						numThreads;
+
+		std::mutex					lock;
+		std::condition_variable		jobReady;
+		std::condition_variable		jobsDone;
+
+		ThreadPoolJob				jobs[MAX_THREADPOOL_JOBS];
+		long						firstJob;
+		long						numJobs;
+		long						numRunning;
+		bool						shuttingDown;
+
+		void workerLoop (void);
+
+	public:
+
+		void init (void) {
+			threads = NULL;
+			numThreads = 0;
+			firstJob = 0;
+			numJobs = 0;
+			numRunning = 0;
+			shuttingDown = false;
+		}
+
+		ThreadPool (void) {
+			init();
+		}
+
+		void init (long maxThreads);
+
+		void submit (ThreadPoolJobFunc func, void* data);
+
+		void wait (void);
+
+		long getNumThreads (void) {
+			return(numThreads);
+		}
+
+		void destroy (void);
+
+		~ThreadPool (void) {
+			destroy();
+		}
+};
+
+typedef ThreadPool* ThreadPoolPtr;
+
+//***************************************************************************
+
+extern ThreadPoolPtr WorkerThreads;
+
+//***************************************************************************
+
+#endif
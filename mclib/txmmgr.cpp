@@ -47,7 +47,7 @@
 #include<gameos.hpp>
 #include<mlr/mlr.hpp>
 #include<gosfx/gosfxheaders.hpp>
-#include <utils/gl_utils.h>
+#include <utils/vec.h>
 
 //---------------------------------------------------------------------------
 // static globals
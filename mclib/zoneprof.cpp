@@ -0,0 +1,595 @@
+//***************************************************************************
+//
+//	ZoneProf.cpp -- Scoped zone profiler
+//
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+//***************************************************************************
+
+//--------------
+// Include Files
+
+#include<gameos.hpp>
+
+#ifndef ZONEPROF_H
+#include"zoneprof.h"
+#endif
+
+#ifdef ZONEPROF
+
+#include<string.h>
+#include<math.h>
+#include<chrono>
+#include<mutex>
+
+//***************************************************************************
+
+#define	ZONEPROF_NAME_LENGTH		64
+#define	ZONEPROF_BUCKETS			128		//four per doubling, up to four seconds
+#define	NO_ZONEPROF_NODE			-1
+
+typedef struct _ZoneProfZone {
+	char				name[ZONEPROF_NAME_LENGTH];
+	long				flags;
+	__int64				frameTime;						// last frame, in GetCycles() ticks
+} ZoneProfZone;
+
+typedef struct _ZoneProfNode {
+	long				zone;
+	long				parent;
+	long				firstChild;
+	long				nextSibling;
+	long				count;
+	__int64				total;
+	__int64				minTime;
+	__int64				maxTime;
+	__int64				frameTotal;
+	long				histogram[ZONEPROF_BUCKETS];
+} ZoneProfNode;
+
+typedef struct _ZoneProfOpen {
+	long				zone;
+	long				node;
+	__int64				start;
+} ZoneProfOpen;
+
+typedef struct _ZoneProfEvent {
+	__int64				start;
+	__int64				duration;
+	long				zone;
+} ZoneProfEvent;
+
+//---------------------------------------------------------------------------
+// A thread holds its own lock while it is inside any zone, so the readers
+// below only ever see a thread's tree and ring between zones.
+
+typedef struct _ZoneProfThread {
+	std::mutex			lock;
+	ZoneProfOpen		stack[MAX_ZONEPROF_DEPTH];
+	long				depth;
+	ZoneProfNode		nodes[MAX_ZONEPROF_NODES];
+	long				numNodes;
+	long				firstRoot;
+	ZoneProfEvent		ring[ZONEPROF_RING_EVENTS];
+	long				ringNext;
+	long				ringCount;
+} ZoneProfThread;
+
+//***************************************************************************
+
+std::atomic<bool>		ZoneProfRunning(false);
+
+static std::mutex		ZoneLock;
+static ZoneProfZone		Zones[MAX_ZONEPROF_ZONES];
+static long				NumZones = 0;
+
+static ZoneProfThread	Threads[MAX_ZONEPROF_THREADS];
+static std::atomic<long> NumThreads(0);
+static thread_local long ThreadIndex = -1;
+static long				FrameThread = -1;
+
+static bool				WantRunning = false;
+static long				NumFrames = 0;
+static __int64			ClockBase = 0;
+static __int64			LastFrameClock = 0;
+static __int64			LastFrameCycles = 0;
+static double			CyclesPerClock = 0.0;			// GetCycles() ticks per nanosecond, over the last frame
+
+//***************************************************************************
+// Zone registry
+//***************************************************************************
+
+long ZoneProf_register (const char* name, long flags) {
+
+	std::lock_guard<std::mutex> guard(ZoneLock);
+
+	for (long i = 0; i < NumZones; i++)
+		if (strcmp(Zones[i].name, name) == 0) {
+			Zones[i].flags |= flags;
+			return(i);
+		}
+
+	//------------------------------------------------------------
+	// Zone 0 is kept for the overflow, so running out of zones
+	// just lumps the rest together...
+	if (NumZones == 0) {
+		strcpy(Zones[0].name, "(too many zones)");
+		NumZones = 1;
+	}
+	if (NumZones == MAX_ZONEPROF_ZONES)
+		return(0);
+
+	strncpy(Zones[NumZones].name, name, ZONEPROF_NAME_LENGTH - 1);
+	Zones[NumZones].flags = flags;
+	Zones[NumZones].frameTime = 0;
+	return(NumZones++);
+}
+
+//---------------------------------------------------------------------------
+
+__int64* ZoneProf_getFrameTime (const char* name) {
+
+	return(&Zones[ZoneProf_register(name, 0)].frameTime);
+}
+
+//***************************************************************************
+// Recording
+//***************************************************************************
+
+inline __int64 ZoneProfClock (void) {
+
+	return((__int64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+//---------------------------------------------------------------------------
+
+static long getNumThreads (void) {
+
+	long numThreads = NumThreads;
+	return((numThreads > MAX_ZONEPROF_THREADS) ? MAX_ZONEPROF_THREADS : numThreads);
+}
+
+//---------------------------------------------------------------------------
+
+static ZoneProfThread* getThread (void) {
+
+	if (ThreadIndex == -1) {
+		ThreadIndex = NumThreads++;
+		if (ThreadIndex >= MAX_ZONEPROF_THREADS)
+			ThreadIndex = -2;
+		else {
+			std::lock_guard<std::mutex> guard(Threads[ThreadIndex].lock);
+			Threads[ThreadIndex].firstRoot = NO_ZONEPROF_NODE;
+		}
+	}
+
+	if (ThreadIndex < 0)
+		return(NULL);
+	return(&Threads[ThreadIndex]);
+}
+
+//---------------------------------------------------------------------------
+
+static long getBucket (__int64 time) {
+
+	if (time < 4)
+		return((time < 0) ? 0 : (long)time);
+
+	//-------------------------------------------------------
+	// Top two bits below the leading one pick the quarter...
+	long octave = 2;
+	while (time >> (octave + 1))
+		octave++;
+	long bucket = octave * 4 + (long)((time >> (octave - 2)) & 3);
+	if (bucket >= ZONEPROF_BUCKETS)
+		bucket = ZONEPROF_BUCKETS - 1;
+	return(bucket);
+}
+
+//---------------------------------------------------------------------------
+
+static __int64 getBucketTime (long bucket) {
+
+	if (bucket < 8)
+		return(bucket);
+
+	long octave = bucket / 4;
+	__int64 low = (__int64)(4 + (bucket & 3)) << (octave - 2);
+	return(low + ((__int64)1 << (octave - 2)) / 2);
+}
+
+//---------------------------------------------------------------------------
+
+static long findNode (ZoneProfThread* thread, long parent, long zone) {
+
+	long* link = (parent == NO_ZONEPROF_NODE) ? &thread->firstRoot : &thread->nodes[parent].firstChild;
+	while (*link != NO_ZONEPROF_NODE) {
+		if (thread->nodes[*link].zone == zone)
+			return(*link);
+		link = &thread->nodes[*link].nextSibling;
+	}
+
+	if (thread->numNodes == MAX_ZONEPROF_NODES)
+		return(NO_ZONEPROF_NODE);
+
+	long newNode = thread->numNodes++;
+	ZoneProfNode* node = &thread->nodes[newNode];
+	memset(node, 0, sizeof(ZoneProfNode));
+	node->zone = zone;
+	node->parent = parent;
+	node->firstChild = NO_ZONEPROF_NODE;
+	node->nextSibling = NO_ZONEPROF_NODE;
+	*link = newNode;
+	return(newNode);
+}
+
+//---------------------------------------------------------------------------
+
+void ZoneProf_begin (long zone) {
+
+	ZoneProfThread* thread = getThread();
+	if (!thread)
+		return;
+
+	if (thread->depth == 0)
+		thread->lock.lock();
+
+	if (thread->depth == MAX_ZONEPROF_DEPTH)
+		return;
+
+	long parent = thread->depth ? thread->stack[thread->depth - 1].node : NO_ZONEPROF_NODE;
+	ZoneProfOpen* open = &thread->stack[thread->depth++];
+	open->zone = zone;
+	open->node = (parent == NO_ZONEPROF_NODE) && (thread->depth > 1) ? NO_ZONEPROF_NODE : findNode(thread, parent, zone);
+	open->start = ZoneProfClock();
+}
+
+//---------------------------------------------------------------------------
+
+static void closeZone (ZoneProfThread* thread, ZoneProfOpen* open, __int64 now) {
+
+	__int64 duration = now - open->start;
+
+	if (open->node != NO_ZONEPROF_NODE) {
+		ZoneProfNode* node = &thread->nodes[open->node];
+		if ((node->count == 0) || (duration < node->minTime))
+			node->minTime = duration;
+		if (duration > node->maxTime)
+			node->maxTime = duration;
+		node->count++;
+		node->total += duration;
+		node->frameTotal += duration;
+		node->histogram[getBucket(duration)]++;
+	}
+
+	if (Zones[open->zone].flags & ZONEPROF_FINE)
+		return;
+
+	ZoneProfEvent* event = &thread->ring[thread->ringNext];
+	event->start = open->start;
+	event->duration = duration;
+	event->zone = open->zone;
+	thread->ringNext = (thread->ringNext + 1) % ZONEPROF_RING_EVENTS;
+	if (thread->ringCount < ZONEPROF_RING_EVENTS)
+		thread->ringCount++;
+}
+
+//---------------------------------------------------------------------------
+
+void ZoneProf_end (long zone) {
+
+	if (ThreadIndex < 0)
+		return;
+
+	ZoneProfThread* thread = &Threads[ThreadIndex];
+	long i = thread->depth - 1;
+	while ((i >= 0) && (thread->stack[i].zone != zone))
+		i--;
+	if (i < 0)
+		return;
+
+	__int64 now = ZoneProfClock();
+	while (thread->depth > i) {
+		thread->depth--;
+		closeZone(thread, &thread->stack[thread->depth], now);
+	}
+
+	if (thread->depth == 0)
+		thread->lock.unlock();
+}
+
+//***************************************************************************
+// Frame and control
+//***************************************************************************
+
+//---------------------------------------------------------------------------
+// The calling thread's own lock is skipped.  It may be inside a zone of its
+// own, and nothing else writes to its data while it's in here.
+
+static void lockThreads (void) {
+
+	for (long i = 0; i < getNumThreads(); i++)
+		if (i != ThreadIndex)
+			Threads[i].lock.lock();
+}
+
+//---------------------------------------------------------------------------
+
+static void unlockThreads (void) {
+
+	for (long i = 0; i < getNumThreads(); i++)
+		if (i != ThreadIndex)
+			Threads[i].lock.unlock();
+}
+
+//---------------------------------------------------------------------------
+
+static void resetThreads (void) {
+
+	for (long i = 0; i < getNumThreads(); i++) {
+		Threads[i].numNodes = 0;
+		Threads[i].firstRoot = NO_ZONEPROF_NODE;
+		Threads[i].ringNext = 0;
+		Threads[i].ringCount = 0;
+	}
+
+	for (long i = 0; i < NumZones; i++)
+		Zones[i].frameTime = 0;
+
+	NumFrames = 0;
+	ClockBase = ZoneProfClock();
+	LastFrameClock = 0;
+	CyclesPerClock = 0.0;
+}
+
+//---------------------------------------------------------------------------
+
+void ZoneProf_frame (void) {
+
+	//--------------------------------------------------------------
+	// Anything left open on this thread (a BEGIN that never saw its
+	// END) is closed here, so the frame starts with an empty stack.
+	ZoneProfThread* thread = getThread();
+	if (thread && thread->depth)
+		ZoneProf_end(thread->stack[0].zone);
+	FrameThread = ThreadIndex;
+
+	if (WantRunning != ZoneProfRunning) {
+		lockThreads();
+		if (WantRunning)
+			resetThreads();
+		ZoneProfRunning = WantRunning;
+		unlockThreads();
+		return;
+	}
+
+	if (!ZoneProfRunning)
+		return;
+
+	NumFrames++;
+	for (long i = 0; i < NumZones; i++)
+		Zones[i].frameTime = 0;
+
+	//--------------------------------------------------------------
+	// A worker still inside a zone keeps its time for next frame,
+	// rather than holding up this one...
+	for (long i = 0; i < getNumThreads(); i++) {
+		if (!Threads[i].lock.try_lock())
+			continue;
+		for (long j = 0; j < Threads[i].numNodes; j++) {
+			ZoneProfNode* node = &Threads[i].nodes[j];
+			Zones[node->zone].frameTime += node->frameTotal;
+			node->frameTotal = 0;
+		}
+		Threads[i].lock.unlock();
+	}
+
+	//--------------------------------------------------------------
+	// The frame times go to the GameOS statistics as gos_timedata,
+	// which is counted in GetCycles() ticks.  Those are nanoseconds
+	// on Linux but the TSC on Windows, so scale by how many ticks
+	// the last frame took.  Until there's a frame to go by, zero.
+	__int64 clock = ZoneProfClock();
+	__int64 cycles = GetCycles();
+	if (LastFrameClock && (clock > LastFrameClock))
+		CyclesPerClock = (double)(cycles - LastFrameCycles) / (double)(clock - LastFrameClock);
+	LastFrameClock = clock;
+	LastFrameCycles = cycles;
+
+	for (long i = 0; i < NumZones; i++)
+		Zones[i].frameTime = (__int64)(Zones[i].frameTime * CyclesPerClock);
+}
+
+//---------------------------------------------------------------------------
+
+void ZoneProf_enable (bool on) {
+
+	WantRunning = on;
+}
+
+//---------------------------------------------------------------------------
+
+bool ZoneProf_isEnabled (void) {
+
+	return(ZoneProfRunning);
+}
+
+//---------------------------------------------------------------------------
+
+long ZoneProf_getNumFrames (void) {
+
+	return(NumFrames);
+}
+
+//***************************************************************************
+// Output
+//***************************************************************************
+
+static void writeName (FILE* file, const char* name) {
+
+	for (; *name; name++) {
+		if ((*name == '"') || (*name == '\\'))
+			fputc('\\', file);
+		fputc(*name, file);
+	}
+}
+
+//---------------------------------------------------------------------------
+
+bool ZoneProf_writeTrace (const char* fileName) {
+
+	FILE* file = fopen(fileName, "w");
+	if (!file)
+		return(false);
+
+	lockThreads();
+
+	fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	bool first = true;
+	for (long i = 0; i < getNumThreads(); i++) {
+		ZoneProfThread* thread = &Threads[i];
+		fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%ld,\"args\":{\"name\":\"", first ? "" : ",\n", i);
+		if (i == FrameThread)
+			fprintf(file, "Main\"}}");
+		else
+			fprintf(file, "Worker %ld\"}}", i);
+		first = false;
+
+		//--------------------------------------
+		// Oldest first, once the ring wraps...
+		long event = (thread->ringCount < ZONEPROF_RING_EVENTS) ? 0 : thread->ringNext;
+		for (long j = 0; j < thread->ringCount; j++) {
+			ZoneProfEvent* curEvent = &thread->ring[event];
+			fprintf(file, ",\n{\"name\":\"");
+			writeName(file, Zones[curEvent->zone].name);
+			fprintf(file, "\",\"ph\":\"X\",\"pid\":1,\"tid\":%ld,\"ts\":%.3f,\"dur\":%.3f}", i,
+					(curEvent->start - ClockBase) / 1000.0, curEvent->duration / 1000.0);
+			event = (event + 1) % ZONEPROF_RING_EVENTS;
+		}
+	}
+	fprintf(file, "\n]}\n");
+
+	unlockThreads();
+
+	fclose(file);
+	return(true);
+}
+
+//---------------------------------------------------------------------------
+
+static __int64 getPercentile (long* histogram, long count, __int64 minTime, __int64 maxTime, double percent) {
+
+	long target = (long)ceil(count * percent);
+	if (target < 1)
+		target = 1;
+
+	long sum = 0;
+	for (long i = 0; i < ZONEPROF_BUCKETS; i++) {
+		sum += histogram[i];
+		if (sum >= target) {
+			__int64 time = getBucketTime(i);
+			if (time < minTime)
+				time = minTime;
+			if (time > maxTime)
+				time = maxTime;
+			return(time);
+		}
+	}
+	return(maxTime);
+}
+
+//---------------------------------------------------------------------------
+
+static void printZoneLine (FILE* out, long indent, const char* name, long count, __int64 total, __int64 self, __int64 minTime, __int64 maxTime, long* histogram) {
+
+	double frames = NumFrames ? (double)NumFrames : 1.0;
+	fprintf(out, "%*s%-*s %9.2f %9.3f", (int)indent, "", (int)(36 - indent), name, count / frames, total / frames / 1000000.0);
+	if (self >= 0)
+		fprintf(out, " %9.3f", self / frames / 1000000.0);
+	fprintf(out, " %9.1f %9.1f %9.1f %9.1f\n",
+			minTime / 1000.0,
+			count ? (total / count) / 1000.0 : 0.0,
+			getPercentile(histogram, count, minTime, maxTime, 0.99) / 1000.0,
+			maxTime / 1000.0);
+}
+
+//---------------------------------------------------------------------------
+
+static void printNode (FILE* out, ZoneProfThread* thread, long nodeIndex, long indent) {
+
+	ZoneProfNode* node = &thread->nodes[nodeIndex];
+
+	__int64 self = node->total;
+	for (long child = node->firstChild; child != NO_ZONEPROF_NODE; child = thread->nodes[child].nextSibling)
+		self -= thread->nodes[child].total;
+
+	//-------------------------------------------------------------
+	// A zone still open has its children's time but not its own.
+	if (self < 0)
+		self = 0;
+
+	printZoneLine(out, indent, Zones[node->zone].name, node->count, node->total, self, node->minTime, node->maxTime, node->histogram);
+
+	for (long child = node->firstChild; child != NO_ZONEPROF_NODE; child = thread->nodes[child].nextSibling)
+		printNode(out, thread, child, indent + 2);
+}
+
+//---------------------------------------------------------------------------
+
+void ZoneProf_printSummary (FILE* out) {
+
+	lockThreads();
+
+	fprintf(out, "ZoneProf: %ld frames\n", NumFrames);
+
+	//------------------------------------------------
+	// Call tree per thread.  Per-call times are in us.
+	for (long i = 0; i < getNumThreads(); i++) {
+		ZoneProfThread* thread = &Threads[i];
+		if (thread->firstRoot == NO_ZONEPROF_NODE)
+			continue;
+		if (i == FrameThread)
+			fprintf(out, "\n%-36s %9s %9s %9s %9s %9s %9s %9s\n", "Main", "calls/frm", "ms/frame", "self ms", "min us", "avg us", "p99 us", "max us");
+		else
+			fprintf(out, "\nWorker %-29ld %9s %9s %9s %9s %9s %9s %9s\n", i, "calls/frm", "ms/frame", "self ms", "min us", "avg us", "p99 us", "max us");
+		for (long root = thread->firstRoot; root != NO_ZONEPROF_NODE; root = thread->nodes[root].nextSibling)
+			printNode(out, thread, root, 0);
+	}
+
+	//--------------------------------------------------------
+	// Then each zone over all its callers and threads.  A zone
+	// nested inside itself counts twice here.
+	fprintf(out, "\n%-36s %9s %9s %9s %9s %9s %9s\n", "All zones", "calls/frm", "ms/frame", "min us", "avg us", "p99 us", "max us");
+	for (long zone = 0; zone < NumZones; zone++) {
+		long histogram[ZONEPROF_BUCKETS];
+		memset(histogram, 0, sizeof(histogram));
+		long count = 0;
+		__int64 total = 0;
+		__int64 minTime = 0;
+		__int64 maxTime = 0;
+		for (long i = 0; i < getNumThreads(); i++)
+			for (long j = 0; j < Threads[i].numNodes; j++) {
+				ZoneProfNode* node = &Threads[i].nodes[j];
+				if ((node->zone != zone) || (node->count == 0))
+					continue;
+				if ((count == 0) || (node->minTime < minTime))
+					minTime = node->minTime;
+				if (node->maxTime > maxTime)
+					maxTime = node->maxTime;
+				count += node->count;
+				total += node->total;
+				for (long k = 0; k < ZONEPROF_BUCKETS; k++)
+					histogram[k] += node->histogram[k];
+			}
+		if (count)
+			printZoneLine(out, 0, Zones[zone].name, count, total, -1, minTime, maxTime, histogram);
+	}
+
+	unlockThreads();
+}
+
+//***************************************************************************
+
+#endif
@@ -0,0 +1,149 @@
+//***************************************************************************
+//
+//	ZoneProf.h -- Prototype for the scoped zone profiler
+//
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+#ifndef ZONEPROF_H
+#define ZONEPROF_H
+
+//***************************************************************************
+
+//---------------------------------------------------------------------------
+// Named zones are timed as nested scopes.  Each thread keeps its own call
+// tree of zones (count, min, max, total and a histogram for p99) and a ring
+// of the last completed zones, which is written out as a Chrome trace
+// (chrome://tracing or ui.perfetto.dev).
+//
+// The profiler is compiled into LAB_ONLY builds, or any build defining
+// ZONEPROF (mc2_headless always does, for its game code and this file).
+// Elsewhere the macros compile to nothing.  When compiled in, it
+// starts switched off and a zone costs one test until ZoneProf_enable().
+//
+// Zones around work done per object (LOS checks, transform and light, etc.)
+// should use the _FINE macros.  Those are kept in the aggregates but not in
+// the trace, so they don't crowd the frame-level zones out of the ring.
+
+#if defined(LAB_ONLY) && !defined(ZONEPROF)
+#define	ZONEPROF
+#endif
+
+#ifdef ZONEPROF
+
+//--------------
+// Include Files
+
+#include<stdio.h>
+#include<atomic>
+
+//--------------------------------
+// Structure and Class Definitions
+
+#define	MAX_ZONEPROF_ZONES			256
+#define	MAX_ZONEPROF_THREADS		8
+#define	MAX_ZONEPROF_NODES			512
+#define	MAX_ZONEPROF_DEPTH			32
+#define	ZONEPROF_RING_EVENTS		32768
+
+#define	ZONEPROF_FINE				1
+
+extern std::atomic<bool> ZoneProfRunning;
+
+long ZoneProf_register (const char* name, long flags);
+
+void ZoneProf_begin (long zone);
+
+void ZoneProf_end (long zone);
+
+//---------------------------------------------------------------------------
+// Call once a frame, outside of any zone.  Switching the profiler on or off
+// takes effect here, so a capture always covers whole frames.
+
+void ZoneProf_frame (void);
+
+void ZoneProf_enable (bool on);
+
+bool ZoneProf_isEnabled (void);
+
+long ZoneProf_getNumFrames (void);
+
+//---------------------------------------------------------------------------
+// Time spent in the zone over the last frame, in GetCycles() ticks and summed
+// over all threads.  The pointer stays valid, so it can be handed to
+// AddStatistic as gos_timedata.
+
+__int64* ZoneProf_getFrameTime (const char* name);
+
+//---------------------------------------------------------------------------
+// These wait for any other thread inside a zone to leave it, so don't call
+// them from a worker thread while the main thread is waiting on it.
+
+bool ZoneProf_writeTrace (const char* fileName);
+
+void ZoneProf_printSummary (FILE* out);
+
+//---------------------------------------------------------------------------
+
+class ZoneProfScope {
+
+	protected:
+
+		long		zone;
+		bool		running;
+
+	public:
+
+		ZoneProfScope (long zoneId) {
+			zone = zoneId;
+			running = ZoneProfRunning.load(std::memory_order_relaxed);
+			if (running)
+				ZoneProf_begin(zone);
+		}
+
+		~ZoneProfScope (void) {
+			if (running)
+				ZoneProf_end(zone);
+		}
+};
+
+#define	ZONEPROF_CAT2(a,b)			a##b
+#define	ZONEPROF_CAT(a,b)			ZONEPROF_CAT2(a,b)
+
+#define	ZONEPROF_SCOPE(name,flags)	static const long ZONEPROF_CAT(zoneProfId,__LINE__) = ZoneProf_register(name, flags);\
+									ZoneProfScope ZONEPROF_CAT(zoneProfScope,__LINE__)(ZONEPROF_CAT(zoneProfId,__LINE__))
+
+#define	ZONEPROF_MARK(name,flags,func)	do {if (ZoneProfRunning.load(std::memory_order_relaxed)) {\
+										static const long zoneProfId = ZoneProf_register(name, flags);\
+										func(zoneProfId);}} while (0)
+
+//---------------------------------------------------------------------------
+// PROFILE_ZONE times the rest of the enclosing scope.  PROFILE_BEGIN and
+// PROFILE_END time a stretch of code that isn't a scope of its own.  An END
+// closes any zones still open inside it, and does nothing if its BEGIN never
+// ran, so a return between the two can't unbalance the stack for long.
+
+#define	PROFILE_ZONE(name)			ZONEPROF_SCOPE(name, 0)
+#define	PROFILE_ZONE_FINE(name)		ZONEPROF_SCOPE(name, ZONEPROF_FINE)
+#define	PROFILE_CALL(name,call)		{ZONEPROF_SCOPE(name, 0); call;}
+
+#define	PROFILE_BEGIN(name)			ZONEPROF_MARK(name, 0, ZoneProf_begin)
+#define	PROFILE_BEGIN_FINE(name)	ZONEPROF_MARK(name, ZONEPROF_FINE, ZoneProf_begin)
+#define	PROFILE_END(name)			ZONEPROF_MARK(name, 0, ZoneProf_end)
+
+#else
+
+#define	PROFILE_ZONE(name)
+#define	PROFILE_ZONE_FINE(name)
+#define	PROFILE_CALL(name,call)		{call;}
+
+#define	PROFILE_BEGIN(name)			do {} while (0)
+#define	PROFILE_BEGIN_FINE(name)	do {} while (0)
+#define	PROFILE_END(name)			do {} while (0)
+
+#endif
+
+//***************************************************************************
+
+#endif
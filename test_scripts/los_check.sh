@@ -0,0 +1,33 @@
+#!/bin/sh
+# Loads a mission headless and casts a fixed set of rays over its map, once
+# with the LOS height bound and horizon shortcuts and once with the full
+# terrain march.  Fails if any ray comes out differently.
+#
+# usage: los_check.sh <mc2_headless> <data dir> <mission> [rays]
+
+if [ $# -lt 3 ] || [ $# -gt 4 ]; then
+	echo "usage: $0 <mc2_headless> <data dir> <mission> [rays]"
+	exit 2
+fi
+
+headless=$(readlink -f "$1")
+mission=$3
+rays=${4:-100000}
+
+cd "$2" || exit 2
+
+result=$("$headless" -mission "$mission" -checklos "$rays" 2>&1 | grep "^LOSCHECK:")
+echo "$result"
+
+if [ -z "$result" ]; then
+	echo "FAIL: $mission ran no LOS check"
+	exit 1
+fi
+
+# LOSCHECK: <mission> <mismatches> of <rays> rays differ
+if ! echo "$result" | grep -q "^LOSCHECK: .* 0 of $rays rays differ$"; then
+	echo "FAIL: $mission LOS shortcuts disagree with the full march"
+	exit 1
+fi
+
+echo "OK: $mission"
@@ -0,0 +1,40 @@
+#!/bin/sh
+# Records a mission headless, replays the log and checks that the replay
+# stayed on the recording: every checkpoint matched and every seed a
+# script passed to seedRandom was used.  Pick a mission whose scripts call
+# seedRandom, or the seed handling isn't being tested at all.
+#
+# usage: replay_check.sh <mc2_headless> <data dir> <mission>
+
+if [ $# -ne 3 ]; then
+	echo "usage: $0 <mc2_headless> <data dir> <mission>"
+	exit 2
+fi
+
+headless=$(readlink -f "$1")
+mission=$3
+log=$(mktemp /tmp/replay_check.XXXXXX)
+
+cd "$2" || exit 2
+
+"$headless" -mission "$mission" -record "$log" > "$log.record.txt" 2>&1
+"$headless" -replay "$log" > "$log.replay.txt" 2>&1
+cat "$log.record.txt" "$log.replay.txt" | grep "^RECORD:\|^REPLAY:"
+
+seeds=$(sed -n 's/^RECORD: .*, \([0-9]*\) seeds$/\1/p' "$log.record.txt")
+result=$(grep "checkpoints matched" "$log.replay.txt")
+rm -f "$log" "$log.record.txt" "$log.replay.txt"
+
+if [ -z "$seeds" ] || [ "$seeds" -eq 0 ]; then
+	echo "FAIL: $mission recorded no seeds"
+	exit 1
+fi
+
+# REPLAY: <n> of <n> checkpoints matched, <seeds> seeds used, 0 seeds missed
+echo "$result" | grep -q "^REPLAY: \([0-9]*\) of \1 checkpoints matched, $seeds seeds used, 0 seeds missed$"
+if [ $? -ne 0 ]; then
+	echo "FAIL: $mission replay went off the recording"
+	exit 1
+fi
+
+echo "OK: $mission"